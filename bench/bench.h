@@ -0,0 +1,19 @@
+// clang-format off
+/// bench.h: provides the helpers shared by the benchmarks
+///
+///     now() -> f64: the seconds of the monotonic clock
+///
+/// A benchmark defines _GNU_SOURCE before any include, for clock_gettime under -std=c99.
+// clang-format on
+
+#pragma once
+
+#include <time.h>
+
+#include "utils.h"
+
+FUNC_STATIC f64 now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,113 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "arena.h"
+#include "tem_list.h"
+#include "tem_map.h"
+#include "tem_vec.h"
+
+static Arena bench_arena;
+
+DECLARE_PLAIN_VEC(VecI64, i64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecI64, i64, FUNC_STATIC);
+
+DECLARE_LIST(ListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_LIST(ListI64, i64, FUNC_STATIC);
+
+DECLARE_MAPPING(MapI64, i64, i64, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR);
+DEFINE_MAPPING(MapI64, i64, i64, FUNC_STATIC);
+
+DECLARE_PLAIN_VEC_WITH_ALLOCATOR(AVecI64, i64, FUNC_STATIC,
+                                 GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_PLAIN_VEC(AVecI64, i64, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AVecI64, allocator, /) {
+    return CALL(Arena, bench_arena, as_allocator, /);
+}
+
+DECLARE_LIST_WITH_ALLOCATOR(AListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE,
+                            GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_LIST(AListI64, i64, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AListI64, allocator, /) {
+    return CALL(Arena, bench_arena, as_allocator, /);
+}
+
+DECLARE_MAPPING_WITH_ALLOCATOR(AMapI64, i64, i64, FUNC_STATIC,
+                               GENERATOR_PLAIN_KEY, GENERATOR_PLAIN_VALUE,
+                               GENERATOR_PLAIN_COMPARATOR,
+                               GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_MAPPING(AMapI64, i64, i64, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AMapI64, allocator, /) {
+    return CALL(Arena, bench_arena, as_allocator, /);
+}
+
+#define BENCH_REQUESTS 20000
+#define BENCH_ITEMS 200
+
+static void report(const char *name, f64 sec, i64 check) {
+    printf("    %-6s %8.3f ms, %8.2f us/request (check %lld)\n", name,
+           sec * 1e3, sec / BENCH_REQUESTS * 1e6, (long long)check);
+}
+
+/// a request: a few temporary vectors, a list and a mapping, dropped at the end
+static void bench_libc() {
+    i64 check = 0;
+    f64 start = now();
+    for (i64 r = 0; r < BENCH_REQUESTS; r++) {
+        ListI64 list = CREOBJ(ListI64, /);
+        MapI64 map = CREOBJ(MapI64, /);
+        for (i64 v = 0; v < 8; v++) {
+            VecI64 vec = CREOBJ(VecI64, /);
+            for (i64 i = 0; i < BENCH_ITEMS / 8; i++) {
+                CALL(VecI64, vec, push_back, /, r + i);
+            }
+            check += vec.data[vec.size - 1];
+            DROPOBJ(VecI64, vec);
+        }
+        for (i64 i = 0; i < BENCH_ITEMS; i++) {
+            CALL(ListI64, list, push_back, /, i);
+            CALL(MapI64, map, insert, /, (i * 7919) % BENCH_ITEMS, i);
+        }
+        check += (i64)(list.size + map.size);
+        DROPOBJ(MapI64, map);
+        DROPOBJ(ListI64, list);
+    }
+    report("libc", now() - start, check);
+}
+
+static void bench_arena_requests() {
+    CALL(Arena, bench_arena, init, /, 0);
+    i64 check = 0;
+    f64 start = now();
+    for (i64 r = 0; r < BENCH_REQUESTS; r++) {
+        AListI64 list = CREOBJ(AListI64, /);
+        AMapI64 map = CREOBJ(AMapI64, /);
+        for (i64 v = 0; v < 8; v++) {
+            AVecI64 vec = CREOBJ(AVecI64, /);
+            for (i64 i = 0; i < BENCH_ITEMS / 8; i++) {
+                CALL(AVecI64, vec, push_back, /, r + i);
+            }
+            check += vec.data[vec.size - 1];
+            DROPOBJ(AVecI64, vec);
+        }
+        for (i64 i = 0; i < BENCH_ITEMS; i++) {
+            CALL(AListI64, list, push_back, /, i);
+            CALL(AMapI64, map, insert, /, (i * 7919) % BENCH_ITEMS, i);
+        }
+        check += (i64)(list.size + map.size);
+        DROPOBJ(AMapI64, map);
+        DROPOBJ(AListI64, list);
+        CALL(Arena, bench_arena, reset, /);
+    }
+    report("arena", now() - start, check);
+    DROPOBJ(Arena, bench_arena);
+}
+
+int main() {
+    printf("%d requests of 8 vectors, a list and a mapping of %d items\n",
+           BENCH_REQUESTS, BENCH_ITEMS);
+    bench_libc();
+    bench_arena_requests();
+    return 0;
+}
@@ -0,0 +1,65 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_bitvec.h"
+#include "tem_vec.h"
+
+DECLARE_BITVEC(BitVec, FUNC_STATIC);
+DEFINE_BITVEC(BitVec, FUNC_STATIC);
+
+DECLARE_PLAIN_VEC(VecU8, u8, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecU8, u8, FUNC_STATIC);
+
+#define BENCH_BITS ((usize)1 << 26)
+#define BENCH_ROUNDS 20
+
+static usize intersect_flags(VecU8 *a, const VecU8 *b) {
+    usize cnt = 0;
+    for (usize i = 0; i < a->size; i++) {
+        a->data[i] &= b->data[i];
+        cnt += a->data[i];
+    }
+    return cnt;
+}
+
+static const char *level_names[] = {"scalar", "vec128", "avx2"};
+
+int main() {
+    VecU8 fa = CREOBJ(VecU8, /), fb = CREOBJ(VecU8, /);
+    BitVec ba = CREOBJ(BitVec, /), bb = CREOBJ(BitVec, /);
+    for (usize i = 0; i < BENCH_BITS; i++) {
+        CALL(VecU8, fa, push_back, /, i % 3 != 0);
+        CALL(VecU8, fb, push_back, /, i % 5 != 0);
+        CALL(BitVec, ba, push_back, /, i % 3 != 0);
+        CALL(BitVec, bb, push_back, /, i % 5 != 0);
+    }
+    printf("intersect and count x %zu flags\n", BENCH_BITS);
+
+    usize cnt = 0;
+    f64 start = now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        cnt += intersect_flags(&fa, &fb);
+    }
+    printf("    %-8s %8.3f ms (%zu)\n", "u8 flags",
+           (now() - start) * 1e3 / BENCH_ROUNDS, cnt / BENCH_ROUNDS);
+
+    SimdLevel supported = NSCALL(Simd, level, /);
+    for (SimdLevel level = SIMD_LEVEL_SCALAR; level <= supported; level++) {
+        NSCALL(Simd, set_level, /, level);
+        cnt = 0;
+        start = now();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            CALL(BitVec, ba, and_with, /, &bb);
+            cnt += CALL(BitVec, ba, count_ones, /);
+        }
+        printf("    %-8s %8.3f ms (%zu)\n", level_names[level],
+               (now() - start) * 1e3 / BENCH_ROUNDS, cnt / BENCH_ROUNDS);
+    }
+
+    DROPOBJ(BitVec, bb);
+    DROPOBJ(BitVec, ba);
+    DROPOBJ(VecU8, fb);
+    DROPOBJ(VecU8, fa);
+    return 0;
+}
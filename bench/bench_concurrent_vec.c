@@ -0,0 +1,66 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_concurrent_vec.h"
+#include "tem_vec.h"
+
+DECLARE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+
+DECLARE_CONCURRENT_VEC(CVecU64, u64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_CONCURRENT_VEC(CVecU64, u64, FUNC_STATIC);
+
+#define BENCH_PER_THREAD 4000000
+#define BENCH_MAX_THREADS 8
+
+static VecU64 locked_vec;
+static pthread_mutex_t locked_mutex = PTHREAD_MUTEX_INITIALIZER;
+static CVecU64 concurrent_vec;
+
+static void *append_locked(void *arg) {
+    u64 base = (u64)(uintptr_t)arg * BENCH_PER_THREAD;
+    for (u64 i = 0; i < BENCH_PER_THREAD; i++) {
+        pthread_mutex_lock(&locked_mutex);
+        CALL(VecU64, locked_vec, push_back, /, base + i);
+        pthread_mutex_unlock(&locked_mutex);
+    }
+    return NULL;
+}
+
+static void *append_concurrent(void *arg) {
+    u64 base = (u64)(uintptr_t)arg * BENCH_PER_THREAD;
+    for (u64 i = 0; i < BENCH_PER_THREAD; i++) {
+        CALL(CVecU64, concurrent_vec, push_back, /, base + i);
+    }
+    return NULL;
+}
+
+static f64 run(void *(*append)(void *), usize n_threads) {
+    pthread_t threads[BENCH_MAX_THREADS];
+    f64 start = now();
+    for (usize i = 0; i < n_threads; i++) {
+        pthread_create(&threads[i], NULL, append, (void *)(uintptr_t)i);
+    }
+    for (usize i = 0; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return n_threads * BENCH_PER_THREAD / (now() - start) / 1e6;
+}
+
+int main() {
+    printf("append x %d per thread\n", BENCH_PER_THREAD);
+    for (usize n = 1; n <= BENCH_MAX_THREADS; n *= 2) {
+        locked_vec = CREOBJ(VecU64, /);
+        concurrent_vec = CREOBJ(CVecU64, /);
+        f64 locked = run(append_locked, n);
+        f64 concurrent = run(append_concurrent, n);
+        printf("    %zu threads: mutex vec %8.2f Mops/s, concurrent vec "
+               "%8.2f Mops/s\n",
+               n, locked, concurrent);
+        DROPOBJ(CVecU64, concurrent_vec);
+        DROPOBJ(VecU64, locked_vec);
+    }
+    return 0;
+}
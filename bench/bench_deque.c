@@ -0,0 +1,42 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_deque.h"
+#include "tem_list.h"
+
+DECLARE_DEQUE(DequeI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_DEQUE(DequeI64, i64, FUNC_STATIC);
+
+DECLARE_LIST(ListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_LIST(ListI64, i64, FUNC_STATIC);
+
+#define BENCH_OPS 10000000
+#define BENCH_BACKLOG 1000
+
+/* a FIFO work queue keeping BENCH_BACKLOG items in flight */
+#define BENCH_FIFO(name, Q, init, ...)                                         \
+    ({                                                                         \
+        Q MPROT(q);                                                            \
+        CALL(Q, MPROT(q), init, /, ##__VA_ARGS__);                             \
+        i64 MPROT(sum) = 0;                                                    \
+        f64 MPROT(start) = now();                                              \
+        for (i64 i = 0; i < BENCH_OPS; i++) {                                  \
+            CALL(Q, MPROT(q), push_back, /, i);                                \
+            if (MPROT(q).size > BENCH_BACKLOG) {                               \
+                MPROT(sum) += CALL(Q, MPROT(q), pop_front, /);                 \
+            }                                                                  \
+        }                                                                      \
+        f64 MPROT(sec) = now() - MPROT(start);                                 \
+        printf("    %-6s %8.2f Mops/s (sum %lld)\n", name,                     \
+               BENCH_OPS / MPROT(sec) / 1e6, (long long)MPROT(sum));           \
+        DROPOBJ(Q, MPROT(q));                                                  \
+    })
+
+int main() {
+    printf("fifo x %d\n", BENCH_OPS);
+    BENCH_FIFO("list", ListI64, init);
+    BENCH_FIFO("pooled", ListI64, init_pooled, NULL);
+    BENCH_FIFO("deque", DequeI64, init);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_list.h"
+#include "tem_lru_cache.h"
+#include "tem_map.h"
+
+DECLARE_LIST(ListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_LIST(ListI64, i64, FUNC_STATIC);
+
+DECLARE_MAPPING(MapI64, i64, ListI64Node *, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR);
+DEFINE_MAPPING(MapI64, i64, ListI64Node *, FUNC_STATIC);
+
+DECLARE_LRU_CACHE(CacheI64, i64, i64, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                  GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR,
+                  GENERATOR_PLAIN_HASH);
+DEFINE_LRU_CACHE(CacheI64, i64, i64, FUNC_STATIC);
+
+#define BENCH_CAP 4096
+#define BENCH_KEYS 16384
+#define BENCH_OPS 4000000
+
+static u64 bench_rand(u64 *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state >> 33;
+}
+
+/// skewed keys: the square of a uniform variable, so that small keys are hot
+static i64 bench_key(u64 *state) {
+    u64 r = bench_rand(state) % BENCH_KEYS;
+    return (i64)(r * r / BENCH_KEYS);
+}
+
+static void report(const char *name, f64 sec, u64 hits) {
+    printf("    %-10s %8.3f ms, %8.2f Mops/s (hit rate %.3f)\n", name,
+           sec * 1e3, BENCH_OPS / sec / 1e6, (f64)hits / BENCH_OPS);
+}
+
+/// the hand-made LRU: a mapping from the keys to the nodes of a recency list
+static void bench_mapping_list() {
+    MapI64 map = CREOBJ(MapI64, /);
+    ListI64 list = CREOBJ(ListI64, /);
+    u64 state = 1, hits = 0;
+    f64 start = now();
+    for (usize i = 0; i < BENCH_OPS; i++) {
+        i64 key = bench_key(&state);
+        MapI64Iterator it = CALL(MapI64, map, find, /, &key);
+        if (it) {
+            ListI64Node *node = it->value;
+            if (node != list.head) {
+                CALL(ListI64, list, splice, /, list.head, &list, node,
+                     node->next);
+            }
+            hits++;
+            continue;
+        }
+        if (list.size == BENCH_CAP) {
+            i64 victim = CALL(ListI64, list, pop_back, /);
+            MapI64Iterator victim_it = CALL(MapI64, map, find, /, &victim);
+            CALL(MapI64, map, erase, /, victim_it);
+        }
+        CALL(ListI64, list, push_front, /, key);
+        CALL(MapI64, map, insert, /, key, list.head);
+    }
+    report("map+list", now() - start, hits);
+    DROPOBJ(MapI64, map);
+    DROPOBJ(ListI64, list);
+}
+
+static void bench_cache(bool clock) {
+    CacheI64 cache;
+    if (clock) {
+        CALL(CacheI64, cache, init_clock, /, BENCH_CAP);
+    } else {
+        CALL(CacheI64, cache, init, /, BENCH_CAP);
+    }
+    u64 state = 1;
+    f64 start = now();
+    for (usize i = 0; i < BENCH_OPS; i++) {
+        i64 key = bench_key(&state);
+        if (!CALL(CacheI64, cache, get, /, &key)) {
+            CALL(CacheI64, cache, put, /, key, key);
+        }
+    }
+    report(clock ? "clock" : "lru", now() - start, cache.hits);
+    DROPOBJ(CacheI64, cache);
+}
+
+int main() {
+    printf("get or put %d skewed keys of %d, capacity %d\n", BENCH_OPS,
+           BENCH_KEYS, BENCH_CAP);
+    bench_mapping_list();
+    bench_cache(false);
+    bench_cache(true);
+    return 0;
+}
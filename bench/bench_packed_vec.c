@@ -0,0 +1,76 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "packed_vec.h"
+#include "simd.h"
+
+#define BENCH_N (1 << 24)
+#define BENCH_ROUNDS 10
+
+/* sum every value by decoding whole blocks */
+static void bench_decode(const char *name, const PackedVec *vec) {
+    u64 buf[SIMD_PACK_BLOCK];
+    u64 sum = 0;
+    f64 start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (usize b = 0; b <= vec->n_blocks; b++) {
+            usize n = CALL(PackedVec, *vec, decode_block, /, b, buf);
+            for (usize i = 0; i < n; i++) {
+                sum += buf[i];
+            }
+        }
+    }
+    f64 sec = (now() - start) / BENCH_ROUNDS;
+    printf("    %-14s %8.3f ms, %6.2f Gvalues/s, %5.2f bits/value (sum %llu)\n",
+           name, sec * 1e3, BENCH_N / sec / 1e9,
+           CALL(PackedVec, *vec, memory, /) * 8.0 / BENCH_N,
+           (unsigned long long)sum);
+}
+
+int main() {
+    u64 *values = (u64 *)malloc(BENCH_N * sizeof(u64));
+    u64 state = 1;
+    values[0] = 0;
+    for (usize i = 1; i < BENCH_N; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        values[i] = values[i - 1] + (state >> 58);
+    }
+    PackedVec plain = CREOBJ(PackedVec, /, false);
+    PackedVec delta = CREOBJ(PackedVec, /, true);
+    for (usize i = 0; i < BENCH_N; i++) {
+        CALL(PackedVec, plain, push_back, /, values[i]);
+        CALL(PackedVec, delta, push_back, /, values[i]);
+    }
+
+    printf("decode %d sorted u64\n", BENCH_N);
+    u64 sum = 0;
+    f64 start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (usize i = 0; i < BENCH_N; i++) {
+            sum += values[i];
+        }
+    }
+    f64 sec = (now() - start) / BENCH_ROUNDS;
+    printf("    %-14s %8.3f ms, %6.2f Gvalues/s, %5.2f bits/value (sum %llu)\n",
+           "u64 array", sec * 1e3, BENCH_N / sec / 1e9, 64.0,
+           (unsigned long long)sum);
+    const char *levels[] = {"scalar", "vec128", "avx2"};
+    for (int level = SIMD_LEVEL_SCALAR; level <= SIMD_LEVEL_AVX2; level++) {
+        NSCALL(Simd, set_level, /, (SimdLevel)level);
+        if ((int)NSCALL(Simd, level, /) != level) {
+            continue;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "for %s", levels[level]);
+        bench_decode(name, &plain);
+        snprintf(name, sizeof(name), "delta %s", levels[level]);
+        bench_decode(name, &delta);
+    }
+
+    DROPOBJ(PackedVec, delta);
+    DROPOBJ(PackedVec, plain);
+    free(values);
+    return 0;
+}
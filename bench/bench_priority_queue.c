@@ -0,0 +1,82 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_map.h"
+#include "tem_priority_queue.h"
+#include "tem_vec.h"
+
+DECLARE_MAPPING(MapU64, u64, u64, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR);
+DEFINE_MAPPING(MapU64, u64, u64, FUNC_STATIC);
+
+DECLARE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+
+DECLARE_PRIORITY_QUEUE(Heap2U64, VecU64, u64, 2, FUNC_STATIC,
+                       GENERATOR_PLAIN_COMPARATOR);
+DEFINE_PRIORITY_QUEUE(Heap2U64, VecU64, u64, 2, FUNC_STATIC);
+
+DECLARE_PRIORITY_QUEUE(Heap4U64, VecU64, u64, 4, FUNC_STATIC,
+                       GENERATOR_PLAIN_COMPARATOR);
+DEFINE_PRIORITY_QUEUE(Heap4U64, VecU64, u64, 4, FUNC_STATIC);
+
+#define BENCH_OPS 5000000
+#define BENCH_BACKLOG 100000
+
+/* job deadlines are unique: a random delay in the high bits, the id below */
+static u64 next_deadline(u64 current, u64 id, u64 *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return ((current >> 24) + 1 + (*state >> 54)) << 24 | id;
+}
+
+static void bench_mapping() {
+    MapU64 map = CREOBJ(MapU64, /);
+    u64 state = 1, current = 0, sum = 0;
+    for (u64 i = 0; i < BENCH_BACKLOG; i++) {
+        CALL(MapU64, map, insert, /, next_deadline(0, i, &state), i);
+    }
+    f64 start = now();
+    for (u64 i = BENCH_BACKLOG; i < BENCH_OPS; i++) {
+        MapU64Iterator first = CALL(MapU64, map, begin, /);
+        current = first->key;
+        sum += first->value;
+        CALL(MapU64, map, erase, /, first);
+        CALL(MapU64, map, insert, /, next_deadline(current, i, &state), i);
+    }
+    f64 sec = now() - start;
+    printf("    %-8s %8.2f Mops/s (sum %llu)\n", "mapping",
+           BENCH_OPS / sec / 1e6, (unsigned long long)sum);
+    DROPOBJ(MapU64, map);
+}
+
+#define BENCH_HEAP(name, PQ)                                                   \
+    ({                                                                         \
+        PQ MPROT(pq) = CREOBJ(PQ, /);                                          \
+        u64 MPROT(state) = 1, MPROT(current) = 0, MPROT(sum) = 0;              \
+        for (u64 i = 0; i < BENCH_BACKLOG; i++) {                              \
+            CALL(PQ, MPROT(pq), push, /,                                       \
+                 next_deadline(0, i, &MPROT(state)));                          \
+        }                                                                      \
+        f64 MPROT(start) = now();                                              \
+        for (u64 i = BENCH_BACKLOG; i < BENCH_OPS; i++) {                      \
+            MPROT(current) = CALL(PQ, MPROT(pq), pop, /);                      \
+            MPROT(sum) += MPROT(current) & 0xffffff;                           \
+            CALL(PQ, MPROT(pq), push, /,                                       \
+                 next_deadline(MPROT(current), i, &MPROT(state)));             \
+        }                                                                      \
+        f64 MPROT(sec) = now() - MPROT(start);                                 \
+        printf("    %-8s %8.2f Mops/s (sum %llu)\n", name,                     \
+               BENCH_OPS / MPROT(sec) / 1e6,                                   \
+               (unsigned long long)MPROT(sum));                                \
+        DROPOBJ(PQ, MPROT(pq));                                                \
+    })
+
+int main() {
+    printf("scheduler pop-min + push x %d, %d pending\n", BENCH_OPS,
+           BENCH_BACKLOG);
+    bench_mapping();
+    BENCH_HEAP("heap-2", Heap2U64);
+    BENCH_HEAP("heap-4", Heap4U64);
+    return 0;
+}
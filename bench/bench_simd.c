@@ -0,0 +1,112 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "simd.h"
+#include "tem_vec.h"
+
+DECLARE_PLAIN_VEC(VecI32, i32, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecI32, i32, FUNC_STATIC);
+DECLARE_VEC_NUMERIC(VecI32, i32);
+
+DECLARE_PLAIN_VEC(VecF64, f64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecF64, f64, FUNC_STATIC);
+DECLARE_VEC_NUMERIC(VecF64, f64);
+
+#define BENCH_SIZE ((usize)1 << 20)
+#define BENCH_ROUNDS 200
+
+static const char *level_names[] = {"scalar", "vec128", "avx2"};
+
+/* keep the results alive */
+static volatile f64 bench_sink;
+
+#define BENCH(name, expr)                                                      \
+    ({                                                                         \
+        f64 MPROT(start) = now();                                              \
+        for (int MPROT(r) = 0; MPROT(r) < BENCH_ROUNDS; MPROT(r)++) {          \
+            bench_sink += (f64)(expr);                                         \
+        }                                                                      \
+        f64 MPROT(sec) = now() - MPROT(start);                                 \
+        printf("    %-12s %8.3f ms, %6.2f GB/s\n", name,                       \
+               MPROT(sec) * 1e3 / BENCH_ROUNDS,                                \
+               (f64)BENCH_SIZE * sizeof(*v.data) * BENCH_ROUNDS / MPROT(sec) / \
+                   1e9);                                                       \
+    })
+
+static usize naive_find_i32(const i32 *data, usize n, i32 value) {
+    for (usize i = 0; i < n; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+static i64 naive_sum_i32(const i32 *data, usize n) {
+    i64 sum = 0;
+    for (usize i = 0; i < n; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+static f64 naive_sum_f64(const f64 *data, usize n) {
+    f64 sum = 0;
+    for (usize i = 0; i < n; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+static void bench_i32() {
+    VecI32 v = CREOBJ(VecI32, /);
+    VecI32 out = CREOBJ(VecI32, /);
+    for (usize i = 0; i < BENCH_SIZE; i++) {
+        CALL(VecI32, v, push_back, /, (i32)(i * 2654435761u % 1000));
+    }
+    printf("i32 x %zu\n", BENCH_SIZE);
+    BENCH("naive find", naive_find_i32(v.data, v.size, -1));
+    BENCH("naive sum", naive_sum_i32(v.data, v.size));
+    SimdLevel supported = NSCALL(Simd, level, /);
+    for (SimdLevel level = SIMD_LEVEL_SCALAR; level <= supported; level++) {
+        NSCALL(Simd, set_level, /, level);
+        printf("  %s\n", level_names[level]);
+        BENCH("find", CALL(VecI32, v, find, /, -1));
+        BENCH("count", CALL(VecI32, v, count, /, 7));
+        BENCH("minmax", CALL(VecI32, v, minmax, /).max);
+        BENCH("sum", CALL(VecI32, v, sum, /));
+        BENCH("filter_into", ({
+                  CALL(VecI32, out, clear, /);
+                  CALL(VecI32, v, filter_into, /, &out, SIMD_CMP_LT, 100);
+                  out.size;
+              }));
+    }
+    NSCALL(Simd, set_level, /, supported);
+    DROPOBJ(VecI32, out);
+    DROPOBJ(VecI32, v);
+}
+
+static void bench_f64() {
+    VecF64 v = CREOBJ(VecF64, /);
+    for (usize i = 0; i < BENCH_SIZE; i++) {
+        CALL(VecF64, v, push_back, /, (f64)(i * 2654435761u % 1000) / 7);
+    }
+    printf("f64 x %zu\n", BENCH_SIZE);
+    BENCH("naive sum", naive_sum_f64(v.data, v.size));
+    SimdLevel supported = NSCALL(Simd, level, /);
+    for (SimdLevel level = SIMD_LEVEL_SCALAR; level <= supported; level++) {
+        NSCALL(Simd, set_level, /, level);
+        printf("  %s\n", level_names[level]);
+        BENCH("minmax", CALL(VecF64, v, minmax, /).max);
+        BENCH("sum", CALL(VecF64, v, sum, /));
+    }
+    NSCALL(Simd, set_level, /, supported);
+    DROPOBJ(VecF64, v);
+}
+
+int main() {
+    bench_i32();
+    bench_f64();
+    return 0;
+}
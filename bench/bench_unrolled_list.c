@@ -0,0 +1,101 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "bench.h"
+#include "tem_list.h"
+#include "tem_unrolled_list.h"
+#include "tem_vec.h"
+
+DECLARE_PLAIN_VEC(VecI64, i64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecI64, i64, FUNC_STATIC);
+
+DECLARE_LIST(ListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_LIST(ListI64, i64, FUNC_STATIC);
+
+DECLARE_UNROLLED_LIST(UListI64, i64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_UNROLLED_LIST(UListI64, i64, FUNC_STATIC);
+
+#define BENCH_N (1 << 20)
+#define BENCH_ROUNDS 20
+#define BENCH_INSERTS 200000
+
+static u64 bench_rand(u64 *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state >> 33;
+}
+
+static void report(const char *name, f64 sec, usize ops, i64 sum) {
+    printf("    %-8s %8.3f ms, %8.2f Mops/s (sum %lld)\n", name, sec * 1e3,
+           ops / sec / 1e6, (long long)sum);
+}
+
+int main() {
+    VecI64 vec = CREOBJ(VecI64, /);
+    ListI64 list = CREOBJ(ListI64, /);
+    UListI64 ulist = CREOBJ(UListI64, /);
+    for (i64 i = 0; i < BENCH_N; i++) {
+        CALL(VecI64, vec, push_back, /, i);
+        CALL(ListI64, list, push_back, /, i);
+        CALL(UListI64, ulist, push_back, /, i);
+    }
+
+    printf("iterate %d i64 x %d\n", BENCH_N, BENCH_ROUNDS);
+    i64 sum = 0;
+    f64 start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (usize i = 0; i < vec.size; i++) {
+            sum += vec.data[i];
+        }
+    }
+    report("vec", (now() - start) / BENCH_ROUNDS, BENCH_N, sum);
+    sum = 0;
+    start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (ListI64Node *node = list.head; node; node = node->next) {
+            sum += node->data;
+        }
+    }
+    report("list", (now() - start) / BENCH_ROUNDS, BENCH_N, sum);
+    sum = 0;
+    start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (UListI64Node *node = ulist.head; node; node = node->next) {
+            for (usize i = 0; i < node->size; i++) {
+                sum += node->data[i];
+            }
+        }
+    }
+    report("ulist", (now() - start) / BENCH_ROUNDS, BENCH_N, sum);
+    sum = 0;
+    start = now();
+    for (usize r = 0; r < BENCH_ROUNDS; r++) {
+        for (UListI64Iterator it = CALL(UListI64, ulist, begin, /); it.node;
+             it = NSCALL(UListI64, next, /, it)) {
+            sum += *NSCALL(UListI64, deref, /, it);
+        }
+    }
+    report("ulist-it", (now() - start) / BENCH_ROUNDS, BENCH_N, sum);
+
+    printf("insert %d i64 at random indices\n", BENCH_INSERTS);
+    CALL(VecI64, vec, clear, /);
+    CALL(UListI64, ulist, clear, /);
+    u64 state = 1;
+    start = now();
+    for (i64 i = 0; i < BENCH_INSERTS; i++) {
+        CALL(VecI64, vec, insert, /, bench_rand(&state) % (vec.size + 1), i);
+    }
+    report("vec", now() - start, BENCH_INSERTS, vec.data[vec.size / 2]);
+    state = 1;
+    start = now();
+    for (i64 i = 0; i < BENCH_INSERTS; i++) {
+        CALL(UListI64, ulist, insert, /, bench_rand(&state) % (ulist.size + 1),
+             i);
+    }
+    report("ulist", now() - start, BENCH_INSERTS,
+           *CALL(UListI64, ulist, at, /, ulist.size / 2));
+
+    DROPOBJ(VecI64, vec);
+    DROPOBJ(ListI64, list);
+    DROPOBJ(UListI64, ulist);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <stdlib.h>
+
+#include "allocator.h"
+
+static void *libc_alloc(ATTR_UNUSED void *ctx, usize size) {
+    return malloc(size);
+}
+
+static void *libc_realloc(ATTR_UNUSED void *ctx, void *ptr,
+                          ATTR_UNUSED usize old_size, usize new_size) {
+    return realloc(ptr, new_size);
+}
+
+static void libc_free(ATTR_UNUSED void *ctx, void *ptr,
+                      ATTR_UNUSED usize size) {
+    free(ptr);
+}
+
+Allocator *NSMTD(Allocator, libc, /) {
+    static Allocator libc_allocator = {
+        .alloc = libc_alloc,
+        .realloc = libc_realloc,
+        .free = libc_free,
+        .ctx = NULL,
+    };
+    return &libc_allocator;
+}
@@ -0,0 +1,112 @@
+// clang-format off
+/// allocator.h: provides the allocator protocol of the containers
+///
+/// An Allocator is a table of alloc / realloc / free functions with a context pointer, so that a container can get its
+/// memory from an arena, a pool, shared memory, etc. instead of the libc heap. The functions are told the sizes of the
+/// blocks (as C++ allocators are), which spares the allocators to record them:
+///
+///     alloc(void *ctx, usize size) -> void *: allocates size > 0 bytes aligned for any type, or returns NULL
+///     realloc(void *ctx, void *ptr, usize old_size, usize new_size) -> void *: resizes the block ptr of old_size bytes
+///         (or allocates one if ptr is NULL) to new_size > 0 bytes, keeping its content, or returns NULL
+///     free(void *ctx, void *ptr, usize size): frees the block ptr of size bytes; ptr may be NULL
+///
+/// The free function may be NULL for an allocator releasing its blocks only as a whole (e.g. an Arena, see arena.h):
+/// the blocks are then never freed, and the containers skip the walks whose only purpose is to free them.
+///
+/// The NULL allocator stands for the libc heap: the functions below call malloc, realloc and free directly for it, so
+/// a container bound to it at compile time (GENERATOR_LIBC_ALLOCATOR, the default of the templates) compiles to the
+/// libc calls as before, with no indirection.
+///
+///     Allocator::allocate(Allocator *allocator, usize size) -> void *: allocates size > 0 bytes; never NULL
+///     Allocator::reallocate(Allocator *allocator, void *ptr, usize old_size, usize new_size) -> void *: resizes a
+///         block to new_size > 0 bytes; never NULL
+///     Allocator::deallocate(Allocator *allocator, void *ptr, usize size): frees a block; ptr may be NULL
+///     Allocator::frees_blocks(Allocator *allocator) -> bool: checks if the blocks of allocator are freed one by one
+///     Allocator::libc() -> Allocator *: a non-NULL allocator calling the libc, e.g. to back other allocators
+///
+/// Allocator generators bind a container type to an allocator, by defining `Container::allocator() -> Allocator *`:
+///     - GENERATOR_LIBC_ALLOCATOR: define the libc heap (NULL) as the allocator.
+///     - GENERATOR_CUSTOM_ALLOCATOR: define nothing; the allocator() is defined outside, e.g. returning a global
+///       allocator. All the objects of the container type must use the same allocator while they are alive.
+///
+/// Macros:
+///     CREOBJRAWHEAP_IN(cls, allocator), CREOBJHEAP_IN(cls, allocator, /, ...), DROPOBJHEAP_IN(cls, allocator, ptr):
+///         CREOBJRAWHEAP, CREOBJHEAP and DROPOBJHEAP (see utils.h) with the memory of allocator
+// clang-format on
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "debug.h"
+#include "utils.h"
+
+typedef struct Allocator {
+    void *(*alloc)(void *ctx, usize size);
+    void *(*realloc)(void *ctx, void *ptr, usize old_size, usize new_size);
+    void (*free)(void *ctx, void *ptr, usize size);
+    void *ctx;
+} Allocator;
+
+FUNC_STATIC void *NSMTD(Allocator, allocate, /, Allocator *allocator,
+                        usize size) {
+    void *ptr = allocator ? allocator->alloc(allocator->ctx, size)
+                          : malloc(size);
+    ASSERT(ptr);
+    return ptr;
+}
+
+FUNC_STATIC void *NSMTD(Allocator, reallocate, /, Allocator *allocator,
+                        void *ptr, usize old_size, usize new_size) {
+    ptr = allocator
+              ? allocator->realloc(allocator->ctx, ptr, old_size, new_size)
+              : realloc(ptr, new_size);
+    ASSERT(ptr);
+    return ptr;
+}
+
+FUNC_STATIC void NSMTD(Allocator, deallocate, /, Allocator *allocator,
+                       void *ptr, usize size) {
+    if (!allocator) {
+        free(ptr);
+    } else if (allocator->free) {
+        allocator->free(allocator->ctx, ptr, size);
+    }
+}
+
+FUNC_STATIC bool NSMTD(Allocator, frees_blocks, /, Allocator *allocator) {
+    return !allocator || allocator->free;
+}
+
+/* Allocator::libc() -> Allocator * */
+Allocator *NSMTD(Allocator, libc, /);
+
+#undef GENERATOR_LIBC_ALLOCATOR
+#define GENERATOR_LIBC_ALLOCATOR(Container)                                    \
+    FUNC_STATIC Allocator *NSMTD(Container, allocator, /) { return NULL; }
+
+#undef GENERATOR_CUSTOM_ALLOCATOR
+#define GENERATOR_CUSTOM_ALLOCATOR(Container)
+
+#undef CREOBJRAWHEAP_IN
+#define CREOBJRAWHEAP_IN(cls, allocator)                                       \
+    ((typeof(cls) *)NSCALL(Allocator, allocate, /, (allocator), sizeof(cls)))
+
+#undef CREOBJHEAP_IN
+#define CREOBJHEAP_IN(cls, allocator, slash, ...)                              \
+    ({                                                                         \
+        typeof(cls) *MPROT(temp) = CREOBJRAWHEAP_IN(cls, allocator);           \
+        CALL(cls, *MPROT(temp), init, /, ##__VA_ARGS__);                       \
+        MPROT(temp);                                                           \
+    })
+
+#undef DROPOBJHEAP_IN
+#define DROPOBJHEAP_IN(cls, allocator, ptr)                                    \
+    ({                                                                         \
+        typeof(cls) *MPROT(temp) = (ptr);                                      \
+        if (MPROT(temp)) {                                                     \
+            DROPOBJ(cls, *MPROT(temp));                                        \
+            NSCALL(Allocator, deallocate, /, (allocator), MPROT(temp),         \
+                   sizeof(cls));                                               \
+        }                                                                      \
+    })
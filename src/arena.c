@@ -0,0 +1,121 @@
+#include <string.h>
+
+#include "arena.h"
+#include "debug.h"
+
+static void *arena_alloc(void *ctx, usize size) {
+    return CALL(Arena, *(Arena *)ctx, alloc, /, size);
+}
+
+static void *arena_realloc(void *ctx, void *ptr, usize old_size,
+                           usize new_size) {
+    return CALL(Arena, *(Arena *)ctx, realloc, /, ptr, old_size, new_size);
+}
+
+void MTD(Arena, init_in, /, usize chunk_size, Allocator *allocator) {
+    self->chunk = NULL;
+    self->cursor = NULL;
+    self->end = NULL;
+    self->spare = NULL;
+    self->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+    self->backing = allocator;
+    self->allocator.alloc = arena_alloc;
+    self->allocator.realloc = arena_realloc;
+    self->allocator.free = NULL;
+    self->allocator.ctx = self;
+}
+
+static void MTD(Arena, free_chunk, /, ArenaChunk *chunk) {
+    NSCALL(Allocator, deallocate, /, self->backing, chunk,
+           ARENA_HEADER + chunk->size);
+}
+
+/// keeps the larger of chunk and the spare as the spare, freeing the other
+static void MTD(Arena, retire_chunk, /, ArenaChunk *chunk) {
+    if (self->spare && self->spare->size >= chunk->size) {
+        CALL(Arena, *self, free_chunk, /, chunk);
+        return;
+    }
+    if (self->spare) {
+        CALL(Arena, *self, free_chunk, /, self->spare);
+    }
+    self->spare = chunk;
+}
+
+void MTD(Arena, drop, /) {
+    while (self->chunk) {
+        ArenaChunk *chunk = self->chunk;
+        self->chunk = chunk->prev;
+        CALL(Arena, *self, free_chunk, /, chunk);
+    }
+    if (self->spare) {
+        CALL(Arena, *self, free_chunk, /, self->spare);
+        self->spare = NULL;
+    }
+    self->cursor = NULL;
+    self->end = NULL;
+}
+
+void *MTD(Arena, alloc_chunk, /, usize size) {
+    ArenaChunk *chunk = self->spare;
+    if (chunk && chunk->size >= size) {
+        self->spare = NULL;
+    } else {
+        usize chunk_size = Max(self->chunk_size, size);
+        chunk = (ArenaChunk *)NSCALL(Allocator, allocate, /, self->backing,
+                                     ARENA_HEADER + chunk_size);
+        chunk->size = chunk_size;
+        if (self->chunk_size < ARENA_MAX_CHUNK) {
+            self->chunk_size =
+                Min(self->chunk_size * 2, (usize)ARENA_MAX_CHUNK);
+        }
+    }
+    chunk->prev = self->chunk;
+    self->chunk = chunk;
+    char *data = (char *)chunk + ARENA_HEADER;
+    self->cursor = data + size;
+    self->end = data + chunk->size;
+    return data;
+}
+
+void *MTD(Arena, realloc, /, void *ptr, usize old_size, usize new_size) {
+    if (!ptr) {
+        return CALL(Arena, *self, alloc, /, new_size);
+    }
+    usize old_rounded = NSCALL(Arena, round_up, /, old_size);
+    usize rounded = NSCALL(Arena, round_up, /, new_size);
+    // the last block grows or shrinks in place while the chunk has room
+    if ((char *)ptr + old_rounded == self->cursor &&
+        rounded <= (usize)(self->end - (char *)ptr)) {
+        self->cursor = (char *)ptr + rounded;
+        return ptr;
+    }
+    if (rounded <= old_rounded) {
+        return ptr;
+    }
+    void *block = CALL(Arena, *self, alloc, /, new_size);
+    memcpy(block, ptr, old_size);
+    return block;
+}
+
+void MTD(Arena, rewind, /, ArenaMark mark) {
+    while (self->chunk != mark.chunk) {
+        ASSERT(self->chunk);
+        ArenaChunk *chunk = self->chunk;
+        self->chunk = chunk->prev;
+        CALL(Arena, *self, retire_chunk, /, chunk);
+    }
+    self->cursor = mark.cursor;
+    self->end = NULL;
+    if (mark.chunk) {
+        self->end = (char *)mark.chunk + ARENA_HEADER + mark.chunk->size;
+    }
+}
+
+usize MTDCONST(Arena, memory, /) {
+    usize bytes = self->spare ? ARENA_HEADER + self->spare->size : 0;
+    for (ArenaChunk *chunk = self->chunk; chunk; chunk = chunk->prev) {
+        bytes += ARENA_HEADER + chunk->size;
+    }
+    return bytes;
+}
@@ -0,0 +1,128 @@
+// clang-format off
+/// arena.h: provides an arena (bump) allocator with scoped reset
+///
+/// The memory is carved from chunks of growing sizes (from the initial chunk size to ARENA_MAX_CHUNK bytes; larger
+/// requests get chunks of their own) by bumping a pointer, so that allocating is a few pointer operations and the
+/// blocks are never freed one by one: they are released together, by rewinding to a mark, by reset or by drop, in
+/// O(chunks). The largest chunk released is kept as a spare for the next chunk needed, so that an arena reset after
+/// each request stops calling the backing allocator once it is warm. An arena is not synchronized.
+///
+/// An arena is an allocator (see allocator.h) for the containers: bind a container type to it by
+/// GENERATOR_CUSTOM_ALLOCATOR and an allocator() returning `Arena.as_allocator()`. The free function of this
+/// allocator is NULL, which tells the containers that their blocks need not be freed: the drop of a container whose
+/// elements drop nothing (e.g. a List or Mapping of plain values) is then O(1), and may be skipped altogether when the
+/// arena is reset. The containers must not be used after the memory is released.
+///
+///     Arena.init(usize chunk_size): initializes the arena with a first chunk of chunk_size bytes (0 for
+///         ARENA_DEFAULT_CHUNK); no memory is taken until the first allocation
+///     Arena.init_in(usize chunk_size, Allocator *allocator): initializes the arena with the chunks from allocator
+///         (NULL for the libc heap)
+///     Arena.drop(): drops the arena, releasing all the chunks
+///     Arena.alloc(usize size) -> void *: allocates size bytes aligned to ARENA_ALIGN; never NULL
+///     Arena.realloc(void *ptr, usize old_size, usize new_size) -> void *: resizes a block of the arena (or allocates
+///         one if ptr is NULL), in place when it is the last block allocated and the chunk has room
+///     Arena.mark() const -> ArenaMark: the current position of the arena
+///     Arena.rewind(ArenaMark mark): releases all the blocks allocated since mark; the marks taken since mark are
+///         invalidated
+///     Arena.reset(): releases all the blocks; all the marks are invalidated
+///     Arena.memory() const -> usize: the bytes of the chunks, the spare included
+///     Arena.as_allocator() -> Allocator *: the arena as an allocator, valid until the arena moves or is dropped
+// clang-format on
+
+#pragma once
+
+#include "allocator.h"
+#include "utils.h"
+
+#undef ARENA_ALIGN
+#define ARENA_ALIGN 16
+
+#undef ARENA_DEFAULT_CHUNK
+#define ARENA_DEFAULT_CHUNK 4096
+
+#undef ARENA_MAX_CHUNK
+#define ARENA_MAX_CHUNK (1 << 20)
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *prev;
+    /// the bytes after the header
+    usize size;
+} ArenaChunk;
+
+#undef ARENA_HEADER
+#define ARENA_HEADER                                                           \
+    ((sizeof(ArenaChunk) + ARENA_ALIGN - 1) & ~(usize)(ARENA_ALIGN - 1))
+
+typedef struct ArenaMark {
+    ArenaChunk *chunk;
+    char *cursor;
+} ArenaMark;
+
+typedef struct Arena {
+    /// the chunks, newest first, linked through prev
+    ArenaChunk *chunk;
+    /// the free space of the newest chunk
+    char *cursor;
+    char *end;
+    /// a chunk released by rewind or reset, kept for reuse
+    ArenaChunk *spare;
+    /// the size of the next chunk
+    usize chunk_size;
+    /// the allocator of the chunks
+    Allocator *backing;
+    /// the arena as an allocator
+    Allocator allocator;
+} Arena;
+
+/* Arena.init_in(usize chunk_size, Allocator *allocator) */
+void MTD(Arena, init_in, /, usize chunk_size, Allocator *allocator);
+
+FUNC_STATIC void MTD(Arena, init, /, usize chunk_size) {
+    CALL(Arena, *self, init_in, /, chunk_size, NULL);
+}
+
+/* Arena.drop() */
+void MTD(Arena, drop, /);
+
+DELETED_CLONER(Arena, FUNC_STATIC);
+
+FUNC_STATIC usize NSMTD(Arena, round_up, /, usize size) {
+    return (size + ARENA_ALIGN - 1) & ~(usize)(ARENA_ALIGN - 1);
+}
+
+/* Arena.alloc_chunk(usize size) -> void *: allocates from a new chunk */
+void *MTD(Arena, alloc_chunk, /, usize size);
+
+FUNC_STATIC void *MTD(Arena, alloc, /, usize size) {
+    size = NSCALL(Arena, round_up, /, size);
+    if ((usize)(self->end - self->cursor) >= size && self->cursor) {
+        void *ptr = self->cursor;
+        self->cursor += size;
+        return ptr;
+    }
+    return CALL(Arena, *self, alloc_chunk, /, size);
+}
+
+/* Arena.realloc(void *ptr, usize old_size, usize new_size) -> void * */
+void *MTD(Arena, realloc, /, void *ptr, usize old_size, usize new_size);
+
+FUNC_STATIC ArenaMark MTDCONST(Arena, mark, /) {
+    ArenaMark mark = {.chunk = self->chunk, .cursor = self->cursor};
+    return mark;
+}
+
+/* Arena.rewind(ArenaMark mark) */
+void MTD(Arena, rewind, /, ArenaMark mark);
+
+FUNC_STATIC void MTD(Arena, reset, /) {
+    ArenaMark start = {.chunk = NULL, .cursor = NULL};
+    CALL(Arena, *self, rewind, /, start);
+}
+
+/* Arena.memory() const -> usize */
+usize MTDCONST(Arena, memory, /);
+
+FUNC_STATIC Allocator *MTD(Arena, as_allocator, /) {
+    self->allocator.ctx = self;
+    return &self->allocator;
+}
@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "container_core.h"
+#include "debug.h"
+
+void *NSMTD(VecCore, reserve, /, Allocator *allocator, void *data,
+            usize capacity, usize new_cap, usize elem_size) {
+    ASSERT(new_cap > capacity);
+    data = NSCALL(Allocator, reallocate, /, allocator, data,
+                  capacity * elem_size, new_cap * elem_size);
+    memset((char *)data + capacity * elem_size, 0,
+           (new_cap - capacity) * elem_size);
+    return data;
+}
+
+usize NSMTD(VecCore, grown_capacity, /, usize capacity, usize elem_size) {
+    // For tiny vectors. From Rust's alloc::raw_vec::min_non_zero_cap
+    usize min_cap = elem_size == 1 ? 8 : elem_size <= 1024 ? 4 : 1;
+    return Max(min_cap, capacity * 2);
+}
+
+void *NSMTD(VecCore, shrink, /, Allocator *allocator, void *data,
+            usize capacity, usize size, usize elem_size) {
+    if (size == 0) {
+        NSCALL(Allocator, deallocate, /, allocator, data, capacity * elem_size);
+        return NULL;
+    }
+    return NSCALL(Allocator, reallocate, /, allocator, data,
+                  capacity * elem_size, size * elem_size);
+}
+
+void NSMTD(VecCore, open_gap, /, void *data, usize size, usize index,
+           usize elem_size) {
+    char *bytes = (char *)data;
+    memmove(bytes + (index + 1) * elem_size, bytes + index * elem_size,
+            (size - index) * elem_size);
+}
+
+void NSMTD(VecCore, close_gap, /, void *data, usize size, usize lo, usize hi,
+           usize elem_size) {
+    char *bytes = (char *)data;
+    memmove(bytes + lo * elem_size, bytes + hi * elem_size,
+            (size - hi) * elem_size);
+}
+
+DEFINE_TREAP_LINKS(TreapCore, FUNC_EXTERN)
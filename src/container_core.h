@@ -0,0 +1,360 @@
+// clang-format off
+/// container_core.h: provides the type-erased core shared by the container templates.
+///
+/// The logic of the templates that does not depend on the element type (the growth and the element moves of vectors,
+/// the rotations and the iteration of the treaps of mappings) is compiled once into liboopinc.a here, parameterized by
+/// the element size or working on the links of the nodes only. When OOPINC_SHARED_CORE is defined before including the
+/// templates (e.g. by `make SHARED_CORE=1`), each instantiation defines thin typed wrappers around the core instead of
+/// its own copy of the logic, trading a call for less code and instruction cache per instantiation.
+///
+/// Macros:
+///     DEFINE_VEC_GROWTH(Vec, T, STORAGE): define reserve, check_expansion and shrink_to_fit of a vector, with the
+///         memory of `Vec::allocator()` (see allocator.h).
+///     DEFINE_VEC_GROWTH_SHARED(Vec, T, STORAGE): define them as wrappers of VecCore.
+///     DEFINE_VEC_SHIFT(Vec, T): define open_gap and close_gap of a vector, the element moves of insert and erase.
+///     DEFINE_VEC_SHIFT_SHARED(Vec, T): define them as wrappers of VecCore.
+///     DECLARE_TREAP_LINKS(Core, STORAGE): declare the treap operations over Core, TreapCore or a typedef of it.
+///     DEFINE_TREAP_LINKS(Core, STORAGE): define the treap operations over Core; TreapCore has them in liboopinc.a, and
+///         TreapLocal inline.
+///     DEFINE_TREAP_NODE(Node, LINK, Core): define the treap operations over Node, a struct embedding a TreapCore as
+///         its member LINK, as wrappers of those of Core (TreapCore or TreapLocal); the links are only ever accessed
+///         as TreapCore, and the nodes found back from them by offsetof.
+///
+/// VecCore Functions:
+///     VecCore::reserve(Allocator *allocator, void *data, usize capacity, usize new_cap, usize elem_size) -> void *:
+///         reallocate data to new_cap > capacity elements, zeroing the new ones.
+///     VecCore::grown_capacity(usize capacity, usize elem_size) -> usize: the capacity to grow a full vector to.
+///     VecCore::shrink(Allocator *allocator, void *data, usize capacity, usize size, usize elem_size) -> void *:
+///         reallocate data to size elements, or free it (returning NULL) if size is 0.
+///     VecCore::open_gap(void *data, usize size, usize index, usize elem_size): move the elements [index, size) of data
+///         one place back; data must have room for size + 1 elements.
+///     VecCore::close_gap(void *data, usize size, usize lo, usize hi, usize elem_size): move the elements [hi, size) of
+///         data to lo.
+///
+/// Treap Operations (over Core):
+///     Core::lturn(Core **p): rotate the subtree *p to the left.
+///     Core::rturn(Core **p): rotate the subtree *p to the right.
+///     Core::leftmost(Core *node) -> Core *: the first node of the subtree.
+///     Core::rightmost(Core *node) -> Core *: the last node of the subtree.
+///     Core.next() -> Core *: the next node in order, or NULL.
+///     Core.prev() -> Core *: the previous node in order, or NULL.
+///     Core::unlink(Core **p) -> Core *: rotate the node *p down until it has at most one son, then unlink it and
+///         return it, without sons.
+///
+/// Treap Operations (over Node, by DEFINE_TREAP_NODE):
+///     Node::entry(TreapCore *link) -> Node *: the node of a link, or NULL if link is NULL.
+///     Node::lturn(TreapCore **p), Node::rturn(TreapCore **p), Node::unlink(TreapCore **p) -> Node *: as above, on the
+///         link slot p.
+///     Node::leftmost(Node *node) -> Node *, Node::rightmost(Node *node) -> Node *, Node.next() -> Node *,
+///         Node.prev() -> Node *: as above.
+// clang-format on
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "debug.h"
+#include "utils.h"
+
+/* VecCore::reserve(Allocator *allocator, void *data, usize capacity,
+ * usize new_cap, usize elem_size) -> void * */
+void *NSMTD(VecCore, reserve, /, Allocator *allocator, void *data,
+            usize capacity, usize new_cap, usize elem_size);
+
+/* VecCore::grown_capacity(usize capacity, usize elem_size) -> usize */
+usize NSMTD(VecCore, grown_capacity, /, usize capacity, usize elem_size);
+
+/* VecCore::shrink(Allocator *allocator, void *data, usize capacity, usize size,
+ * usize elem_size) -> void * */
+void *NSMTD(VecCore, shrink, /, Allocator *allocator, void *data,
+            usize capacity, usize size, usize elem_size);
+
+/* VecCore::open_gap(void *data, usize size, usize index, usize elem_size) */
+void NSMTD(VecCore, open_gap, /, void *data, usize size, usize index,
+           usize elem_size);
+
+/* VecCore::close_gap(void *data, usize size, usize lo, usize hi,
+ * usize elem_size) */
+void NSMTD(VecCore, close_gap, /, void *data, usize size, usize lo, usize hi,
+           usize elem_size);
+
+#undef DEFINE_VEC_GROWTH
+#define DEFINE_VEC_GROWTH(Vec, T, STORAGE)                                     \
+    STORAGE void MTD(Vec, reserve, /, usize MPROT(new_cap)) {                  \
+        if (MPROT(new_cap) <= self->capacity) {                                \
+            return;                                                            \
+        }                                                                      \
+        ASSERT(MPROT(new_cap) > 0);                                            \
+        self->data = (T *)NSCALL(Allocator, reallocate, /,                     \
+                                 NSCALL(Vec, allocator, /), self->data,        \
+                                 self->capacity * sizeof(T),                   \
+                                 MPROT(new_cap) * sizeof(T));                  \
+        memset(self->data + self->capacity, 0,                                 \
+               (MPROT(new_cap) - self->capacity) * sizeof(T));                 \
+        self->capacity = MPROT(new_cap);                                       \
+    }                                                                          \
+                                                                               \
+    static usize NSMTD(Vec, num_from_size, /) {                                \
+        usize MPROT(size) = sizeof(T);                                         \
+        /* For tiny vectors. From Rust's alloc::raw_vec::min_non_zero_cap */   \
+        if (MPROT(size) == 1) {                                                \
+            return 8;                                                          \
+        } else if (MPROT(size) <= 1024) {                                      \
+            return 4;                                                          \
+        } else {                                                               \
+            return 1;                                                          \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void MTD(Vec, check_expansion, /) {                                 \
+        if (self->size < self->capacity) {                                     \
+            return;                                                            \
+        }                                                                      \
+        CALL(Vec, *self, reserve, /,                                           \
+             Max(NSCALL(Vec, num_from_size, /), self->capacity * 2));          \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, shrink_to_fit, /) {                                  \
+        if (self->size == self->capacity) {                                    \
+            return;                                                            \
+        }                                                                      \
+        if (self->size == 0) {                                                 \
+            NSCALL(Allocator, deallocate, /, NSCALL(Vec, allocator, /),        \
+                   self->data, self->capacity * sizeof(T));                    \
+            self->data = NULL;                                                 \
+        } else {                                                               \
+            self->data = (T *)NSCALL(Allocator, reallocate, /,                 \
+                                     NSCALL(Vec, allocator, /), self->data,    \
+                                     self->capacity * sizeof(T),               \
+                                     self->size * sizeof(T));                  \
+        }                                                                      \
+        self->capacity = self->size;                                           \
+    }
+
+#undef DEFINE_VEC_GROWTH_SHARED
+#define DEFINE_VEC_GROWTH_SHARED(Vec, T, STORAGE)                              \
+    STORAGE void MTD(Vec, reserve, /, usize MPROT(new_cap)) {                  \
+        if (MPROT(new_cap) <= self->capacity) {                                \
+            return;                                                            \
+        }                                                                      \
+        self->data = (T *)NSCALL(VecCore, reserve, /,                          \
+                                 NSCALL(Vec, allocator, /), self->data,        \
+                                 self->capacity, MPROT(new_cap), sizeof(T));   \
+        self->capacity = MPROT(new_cap);                                       \
+    }                                                                          \
+                                                                               \
+    static void MTD(Vec, check_expansion, /) {                                 \
+        if (self->size < self->capacity) {                                     \
+            return;                                                            \
+        }                                                                      \
+        CALL(Vec, *self, reserve, /,                                           \
+             NSCALL(VecCore, grown_capacity, /, self->capacity, sizeof(T)));   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, shrink_to_fit, /) {                                  \
+        if (self->size == self->capacity) {                                    \
+            return;                                                            \
+        }                                                                      \
+        self->data = (T *)NSCALL(VecCore, shrink, /,                           \
+                                 NSCALL(Vec, allocator, /), self->data,        \
+                                 self->capacity, self->size, sizeof(T));       \
+        self->capacity = self->size;                                           \
+    }
+
+#undef DEFINE_VEC_SHIFT
+#define DEFINE_VEC_SHIFT(Vec, T)                                               \
+    /* Vec.open_gap(usize index): move [index, size) one place back */         \
+    static void MTD(Vec, open_gap, /, usize MPROT(index)) {                    \
+        memmove(self->data + MPROT(index) + 1, self->data + MPROT(index),      \
+                (self->size - MPROT(index)) * sizeof(T));                      \
+    }                                                                          \
+                                                                               \
+    /* Vec.close_gap(usize lo, usize hi): move [hi, size) to lo */             \
+    static void MTD(Vec, close_gap, /, usize MPROT(lo), usize MPROT(hi)) {     \
+        memmove(self->data + MPROT(lo), self->data + MPROT(hi),                \
+                (self->size - MPROT(hi)) * sizeof(T));                         \
+    }
+
+#undef DEFINE_VEC_SHIFT_SHARED
+#define DEFINE_VEC_SHIFT_SHARED(Vec, T)                                        \
+    static void MTD(Vec, open_gap, /, usize MPROT(index)) {                    \
+        NSCALL(VecCore, open_gap, /, self->data, self->size, MPROT(index),     \
+               sizeof(T));                                                     \
+    }                                                                          \
+                                                                               \
+    static void MTD(Vec, close_gap, /, usize MPROT(lo), usize MPROT(hi)) {     \
+        NSCALL(VecCore, close_gap, /, self->data, self->size, MPROT(lo),       \
+               MPROT(hi), sizeof(T));                                          \
+    }
+
+/// the links of a treap node, embedded into the node types
+typedef struct TreapCore {
+    struct TreapCore *left_son;
+    struct TreapCore *right_son;
+    struct TreapCore *parent;
+    u64 random_value;
+} TreapCore;
+
+/// TreapCore with its operations defined inline in each translation unit, for
+/// the containers off the shared core
+typedef TreapCore TreapLocal;
+
+#undef DECLARE_TREAP_LINKS
+#define DECLARE_TREAP_LINKS(Core, STORAGE)                                     \
+    /* Core::lturn(Core **p) */                                                \
+    STORAGE void NSMTD(Core, lturn, /, Core * *p);                             \
+                                                                               \
+    /* Core::rturn(Core **p) */                                                \
+    STORAGE void NSMTD(Core, rturn, /, Core * *p);                             \
+                                                                               \
+    /* Core::leftmost(Core *node) -> Core * */                                 \
+    STORAGE Core *NSMTD(Core, leftmost, /, Core * node);                       \
+                                                                               \
+    /* Core::rightmost(Core *node) -> Core * */                                \
+    STORAGE Core *NSMTD(Core, rightmost, /, Core * node);                      \
+                                                                               \
+    /* Core.next() -> Core * */                                                \
+    STORAGE Core *MTD(Core, next, /);                                          \
+                                                                               \
+    /* Core.prev() -> Core * */                                                \
+    STORAGE Core *MTD(Core, prev, /);                                          \
+                                                                               \
+    /* Core::unlink(Core **p) -> Core * */                                     \
+    STORAGE Core *NSMTD(Core, unlink, /, Core * *p);
+
+#undef DEFINE_TREAP_LINKS
+#define DEFINE_TREAP_LINKS(Core, STORAGE)                                      \
+    STORAGE void NSMTD(Core, lturn, /, Core * *MPROT(p)) {                     \
+        Core *MPROT(son) = (*MPROT(p))->right_son;                             \
+        ASSERT(MPROT(son));                                                    \
+        (*MPROT(p))->right_son = MPROT(son)->left_son;                         \
+        if (MPROT(son)->left_son) {                                            \
+            MPROT(son)->left_son->parent = *MPROT(p);                          \
+        }                                                                      \
+        MPROT(son)->left_son = *MPROT(p);                                      \
+        MPROT(son)->parent = (*MPROT(p))->parent;                              \
+        (*MPROT(p))->parent = MPROT(son);                                      \
+        *MPROT(p) = MPROT(son);                                                \
+    }                                                                          \
+                                                                               \
+    STORAGE void NSMTD(Core, rturn, /, Core * *MPROT(p)) {                     \
+        Core *MPROT(son) = (*MPROT(p))->left_son;                              \
+        ASSERT(MPROT(son));                                                    \
+        (*MPROT(p))->left_son = MPROT(son)->right_son;                         \
+        if (MPROT(son)->right_son) {                                           \
+            MPROT(son)->right_son->parent = *MPROT(p);                         \
+        }                                                                      \
+        MPROT(son)->right_son = *MPROT(p);                                     \
+        MPROT(son)->parent = (*MPROT(p))->parent;                              \
+        (*MPROT(p))->parent = MPROT(son);                                      \
+        *MPROT(p) = MPROT(son);                                                \
+    }                                                                          \
+                                                                               \
+    STORAGE Core *NSMTD(Core, leftmost, /, Core * MPROT(node)) {               \
+        while (MPROT(node)->left_son) {                                        \
+            MPROT(node) = MPROT(node)->left_son;                               \
+        }                                                                      \
+        return MPROT(node);                                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE Core *NSMTD(Core, rightmost, /, Core * MPROT(node)) {              \
+        while (MPROT(node)->right_son) {                                       \
+            MPROT(node) = MPROT(node)->right_son;                              \
+        }                                                                      \
+        return MPROT(node);                                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE Core *MTD(Core, next, /) {                                         \
+        if (self->right_son) {                                                 \
+            return NSCALL(Core, leftmost, /, self->right_son);                 \
+        }                                                                      \
+        Core *MPROT(node) = self;                                              \
+        while (MPROT(node)->parent &&                                          \
+               MPROT(node)->parent->right_son == MPROT(node)) {                \
+            MPROT(node) = MPROT(node)->parent;                                 \
+        }                                                                      \
+        return MPROT(node)->parent;                                            \
+    }                                                                          \
+                                                                               \
+    STORAGE Core *MTD(Core, prev, /) {                                         \
+        if (self->left_son) {                                                  \
+            return NSCALL(Core, rightmost, /, self->left_son);                 \
+        }                                                                      \
+        ASSERT(self->parent);                                                  \
+        Core *MPROT(node) = self;                                              \
+        while (MPROT(node)->parent &&                                          \
+               MPROT(node)->parent->left_son == MPROT(node)) {                 \
+            MPROT(node) = MPROT(node)->parent;                                 \
+        }                                                                      \
+        return MPROT(node)->parent;                                            \
+    }                                                                          \
+                                                                               \
+    STORAGE Core *NSMTD(Core, unlink, /, Core * *MPROT(p)) {                   \
+        ASSERT(MPROT(p) && *MPROT(p));                                         \
+        while ((*MPROT(p))->left_son && (*MPROT(p))->right_son) {              \
+            if ((*MPROT(p))->left_son->random_value <                          \
+                (*MPROT(p))->right_son->random_value) {                        \
+                NSCALL(Core, rturn, /, MPROT(p));                              \
+                MPROT(p) = &(*MPROT(p))->right_son;                            \
+            } else {                                                           \
+                NSCALL(Core, lturn, /, MPROT(p));                              \
+                MPROT(p) = &(*MPROT(p))->left_son;                             \
+            }                                                                  \
+        }                                                                      \
+        Core *MPROT(node) = *MPROT(p);                                         \
+        *MPROT(p) = MPROT(node)->left_son ? MPROT(node)->left_son              \
+                                          : MPROT(node)->right_son;            \
+        if (*MPROT(p)) {                                                       \
+            (*MPROT(p))->parent = MPROT(node)->parent;                         \
+        }                                                                      \
+        MPROT(node)->left_son = NULL;                                          \
+        MPROT(node)->right_son = NULL;                                         \
+        return MPROT(node);                                                    \
+    }
+
+#undef DEFINE_TREAP_NODE
+#define DEFINE_TREAP_NODE(Node, LINK, Core)                                    \
+    /* Node::entry(TreapCore *link) -> Node * */                               \
+    FUNC_STATIC Node *NSMTD(Node, entry, /, TreapCore * MPROT(link)) {         \
+        if (!MPROT(link)) {                                                    \
+            return NULL;                                                       \
+        }                                                                      \
+        return (Node *)((char *)MPROT(link) - offsetof(Node, LINK));           \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC void NSMTD(Node, lturn, /, TreapCore * *MPROT(p)) {            \
+        NSCALL(Core, lturn, /, MPROT(p));                                      \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC void NSMTD(Node, rturn, /, TreapCore * *MPROT(p)) {            \
+        NSCALL(Core, rturn, /, MPROT(p));                                      \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC Node *NSMTD(Node, leftmost, /, Node * MPROT(node)) {           \
+        return NSCALL(Node, entry, /,                                          \
+                      NSCALL(Core, leftmost, /, &MPROT(node)->LINK));          \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC Node *NSMTD(Node, rightmost, /, Node * MPROT(node)) {          \
+        return NSCALL(Node, entry, /,                                          \
+                      NSCALL(Core, rightmost, /, &MPROT(node)->LINK));         \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC Node *MTD(Node, next, /) {                                     \
+        return NSCALL(Node, entry, /, NSCALL(Core, next, /, &self->LINK));     \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC Node *MTD(Node, prev, /) {                                     \
+        return NSCALL(Node, entry, /, NSCALL(Core, prev, /, &self->LINK));     \
+    }                                                                          \
+                                                                               \
+    FUNC_STATIC Node *NSMTD(Node, unlink, /, TreapCore * *MPROT(p)) {          \
+        return NSCALL(Node, entry, /, NSCALL(Core, unlink, /, MPROT(p)));      \
+    }
+
+DECLARE_TREAP_LINKS(TreapCore, FUNC_EXTERN);
+
+DEFINE_TREAP_LINKS(TreapLocal, FUNC_STATIC)
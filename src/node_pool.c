@@ -0,0 +1,81 @@
+#include <stdlib.h>
+
+#include "debug.h"
+#include "node_pool.h"
+
+static void MTD(NodePool, free_slab, /, NodePoolSlab *slab) {
+    NSCALL(Allocator, deallocate, /, self->allocator, slab,
+           self->node_offset + slab->n_nodes * self->node_size);
+}
+
+void MTD(NodePool, drop, /) {
+    while (self->slabs) {
+        NodePoolSlab *slab = self->slabs;
+        self->slabs = slab->next;
+        CALL(NodePool, *self, free_slab, /, slab);
+    }
+    self->free_list = NULL;
+    self->fresh = NULL;
+    self->fresh_end = NULL;
+}
+
+void *MTD(NodePool, alloc_bulk, /, usize n) {
+    ASSERT(n > 0);
+    usize bytes = n * self->node_size;
+    if ((usize)(self->fresh_end - self->fresh) >= bytes) {
+        void *nodes = self->fresh;
+        self->fresh += bytes;
+        return nodes;
+    }
+    for (; self->fresh != self->fresh_end; self->fresh += self->node_size) {
+        CALL(NodePool, *self, free, /, self->fresh);
+    }
+    usize n_nodes = NODE_POOL_MIN_SLAB;
+    if (self->slabs) {
+        n_nodes = Min(self->slabs->n_nodes * 2, (usize)NODE_POOL_MAX_SLAB);
+    }
+    n_nodes = Max(n_nodes, n);
+    NodePoolSlab *slab = (NodePoolSlab *)NSCALL(
+        Allocator, allocate, /, self->allocator,
+        self->node_offset + n_nodes * self->node_size);
+    slab->next = self->slabs;
+    slab->n_nodes = n_nodes;
+    self->slabs = slab;
+    self->fresh = (char *)slab + self->node_offset + bytes;
+    self->fresh_end =
+        (char *)slab + self->node_offset + n_nodes * self->node_size;
+    return (char *)slab + self->node_offset;
+}
+
+void MTD(NodePool, reset, /) {
+    self->free_list = NULL;
+    if (!self->slabs) {
+        return;
+    }
+    // a bulk allocation may have made an older slab the largest one
+    NodePoolSlab *largest = self->slabs;
+    for (NodePoolSlab *slab = largest->next; slab; slab = slab->next) {
+        if (slab->n_nodes > largest->n_nodes) {
+            largest = slab;
+        }
+    }
+    while (self->slabs) {
+        NodePoolSlab *slab = self->slabs;
+        self->slabs = slab->next;
+        if (slab != largest) {
+            CALL(NodePool, *self, free_slab, /, slab);
+        }
+    }
+    largest->next = NULL;
+    self->slabs = largest;
+    self->fresh = (char *)largest + self->node_offset;
+    self->fresh_end = self->fresh + largest->n_nodes * self->node_size;
+}
+
+usize MTDCONST(NodePool, memory, /) {
+    usize bytes = 0;
+    for (NodePoolSlab *slab = self->slabs; slab; slab = slab->next) {
+        bytes += self->node_offset + slab->n_nodes * self->node_size;
+    }
+    return bytes;
+}
@@ -0,0 +1,107 @@
+// clang-format off
+/// node_pool.h: provides a pool of fixed-size nodes carved from large slabs
+///
+/// The nodes are carved from slabs of growing sizes (from NODE_POOL_MIN_SLAB to NODE_POOL_MAX_SLAB nodes), and the
+/// freed ones are kept in a free list threaded through their first word, so that allocating or freeing a node is a few
+/// pointer operations instead of a malloc or free. The slabs are released only as a whole, by reset or drop. A pool is
+/// not synchronized: share one pool among the containers of a thread, or give each container its own.
+///
+///     NodePool.init(usize node_size, usize node_align): initializes the pool; node_align (e.g. `__alignof__(Node)`)
+///         must be a power of two no more than NODE_POOL_MAX_ALIGN
+///     NodePool.init_in(usize node_size, usize node_align, Allocator *allocator): initializes the pool with the slabs
+///         from allocator (see allocator.h; NULL for the libc heap)
+///     NodePool.drop(): drops the pool, releasing all the slabs; the nodes must not be used anymore
+///     NodePool.alloc() -> void *: allocates an uninitialized node
+///     NodePool.alloc_bulk(usize n) -> void *: allocates n > 0 contiguous uninitialized nodes, each freed on its own;
+///         the nodes left in the newest slab are moved to the free list when they are too few
+///     NodePool.free(void *node): returns a node allocated by the pool to the free list
+///     NodePool.reset(): frees all the nodes at once, keeping the largest slab for reuse
+///     NodePool.memory() const -> usize: the bytes of the slabs
+// clang-format on
+
+#pragma once
+
+#include "allocator.h"
+#include "utils.h"
+
+#undef NODE_POOL_MIN_SLAB
+#define NODE_POOL_MIN_SLAB 64
+
+#undef NODE_POOL_MAX_SLAB
+#define NODE_POOL_MAX_SLAB 4096
+
+#undef NODE_POOL_MAX_ALIGN
+#define NODE_POOL_MAX_ALIGN 16
+
+typedef struct NodePoolSlab {
+    struct NodePoolSlab *next;
+    usize n_nodes;
+} NodePoolSlab;
+
+typedef struct NodePool {
+    /// the freed nodes, linked through their first word
+    void *free_list;
+    /// the slabs, newest first
+    NodePoolSlab *slabs;
+    /// the next node of the newest slab never allocated, and the end of it
+    char *fresh;
+    char *fresh_end;
+    usize node_size;
+    /// the offset of the first node from the start of a slab
+    usize node_offset;
+    /// the allocator of the slabs
+    Allocator *allocator;
+} NodePool;
+
+FUNC_STATIC void MTD(NodePool, init_in, /, usize node_size, usize node_align,
+                     Allocator *allocator) {
+    ASSERT(node_align > 0 && (node_align & (node_align - 1)) == 0 &&
+           node_align <= NODE_POOL_MAX_ALIGN);
+    node_align = Max(node_align, sizeof(void *));
+    node_size = Max(node_size, sizeof(void *));
+    self->free_list = NULL;
+    self->slabs = NULL;
+    self->fresh = NULL;
+    self->fresh_end = NULL;
+    self->node_size = (node_size + node_align - 1) & ~(node_align - 1);
+    self->node_offset =
+        (sizeof(NodePoolSlab) + node_align - 1) & ~(node_align - 1);
+    self->allocator = allocator;
+}
+
+FUNC_STATIC void MTD(NodePool, init, /, usize node_size, usize node_align) {
+    CALL(NodePool, *self, init_in, /, node_size, node_align, NULL);
+}
+
+/* NodePool.drop() */
+void MTD(NodePool, drop, /);
+
+DELETED_CLONER(NodePool, FUNC_STATIC);
+
+/* NodePool.alloc_bulk(usize n) -> void * */
+void *MTD(NodePool, alloc_bulk, /, usize n);
+
+FUNC_STATIC void *MTD(NodePool, alloc, /) {
+    void *node = self->free_list;
+    if (node) {
+        self->free_list = *(void **)node;
+        return node;
+    }
+    if (self->fresh != self->fresh_end) {
+        node = self->fresh;
+        self->fresh += self->node_size;
+        return node;
+    }
+    return CALL(NodePool, *self, alloc_bulk, /, 1);
+}
+
+FUNC_STATIC void MTD(NodePool, free, /, void *node) {
+    *(void **)node = self->free_list;
+    self->free_list = node;
+}
+
+/* NodePool.reset() */
+void MTD(NodePool, reset, /);
+
+/* NodePool.memory() const -> usize */
+usize MTDCONST(NodePool, memory, /);
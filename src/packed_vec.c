@@ -0,0 +1,205 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "packed_vec.h"
+
+void MTD(PackedVec, drop, /) {
+    free(self->blocks);
+    free(self->words);
+    free(self->tail);
+    CALL(PackedVec, *self, init, /, self->delta);
+}
+
+void MTD(PackedVec, clone_from, /, const PackedVec *other) {
+    if (self == other) {
+        return;
+    }
+    CALL(PackedVec, *self, drop, /);
+    self->delta = other->delta;
+    if (other->n_blocks > 0) {
+        self->blocks =
+            (PackedBlock *)malloc(other->n_blocks * sizeof(PackedBlock));
+        ASSERT(self->blocks);
+        memcpy(self->blocks, other->blocks,
+               other->n_blocks * sizeof(PackedBlock));
+        self->n_blocks = self->blocks_capacity = other->n_blocks;
+    }
+    if (other->n_words > 0) {
+        self->words = (u64 *)malloc(other->n_words * sizeof(u64));
+        ASSERT(self->words);
+        memcpy(self->words, other->words, other->n_words * sizeof(u64));
+        self->n_words = self->words_capacity = other->n_words;
+    }
+    if (other->tail) {
+        self->tail = (u64 *)malloc(SIMD_PACK_BLOCK * sizeof(u64));
+        ASSERT(self->tail);
+        memcpy(self->tail, other->tail, other->tail_size * sizeof(u64));
+        self->tail_size = other->tail_size;
+    }
+}
+
+/* pack the full tail as a new block */
+static void MTD(PackedVec, flush_tail, /) {
+    const u64 *values = self->tail;
+    u64 base = values[0];
+    u64 spread = 0;
+    if (self->delta) {
+        for (usize i = 0; i < SIMD_PACK_BLOCK; i++) {
+            u64 prev =
+                i >= SIMD_PACK_LANES ? values[i - SIMD_PACK_LANES] : base;
+            spread |= values[i] - prev;
+        }
+    } else {
+        u64 max = values[0];
+        for (usize i = 1; i < SIMD_PACK_BLOCK; i++) {
+            base = Min(base, values[i]);
+            max = Max(max, values[i]);
+        }
+        spread = max - base;
+    }
+    u32 bits = spread ? (u32)(64 - __builtin_clzll(spread)) : 0;
+
+    usize n_words = SIMD_PACK_WORDS(bits);
+    if (self->n_words + n_words > self->words_capacity) {
+        usize cap = Max(self->words_capacity * 2, self->n_words + n_words);
+        self->words = (u64 *)realloc(self->words, cap * sizeof(u64));
+        ASSERT(self->words);
+        self->words_capacity = cap;
+    }
+    if (self->n_blocks == self->blocks_capacity) {
+        usize cap = Max((usize)4, self->blocks_capacity * 2);
+        self->blocks =
+            (PackedBlock *)realloc(self->blocks, cap * sizeof(PackedBlock));
+        ASSERT(self->blocks);
+        self->blocks_capacity = cap;
+    }
+    NSCALL(Simd, pack_u64, /, values, bits, base, self->delta,
+           self->words + self->n_words);
+    self->blocks[self->n_blocks++] = (PackedBlock){
+        .base = base,
+        .offset = self->n_words,
+        .bits = bits,
+    };
+    self->n_words += n_words;
+    self->tail_size = 0;
+}
+
+void MTD(PackedVec, push_back, /, u64 value) {
+    if (!self->tail) {
+        self->tail = (u64 *)malloc(SIMD_PACK_BLOCK * sizeof(u64));
+        ASSERT(self->tail);
+    }
+    self->tail[self->tail_size++] = value;
+    if (self->tail_size == SIMD_PACK_BLOCK) {
+        CALL(PackedVec, *self, flush_tail, /);
+    }
+}
+
+/* the packed difference at position k of a lane, see simd.h for the layout */
+static u64 NSMTD(PackedBlock, extract, /, const u64 *words, u32 bits,
+                 usize lane, usize k) {
+    if (bits == 0) {
+        return 0;
+    }
+    usize bit = k * bits;
+    usize w = bit / 64, s = bit % 64;
+    u64 v = words[w * SIMD_PACK_LANES + lane] >> s;
+    if (s + bits > 64) {
+        v |= words[(w + 1) * SIMD_PACK_LANES + lane] << (64 - s);
+    }
+    return bits == 64 ? v : v & ((1ull << bits) - 1);
+}
+
+u64 MTDCONST(PackedVec, get, /, usize index) {
+    ASSERT(index < CALL(PackedVec, *self, size, /));
+    usize b = index / SIMD_PACK_BLOCK;
+    if (b == self->n_blocks) {
+        return self->tail[index % SIMD_PACK_BLOCK];
+    }
+    const PackedBlock *block = self->blocks + b;
+    const u64 *words = self->words + block->offset;
+    usize i = index % SIMD_PACK_BLOCK;
+    usize lane = i % SIMD_PACK_LANES;
+    if (!self->delta) {
+        return block->base + NSCALL(PackedBlock, extract, /, words,
+                                    block->bits, lane, i / SIMD_PACK_LANES);
+    }
+    u64 value = block->base;
+    for (usize k = 0; k <= i / SIMD_PACK_LANES; k++) {
+        value += NSCALL(PackedBlock, extract, /, words, block->bits, lane, k);
+    }
+    return value;
+}
+
+usize MTDCONST(PackedVec, decode_block, /, usize block, u64 *out) {
+    ASSERT(block <= self->n_blocks);
+    if (block == self->n_blocks) {
+        if (self->tail_size > 0) {
+            memcpy(out, self->tail, self->tail_size * sizeof(u64));
+        }
+        return self->tail_size;
+    }
+    const PackedBlock *b = self->blocks + block;
+    NSCALL(Simd, unpack_u64, /, self->words + b->offset, b->bits, b->base,
+           self->delta, out);
+    return SIMD_PACK_BLOCK;
+}
+
+usize MTDCONST(PackedVec, lower_bound, /, u64 key) {
+    // the first block whose first value >= key
+    usize lo = 0, hi = self->n_blocks;
+    while (lo < hi) {
+        usize mid = lo + (hi - lo) / 2;
+        if (self->blocks[mid].base < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0 && self->n_blocks > 0) {
+        return 0;
+    }
+    // otherwise the answer is in the block before, or starts the block
+    u64 buf[SIMD_PACK_BLOCK];
+    usize block = lo > 0 ? lo - 1 : 0;
+    usize n = CALL(PackedVec, *self, decode_block, /, block, buf);
+    for (usize i = 0; i < n; i++) {
+        if (buf[i] >= key) {
+            return block * SIMD_PACK_BLOCK + i;
+        }
+    }
+    if (lo < self->n_blocks) {
+        return lo * SIMD_PACK_BLOCK;
+    }
+    // past the packed blocks, so in the unpacked values
+    usize base = self->n_blocks * SIMD_PACK_BLOCK;
+    if (block == self->n_blocks) {
+        return base + n;
+    }
+    for (usize i = 0; i < self->tail_size; i++) {
+        if (self->tail[i] >= key) {
+            return base + i;
+        }
+    }
+    return base + self->tail_size;
+}
+
+void MTD(PackedVec, clear, /) {
+    self->n_blocks = 0;
+    self->n_words = 0;
+    self->tail_size = 0;
+}
+
+bool MTD(PackedVecIter, next, /, u64 *value) {
+    while (self->pos == self->n) {
+        if (self->block > self->vec->n_blocks) {
+            return false;
+        }
+        self->n = CALL(PackedVec, *self->vec, decode_block, /, self->block++,
+                       self->buf);
+        self->pos = 0;
+    }
+    *value = self->buf[self->pos++];
+    return true;
+}
@@ -0,0 +1,119 @@
+// clang-format off
+/// packed_vec.h: provides a compressed vector of 64-bit integers
+///
+/// The values are stored in blocks of SIMD_PACK_BLOCK values, each bit-packed with the fewest bits it needs: as the
+/// differences from the minimum of the block, or in delta mode, as the differences from the value SIMD_PACK_LANES
+/// before, which suits sorted values (unsorted ones still round-trip, with poor compression). A skip index over the
+/// blocks gives random access, and the values of the last, partial block stay unpacked.
+///
+///     PackedVec.init(bool delta): initializes the vector; delta selects the delta encoding
+///     PackedVec.drop(): drops the vector
+///     PackedVec.clone_from(const PackedVec *other): clones the vector from another vector
+///     PackedVec.clone() const -> PackedVec: clones the vector
+///     PackedVec.push_back(u64 value): pushes a value to the back of the vector
+///     PackedVec.get(usize index) const -> u64: gets the value at index; O(1), or O(SIMD_PACK_BLOCK) in delta mode
+///     PackedVec.decode_block(usize block, u64 *out) const -> usize: decodes the values of a block (the unpacked ones
+///         for block n_blocks) into out, which holds SIMD_PACK_BLOCK values, and returns their number
+///     PackedVec.lower_bound(u64 key) const -> usize: the first index whose value >= key; the values must be sorted
+///     PackedVec.size() const -> usize: the number of values
+///     PackedVec.empty() const -> bool: checks if the vector is empty
+///     PackedVec.clear(): clears the vector
+///     PackedVec.memory() const -> usize: the bytes used by the values and the skip index
+///     PackedVec.iter() const -> PackedVecIter: an iterator decoding the vector a block at a time
+///     PackedVecIter.next(u64 *value) -> bool: gets the next value, or returns false at the end
+// clang-format on
+
+#pragma once
+
+#include "simd.h"
+#include "utils.h"
+
+typedef struct PackedBlock {
+    /// the minimum of the block, or its first value in delta mode
+    u64 base;
+    /// the first word of the block
+    usize offset;
+    u32 bits;
+} PackedBlock;
+
+typedef struct PackedVec {
+    PackedBlock *blocks;
+    usize n_blocks;
+    usize blocks_capacity;
+    u64 *words;
+    usize n_words;
+    usize words_capacity;
+    /// the unpacked values, allocated with SIMD_PACK_BLOCK values on demand
+    u64 *tail;
+    usize tail_size;
+    bool delta;
+} PackedVec;
+
+typedef struct PackedVecIter {
+    const PackedVec *vec;
+    usize block;
+    usize pos;
+    usize n;
+    u64 buf[SIMD_PACK_BLOCK];
+} PackedVecIter;
+
+FUNC_STATIC void MTD(PackedVec, init, /, bool delta) {
+    self->blocks = NULL;
+    self->n_blocks = 0;
+    self->blocks_capacity = 0;
+    self->words = NULL;
+    self->n_words = 0;
+    self->words_capacity = 0;
+    self->tail = NULL;
+    self->tail_size = 0;
+    self->delta = delta;
+}
+
+/* PackedVec.drop() */
+void MTD(PackedVec, drop, /);
+
+/* PackedVec.clone_from(const PackedVec *other) */
+void MTD(PackedVec, clone_from, /, const PackedVec *other);
+
+FUNC_STATIC DEFAULT_DERIVE_CLONE(PackedVec, /, false);
+
+/* PackedVec.push_back(u64 value) */
+void MTD(PackedVec, push_back, /, u64 value);
+
+/* PackedVec.get(usize index) const -> u64 */
+u64 MTDCONST(PackedVec, get, /, usize index);
+
+/* PackedVec.decode_block(usize block, u64 *out) const -> usize */
+usize MTDCONST(PackedVec, decode_block, /, usize block, u64 *out);
+
+/* PackedVec.lower_bound(u64 key) const -> usize */
+usize MTDCONST(PackedVec, lower_bound, /, u64 key);
+
+/* PackedVec.clear() */
+void MTD(PackedVec, clear, /);
+
+FUNC_STATIC usize MTDCONST(PackedVec, size, /) {
+    return self->n_blocks * SIMD_PACK_BLOCK + self->tail_size;
+}
+
+FUNC_STATIC bool MTDCONST(PackedVec, empty, /) {
+    return CALL(PackedVec, *self, size, /) == 0;
+}
+
+FUNC_STATIC usize MTDCONST(PackedVec, memory, /) {
+    return self->n_words * sizeof(u64) +
+           self->n_blocks * sizeof(PackedBlock) +
+           (self->tail ? SIMD_PACK_BLOCK * sizeof(u64) : 0);
+}
+
+FUNC_STATIC PackedVecIter MTDCONST(PackedVec, iter, /) {
+    PackedVecIter iter;
+    iter.vec = self;
+    iter.block = 0;
+    iter.pos = 0;
+    iter.n = 0;
+    return iter;
+}
+
+/* PackedVecIter.next(u64 *value) -> bool */
+bool MTD(PackedVecIter, next, /, u64 *value);
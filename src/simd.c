@@ -0,0 +1,473 @@
+#include "debug.h"
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_ATTR_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_ATTR_AVX2
+#endif
+
+static int simd_current_level = -1;
+
+static SimdLevel NSMTD(Simd, detect_level, /) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_LEVEL_AVX2;
+    }
+#endif
+    return SIMD_LEVEL_VEC128;
+}
+
+SimdLevel NSMTD(Simd, level, /) {
+    if (unlikely(simd_current_level < 0)) {
+        simd_current_level = (int)NSCALL(Simd, detect_level, /);
+    }
+    return (SimdLevel)simd_current_level;
+}
+
+void NSMTD(Simd, set_level, /, SimdLevel level) {
+    SimdLevel supported = NSCALL(Simd, detect_level, /);
+    simd_current_level = (int)(level < supported ? level : supported);
+}
+
+/// Scalar kernels, also used for the tails of the vector kernels
+
+#define SIMD_SCALAR_KERNELS(Suffix, T, S)                                      \
+    static usize NSMTD(Simd, CONCATENATE3(find_, Suffix, _scalar), /,          \
+                       const T *data, usize n, T value) {                      \
+        for (usize i = 0; i < n; i++) {                                        \
+            if (data[i] == value) {                                            \
+                return i;                                                      \
+            }                                                                  \
+        }                                                                      \
+        return n;                                                              \
+    }                                                                          \
+                                                                               \
+    static usize NSMTD(Simd, CONCATENATE3(count_, Suffix, _scalar), /,         \
+                       const T *data, usize n, T value) {                      \
+        usize cnt = 0;                                                         \
+        for (usize i = 0; i < n; i++) {                                        \
+            cnt += data[i] == value;                                           \
+        }                                                                      \
+        return cnt;                                                            \
+    }                                                                          \
+                                                                               \
+    static void NSMTD(Simd, CONCATENATE3(minmax_, Suffix, _scalar), /,         \
+                      const T *data, usize n, T *min, T *max) {                \
+        for (usize i = 0; i < n; i++) {                                        \
+            if (data[i] < *min) {                                              \
+                *min = data[i];                                                \
+            }                                                                  \
+            if (data[i] > *max) {                                              \
+                *max = data[i];                                                \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static S NSMTD(Simd, CONCATENATE3(sum_, Suffix, _scalar), /,               \
+                   const T *data, usize n) {                                   \
+        S sum = 0;                                                             \
+        for (usize i = 0; i < n; i++) {                                        \
+            sum += (S)data[i];                                                 \
+        }                                                                      \
+        return sum;                                                            \
+    }                                                                          \
+                                                                               \
+    static bool NSMTD(Simd, CONCATENATE3(match_, Suffix, _scalar), /, T elem,  \
+                      SimdCmp cmp, T value) {                                  \
+        switch (cmp) {                                                         \
+        case SIMD_CMP_EQ:                                                      \
+            return elem == value;                                              \
+        case SIMD_CMP_NE:                                                      \
+            return elem != value;                                              \
+        case SIMD_CMP_LT:                                                      \
+            return elem < value;                                               \
+        case SIMD_CMP_LE:                                                      \
+            return elem <= value;                                              \
+        case SIMD_CMP_GT:                                                      \
+            return elem > value;                                               \
+        case SIMD_CMP_GE:                                                      \
+            return elem >= value;                                              \
+        }                                                                      \
+        UNREACHABLE;                                                           \
+    }                                                                          \
+                                                                               \
+    static usize NSMTD(Simd, CONCATENATE3(filter_, Suffix, _scalar), /,        \
+                       const T *data, usize n, SimdCmp cmp, T value, T *out) { \
+        usize cnt = 0;                                                         \
+        for (usize i = 0; i < n; i++) {                                        \
+            if (NSCALL(Simd, CONCATENATE3(match_, Suffix, _scalar), /,         \
+                       data[i], cmp, value)) {                                 \
+                out[cnt++] = data[i];                                          \
+            }                                                                  \
+        }                                                                      \
+        return cnt;                                                            \
+    }
+
+/// Vector kernels, written with the GCC vector extensions; W is the width of a
+/// vector in bytes, and M is the signed integer type as wide as T
+
+#define SIMD_VECTOR_TYPES(T, M, S, W)                                          \
+    typedef T VT __attribute__((vector_size(W), unused));                      \
+    /* the unaligned type to load the vectors with */                          \
+    typedef T VU __attribute__((vector_size(W), aligned(sizeof(T)), may_alias, \
+                                unused));                                      \
+    typedef M VM __attribute__((vector_size(W), unused));                      \
+    /* the sums are accumulated in W bytes, from vectors of as many T */       \
+    typedef S VS __attribute__((vector_size(W), unused));                      \
+    typedef T VUS __attribute__((vector_size(W / sizeof(S) * sizeof(T)),       \
+                                 aligned(sizeof(T)), may_alias, unused));      \
+    enum { L = W / sizeof(T), LS = W / sizeof(S) }
+
+#define SIMD_VECTOR_KERNELS(Suffix, T, M, S, Level, W, ATTR)                   \
+    ATTR static usize NSMTD(Simd, CONCATENATE4(find_, Suffix, _, Level), /,    \
+                            const T *data, usize n, T value) {                 \
+        SIMD_VECTOR_TYPES(T, M, S, W);                                         \
+        VT needle = (VT){} + value;                                            \
+        usize i = 0;                                                           \
+        for (; i + 4 * L <= n; i += 4 * L) {                                   \
+            VT a0 = *(const VU *)(data + i);                                   \
+            VT a1 = *(const VU *)(data + i + L);                               \
+            VT a2 = *(const VU *)(data + i + 2 * L);                           \
+            VT a3 = *(const VU *)(data + i + 3 * L);                           \
+            VM m = (VM)(a0 == needle) | (VM)(a1 == needle) |                   \
+                   (VM)(a2 == needle) | (VM)(a3 == needle);                    \
+            M any = 0;                                                         \
+            for (usize l = 0; l < L; l++) {                                    \
+                any |= m[l];                                                   \
+            }                                                                  \
+            if (any) {                                                         \
+                break;                                                         \
+            }                                                                  \
+        }                                                                      \
+        return i + NSCALL(Simd, CONCATENATE3(find_, Suffix, _scalar), /,       \
+                          data + i, n - i, value);                             \
+    }                                                                          \
+                                                                               \
+    ATTR static usize NSMTD(Simd, CONCATENATE4(count_, Suffix, _, Level), /,   \
+                            const T *data, usize n, T value) {                 \
+        SIMD_VECTOR_TYPES(T, M, S, W);                                         \
+        VT needle = (VT){} + value;                                            \
+        usize cnt = 0;                                                         \
+        usize i = 0;                                                           \
+        while (i + L <= n) {                                                   \
+            /* flush the lanes before they may overflow */                     \
+            usize end = i + ((usize)1 << 24) * L;                              \
+            VM acc = {};                                                       \
+            for (; i + L <= n && i < end; i += L) {                            \
+                VT a = *(const VU *)(data + i);                                \
+                acc -= (VM)(a == needle);                                      \
+            }                                                                  \
+            for (usize l = 0; l < L; l++) {                                    \
+                cnt += (usize)acc[l];                                          \
+            }                                                                  \
+        }                                                                      \
+        return cnt + NSCALL(Simd, CONCATENATE3(count_, Suffix, _scalar), /,    \
+                            data + i, n - i, value);                           \
+    }                                                                          \
+                                                                               \
+    ATTR static void NSMTD(Simd, CONCATENATE4(minmax_, Suffix, _, Level), /,   \
+                           const T *data, usize n, T *min, T *max) {           \
+        SIMD_VECTOR_TYPES(T, M, S, W);                                         \
+        VT vmin = (VT){} + *min;                                               \
+        VT vmax = (VT){} + *max;                                               \
+        usize i = 0;                                                           \
+        for (; i + L <= n; i += L) {                                           \
+            VT a = *(const VU *)(data + i);                                    \
+            VM lt = (VM)(a < vmin);                                            \
+            VM gt = (VM)(a > vmax);                                            \
+            vmin = (VT)(((VM)a & lt) | ((VM)vmin & ~lt));                      \
+            vmax = (VT)(((VM)a & gt) | ((VM)vmax & ~gt));                      \
+        }                                                                      \
+        for (usize l = 0; l < L; l++) {                                        \
+            if (vmin[l] < *min) {                                              \
+                *min = vmin[l];                                                \
+            }                                                                  \
+            if (vmax[l] > *max) {                                              \
+                *max = vmax[l];                                                \
+            }                                                                  \
+        }                                                                      \
+        NSCALL(Simd, CONCATENATE3(minmax_, Suffix, _scalar), /, data + i,      \
+               n - i, min, max);                                               \
+    }                                                                          \
+                                                                               \
+    ATTR static S NSMTD(Simd, CONCATENATE4(sum_, Suffix, _, Level), /,         \
+                        const T *data, usize n) {                              \
+        SIMD_VECTOR_TYPES(T, M, S, W);                                         \
+        VS acc[2] = {};                                                        \
+        usize i = 0;                                                           \
+        for (; i + 2 * LS <= n; i += 2 * LS) {                                 \
+            acc[0] += __builtin_convertvector(*(const VUS *)(data + i), VS);   \
+            acc[1] +=                                                          \
+                __builtin_convertvector(*(const VUS *)(data + i + LS), VS);    \
+        }                                                                      \
+        acc[0] += acc[1];                                                      \
+        S sum = 0;                                                             \
+        for (usize l = 0; l < LS; l++) {                                       \
+            sum += acc[0][l];                                                  \
+        }                                                                      \
+        return sum + NSCALL(Simd, CONCATENATE3(sum_, Suffix, _scalar), /,      \
+                            data + i, n - i);                                  \
+    }                                                                          \
+                                                                               \
+    ATTR static usize NSMTD(Simd, CONCATENATE4(filter_, Suffix, _, Level), /,  \
+                            const T *data, usize n, SimdCmp cmp, T value,      \
+                            T *out) {                                          \
+        SIMD_VECTOR_TYPES(T, M, S, W);                                         \
+        VT needle = (VT){} + value;                                            \
+        usize cnt = 0;                                                         \
+        usize i = 0;                                                           \
+        for (; i + L <= n; i += L) {                                           \
+            VT a = *(const VU *)(data + i);                                    \
+            VM m;                                                              \
+            switch (cmp) {                                                     \
+            case SIMD_CMP_EQ:                                                  \
+                m = (VM)(a == needle);                                         \
+                break;                                                         \
+            case SIMD_CMP_NE:                                                  \
+                m = (VM)(a != needle);                                         \
+                break;                                                         \
+            case SIMD_CMP_LT:                                                  \
+                m = (VM)(a < needle);                                          \
+                break;                                                         \
+            case SIMD_CMP_LE:                                                  \
+                m = (VM)(a <= needle);                                         \
+                break;                                                         \
+            case SIMD_CMP_GT:                                                  \
+                m = (VM)(a > needle);                                          \
+                break;                                                         \
+            case SIMD_CMP_GE:                                                  \
+                m = (VM)(a >= needle);                                         \
+                break;                                                         \
+            default:                                                           \
+                UNREACHABLE;                                                   \
+            }                                                                  \
+            M any = 0;                                                         \
+            for (usize l = 0; l < L; l++) {                                    \
+                any |= m[l];                                                   \
+            }                                                                  \
+            if (!any) {                                                        \
+                continue;                                                      \
+            }                                                                  \
+            /* branchless compaction; out has room for all the elements */     \
+            for (usize l = 0; l < L; l++) {                                    \
+                out[cnt] = a[l];                                               \
+                cnt += m[l] & 1;                                               \
+            }                                                                  \
+        }                                                                      \
+        return cnt + NSCALL(Simd, CONCATENATE3(filter_, Suffix, _scalar), /,   \
+                            data + i, n - i, cmp, value, out + cnt);           \
+    }
+
+/// Public entries, dispatching on the current level
+
+#define SIMD_DISPATCH(Suffix, func, ...)                                       \
+    switch (NSCALL(Simd, level, /)) {                                          \
+    case SIMD_LEVEL_AVX2:                                                      \
+        return NSCALL(Simd, CONCATENATE4(func, _, Suffix, _avx2), /,           \
+                      __VA_ARGS__);                                            \
+    case SIMD_LEVEL_VEC128:                                                    \
+        return NSCALL(Simd, CONCATENATE4(func, _, Suffix, _vec128), /,         \
+                      __VA_ARGS__);                                            \
+    default:                                                                   \
+        return NSCALL(Simd, CONCATENATE4(func, _, Suffix, _scalar), /,         \
+                      __VA_ARGS__);                                            \
+    }
+
+#define SIMD_KERNELS(Suffix, T, M, S)                                          \
+    SIMD_SCALAR_KERNELS(Suffix, T, S)                                          \
+    SIMD_VECTOR_KERNELS(Suffix, T, M, S, vec128, 16, )                         \
+    SIMD_VECTOR_KERNELS(Suffix, T, M, S, avx2, 32, SIMD_ATTR_AVX2)             \
+                                                                               \
+    usize NSMTD(Simd, CONCATENATE(find_, Suffix), /, const T *data, usize n,   \
+                T value) {                                                     \
+        SIMD_DISPATCH(Suffix, find, data, n, value);                           \
+    }                                                                          \
+                                                                               \
+    usize NSMTD(Simd, CONCATENATE(count_, Suffix), /, const T *data, usize n,  \
+                T value) {                                                     \
+        SIMD_DISPATCH(Suffix, count, data, n, value);                          \
+    }                                                                          \
+                                                                               \
+    void NSMTD(Simd, CONCATENATE(minmax_, Suffix), /, const T *data, usize n,  \
+               T *min, T *max) {                                               \
+        ASSERT(n > 0);                                                         \
+        *min = data[0];                                                        \
+        *max = data[0];                                                        \
+        SIMD_DISPATCH(Suffix, minmax, data, n, min, max);                      \
+    }                                                                          \
+                                                                               \
+    S NSMTD(Simd, CONCATENATE(sum_, Suffix), /, const T *data, usize n) {      \
+        SIMD_DISPATCH(Suffix, sum, data, n);                                   \
+    }                                                                          \
+                                                                               \
+    usize NSMTD(Simd, CONCATENATE(filter_, Suffix), /, const T *data, usize n, \
+                SimdCmp cmp, T value, T *out) {                                \
+        SIMD_DISPATCH(Suffix, filter, data, n, cmp, value, out);               \
+    }
+
+SIMD_KERNELS(i32, i32, i32, i64)
+SIMD_KERNELS(u32, u32, i32, u64)
+SIMD_KERNELS(i64, i64, i64, i64)
+SIMD_KERNELS(u64, u64, i64, u64)
+SIMD_KERNELS(f32, f32, i32, f64)
+SIMD_KERNELS(f64, f64, i64, f64)
+
+/// Bitwise kernels over words, for bit vectors
+
+#define SIMD_OP_AND(a, b) ((a) & (b))
+#define SIMD_OP_OR(a, b) ((a) | (b))
+#define SIMD_OP_XOR(a, b) ((a) ^ (b))
+#define SIMD_OP_ANDNOT(a, b) ((a) & ~(b))
+
+/* the bits of each 64-bit lane of x are counted by SWAR, also in vectors */
+#define SIMD_POPCOUNT_WORD(x)                                                  \
+    ({                                                                         \
+        x = x - ((x >> 1) & 0x5555555555555555ull);                            \
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);  \
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;                            \
+        x += x >> 8;                                                           \
+        x += x >> 16;                                                          \
+        x += x >> 32;                                                          \
+        x & 0x7f;                                                              \
+    })
+
+#define SIMD_BITWISE_KERNEL(op, OP, Level, W, ATTR)                            \
+    ATTR static void NSMTD(Simd, CONCATENATE3(op, _u64_, Level), /, u64 *dst,  \
+                           const u64 *src, usize n) {                          \
+        typedef u64 VU __attribute__((vector_size(W), aligned(8), may_alias)); \
+        enum { L = W / sizeof(u64) };                                          \
+        usize i = 0;                                                           \
+        for (; i + L <= n; i += L) {                                           \
+            VU a = *(VU *)(dst + i);                                           \
+            VU b = *(const VU *)(src + i);                                     \
+            *(VU *)(dst + i) = OP(a, b);                                       \
+        }                                                                      \
+        for (; i < n; i++) {                                                   \
+            dst[i] = OP(dst[i], src[i]);                                       \
+        }                                                                      \
+    }
+
+#define SIMD_BITWISE_KERNELS(Level, W, ATTR)                                   \
+    SIMD_BITWISE_KERNEL(and, SIMD_OP_AND, Level, W, ATTR)                      \
+    SIMD_BITWISE_KERNEL(or, SIMD_OP_OR, Level, W, ATTR)                        \
+    SIMD_BITWISE_KERNEL(xor, SIMD_OP_XOR, Level, W, ATTR)                      \
+    SIMD_BITWISE_KERNEL(andnot, SIMD_OP_ANDNOT, Level, W, ATTR)                \
+                                                                               \
+    ATTR static usize NSMTD(Simd, CONCATENATE(popcount_u64_, Level), /,        \
+                            const u64 *data, usize n) {                        \
+        typedef u64 VU __attribute__((vector_size(W), aligned(8), may_alias)); \
+        enum { L = W / sizeof(u64) };                                          \
+        VU acc = {};                                                           \
+        usize i = 0;                                                           \
+        for (; i + L <= n; i += L) {                                           \
+            VU x = *(const VU *)(data + i);                                    \
+            acc += SIMD_POPCOUNT_WORD(x);                                      \
+        }                                                                      \
+        usize cnt = 0;                                                         \
+        for (usize l = 0; l < L; l++) {                                        \
+            cnt += acc[l];                                                     \
+        }                                                                      \
+        for (; i < n; i++) {                                                   \
+            u64 x = data[i];                                                   \
+            cnt += SIMD_POPCOUNT_WORD(x);                                      \
+        }                                                                      \
+        return cnt;                                                            \
+    }
+
+/* the scalar level is a vector of one word */
+SIMD_BITWISE_KERNELS(scalar, 8, )
+SIMD_BITWISE_KERNELS(vec128, 16, )
+SIMD_BITWISE_KERNELS(avx2, 32, SIMD_ATTR_AVX2)
+
+#define SIMD_BITWISE_ENTRY(op)                                                 \
+    void NSMTD(Simd, CONCATENATE(op, _u64), /, u64 *dst, const u64 *src,       \
+               usize n) {                                                      \
+        SIMD_DISPATCH(u64, op, dst, src, n);                                   \
+    }
+
+SIMD_BITWISE_ENTRY(and)
+SIMD_BITWISE_ENTRY(or)
+SIMD_BITWISE_ENTRY(xor)
+SIMD_BITWISE_ENTRY(andnot)
+
+usize NSMTD(Simd, popcount_u64, /, const u64 *data, usize n) {
+    SIMD_DISPATCH(u64, popcount, data, n);
+}
+
+/// Packing kernels, for compressed integers
+
+#define SIMD_PACK_MASK(bits) ((bits) == 64 ? ~0ull : (1ull << (bits)) - 1)
+
+void NSMTD(Simd, pack_u64, /, const u64 *values, u32 bits, u64 base,
+           bool delta, u64 *words) {
+    ASSERT(bits <= 64);
+    for (usize i = 0; i < SIMD_PACK_WORDS(bits); i++) {
+        words[i] = 0;
+    }
+    if (bits == 0) {
+        return;
+    }
+    for (usize i = 0; i < SIMD_PACK_BLOCK; i++) {
+        u64 prev = delta && i >= SIMD_PACK_LANES ? values[i - SIMD_PACK_LANES]
+                                                 : base;
+        u64 v = (values[i] - prev) & SIMD_PACK_MASK(bits);
+        usize lane = i % SIMD_PACK_LANES;
+        usize bit = i / SIMD_PACK_LANES * bits;
+        usize w = bit / 64, s = bit % 64;
+        words[w * SIMD_PACK_LANES + lane] |= v << s;
+        if (s + bits > 64) {
+            words[(w + 1) * SIMD_PACK_LANES + lane] |= v >> (64 - s);
+        }
+    }
+}
+
+/* each step decodes the values of all the lanes at the same position, in
+ * SIMD_PACK_LANES / L vectors; the delta sums are carried in acc */
+#define SIMD_UNPACK_KERNEL(Level, W, ATTR)                                     \
+    ATTR static void NSMTD(Simd, CONCATENATE(unpack_u64_, Level), /,           \
+                           const u64 *words, u32 bits, u64 base, bool delta,   \
+                           u64 *out) {                                         \
+        typedef u64 VU __attribute__((vector_size(W), aligned(8), may_alias)); \
+        enum { L = W / sizeof(u64), H = SIMD_PACK_LANES / L };                 \
+        u64 mask = SIMD_PACK_MASK(bits);                                       \
+        VU acc[H];                                                             \
+        for (usize h = 0; h < H; h++) {                                        \
+            acc[h] = (VU){} + base;                                            \
+        }                                                                      \
+        for (usize k = 0; k < SIMD_PACK_BLOCK / SIMD_PACK_LANES; k++) {        \
+            usize bit = k * bits;                                              \
+            usize w = bit / 64, s = bit % 64;                                  \
+            const u64 *lo = words + w * SIMD_PACK_LANES;                       \
+            for (usize h = 0; h < H; h++) {                                    \
+                VU v = {};                                                     \
+                if (bits > 0) {                                                \
+                    v = *(const VU *)(lo + h * L) >> s;                        \
+                    if (s + bits > 64) {                                       \
+                        v |= *(const VU *)(lo + SIMD_PACK_LANES + h * L)       \
+                             << (64 - s);                                      \
+                    }                                                          \
+                    v &= mask;                                                 \
+                }                                                              \
+                if (delta) {                                                   \
+                    acc[h] += v;                                               \
+                    v = acc[h];                                                \
+                } else {                                                       \
+                    v += acc[h];                                               \
+                }                                                              \
+                *(VU *)(out + k * SIMD_PACK_LANES + h * L) = v;                \
+            }                                                                  \
+        }                                                                      \
+    }
+
+/* the scalar level is a vector of one word */
+SIMD_UNPACK_KERNEL(scalar, 8, )
+SIMD_UNPACK_KERNEL(vec128, 16, )
+SIMD_UNPACK_KERNEL(avx2, 32, SIMD_ATTR_AVX2)
+
+void NSMTD(Simd, unpack_u64, /, const u64 *words, u32 bits, u64 base,
+           bool delta, u64 *out) {
+    ASSERT(bits <= 64);
+    SIMD_DISPATCH(u64, unpack, words, bits, base, delta, out);
+}
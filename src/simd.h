@@ -0,0 +1,146 @@
+// clang-format off
+/// simd.h: provides vectorized kernels over arrays of arithmetic types
+///
+/// The kernels are selected at runtime according to the CPU: AVX2 (x86 only),
+/// 128-bit vectors (SSE2 on x86-64) or scalar loops.
+///
+///     Simd::level() -> SimdLevel: the level in use; detected on the first call
+///     Simd::set_level(SimdLevel level): use another level, clamped to what the CPU supports
+///
+/// For each Suffix/T/S in i32/i32/i64, u32/u32/u64, i64/i64/i64, u64/u64/u64, f32/f32/f64, f64/f64/f64:
+///
+///     Simd::find_<Suffix>(const T *data, usize n, T value) -> usize: the first index of value, or n
+///     Simd::count_<Suffix>(const T *data, usize n, T value) -> usize: the number of value
+///     Simd::minmax_<Suffix>(const T *data, usize n, T *min, T *max): the minimum and maximum; n > 0
+///     Simd::sum_<Suffix>(const T *data, usize n) -> S: the sum, accumulated in S
+///     Simd::filter_<Suffix>(const T *data, usize n, SimdCmp cmp, T value, T *out) -> usize:
+///         copy the elements `e` with `e cmp value` to out, and return their number; out must hold n elements
+///
+/// For bit vectors, over n 64-bit words:
+///
+///     Simd::and_u64(u64 *dst, const u64 *src, usize n): dst &= src
+///     Simd::or_u64(u64 *dst, const u64 *src, usize n): dst |= src
+///     Simd::xor_u64(u64 *dst, const u64 *src, usize n): dst ^= src
+///     Simd::andnot_u64(u64 *dst, const u64 *src, usize n): dst &= ~src
+///     Simd::popcount_u64(const u64 *data, usize n) -> usize: the number of set bits
+///
+/// For compressed integers, over blocks of SIMD_PACK_BLOCK values packed in SIMD_PACK_WORDS(bits) words:
+///
+///     Simd::pack_u64(const u64 *values, u32 bits, u64 base, bool delta, u64 *words): pack the values, as their
+///         differences from base, or with delta from the value SIMD_PACK_LANES before (base for the first ones);
+///         the differences must fit in bits, at most 64
+///     Simd::unpack_u64(const u64 *words, u32 bits, u64 base, bool delta, u64 *out): unpack the values
+///
+/// NaNs are not supported by minmax, and the float sums are accumulated in a
+/// different order from a sequential loop.
+///
+/// Macros:
+///     SIMD_KIND(T): the SimdKind of the kernels for T
+///     SIMD_SUM_TYPE(T): the type which the sums of T are accumulated in
+///     SIMD_PACK_WORDS(bits): the number of words a block of values of the bits is packed in
+// clang-format on
+
+#pragma once
+
+#include "utils.h"
+
+typedef enum SimdLevel {
+    SIMD_LEVEL_SCALAR,
+    SIMD_LEVEL_VEC128,
+    SIMD_LEVEL_AVX2,
+} SimdLevel;
+
+typedef enum SimdCmp {
+    SIMD_CMP_EQ,
+    SIMD_CMP_NE,
+    SIMD_CMP_LT,
+    SIMD_CMP_LE,
+    SIMD_CMP_GT,
+    SIMD_CMP_GE,
+} SimdCmp;
+
+typedef enum SimdKind {
+    SIMD_KIND_NONE,
+    SIMD_KIND_I32,
+    SIMD_KIND_U32,
+    SIMD_KIND_I64,
+    SIMD_KIND_U64,
+    SIMD_KIND_F32,
+    SIMD_KIND_F64,
+} SimdKind;
+
+#undef SIMD_KIND
+#define SIMD_KIND(T)                                                           \
+    (TYPE_IS_SIGNED_INTEGER(T) && sizeof(T) == 4     ? SIMD_KIND_I32           \
+     : TYPE_IS_UNSIGNED_INTEGER(T) && sizeof(T) == 4 ? SIMD_KIND_U32           \
+     : TYPE_IS_SIGNED_INTEGER(T) && sizeof(T) == 8   ? SIMD_KIND_I64           \
+     : TYPE_IS_UNSIGNED_INTEGER(T) && sizeof(T) == 8 ? SIMD_KIND_U64           \
+     : __builtin_types_compatible_p(T, f32)          ? SIMD_KIND_F32           \
+     : __builtin_types_compatible_p(T, f64)          ? SIMD_KIND_F64           \
+                                                     : SIMD_KIND_NONE)
+
+#undef SIMD_SUM_TYPE
+#define SIMD_SUM_TYPE(T)                                                       \
+    typeof(__builtin_choose_expr(                                              \
+        TYPE_IS_SIGNED_INTEGER(T), (i64)0,                                     \
+        __builtin_choose_expr(TYPE_IS_UNSIGNED_INTEGER(T), (u64)0, (f64)0)))
+
+/// value i of a packed block is in the lane i % SIMD_PACK_LANES, whose words
+/// are interleaved with the other lanes, so that the values decoded together
+/// share their shifts and are stored next to each other
+#undef SIMD_PACK_BLOCK
+#define SIMD_PACK_BLOCK 128
+
+#undef SIMD_PACK_LANES
+#define SIMD_PACK_LANES 4
+
+#undef SIMD_PACK_WORDS
+#define SIMD_PACK_WORDS(bits) (SIMD_PACK_LANES * (((usize)(bits) + 1) / 2))
+
+/* Simd::level() -> SimdLevel */
+SimdLevel NSMTD(Simd, level, /);
+
+/* Simd::set_level(SimdLevel level) */
+void NSMTD(Simd, set_level, /, SimdLevel level);
+
+#undef DECLARE_SIMD_KERNELS
+#define DECLARE_SIMD_KERNELS(Suffix, T, S)                                     \
+    usize NSMTD(Simd, CONCATENATE(find_, Suffix), /, const T *data, usize n,   \
+                T value);                                                      \
+    usize NSMTD(Simd, CONCATENATE(count_, Suffix), /, const T *data, usize n,  \
+                T value);                                                      \
+    void NSMTD(Simd, CONCATENATE(minmax_, Suffix), /, const T *data, usize n,  \
+               T *min, T *max);                                                \
+    S NSMTD(Simd, CONCATENATE(sum_, Suffix), /, const T *data, usize n);       \
+    usize NSMTD(Simd, CONCATENATE(filter_, Suffix), /, const T *data, usize n, \
+                SimdCmp cmp, T value, T *out);
+
+DECLARE_SIMD_KERNELS(i32, i32, i64);
+DECLARE_SIMD_KERNELS(u32, u32, u64);
+DECLARE_SIMD_KERNELS(i64, i64, i64);
+DECLARE_SIMD_KERNELS(u64, u64, u64);
+DECLARE_SIMD_KERNELS(f32, f32, f64);
+DECLARE_SIMD_KERNELS(f64, f64, f64);
+
+/* Simd::and_u64(u64 *dst, const u64 *src, usize n) */
+void NSMTD(Simd, and_u64, /, u64 *dst, const u64 *src, usize n);
+
+/* Simd::or_u64(u64 *dst, const u64 *src, usize n) */
+void NSMTD(Simd, or_u64, /, u64 *dst, const u64 *src, usize n);
+
+/* Simd::xor_u64(u64 *dst, const u64 *src, usize n) */
+void NSMTD(Simd, xor_u64, /, u64 *dst, const u64 *src, usize n);
+
+/* Simd::andnot_u64(u64 *dst, const u64 *src, usize n) */
+void NSMTD(Simd, andnot_u64, /, u64 *dst, const u64 *src, usize n);
+
+/* Simd::popcount_u64(const u64 *data, usize n) -> usize */
+usize NSMTD(Simd, popcount_u64, /, const u64 *data, usize n);
+
+/* Simd::pack_u64(const u64 *values, u32 bits, u64 base, bool delta, u64 *words) */
+void NSMTD(Simd, pack_u64, /, const u64 *values, u32 bits, u64 base,
+           bool delta, u64 *words);
+
+/* Simd::unpack_u64(const u64 *words, u32 bits, u64 base, bool delta, u64 *out) */
+void NSMTD(Simd, unpack_u64, /, const u64 *words, u32 bits, u64 base,
+           bool delta, u64 *out);
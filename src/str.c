@@ -6,6 +6,7 @@
 #include "tem_vec.h"
 
 DEFINE_PLAIN_VEC(String, char, extern);
+DEFINE_COW_VEC(CowString, String, char, extern);
 
 String NSMTD(String, from_raw, /, const char *s) {
     String ret = CREOBJ(String, /);
@@ -101,3 +102,12 @@ int NSMTD(HString, compare, /, const HString *a, const HString *b) {
     }
     return NSCALL(String, compare, /, &a->s, &b->s);
 }
+
+const char *MTD(CowString, c_str, /) {
+    const String *s = CALL(CowString, *self, view, /);
+    if (s->size < s->capacity && s->data[s->size] == '\0') {
+        return s->data;
+    }
+    String *mut = CALL(CowString, *self, make_mut, /);
+    return CALL(String, *mut, c_str, /);
+}
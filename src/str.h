@@ -13,15 +13,22 @@
 ///     String.pushf(const char *format, ...) -> int: appends a formatted string to the string
 ///     String.pushfv(const char *format, va_list args) -> int: appends a formatted string with va_list to the string
 ///     String::compare(const String *a, const String *b) -> int: compares two strings
+///     String.hash() const -> u64: hashes the string, for hashed containers (see GENERATOR_CLASS_HASH)
 ///
 /// Macros:
 ///     STRING_C_STR(s): returns the C string of the string s
+///
+/// CowString is a copy-on-write String (see tem_cow_vec.h), whose clones share one buffer; it provides in addition:
+///
+///     CowString.c_str() -> const char *: returns the string as a C string, copying it only if it is not terminated
 
 #pragma once
 
 #include <stdarg.h>
 
 #include "utils.h"
+#include "tem_cow_vec.h"
+#include "tem_memory_primitive.h"
 #include "tem_vec.h"
 
 DECLARE_PLAIN_VEC(String, char, extern);
@@ -58,6 +65,11 @@ int MTD(String, pushfv, /, const char *format, va_list args) __attribute__((form
 /* String.compare(const String *a, const String *b) -> int */
 int NSMTD(String, compare, /, const String *a, const String *b);
 
+/* String.hash() const -> u64 */
+FUNC_STATIC u64 MTDCONST(String, hash, /) {
+    return NSCALL(Hash, bytes, /, self->data, self->size);
+}
+
 #undef STRING_C_STR
 #define STRING_C_STR(s) CALL(String, s, c_str, /)
 
@@ -102,3 +114,11 @@ FUNC_STATIC HString NSMTD(HString, from_inner, /, String s) {
 }
 
 int NSMTD(HString, compare, /, const HString *a, const HString *b);
+
+/// CowString: a copy-on-write String, see tem_cow_vec.h
+
+DECLARE_COW_VEC(CowString, String, char, extern);
+
+/// Reads a terminated buffer in place, so shared strings are not copied
+/* CowString.c_str() -> const char * */
+const char *MTD(CowString, c_str, /);
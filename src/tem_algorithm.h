@@ -0,0 +1,564 @@
+// clang-format off
+/// tem_algorithm.h: provides templates of sorting and searching algorithms over slices (T *data, usize n).
+///
+/// Macros:
+///     DECLARE_SLICE_ALGORITHM(Ns, T, STORAGE, com_gen): declare the algorithms in namespace Ns.
+///         com_gen: define the comparator generator.
+///         - GENERATOR_PLAIN_COMPARATOR: define a plain comparator generator.
+///         - GENERATOR_CLASS_COMPARATOR: define a class comparator generator.
+///         - GENERATOR_CUSTOM_COMPARATOR: define a custom comparator generator.
+///     DEFINE_SLICE_ALGORITHM(Ns, T, STORAGE): define the algorithms in namespace Ns.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+///     The comparator is called directly (not through a function pointer), so
+///     it is inlined into the algorithms. Elements are moved bitwise, which is
+///     valid for both plain and class types.
+///
+/// Algorithms:
+///     Ns::sort_slice(T *data, usize n): sort the slice, not stable (pattern-defeating quicksort).
+///     Ns::stable_sort_slice(T *data, usize n): sort the slice, stable (merge sort).
+///     Ns::is_sorted_slice(const T *data, usize n) -> bool: check if the slice is sorted.
+///     Ns::lower_bound_slice(const T *data, usize n, const T *key) -> usize: the first index whose element >= key.
+///     Ns::upper_bound_slice(const T *data, usize n, const T *key) -> usize: the first index whose element > key.
+///     Ns::binary_search_slice(const T *data, usize n, const T *key) -> usize: the index of an element == key, or n.
+///     Ns::dedup_slice(T *data, usize n) -> usize: move consecutive duplicates to the tail, and return the length of
+///         the remaining prefix.
+///
+///     When the comparator is the natural order (GENERATOR_PLAIN_COMPARATOR)
+///     over an integer type, the sorts of large slices use LSD radix sort.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+/// slices shorter than this are sorted by insertion sort
+#undef SLICE_ALGORITHM_INSERTION_THRESHOLD
+#define SLICE_ALGORITHM_INSERTION_THRESHOLD 24
+
+/// slices not shorter than this are sorted by radix sort, if applicable
+#undef SLICE_ALGORITHM_RADIX_THRESHOLD
+#define SLICE_ALGORITHM_RADIX_THRESHOLD 512
+
+#undef DECLARE_SLICE_ALGORITHM
+#define DECLARE_SLICE_ALGORITHM(Ns, T, STORAGE, com_gen)                       \
+    DECLARE_SLICE_ALGORITHM_INNER(Ns, typeof(T), STORAGE);                     \
+    com_gen(Ns, T);
+
+#undef DEFINE_SLICE_ALGORITHM
+#define DEFINE_SLICE_ALGORITHM(Ns, T, STORAGE)                                 \
+    DEFINE_SLICE_ALGORITHM_INNER(Ns, typeof(T), STORAGE);
+
+#undef DECLARE_SLICE_ALGORITHM_INNER
+#define DECLARE_SLICE_ALGORITHM_INNER(Ns, T, STORAGE)                          \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* Ns::comparator(const T *a, const T *b) -> int */                        \
+    FUNC_STATIC int NSMTD(Ns, comparator, /, const T *a, const T *b);          \
+                                                                               \
+    /* Ns::natural_order() -> bool */                                          \
+    FUNC_STATIC bool NSMTD(Ns, natural_order, /);                              \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* Ns::sort_slice(T *data, usize n) */                                     \
+    STORAGE void NSMTD(Ns, sort_slice, /, T * data, usize n);                  \
+                                                                               \
+    /* Ns::stable_sort_slice(T *data, usize n) */                              \
+    STORAGE void NSMTD(Ns, stable_sort_slice, /, T * data, usize n);           \
+                                                                               \
+    /* Ns::is_sorted_slice(const T *data, usize n) -> bool */                  \
+    STORAGE bool NSMTD(Ns, is_sorted_slice, /, const T *data, usize n);        \
+                                                                               \
+    /* Ns::lower_bound_slice(const T *data, usize n, const T *key) -> usize */ \
+    STORAGE usize NSMTD(Ns, lower_bound_slice, /, const T *data, usize n,      \
+                        const T *key);                                         \
+                                                                               \
+    /* Ns::upper_bound_slice(const T *data, usize n, const T *key) -> usize */ \
+    STORAGE usize NSMTD(Ns, upper_bound_slice, /, const T *data, usize n,      \
+                        const T *key);                                         \
+                                                                               \
+    /* Ns::binary_search_slice(const T *data, usize n, const T *key) -> usize  \
+     */                                                                        \
+    STORAGE usize NSMTD(Ns, binary_search_slice, /, const T *data, usize n,    \
+                        const T *key);                                         \
+                                                                               \
+    /* Ns::dedup_slice(T *data, usize n) -> usize */                           \
+    STORAGE usize NSMTD(Ns, dedup_slice, /, T * data, usize n);
+
+#undef DEFINE_SLICE_ALGORITHM_INNER
+#define DEFINE_SLICE_ALGORITHM_INNER(Ns, T, STORAGE)                           \
+    /* Ns::algo_less(const T *a, const T *b) -> bool */                        \
+    FUNC_STATIC bool NSMTD(Ns, algo_less, /, const T *MPROT(a),                \
+                           const T *MPROT(b)) {                                \
+        return NSCALL(Ns, comparator, /, MPROT(a), MPROT(b)) < 0;              \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_swap(T *a, T *b) */                                            \
+    FUNC_STATIC void NSMTD(Ns, algo_swap, /, T *MPROT(a), T *MPROT(b)) {       \
+        T MPROT(tmp) = *MPROT(a);                                              \
+        *MPROT(a) = *MPROT(b);                                                 \
+        *MPROT(b) = MPROT(tmp);                                                \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_sort2(T *a, T *b) */                                           \
+    FUNC_STATIC void NSMTD(Ns, algo_sort2, /, T *MPROT(a), T *MPROT(b)) {      \
+        if (NSCALL(Ns, algo_less, /, MPROT(b), MPROT(a))) {                    \
+            NSCALL(Ns, algo_swap, /, MPROT(a), MPROT(b));                      \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_sort3(T *a, T *b, T *c) */                                     \
+    FUNC_STATIC void NSMTD(Ns, algo_sort3, /, T *MPROT(a), T *MPROT(b),        \
+                           T *MPROT(c)) {                                      \
+        NSCALL(Ns, algo_sort2, /, MPROT(a), MPROT(b));                         \
+        NSCALL(Ns, algo_sort2, /, MPROT(b), MPROT(c));                         \
+        NSCALL(Ns, algo_sort2, /, MPROT(a), MPROT(b));                         \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_insertion_sort(T *data, usize n) */                            \
+    static void NSMTD(Ns, algo_insertion_sort, /, T *MPROT(data),              \
+                      usize MPROT(n)) {                                        \
+        for (usize i = 1; i < MPROT(n); i++) {                                 \
+            if (!NSCALL(Ns, algo_less, /, &MPROT(data)[i],                     \
+                        &MPROT(data)[i - 1])) {                                \
+                continue;                                                      \
+            }                                                                  \
+            T MPROT(tmp) = MPROT(data)[i];                                     \
+            usize j = i;                                                       \
+            do {                                                               \
+                MPROT(data)[j] = MPROT(data)[j - 1];                           \
+                j--;                                                           \
+            } while (j > 0 && NSCALL(Ns, algo_less, /, &MPROT(tmp),            \
+                                     &MPROT(data)[j - 1]));                    \
+            MPROT(data)[j] = MPROT(tmp);                                       \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_partial_insertion_sort(T *data, usize n) -> bool; gives up     \
+     * and returns false after moving too many elements */                     \
+    static bool NSMTD(Ns, algo_partial_insertion_sort, /, T *MPROT(data),      \
+                      usize MPROT(n)) {                                        \
+        usize MPROT(moved) = 0;                                                \
+        for (usize i = 1; i < MPROT(n); i++) {                                 \
+            if (MPROT(moved) > 8) {                                            \
+                return false;                                                  \
+            }                                                                  \
+            if (!NSCALL(Ns, algo_less, /, &MPROT(data)[i],                     \
+                        &MPROT(data)[i - 1])) {                                \
+                continue;                                                      \
+            }                                                                  \
+            T MPROT(tmp) = MPROT(data)[i];                                     \
+            usize j = i;                                                       \
+            do {                                                               \
+                MPROT(data)[j] = MPROT(data)[j - 1];                           \
+                j--;                                                           \
+            } while (j > 0 && NSCALL(Ns, algo_less, /, &MPROT(tmp),            \
+                                     &MPROT(data)[j - 1]));                    \
+            MPROT(data)[j] = MPROT(tmp);                                       \
+            MPROT(moved) += i - j;                                             \
+        }                                                                      \
+        return true;                                                           \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_sift_down(T *data, usize n, usize i) */                        \
+    static void NSMTD(Ns, algo_sift_down, /, T *MPROT(data), usize MPROT(n),   \
+                      usize MPROT(i)) {                                        \
+        while (true) {                                                         \
+            usize MPROT(child) = 2 * MPROT(i) + 1;                             \
+            if (MPROT(child) >= MPROT(n)) {                                    \
+                return;                                                        \
+            }                                                                  \
+            if (MPROT(child) + 1 < MPROT(n) &&                                 \
+                NSCALL(Ns, algo_less, /, &MPROT(data)[MPROT(child)],           \
+                       &MPROT(data)[MPROT(child) + 1])) {                      \
+                MPROT(child)++;                                                \
+            }                                                                  \
+            if (!NSCALL(Ns, algo_less, /, &MPROT(data)[MPROT(i)],              \
+                        &MPROT(data)[MPROT(child)])) {                         \
+                return;                                                        \
+            }                                                                  \
+            NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(i)],                   \
+                   &MPROT(data)[MPROT(child)]);                                \
+            MPROT(i) = MPROT(child);                                           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_heap_sort(T *data, usize n) */                                 \
+    static void NSMTD(Ns, algo_heap_sort, /, T *MPROT(data), usize MPROT(n)) { \
+        for (usize i = MPROT(n) / 2; i-- > 0;) {                               \
+            NSCALL(Ns, algo_sift_down, /, MPROT(data), MPROT(n), i);           \
+        }                                                                      \
+        for (usize i = MPROT(n); i-- > 1;) {                                   \
+            NSCALL(Ns, algo_swap, /, &MPROT(data)[0], &MPROT(data)[i]);        \
+            NSCALL(Ns, algo_sift_down, /, MPROT(data), i, 0);                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_partition_right(T *data, usize n, bool *partitioned) ->        \
+     * usize; data[0] is the pivot, and there must be an element >= pivot      \
+     * after it. Elements equal to the pivot go to the right. */               \
+    static usize NSMTD(Ns, algo_partition_right, /, T *MPROT(data),            \
+                       usize MPROT(n), bool *MPROT(partitioned)) {             \
+        T MPROT(pivot) = MPROT(data)[0];                                       \
+        usize MPROT(first) = 0;                                                \
+        usize MPROT(last) = MPROT(n);                                          \
+        while (NSCALL(Ns, algo_less, /, &MPROT(data)[++MPROT(first)],          \
+                      &MPROT(pivot))) {                                        \
+        }                                                                      \
+        if (MPROT(first) == 1) {                                               \
+            while (MPROT(first) < MPROT(last) &&                               \
+                   !NSCALL(Ns, algo_less, /, &MPROT(data)[--MPROT(last)],      \
+                           &MPROT(pivot))) {                                   \
+            }                                                                  \
+        } else {                                                               \
+            while (!NSCALL(Ns, algo_less, /, &MPROT(data)[--MPROT(last)],      \
+                           &MPROT(pivot))) {                                   \
+            }                                                                  \
+        }                                                                      \
+        *MPROT(partitioned) = MPROT(first) >= MPROT(last);                     \
+        while (MPROT(first) < MPROT(last)) {                                   \
+            NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(first)],               \
+                   &MPROT(data)[MPROT(last)]);                                 \
+            while (NSCALL(Ns, algo_less, /, &MPROT(data)[++MPROT(first)],      \
+                          &MPROT(pivot))) {                                    \
+            }                                                                  \
+            while (!NSCALL(Ns, algo_less, /, &MPROT(data)[--MPROT(last)],      \
+                           &MPROT(pivot))) {                                   \
+            }                                                                  \
+        }                                                                      \
+        usize MPROT(pivot_pos) = MPROT(first) - 1;                             \
+        MPROT(data)[0] = MPROT(data)[MPROT(pivot_pos)];                        \
+        MPROT(data)[MPROT(pivot_pos)] = MPROT(pivot);                          \
+        return MPROT(pivot_pos);                                               \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_partition_left(T *data, usize n) -> usize; data[0] is the      \
+     * pivot. Elements equal to the pivot go to the left. */                   \
+    static usize NSMTD(Ns, algo_partition_left, /, T *MPROT(data),             \
+                       usize MPROT(n)) {                                       \
+        T MPROT(pivot) = MPROT(data)[0];                                       \
+        usize MPROT(first) = 0;                                                \
+        usize MPROT(last) = MPROT(n);                                          \
+        while (NSCALL(Ns, algo_less, /, &MPROT(pivot),                         \
+                      &MPROT(data)[--MPROT(last)])) {                          \
+        }                                                                      \
+        if (MPROT(last) + 1 == MPROT(n)) {                                     \
+            while (MPROT(first) < MPROT(last) &&                               \
+                   !NSCALL(Ns, algo_less, /, &MPROT(pivot),                    \
+                           &MPROT(data)[++MPROT(first)])) {                    \
+            }                                                                  \
+        } else {                                                               \
+            while (!NSCALL(Ns, algo_less, /, &MPROT(pivot),                    \
+                           &MPROT(data)[++MPROT(first)])) {                    \
+            }                                                                  \
+        }                                                                      \
+        while (MPROT(first) < MPROT(last)) {                                   \
+            NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(first)],               \
+                   &MPROT(data)[MPROT(last)]);                                 \
+            while (NSCALL(Ns, algo_less, /, &MPROT(pivot),                     \
+                          &MPROT(data)[--MPROT(last)])) {                      \
+            }                                                                  \
+            while (!NSCALL(Ns, algo_less, /, &MPROT(pivot),                    \
+                           &MPROT(data)[++MPROT(first)])) {                    \
+            }                                                                  \
+        }                                                                      \
+        MPROT(data)[0] = MPROT(data)[MPROT(last)];                             \
+        MPROT(data)[MPROT(last)] = MPROT(pivot);                               \
+        return MPROT(last);                                                    \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_pdq_loop(T *data, usize n, int bad_allowed, bool leftmost) */  \
+    static void NSMTD(Ns, algo_pdq_loop, /, T *MPROT(data), usize MPROT(n),    \
+                      int MPROT(bad_allowed), bool MPROT(leftmost)) {          \
+        while (true) {                                                         \
+            if (MPROT(n) < SLICE_ALGORITHM_INSERTION_THRESHOLD) {              \
+                NSCALL(Ns, algo_insertion_sort, /, MPROT(data), MPROT(n));     \
+                return;                                                        \
+            }                                                                  \
+                                                                               \
+            /* choose the pivot: median of 3, or pseudo-median of 9 */         \
+            usize MPROT(half) = MPROT(n) / 2;                                  \
+            if (MPROT(n) > 128) {                                              \
+                NSCALL(Ns, algo_sort3, /, &MPROT(data)[0],                     \
+                       &MPROT(data)[MPROT(half)], &MPROT(data)[MPROT(n) - 1]); \
+                NSCALL(Ns, algo_sort3, /, &MPROT(data)[1],                     \
+                       &MPROT(data)[MPROT(half) - 1],                          \
+                       &MPROT(data)[MPROT(n) - 2]);                            \
+                NSCALL(Ns, algo_sort3, /, &MPROT(data)[2],                     \
+                       &MPROT(data)[MPROT(half) + 1],                          \
+                       &MPROT(data)[MPROT(n) - 3]);                            \
+                NSCALL(Ns, algo_sort3, /, &MPROT(data)[MPROT(half) - 1],       \
+                       &MPROT(data)[MPROT(half)],                              \
+                       &MPROT(data)[MPROT(half) + 1]);                         \
+                NSCALL(Ns, algo_swap, /, &MPROT(data)[0],                      \
+                       &MPROT(data)[MPROT(half)]);                             \
+            } else {                                                           \
+                NSCALL(Ns, algo_sort3, /, &MPROT(data)[MPROT(half)],           \
+                       &MPROT(data)[0], &MPROT(data)[MPROT(n) - 1]);           \
+            }                                                                  \
+                                                                               \
+            /* the pivot equals to the element before the slice, so all the    \
+             * elements equal to the pivot can be skipped */                   \
+            if (!MPROT(leftmost) &&                                            \
+                !NSCALL(Ns, algo_less, /, &MPROT(data)[-1],                    \
+                        &MPROT(data)[0])) {                                    \
+                usize MPROT(pos) =                                             \
+                    NSCALL(Ns, algo_partition_left, /, MPROT(data), MPROT(n)); \
+                MPROT(data) += MPROT(pos) + 1;                                 \
+                MPROT(n) -= MPROT(pos) + 1;                                    \
+                continue;                                                      \
+            }                                                                  \
+                                                                               \
+            bool MPROT(partitioned) = false;                                   \
+            usize MPROT(pos) = NSCALL(Ns, algo_partition_right, /,             \
+                                      MPROT(data), MPROT(n),                   \
+                                      &MPROT(partitioned));                    \
+            usize MPROT(l_size) = MPROT(pos);                                  \
+            usize MPROT(r_size) = MPROT(n) - MPROT(pos) - 1;                   \
+                                                                               \
+            if (MPROT(l_size) < MPROT(n) / 8 ||                                \
+                MPROT(r_size) < MPROT(n) / 8) {                                \
+                /* highly unbalanced: fall back to heap sort if it happens     \
+                 * too often, otherwise shuffle some elements */               \
+                if (--MPROT(bad_allowed) == 0) {                               \
+                    NSCALL(Ns, algo_heap_sort, /, MPROT(data), MPROT(n));      \
+                    return;                                                    \
+                }                                                              \
+                if (MPROT(l_size) >= SLICE_ALGORITHM_INSERTION_THRESHOLD) {    \
+                    NSCALL(Ns, algo_swap, /, &MPROT(data)[0],                  \
+                           &MPROT(data)[MPROT(l_size) / 4]);                   \
+                    NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(pos) - 1],     \
+                           &MPROT(data)[MPROT(pos) - MPROT(l_size) / 4]);      \
+                }                                                              \
+                if (MPROT(r_size) >= SLICE_ALGORITHM_INSERTION_THRESHOLD) {    \
+                    NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(pos) + 1],     \
+                           &MPROT(data)[MPROT(pos) + 1 + MPROT(r_size) / 4]);  \
+                    NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(n) - 1],       \
+                           &MPROT(data)[MPROT(n) - MPROT(r_size) / 4]);        \
+                }                                                              \
+            } else if (MPROT(partitioned) &&                                   \
+                       NSCALL(Ns, algo_partial_insertion_sort, /, MPROT(data), \
+                              MPROT(l_size)) &&                                \
+                       NSCALL(Ns, algo_partial_insertion_sort, /,              \
+                              MPROT(data) + MPROT(pos) + 1, MPROT(r_size))) {  \
+                /* the slice was likely sorted already */                      \
+                return;                                                        \
+            }                                                                  \
+                                                                               \
+            NSCALL(Ns, algo_pdq_loop, /, MPROT(data), MPROT(l_size),           \
+                   MPROT(bad_allowed), MPROT(leftmost));                       \
+            MPROT(data) += MPROT(pos) + 1;                                     \
+            MPROT(n) = MPROT(r_size);                                          \
+            MPROT(leftmost) = false;                                           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_radix_applicable(usize n) -> bool */                           \
+    FUNC_STATIC bool NSMTD(Ns, algo_radix_applicable, /, usize MPROT(n)) {     \
+        return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ &&                    \
+               NSCALL(Ns, natural_order, /) && TYPE_IS_INTEGER(T) &&           \
+               MPROT(n) >= SLICE_ALGORITHM_RADIX_THRESHOLD;                    \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_radix_key(const T *elem) -> u64 */                             \
+    FUNC_STATIC u64 NSMTD(Ns, algo_radix_key, /, const T *MPROT(elem)) {       \
+        enum { MPROT(passes) = sizeof(T) < sizeof(u64) ? sizeof(T) : 8 };      \
+        u64 MPROT(key) = 0;                                                    \
+        memcpy(&MPROT(key), MPROT(elem), MPROT(passes));                       \
+        if (TYPE_IS_SIGNED_INTEGER(T)) {                                       \
+            MPROT(key) ^= (u64)1 << (MPROT(passes) * 8 - 1);                   \
+        }                                                                      \
+        return MPROT(key);                                                     \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_radix_sort(T *data, usize n); LSD radix sort, stable */        \
+    static void NSMTD(Ns, algo_radix_sort, /, T *MPROT(data),                  \
+                      usize MPROT(n)) {                                        \
+        enum { MPROT(passes) = sizeof(T) < sizeof(u64) ? sizeof(T) : 8 };      \
+        usize MPROT(count)[MPROT(passes)][256];                                \
+        memset(MPROT(count), 0, sizeof(MPROT(count)));                         \
+        for (usize i = 0; i < MPROT(n); i++) {                                 \
+            u64 MPROT(key) = NSCALL(Ns, algo_radix_key, /, &MPROT(data)[i]);   \
+            for (usize p = 0; p < MPROT(passes); p++) {                        \
+                MPROT(count)[p][(MPROT(key) >> (p * 8)) & 0xff]++;             \
+            }                                                                  \
+        }                                                                      \
+        T *MPROT(buf) = (T *)malloc(MPROT(n) * sizeof(T));                     \
+        ASSERT(MPROT(buf));                                                    \
+        T *MPROT(src) = MPROT(data);                                           \
+        T *MPROT(dst) = MPROT(buf);                                            \
+        for (usize p = 0; p < MPROT(passes); p++) {                            \
+            usize *MPROT(cnt) = MPROT(count)[p];                               \
+            u64 MPROT(first_byte) =                                            \
+                (NSCALL(Ns, algo_radix_key, /, &MPROT(src)[0]) >> (p * 8)) &   \
+                0xff;                                                          \
+            if (MPROT(cnt)[MPROT(first_byte)] == MPROT(n)) {                   \
+                /* all the elements share this byte */                         \
+                continue;                                                      \
+            }                                                                  \
+            usize MPROT(offset) = 0;                                           \
+            for (usize b = 0; b < 256; b++) {                                  \
+                usize MPROT(c) = MPROT(cnt)[b];                                \
+                MPROT(cnt)[b] = MPROT(offset);                                 \
+                MPROT(offset) += MPROT(c);                                     \
+            }                                                                  \
+            for (usize i = 0; i < MPROT(n); i++) {                             \
+                u64 MPROT(byte) =                                              \
+                    (NSCALL(Ns, algo_radix_key, /, &MPROT(src)[i]) >>          \
+                     (p * 8)) &                                                \
+                    0xff;                                                      \
+                MPROT(dst)[MPROT(cnt)[MPROT(byte)]++] = MPROT(src)[i];         \
+            }                                                                  \
+            T *MPROT(tmp) = MPROT(src);                                        \
+            MPROT(src) = MPROT(dst);                                           \
+            MPROT(dst) = MPROT(tmp);                                           \
+        }                                                                      \
+        if (MPROT(src) != MPROT(data)) {                                       \
+            memcpy(MPROT(data), MPROT(src), MPROT(n) * sizeof(T));             \
+        }                                                                      \
+        free(MPROT(buf));                                                      \
+    }                                                                          \
+                                                                               \
+    /* Ns::algo_merge_sort(T *data, usize n, T *buf); buf holds n / 2 */       \
+    static void NSMTD(Ns, algo_merge_sort, /, T *MPROT(data), usize MPROT(n),  \
+                      T *MPROT(buf)) {                                         \
+        if (MPROT(n) < SLICE_ALGORITHM_INSERTION_THRESHOLD) {                  \
+            NSCALL(Ns, algo_insertion_sort, /, MPROT(data), MPROT(n));         \
+            return;                                                            \
+        }                                                                      \
+        usize MPROT(mid) = MPROT(n) / 2;                                       \
+        NSCALL(Ns, algo_merge_sort, /, MPROT(data), MPROT(mid), MPROT(buf));   \
+        NSCALL(Ns, algo_merge_sort, /, MPROT(data) + MPROT(mid),               \
+               MPROT(n) - MPROT(mid), MPROT(buf));                             \
+        if (!NSCALL(Ns, algo_less, /, &MPROT(data)[MPROT(mid)],                \
+                    &MPROT(data)[MPROT(mid) - 1])) {                           \
+            return;                                                            \
+        }                                                                      \
+        memcpy(MPROT(buf), MPROT(data), MPROT(mid) * sizeof(T));               \
+        usize i = 0, j = MPROT(mid), k = 0;                                    \
+        while (i < MPROT(mid) && j < MPROT(n)) {                               \
+            if (NSCALL(Ns, algo_less, /, &MPROT(data)[j], &MPROT(buf)[i])) {   \
+                MPROT(data)[k++] = MPROT(data)[j++];                           \
+            } else {                                                           \
+                MPROT(data)[k++] = MPROT(buf)[i++];                            \
+            }                                                                  \
+        }                                                                      \
+        while (i < MPROT(mid)) {                                               \
+            MPROT(data)[k++] = MPROT(buf)[i++];                                \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Implement the interface */                                              \
+                                                                               \
+    STORAGE void NSMTD(Ns, sort_slice, /, T *MPROT(data), usize MPROT(n)) {    \
+        if (NSCALL(Ns, algo_radix_applicable, /, MPROT(n))) {                  \
+            NSCALL(Ns, algo_radix_sort, /, MPROT(data), MPROT(n));             \
+            return;                                                            \
+        }                                                                      \
+        int MPROT(bad_allowed) = 1;                                            \
+        for (usize MPROT(m) = MPROT(n); MPROT(m) > 1; MPROT(m) >>= 1) {        \
+            MPROT(bad_allowed)++;                                              \
+        }                                                                      \
+        NSCALL(Ns, algo_pdq_loop, /, MPROT(data), MPROT(n),                    \
+               MPROT(bad_allowed), true);                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void NSMTD(Ns, stable_sort_slice, /, T *MPROT(data),               \
+                       usize MPROT(n)) {                                       \
+        if (NSCALL(Ns, algo_radix_applicable, /, MPROT(n))) {                  \
+            NSCALL(Ns, algo_radix_sort, /, MPROT(data), MPROT(n));             \
+            return;                                                            \
+        }                                                                      \
+        if (MPROT(n) < SLICE_ALGORITHM_INSERTION_THRESHOLD) {                  \
+            NSCALL(Ns, algo_insertion_sort, /, MPROT(data), MPROT(n));         \
+            return;                                                            \
+        }                                                                      \
+        T *MPROT(buf) = (T *)malloc(MPROT(n) / 2 * sizeof(T));                 \
+        ASSERT(MPROT(buf));                                                    \
+        NSCALL(Ns, algo_merge_sort, /, MPROT(data), MPROT(n), MPROT(buf));     \
+        free(MPROT(buf));                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE bool NSMTD(Ns, is_sorted_slice, /, const T *MPROT(data),           \
+                       usize MPROT(n)) {                                       \
+        for (usize i = 1; i < MPROT(n); i++) {                                 \
+            if (NSCALL(Ns, algo_less, /, &MPROT(data)[i],                      \
+                       &MPROT(data)[i - 1])) {                                 \
+                return false;                                                  \
+            }                                                                  \
+        }                                                                      \
+        return true;                                                           \
+    }                                                                          \
+                                                                               \
+    STORAGE usize NSMTD(Ns, lower_bound_slice, /, const T *MPROT(data),        \
+                        usize MPROT(n), const T *MPROT(key)) {                 \
+        usize MPROT(lo) = 0;                                                   \
+        usize MPROT(len) = MPROT(n);                                           \
+        while (MPROT(len) > 0) {                                               \
+            usize MPROT(half) = MPROT(len) / 2;                                \
+            if (NSCALL(Ns, algo_less, /,                                       \
+                       &MPROT(data)[MPROT(lo) + MPROT(half)], MPROT(key))) {   \
+                MPROT(lo) += MPROT(half) + 1;                                  \
+                MPROT(len) -= MPROT(half) + 1;                                 \
+            } else {                                                           \
+                MPROT(len) = MPROT(half);                                      \
+            }                                                                  \
+        }                                                                      \
+        return MPROT(lo);                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE usize NSMTD(Ns, upper_bound_slice, /, const T *MPROT(data),        \
+                        usize MPROT(n), const T *MPROT(key)) {                 \
+        usize MPROT(lo) = 0;                                                   \
+        usize MPROT(len) = MPROT(n);                                           \
+        while (MPROT(len) > 0) {                                               \
+            usize MPROT(half) = MPROT(len) / 2;                                \
+            if (!NSCALL(Ns, algo_less, /, MPROT(key),                          \
+                        &MPROT(data)[MPROT(lo) + MPROT(half)])) {              \
+                MPROT(lo) += MPROT(half) + 1;                                  \
+                MPROT(len) -= MPROT(half) + 1;                                 \
+            } else {                                                           \
+                MPROT(len) = MPROT(half);                                      \
+            }                                                                  \
+        }                                                                      \
+        return MPROT(lo);                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE usize NSMTD(Ns, binary_search_slice, /, const T *MPROT(data),      \
+                        usize MPROT(n), const T *MPROT(key)) {                 \
+        usize MPROT(pos) = NSCALL(Ns, lower_bound_slice, /, MPROT(data),       \
+                                  MPROT(n), MPROT(key));                       \
+        if (MPROT(pos) < MPROT(n) &&                                           \
+            NSCALL(Ns, comparator, /, &MPROT(data)[MPROT(pos)], MPROT(key)) == \
+                0) {                                                           \
+            return MPROT(pos);                                                 \
+        }                                                                      \
+        return MPROT(n);                                                       \
+    }                                                                          \
+                                                                               \
+    STORAGE usize NSMTD(Ns, dedup_slice, /, T *MPROT(data), usize MPROT(n)) {  \
+        if (MPROT(n) == 0) {                                                   \
+            return 0;                                                          \
+        }                                                                      \
+        usize MPROT(kept) = 1;                                                 \
+        for (usize i = 1; i < MPROT(n); i++) {                                 \
+            if (NSCALL(Ns, comparator, /, &MPROT(data)[MPROT(kept) - 1],       \
+                       &MPROT(data)[i]) == 0) {                                \
+                continue;                                                      \
+            }                                                                  \
+            if (i != MPROT(kept)) {                                            \
+                NSCALL(Ns, algo_swap, /, &MPROT(data)[MPROT(kept)],            \
+                       &MPROT(data)[i]);                                       \
+            }                                                                  \
+            MPROT(kept)++;                                                     \
+        }                                                                      \
+        return MPROT(kept);                                                    \
+    }
@@ -0,0 +1,290 @@
+// clang-format off
+/// tem_bitvec.h: provides a template for implementing a packed bit vector.
+///
+/// The bits are packed in 64-bit words; the bits beyond the size in the last word are always zero, so that the bulk
+/// operations work on whole words, dispatched to the vectorized kernels of simd.h.
+///
+/// Macros:
+///     DECLARE_BITVEC(BitVec, STORAGE): declare a bit vector.
+///     DEFINE_BITVEC(BitVec, STORAGE): define a bit vector.
+///     BITVEC_FOR_EACH_SET_BIT(bv, index): iterate over the indices of the set bits of bv in increasing order, e.g.
+///         BITVEC_FOR_EACH_SET_BIT(bv, i) { ... }; a single loop, so that break and continue work as usual.
+///
+/// Functions:
+///     BitWords::next_set(const u64 *words, usize size, usize from) -> usize: the first set bit at or after from among
+///         the size bits of words, or size if none.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// BitVec Methods:
+///     BitVec.init(): initialize the bit vector.
+///     BitVec.drop(): drop the bit vector.
+///     BitVec.clone_from(const BitVec *other): clone the bit vector from another bit vector.
+///     BitVec.clone() const -> BitVec: clone the bit vector.
+///     BitVec.reserve(usize new_cap): reserve the capacity of the bit vector, in bits.
+///     BitVec.resize(usize new_size, bool value): resize the bit vector, filling the new bits with value.
+///     BitVec.push_back(bool value): push a bit to the back of the bit vector.
+///     BitVec.set(usize index, bool value): set the bit at the specified index.
+///     BitVec.test(usize index) -> bool: get the bit at the specified index.
+///     BitVec.fill(bool value): set all the bits.
+///     BitVec.and_with(const BitVec *other): self &= other; the sizes must be equal.
+///     BitVec.or_with(const BitVec *other): self |= other; the sizes must be equal.
+///     BitVec.xor_with(const BitVec *other): self ^= other; the sizes must be equal.
+///     BitVec.andnot_with(const BitVec *other): self &= ~other; the sizes must be equal.
+///     BitVec.count_ones() -> usize: the number of set bits.
+///     BitVec.find_next_set(usize from) -> usize: the first set bit at or after from, or size if none.
+///     BitVec.swap(BitVec *other): swap the bit vector with another bit vector.
+///     BitVec.empty() -> bool: check if the bit vector is empty.
+///     BitVec.clear(): clear the bit vector.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "simd.h"
+#include "utils.h"
+
+#undef BITVEC_WORD_BITS
+#define BITVEC_WORD_BITS 64
+
+#undef BITVEC_WORDS
+#define BITVEC_WORDS(bits) (((bits) + BITVEC_WORD_BITS - 1) / BITVEC_WORD_BITS)
+
+/* BitWords::next_set(const u64 *words, usize size, usize from) -> usize */
+FUNC_STATIC usize NSMTD(BitWords, next_set, /, const u64 *words, usize size,
+                        usize from) {
+    if (from >= size) {
+        return size;
+    }
+    usize w = from / BITVEC_WORD_BITS;
+    u64 bits = words[w] & (~(u64)0 << (from % BITVEC_WORD_BITS));
+    usize n_words = BITVEC_WORDS(size);
+    while (!bits) {
+        if (++w == n_words) {
+            return size;
+        }
+        bits = words[w];
+    }
+    return w * BITVEC_WORD_BITS + (usize)__builtin_ctzll(bits);
+}
+
+#undef BITVEC_FOR_EACH_SET_BIT
+#define BITVEC_FOR_EACH_SET_BIT(bv, index)                                     \
+    for (usize index =                                                         \
+             NSCALL(BitWords, next_set, /, (bv).words, (bv).size, 0);          \
+         (index) < (bv).size;                                                  \
+         (index) = NSCALL(BitWords, next_set, /, (bv).words, (bv).size,        \
+                          (index) + 1))
+
+/// declare at .h files
+#undef DECLARE_BITVEC
+#define DECLARE_BITVEC(BitVec, STORAGE)                                        \
+    typedef struct BitVec {                                                    \
+        u64 *words;                                                            \
+        usize size;                                                            \
+        usize capacity;                                                        \
+    } BitVec;                                                                  \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* BitVec.clone_from(const BitVec *other) */                               \
+    STORAGE void MTD(BitVec, clone_from, /, const BitVec *other);              \
+                                                                               \
+    /* BitVec.drop() */                                                        \
+    STORAGE void MTD(BitVec, drop, /);                                         \
+                                                                               \
+    /* BitVec.reserve(usize new_cap) */                                        \
+    STORAGE void MTD(BitVec, reserve, /, usize new_cap);                       \
+                                                                               \
+    /* BitVec.resize(usize new_size, bool value) */                            \
+    STORAGE void MTD(BitVec, resize, /, usize new_size, bool value);           \
+                                                                               \
+    /* BitVec.push_back(bool value) */                                         \
+    STORAGE void MTD(BitVec, push_back, /, bool value);                        \
+                                                                               \
+    /* BitVec.fill(bool value) */                                              \
+    STORAGE void MTD(BitVec, fill, /, bool value);                             \
+                                                                               \
+    /* BitVec.find_next_set(usize from) -> usize */                            \
+    STORAGE usize MTD(BitVec, find_next_set, /, usize from);                   \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* BitVec.init() */                                                        \
+    FUNC_STATIC void MTD(BitVec, init, /) {                                    \
+        self->words = NULL;                                                    \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* BitVec.clone() const -> BitVec */                                       \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(BitVec, /);                               \
+                                                                               \
+    /* BitVec.set(usize index, bool value) */                                  \
+    FUNC_STATIC void MTD(BitVec, set, /, usize index, bool value) {            \
+        ASSERT(index < self->size);                                            \
+        u64 MPROT(mask) = (u64)1 << (index % BITVEC_WORD_BITS);                \
+        if (value) {                                                           \
+            self->words[index / BITVEC_WORD_BITS] |= MPROT(mask);              \
+        } else {                                                               \
+            self->words[index / BITVEC_WORD_BITS] &= ~MPROT(mask);             \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* BitVec.test(usize index) -> bool */                                     \
+    FUNC_STATIC bool MTD(BitVec, test, /, usize index) {                       \
+        ASSERT(index < self->size);                                            \
+        return (self->words[index / BITVEC_WORD_BITS] >>                       \
+                (index % BITVEC_WORD_BITS)) &                                  \
+               1;                                                              \
+    }                                                                          \
+                                                                               \
+    /* BitVec.and_with(const BitVec *other) */                                 \
+    FUNC_STATIC void MTD(BitVec, and_with, /, const BitVec *other) {           \
+        ASSERT(self->size == other->size);                                     \
+        NSCALL(Simd, and_u64, /, self->words, other->words,                    \
+               BITVEC_WORDS(self->size));                                      \
+    }                                                                          \
+                                                                               \
+    /* BitVec.or_with(const BitVec *other) */                                  \
+    FUNC_STATIC void MTD(BitVec, or_with, /, const BitVec *other) {            \
+        ASSERT(self->size == other->size);                                     \
+        NSCALL(Simd, or_u64, /, self->words, other->words,                     \
+               BITVEC_WORDS(self->size));                                      \
+    }                                                                          \
+                                                                               \
+    /* BitVec.xor_with(const BitVec *other) */                                 \
+    FUNC_STATIC void MTD(BitVec, xor_with, /, const BitVec *other) {           \
+        ASSERT(self->size == other->size);                                     \
+        NSCALL(Simd, xor_u64, /, self->words, other->words,                    \
+               BITVEC_WORDS(self->size));                                      \
+    }                                                                          \
+                                                                               \
+    /* BitVec.andnot_with(const BitVec *other) */                              \
+    FUNC_STATIC void MTD(BitVec, andnot_with, /, const BitVec *other) {        \
+        ASSERT(self->size == other->size);                                     \
+        NSCALL(Simd, andnot_u64, /, self->words, other->words,                 \
+               BITVEC_WORDS(self->size));                                      \
+    }                                                                          \
+                                                                               \
+    /* BitVec.count_ones() -> usize */                                         \
+    FUNC_STATIC usize MTD(BitVec, count_ones, /) {                             \
+        return NSCALL(Simd, popcount_u64, /, self->words,                      \
+                      BITVEC_WORDS(self->size));                               \
+    }                                                                          \
+                                                                               \
+    /* BitVec.swap(BitVec *other) */                                           \
+    FUNC_STATIC void MTD(BitVec, swap, /, BitVec * other) {                    \
+        BitVec MPROT(tmp) = *self;                                             \
+        *self = *other;                                                        \
+        *other = MPROT(tmp);                                                   \
+    }                                                                          \
+                                                                               \
+    /* BitVec.empty() -> bool */                                               \
+    FUNC_STATIC bool MTD(BitVec, empty, /) { return self->size == 0; }         \
+                                                                               \
+    /* BitVec.clear() */                                                       \
+    FUNC_STATIC void MTD(BitVec, clear, /) {                                   \
+        CALL(BitVec, *self, resize, /, 0, false);                              \
+    }
+
+/// define at .c files
+#undef DEFINE_BITVEC
+#define DEFINE_BITVEC(BitVec, STORAGE)                                         \
+    STORAGE void MTD(BitVec, clone_from, /, const BitVec *MPROT(other)) {      \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        usize MPROT(old_words) = BITVEC_WORDS(self->size);                     \
+        usize MPROT(new_words) = BITVEC_WORDS(MPROT(other)->size);             \
+        CALL(BitVec, *self, reserve, /, MPROT(other)->size);                   \
+        if (MPROT(new_words) > 0) {                                            \
+            memcpy(self->words, MPROT(other)->words,                           \
+                   MPROT(new_words) * sizeof(u64));                            \
+        }                                                                      \
+        /* keep the bits beyond the size zero */                               \
+        if (MPROT(old_words) > MPROT(new_words)) {                             \
+            memset(self->words + MPROT(new_words), 0,                          \
+                   (MPROT(old_words) - MPROT(new_words)) * sizeof(u64));       \
+        }                                                                      \
+        self->size = MPROT(other)->size;                                       \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(BitVec, drop, /) {                                        \
+        free(self->words);                                                     \
+        self->words = NULL;                                                    \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(BitVec, reserve, /, usize MPROT(new_cap)) {               \
+        if (MPROT(new_cap) <= self->capacity) {                                \
+            return;                                                            \
+        }                                                                      \
+        usize MPROT(old_words) = BITVEC_WORDS(self->capacity);                 \
+        usize MPROT(new_words) = BITVEC_WORDS(MPROT(new_cap));                 \
+        self->words =                                                          \
+            (u64 *)realloc(self->words, MPROT(new_words) * sizeof(u64));       \
+        ASSERT(self->words);                                                   \
+        memset(self->words + MPROT(old_words), 0,                              \
+               (MPROT(new_words) - MPROT(old_words)) * sizeof(u64));           \
+        self->capacity = MPROT(new_words) * BITVEC_WORD_BITS;                  \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(BitVec, resize, /, usize MPROT(new_size),                 \
+                     bool MPROT(value)) {                                      \
+        usize MPROT(old_size) = self->size;                                    \
+        if (MPROT(new_size) > self->capacity) {                                \
+            CALL(BitVec, *self, reserve, /,                                    \
+                 Max(MPROT(new_size), self->capacity * 2));                    \
+        }                                                                      \
+        if (MPROT(new_size) < MPROT(old_size)) {                               \
+            /* zero the bits beyond the new size */                            \
+            usize MPROT(first) = BITVEC_WORDS(MPROT(new_size));                \
+            memset(self->words + MPROT(first), 0,                              \
+                   (BITVEC_WORDS(MPROT(old_size)) - MPROT(first)) *            \
+                       sizeof(u64));                                           \
+            if (MPROT(new_size) % BITVEC_WORD_BITS) {                          \
+                self->words[MPROT(first) - 1] &=                               \
+                    ((u64)1 << (MPROT(new_size) % BITVEC_WORD_BITS)) - 1;      \
+            }                                                                  \
+        }                                                                      \
+        self->size = MPROT(new_size);                                          \
+        if (MPROT(value) && MPROT(new_size) > MPROT(old_size)) {               \
+            usize i = MPROT(old_size);                                         \
+            for (; i < MPROT(new_size) && i % BITVEC_WORD_BITS; i++) {         \
+                CALL(BitVec, *self, set, /, i, true);                          \
+            }                                                                  \
+            for (; i + BITVEC_WORD_BITS <= MPROT(new_size);                    \
+                 i += BITVEC_WORD_BITS) {                                      \
+                self->words[i / BITVEC_WORD_BITS] = ~(u64)0;                   \
+            }                                                                  \
+            for (; i < MPROT(new_size); i++) {                                 \
+                CALL(BitVec, *self, set, /, i, true);                          \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(BitVec, push_back, /, bool MPROT(value)) {                \
+        if (self->size == self->capacity) {                                    \
+            CALL(BitVec, *self, reserve, /,                                    \
+                 Max((usize)BITVEC_WORD_BITS, self->capacity * 2));            \
+        }                                                                      \
+        self->size++;                                                          \
+        CALL(BitVec, *self, set, /, self->size - 1, MPROT(value));             \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(BitVec, fill, /, bool MPROT(value)) {                     \
+        usize MPROT(size) = self->size;                                        \
+        CALL(BitVec, *self, resize, /, 0, false);                              \
+        CALL(BitVec, *self, resize, /, MPROT(size), MPROT(value));             \
+    }                                                                          \
+                                                                               \
+    STORAGE usize MTD(BitVec, find_next_set, /, usize MPROT(from)) {           \
+        return NSCALL(BitWords, next_set, /, self->words, self->size,          \
+                      MPROT(from));                                            \
+    }
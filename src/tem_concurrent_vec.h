@@ -0,0 +1,262 @@
+// clang-format off
+/// tem_concurrent_vec.h: provides a template for implementing a lock-free, append-only vector shared by threads.
+///
+/// An append claims its index by an atomic fetch-add, and the elements live in blocks of 64, 128, 256, ... elements
+/// allocated on demand, so that they never move and appends never wait for each other. An element is readable once it
+/// is published: published() returns the length of the prefix whose elements are all written.
+///
+/// Thread safety: push_back, reserve, published, size and at (below a published length) may run concurrently; the
+/// other methods need exclusive access to the vector.
+///
+/// Macros:
+///     DECLARE_CONCURRENT_VEC(CVec, T, STORAGE, value_gen): declare a concurrent vector.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_CONCURRENT_VEC(CVec, T, STORAGE): define a concurrent vector.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// ConcurrentVec Methods:
+///     CVec.init(): initialize the vector.
+///     CVec.drop(): drop the vector.
+///     CVec.clone_from(const CVec *other): clone the published elements of another vector.
+///     CVec.clone() const -> CVec: clone the vector.
+///     CVec.reserve(usize new_cap): allocate blocks until the capacity reaches new_cap.
+///     CVec.push_back(T value) -> usize: append a value, and return its index.
+///     CVec.published() -> usize: the length of the readable prefix.
+///     CVec.size() -> usize: the number of claimed indices, some of which may not be published yet.
+///     CVec.at(usize index) -> T *: get the element at the specified index, which must be published.
+///     CVec.clear(): clear the vector; the blocks are kept.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+/// block k holds CONCURRENT_VEC_FIRST_BLOCK << k elements followed by their
+/// ready flags
+#undef CONCURRENT_VEC_FIRST_BLOCK_LOG
+#define CONCURRENT_VEC_FIRST_BLOCK_LOG 6
+
+#undef CONCURRENT_VEC_FIRST_BLOCK
+#define CONCURRENT_VEC_FIRST_BLOCK ((usize)1 << CONCURRENT_VEC_FIRST_BLOCK_LOG)
+
+#undef CONCURRENT_VEC_MAX_BLOCKS
+#define CONCURRENT_VEC_MAX_BLOCKS (64 - CONCURRENT_VEC_FIRST_BLOCK_LOG)
+
+/// the block of an index, and the offset of the index in the block
+#undef CONCURRENT_VEC_LOCATE
+#define CONCURRENT_VEC_LOCATE(index, block, offset)                            \
+    do {                                                                       \
+        usize MPROT(pos) = (index) + CONCURRENT_VEC_FIRST_BLOCK;               \
+        int MPROT(msb) =                                                       \
+            63 - __builtin_clzll((unsigned long long)MPROT(pos));              \
+        (block) = (usize)MPROT(msb) - CONCURRENT_VEC_FIRST_BLOCK_LOG;          \
+        (offset) = MPROT(pos) - ((usize)1 << MPROT(msb));                      \
+    } while (0)
+
+/// declare at .h files
+#undef DECLARE_CONCURRENT_VEC
+#define DECLARE_CONCURRENT_VEC(CVec, T, STORAGE, value_gen)                    \
+    DECLARE_CONCURRENT_VEC_INNER(CVec, typeof(T), STORAGE);                    \
+    value_gen(CVec, T);
+
+#undef DECLARE_CONCURRENT_VEC_INNER
+#define DECLARE_CONCURRENT_VEC_INNER(CVec, T, STORAGE)                         \
+    typedef struct CVec {                                                      \
+        T *blocks[CONCURRENT_VEC_MAX_BLOCKS];                                  \
+        usize size;                                                            \
+        usize published;                                                       \
+    } CVec;                                                                    \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* CVec::drop_value(T *value) */                                           \
+    FUNC_STATIC void NSMTD(CVec, drop_value, /, T * value);                    \
+                                                                               \
+    /* CVec::clone_value(const T *other) -> T */                               \
+    FUNC_STATIC T NSMTD(CVec, clone_value, /, const T *other);                 \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* CVec.drop() */                                                          \
+    STORAGE void MTD(CVec, drop, /);                                           \
+                                                                               \
+    /* CVec.clone_from(const CVec *other) */                                   \
+    STORAGE void MTD(CVec, clone_from, /, const CVec *other);                  \
+                                                                               \
+    /* CVec.reserve(usize new_cap) */                                          \
+    STORAGE void MTD(CVec, reserve, /, usize new_cap);                         \
+                                                                               \
+    /* CVec.push_back(T value) -> usize */                                     \
+    STORAGE usize MTD(CVec, push_back, /, T value);                            \
+                                                                               \
+    /* CVec.published() -> usize */                                            \
+    STORAGE usize MTD(CVec, published, /);                                     \
+                                                                               \
+    /* CVec.clear() */                                                         \
+    STORAGE void MTD(CVec, clear, /);                                          \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* CVec.init() */                                                          \
+    FUNC_STATIC void MTD(CVec, init, /) {                                      \
+        memset(self->blocks, 0, sizeof(self->blocks));                         \
+        self->size = 0;                                                        \
+        self->published = 0;                                                   \
+    }                                                                          \
+                                                                               \
+    /* CVec.clone() const -> CVec */                                           \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(CVec, /);                                 \
+                                                                               \
+    /* CVec.size() -> usize */                                                 \
+    FUNC_STATIC usize MTD(CVec, size, /) {                                     \
+        return __atomic_load_n(&self->size, __ATOMIC_ACQUIRE);                 \
+    }                                                                          \
+                                                                               \
+    /* CVec.at(usize index) -> T * */                                          \
+    FUNC_STATIC T *MTD(CVec, at, /, usize index) {                             \
+        ASSERT(index < __atomic_load_n(&self->published, __ATOMIC_ACQUIRE));   \
+        usize MPROT(block), MPROT(offset);                                     \
+        CONCURRENT_VEC_LOCATE(index, MPROT(block), MPROT(offset));             \
+        return __atomic_load_n(&self->blocks[MPROT(block)],                    \
+                               __ATOMIC_ACQUIRE) +                             \
+               MPROT(offset);                                                  \
+    }
+
+/// define at .c files
+#undef DEFINE_CONCURRENT_VEC
+#define DEFINE_CONCURRENT_VEC(CVec, T, STORAGE)                                \
+    DEFINE_CONCURRENT_VEC_INNER(CVec, typeof(T), STORAGE)
+
+#undef DEFINE_CONCURRENT_VEC_INNER
+#define DEFINE_CONCURRENT_VEC_INNER(CVec, T, STORAGE)                          \
+    /* the ready flags of a block follow its elements */                       \
+    static u8 *NSMTD(CVec, ready_flags, /, T *MPROT(block), usize k) {         \
+        return (u8 *)(MPROT(block) + (CONCURRENT_VEC_FIRST_BLOCK << k));       \
+    }                                                                          \
+                                                                               \
+    /* get block k, allocating it if no thread has done so */                  \
+    static T *MTD(CVec, block, /, usize k) {                                   \
+        ASSERT(k < CONCURRENT_VEC_MAX_BLOCKS);                                 \
+        T *MPROT(block) = __atomic_load_n(&self->blocks[k], __ATOMIC_ACQUIRE); \
+        if (likely(MPROT(block) != NULL)) {                                    \
+            return MPROT(block);                                               \
+        }                                                                      \
+        usize MPROT(n) = CONCURRENT_VEC_FIRST_BLOCK << k;                      \
+        T *MPROT(fresh) = (T *)malloc(MPROT(n) * (sizeof(T) + 1));             \
+        ASSERT(MPROT(fresh));                                                  \
+        memset(NSCALL(CVec, ready_flags, /, MPROT(fresh), k), 0, MPROT(n));    \
+        if (__atomic_compare_exchange_n(&self->blocks[k], &MPROT(block),       \
+                                        MPROT(fresh), false, __ATOMIC_ACQ_REL, \
+                                        __ATOMIC_ACQUIRE)) {                   \
+            return MPROT(fresh);                                               \
+        }                                                                      \
+        /* another thread won, and MPROT(block) is its block */                \
+        free(MPROT(fresh));                                                    \
+        return MPROT(block);                                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(CVec, drop, /) {                                          \
+        CALL(CVec, *self, clear, /);                                           \
+        for (usize i = 0; i < CONCURRENT_VEC_MAX_BLOCKS; i++) {                \
+            free(self->blocks[i]);                                             \
+            self->blocks[i] = NULL;                                            \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(CVec, clone_from, /, const CVec *MPROT(other)) {          \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(CVec, *self, clear, /);                                           \
+        usize MPROT(n) = MPROT(other)->published;                              \
+        CALL(CVec, *self, reserve, /, MPROT(n));                               \
+        for (usize i = 0; i < MPROT(n); i++) {                                 \
+            usize MPROT(block), MPROT(offset);                                 \
+            CONCURRENT_VEC_LOCATE(i, MPROT(block), MPROT(offset));             \
+            T *MPROT(dst) = self->blocks[MPROT(block)];                        \
+            MPROT(dst)[MPROT(offset)] = NSCALL(                                \
+                CVec, clone_value, /,                                          \
+                MPROT(other)->blocks[MPROT(block)] + MPROT(offset));           \
+            NSCALL(CVec, ready_flags, /, MPROT(dst),                           \
+                   MPROT(block))[MPROT(offset)] = 1;                           \
+        }                                                                      \
+        self->size = MPROT(n);                                                 \
+        self->published = MPROT(n);                                            \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(CVec, reserve, /, usize MPROT(new_cap)) {                 \
+        if (MPROT(new_cap) == 0) {                                             \
+            return;                                                            \
+        }                                                                      \
+        usize MPROT(last);                                                     \
+        ATTR_UNUSED usize MPROT(offset);                                       \
+        CONCURRENT_VEC_LOCATE(MPROT(new_cap) - 1, MPROT(last), MPROT(offset)); \
+        for (usize k = 0; k <= MPROT(last); k++) {                             \
+            CALL(CVec, *self, block, /, k);                                    \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE usize MTD(CVec, push_back, /, T MPROT(value)) {                    \
+        usize MPROT(index) =                                                   \
+            __atomic_fetch_add(&self->size, 1, __ATOMIC_RELAXED);              \
+        usize MPROT(block), MPROT(offset);                                     \
+        CONCURRENT_VEC_LOCATE(MPROT(index), MPROT(block), MPROT(offset));      \
+        T *MPROT(data) = CALL(CVec, *self, block, /, MPROT(block));            \
+        MPROT(data)[MPROT(offset)] = MPROT(value);                             \
+        __atomic_store_n(NSCALL(CVec, ready_flags, /, MPROT(data),             \
+                                MPROT(block)) + MPROT(offset),                 \
+                         1, __ATOMIC_RELEASE);                                 \
+        return MPROT(index);                                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE usize MTD(CVec, published, /) {                                    \
+        usize MPROT(old) =                                                     \
+            __atomic_load_n(&self->published, __ATOMIC_ACQUIRE);               \
+        usize MPROT(size) = __atomic_load_n(&self->size, __ATOMIC_ACQUIRE);    \
+        usize MPROT(end) = MPROT(old);                                         \
+        /* extend the prefix over the ready flags that are set */              \
+        while (MPROT(end) < MPROT(size)) {                                     \
+            usize MPROT(block), MPROT(offset);                                 \
+            CONCURRENT_VEC_LOCATE(MPROT(end), MPROT(block), MPROT(offset));    \
+            T *MPROT(data) = __atomic_load_n(&self->blocks[MPROT(block)],      \
+                                             __ATOMIC_ACQUIRE);                \
+            if (!MPROT(data) ||                                                \
+                !__atomic_load_n(NSCALL(CVec, ready_flags, /, MPROT(data),     \
+                                        MPROT(block)) + MPROT(offset),         \
+                                 __ATOMIC_ACQUIRE)) {                          \
+                break;                                                         \
+            }                                                                  \
+            MPROT(end)++;                                                      \
+        }                                                                      \
+        /* only move forward, as other readers may have gone further */        \
+        while (MPROT(old) < MPROT(end) &&                                      \
+               !__atomic_compare_exchange_n(&self->published, &MPROT(old),     \
+                                            MPROT(end), true,                  \
+                                            __ATOMIC_ACQ_REL,                  \
+                                            __ATOMIC_ACQUIRE)) {               \
+        }                                                                      \
+        return Max(MPROT(old), MPROT(end));                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(CVec, clear, /) {                                         \
+        for (usize i = 0; i < self->size; i++) {                               \
+            usize MPROT(block), MPROT(offset);                                 \
+            CONCURRENT_VEC_LOCATE(i, MPROT(block), MPROT(offset));             \
+            T *MPROT(data) = self->blocks[MPROT(block)];                       \
+            NSCALL(CVec, drop_value, /, MPROT(data) + MPROT(offset));          \
+            NSCALL(CVec, ready_flags, /, MPROT(data),                          \
+                   MPROT(block))[MPROT(offset)] = 0;                           \
+        }                                                                      \
+        self->size = 0;                                                        \
+        self->published = 0;                                                   \
+    }
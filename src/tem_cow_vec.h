@@ -0,0 +1,200 @@
+// clang-format off
+/// tem_cow_vec.h: provides a template for implementing copy-on-write vectors.
+///
+/// A copy-on-write vector shares one reference counted buffer (a plain or class Vec) between its clones, so that
+/// cloning is O(1); the first mutation through a clone whose buffer is shared copies the buffer. The reference count
+/// is atomic, so clones sharing a buffer may live in different threads, while each clone itself is not thread-safe.
+///
+/// Macros:
+///     DECLARE_COW_VEC(Cow, Vec, T, STORAGE): declare a copy-on-write vector over Vec, a vector of T declared before.
+///     DEFINE_COW_VEC(Cow, Vec, T, STORAGE): define a copy-on-write vector.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// CowVec Methods:
+///     Cow.init(): initialize the vector.
+///     Cow.drop(): drop the vector; the buffer is dropped with its last owner.
+///     Cow.clone_from(const Cow *other): share the buffer of another vector, in O(1).
+///     Cow.clone() const -> Cow: share the buffer of the vector, in O(1).
+///     Cow::from_vec(Vec vec) -> Cow: build a vector from a Vec, taking its ownership.
+///     Cow.view() -> const Vec *: get the buffer for reading.
+///     Cow.make_mut() -> Vec *: get the buffer for writing, copying it first if it is shared.
+///     Cow.is_shared() -> bool: check if the buffer is shared with another vector.
+///     Cow.get(usize index) -> const T *: get the element at the specified index for reading.
+///     Cow.at_mut(usize index) -> T *: get the element at the specified index for writing.
+///     Cow.push_back(T elem): push an element to the back of the vector.
+///     Cow.pop_back(): pop an element from the back of the vector.
+///     Cow.insert(usize to_index, T elem): insert an element at the specified index.
+///     Cow.erase(usize index): erase an element at the specified index.
+///     Cow.size() -> usize: the number of elements.
+///     Cow.empty() -> bool: check if the vector is empty.
+///     Cow.clear(): clear the vector; a shared buffer is released instead of copied.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "utils.h"
+
+/// declare at .h files
+#undef DECLARE_COW_VEC
+#define DECLARE_COW_VEC(Cow, Vec, T, STORAGE)                                  \
+    DECLARE_COW_VEC_INNER(Cow, CONCATENATE(Cow, Shared), Vec, typeof(T),       \
+                          STORAGE)
+
+#undef DECLARE_COW_VEC_INNER
+#define DECLARE_COW_VEC_INNER(Cow, CowShared, Vec, T, STORAGE)                 \
+    typedef struct CowShared {                                                 \
+        usize refs;                                                            \
+        Vec vec;                                                               \
+    } CowShared;                                                               \
+                                                                               \
+    typedef struct Cow {                                                       \
+        /* NULL for an empty vector that never allocated */                    \
+        CowShared *shared;                                                     \
+    } Cow;                                                                     \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* Cow.drop() */                                                           \
+    STORAGE void MTD(Cow, drop, /);                                            \
+                                                                               \
+    /* Cow.clone_from(const Cow *other) */                                     \
+    STORAGE void MTD(Cow, clone_from, /, const Cow *other);                    \
+                                                                               \
+    /* Cow::from_vec(Vec vec) -> Cow */                                        \
+    STORAGE Cow NSMTD(Cow, from_vec, /, Vec vec);                              \
+                                                                               \
+    /* Cow.make_mut() -> Vec * */                                              \
+    STORAGE Vec *MTD(Cow, make_mut, /);                                        \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* Cow.init() */                                                           \
+    FUNC_STATIC void MTD(Cow, init, /) { self->shared = NULL; }                \
+                                                                               \
+    /* Cow.clone() const -> Cow */                                             \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(Cow, /);                                  \
+                                                                               \
+    /* Cow.view() -> const Vec * */                                            \
+    FUNC_STATIC const Vec *MTD(Cow, view, /) {                                 \
+        static const Vec MPROT(empty);                                         \
+        return self->shared ? &self->shared->vec : &MPROT(empty);              \
+    }                                                                          \
+                                                                               \
+    /* Cow.is_shared() -> bool */                                              \
+    FUNC_STATIC bool MTD(Cow, is_shared, /) {                                  \
+        return self->shared &&                                                 \
+               __atomic_load_n(&self->shared->refs, __ATOMIC_ACQUIRE) > 1;     \
+    }                                                                          \
+                                                                               \
+    /* Cow.size() -> usize */                                                  \
+    FUNC_STATIC usize MTD(Cow, size, /) {                                      \
+        return self->shared ? self->shared->vec.size : 0;                      \
+    }                                                                          \
+                                                                               \
+    /* Cow.empty() -> bool */                                                  \
+    FUNC_STATIC bool MTD(Cow, empty, /) {                                      \
+        return CALL(Cow, *self, size, /) == 0;                                 \
+    }                                                                          \
+                                                                               \
+    /* Cow.get(usize index) -> const T * */                                    \
+    FUNC_STATIC const T *MTD(Cow, get, /, usize index) {                       \
+        ASSERT(index < CALL(Cow, *self, size, /));                             \
+        return self->shared->vec.data + index;                                 \
+    }                                                                          \
+                                                                               \
+    /* Cow.at_mut(usize index) -> T * */                                       \
+    FUNC_STATIC T *MTD(Cow, at_mut, /, usize index) {                          \
+        Vec *MPROT(vec) = CALL(Cow, *self, make_mut, /);                       \
+        return CALL(Vec, *MPROT(vec), at, /, index);                           \
+    }                                                                          \
+                                                                               \
+    /* Cow.push_back(T elem) */                                                \
+    FUNC_STATIC void MTD(Cow, push_back, /, T elem) {                          \
+        Vec *MPROT(vec) = CALL(Cow, *self, make_mut, /);                       \
+        CALL(Vec, *MPROT(vec), push_back, /, elem);                            \
+    }                                                                          \
+                                                                               \
+    /* Cow.pop_back() */                                                       \
+    FUNC_STATIC void MTD(Cow, pop_back, /) {                                   \
+        Vec *MPROT(vec) = CALL(Cow, *self, make_mut, /);                       \
+        CALL(Vec, *MPROT(vec), pop_back, /);                                   \
+    }                                                                          \
+                                                                               \
+    /* Cow.insert(usize to_index, T elem) */                                   \
+    FUNC_STATIC void MTD(Cow, insert, /, usize to_index, T elem) {             \
+        Vec *MPROT(vec) = CALL(Cow, *self, make_mut, /);                       \
+        CALL(Vec, *MPROT(vec), insert, /, to_index, elem);                     \
+    }                                                                          \
+                                                                               \
+    /* Cow.erase(usize index) */                                               \
+    FUNC_STATIC void MTD(Cow, erase, /, usize index) {                         \
+        Vec *MPROT(vec) = CALL(Cow, *self, make_mut, /);                       \
+        CALL(Vec, *MPROT(vec), erase, /, index);                               \
+    }                                                                          \
+                                                                               \
+    /* Cow.clear() */                                                          \
+    FUNC_STATIC void MTD(Cow, clear, /) {                                      \
+        if (CALL(Cow, *self, is_shared, /)) {                                  \
+            CALL(Cow, *self, drop, /);                                         \
+        } else if (self->shared) {                                             \
+            CALL(Vec, self->shared->vec, clear, /);                            \
+        }                                                                      \
+    }
+
+/// define at .c files
+#undef DEFINE_COW_VEC
+#define DEFINE_COW_VEC(Cow, Vec, T, STORAGE)                                   \
+    DEFINE_COW_VEC_INNER(Cow, CONCATENATE(Cow, Shared), Vec, typeof(T),        \
+                         STORAGE)
+
+#undef DEFINE_COW_VEC_INNER
+#define DEFINE_COW_VEC_INNER(Cow, CowShared, Vec, T, STORAGE)                  \
+    static CowShared *NSMTD(CowShared, new, /, Vec MPROT(vec)) {               \
+        CowShared *MPROT(shared) = (CowShared *)malloc(sizeof(CowShared));     \
+        ASSERT(MPROT(shared));                                                 \
+        MPROT(shared)->refs = 1;                                               \
+        MPROT(shared)->vec = MPROT(vec);                                       \
+        return MPROT(shared);                                                  \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cow, drop, /) {                                           \
+        if (self->shared && __atomic_sub_fetch(&self->shared->refs, 1,         \
+                                               __ATOMIC_ACQ_REL) == 0) {       \
+            DROPOBJ(Vec, self->shared->vec);                                   \
+            free(self->shared);                                                \
+        }                                                                      \
+        self->shared = NULL;                                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cow, clone_from, /, const Cow *MPROT(other)) {            \
+        if (self->shared == MPROT(other)->shared) {                            \
+            return;                                                            \
+        }                                                                      \
+        if (MPROT(other)->shared) {                                            \
+            __atomic_add_fetch(&MPROT(other)->shared->refs, 1,                 \
+                               __ATOMIC_RELAXED);                              \
+        }                                                                      \
+        CALL(Cow, *self, drop, /);                                             \
+        self->shared = MPROT(other)->shared;                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE Cow NSMTD(Cow, from_vec, /, Vec MPROT(vec)) {                      \
+        Cow MPROT(cow) = {.shared = NSCALL(CowShared, new, /, MPROT(vec))};    \
+        return MPROT(cow);                                                     \
+    }                                                                          \
+                                                                               \
+    STORAGE Vec *MTD(Cow, make_mut, /) {                                       \
+        if (!self->shared) {                                                   \
+            self->shared = NSCALL(CowShared, new, /, CREOBJ(Vec, /));          \
+        } else if (CALL(Cow, *self, is_shared, /)) {                           \
+            Vec MPROT(copied) = CALL(Vec, self->shared->vec, clone, /);        \
+            CALL(Cow, *self, drop, /);                                         \
+            self->shared = NSCALL(CowShared, new, /, MPROT(copied));           \
+        }                                                                      \
+        return &self->shared->vec;                                             \
+    }
@@ -0,0 +1,248 @@
+// clang-format off
+/// tem_deque.h: provides a template for implementing a double-ended queue on a ring buffer.
+///
+/// The elements live in one contiguous buffer whose capacity is a power of two, so that push and pop at both ends
+/// and random access are O(1) without any allocation per element.
+///
+/// Macros:
+///     DECLARE_DEQUE(Deque, T, STORAGE, value_gen): declare a deque.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_DEQUE(Deque, T, STORAGE): define a deque.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// Deque Methods:
+///     Deque.init(): initialize the deque.
+///     Deque.drop(): drop the deque.
+///     Deque.clone_from(const Deque *other): clone the deque from another deque.
+///     Deque.clone() const -> Deque: clone the deque.
+///     Deque.reserve(usize new_cap): reserve the capacity of the deque, rounded up to a power of two.
+///     Deque.push_front(T value): push a value to the front of the deque.
+///     Deque.push_back(T value): push a value to the back of the deque.
+///     Deque.pop_front() -> T: pop a value from the front of the deque.
+///     Deque.pop_back() -> T: pop a value from the back of the deque.
+///     Deque.remove_front(): remove (and drop) the front element of the deque.
+///     Deque.remove_back(): remove (and drop) the back element of the deque.
+///     Deque.at(usize index) -> T *: get the element at the specified index from the front.
+///     Deque.front() -> T *: get the front element of the deque.
+///     Deque.back() -> T *: get the back element of the deque.
+///     Deque.swap(Deque *other): swap the deque with another deque.
+///     Deque.empty() -> bool: check if the deque is empty.
+///     Deque.clear(): clear the deque; the buffer is kept.
+// clang-format on
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+#undef DECLARE_DEQUE
+#define DECLARE_DEQUE(Deque, T, STORAGE, value_gen)                            \
+    DECLARE_DEQUE_INNER(Deque, typeof(T), STORAGE);                            \
+    value_gen(Deque, T);
+
+#undef DEFINE_DEQUE
+#define DEFINE_DEQUE(Deque, T, STORAGE)                                        \
+    DEFINE_DEQUE_INNER(Deque, typeof(T), STORAGE);
+
+#undef DECLARE_DEQUE_INNER
+#define DECLARE_DEQUE_INNER(Deque, T, STORAGE)                                 \
+    typedef struct Deque {                                                     \
+        T *data;                                                               \
+        usize head;                                                            \
+        usize size;                                                            \
+        usize capacity;                                                        \
+    } Deque;                                                                   \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* Deque::drop_value(T *value) */                                          \
+    FUNC_STATIC void NSMTD(Deque, drop_value, /, T * value);                   \
+                                                                               \
+    /* Deque::clone_value(const T *other) -> T */                              \
+    FUNC_STATIC T NSMTD(Deque, clone_value, /, const T *other);                \
+                                                                               \
+    /* Deque::trivial_drop_value() -> bool */                                  \
+    FUNC_STATIC bool NSMTD(Deque, trivial_drop_value, /);                      \
+                                                                               \
+    /* Deque::trivial_clone_value() -> bool */                                 \
+    FUNC_STATIC bool NSMTD(Deque, trivial_clone_value, /);                     \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* Deque.drop() */                                                         \
+    STORAGE void MTD(Deque, drop, /);                                          \
+                                                                               \
+    /* Deque.clone_from(const Deque *other) */                                 \
+    STORAGE void MTD(Deque, clone_from, /, const Deque *other);                \
+                                                                               \
+    /* Deque.reserve(usize new_cap) */                                         \
+    STORAGE void MTD(Deque, reserve, /, usize new_cap);                        \
+                                                                               \
+    /* Deque.clear() */                                                        \
+    STORAGE void MTD(Deque, clear, /);                                         \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* Deque.init() */                                                         \
+    FUNC_STATIC void MTD(Deque, init, /) {                                     \
+        self->data = NULL;                                                     \
+        self->head = 0;                                                        \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* Deque.clone() const -> Deque */                                         \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(Deque, /);                                \
+                                                                               \
+    /* Deque.at(usize index) -> T * */                                         \
+    FUNC_STATIC T *MTD(Deque, at, /, usize index) {                            \
+        ASSERT(index < self->size);                                            \
+        return self->data + ((self->head + index) & (self->capacity - 1));     \
+    }                                                                          \
+                                                                               \
+    /* Deque.front() -> T * */                                                 \
+    FUNC_STATIC T *MTD(Deque, front, /) {                                      \
+        return CALL(Deque, *self, at, /, 0);                                   \
+    }                                                                          \
+                                                                               \
+    /* Deque.back() -> T * */                                                  \
+    FUNC_STATIC T *MTD(Deque, back, /) {                                       \
+        return CALL(Deque, *self, at, /, self->size - 1);                      \
+    }                                                                          \
+                                                                               \
+    /* Deque.push_back(T value) */                                             \
+    FUNC_STATIC void MTD(Deque, push_back, /, T value) {                       \
+        if (self->size == self->capacity) {                                    \
+            CALL(Deque, *self, reserve, /, self->size + 1);                    \
+        }                                                                      \
+        self->data[(self->head + self->size) & (self->capacity - 1)] = value;  \
+        self->size++;                                                          \
+    }                                                                          \
+                                                                               \
+    /* Deque.push_front(T value) */                                            \
+    FUNC_STATIC void MTD(Deque, push_front, /, T value) {                      \
+        if (self->size == self->capacity) {                                    \
+            CALL(Deque, *self, reserve, /, self->size + 1);                    \
+        }                                                                      \
+        self->head = (self->head - 1) & (self->capacity - 1);                  \
+        self->data[self->head] = value;                                        \
+        self->size++;                                                          \
+    }                                                                          \
+                                                                               \
+    /* Deque.pop_front() -> T */                                               \
+    FUNC_STATIC T MTD(Deque, pop_front, /) {                                   \
+        ASSERT(self->size > 0);                                                \
+        T MPROT(value) = self->data[self->head];                               \
+        self->head = (self->head + 1) & (self->capacity - 1);                  \
+        self->size--;                                                          \
+        return MPROT(value);                                                   \
+    }                                                                          \
+                                                                               \
+    /* Deque.pop_back() -> T */                                                \
+    FUNC_STATIC T MTD(Deque, pop_back, /) {                                    \
+        ASSERT(self->size > 0);                                                \
+        self->size--;                                                          \
+        return self->data[(self->head + self->size) & (self->capacity - 1)];   \
+    }                                                                          \
+                                                                               \
+    /* Deque.remove_front() */                                                 \
+    FUNC_STATIC void MTD(Deque, remove_front, /) {                             \
+        T MPROT(value) = CALL(Deque, *self, pop_front, /);                     \
+        NSCALL(Deque, drop_value, /, &MPROT(value));                           \
+    }                                                                          \
+                                                                               \
+    /* Deque.remove_back() */                                                  \
+    FUNC_STATIC void MTD(Deque, remove_back, /) {                              \
+        T MPROT(value) = CALL(Deque, *self, pop_back, /);                      \
+        NSCALL(Deque, drop_value, /, &MPROT(value));                           \
+    }                                                                          \
+                                                                               \
+    /* Deque.swap(Deque *other) */                                             \
+    FUNC_STATIC void MTD(Deque, swap, /, Deque * other) {                      \
+        Deque MPROT(temp) = *self;                                             \
+        *self = *other;                                                        \
+        *other = MPROT(temp);                                                  \
+    }                                                                          \
+                                                                               \
+    /* Deque.empty() -> bool */                                                \
+    FUNC_STATIC bool MTD(Deque, empty, /) { return self->size == 0; }
+
+#undef DEFINE_DEQUE_INNER
+#define DEFINE_DEQUE_INNER(Deque, T, STORAGE)                                  \
+    /* Deque.drop() */                                                         \
+    STORAGE void MTD(Deque, drop, /) {                                         \
+        CALL(Deque, *self, clear, /);                                          \
+        free(self->data);                                                      \
+        self->data = NULL;                                                     \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* Deque.clone_from(const Deque *other) */                                 \
+    STORAGE void MTD(Deque, clone_from, /, const Deque *MPROT(other)) {        \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(Deque, *self, clear, /);                                          \
+        CALL(Deque, *self, reserve, /, MPROT(other)->size);                    \
+        self->size = MPROT(other)->size;                                       \
+        if (NSCALL(Deque, trivial_clone_value, /)) {                           \
+            /* copy the wrapped part after the part up to the end */           \
+            usize MPROT(first) =                                               \
+                Min(MPROT(other)->size,                                        \
+                    MPROT(other)->capacity - MPROT(other)->head);              \
+            if (MPROT(first) > 0) {                                            \
+                memcpy(self->data, MPROT(other)->data + MPROT(other)->head,    \
+                       MPROT(first) * sizeof(T));                              \
+            }                                                                  \
+            if (MPROT(other)->size > MPROT(first)) {                           \
+                memcpy(self->data + MPROT(first), MPROT(other)->data,          \
+                       (MPROT(other)->size - MPROT(first)) * sizeof(T));       \
+            }                                                                  \
+            return;                                                            \
+        }                                                                      \
+        for (usize i = 0; i < MPROT(other)->size; i++) {                       \
+            usize MPROT(pos) =                                                 \
+                (MPROT(other)->head + i) & (MPROT(other)->capacity - 1);       \
+            self->data[i] = NSCALL(Deque, clone_value, /,                      \
+                                   MPROT(other)->data + MPROT(pos));           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Deque.reserve(usize new_cap) */                                         \
+    STORAGE void MTD(Deque, reserve, /, usize MPROT(new_cap)) {                \
+        if (MPROT(new_cap) <= self->capacity) {                                \
+            return;                                                            \
+        }                                                                      \
+        usize MPROT(old_cap) = self->capacity;                                 \
+        usize MPROT(cap) = Max(self->capacity, (usize)4);                      \
+        while (MPROT(cap) < MPROT(new_cap)) {                                  \
+            MPROT(cap) *= 2;                                                   \
+        }                                                                      \
+        self->data = (T *)realloc(self->data, MPROT(cap) * sizeof(T));         \
+        ASSERT(self->data);                                                    \
+        self->capacity = MPROT(cap);                                           \
+        /* the wrapped part moves after the old end, which has room for it */  \
+        if (self->head + self->size > MPROT(old_cap)) {                        \
+            memcpy(self->data + MPROT(old_cap), self->data,                    \
+                   (self->head + self->size - MPROT(old_cap)) * sizeof(T));    \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Deque.clear() */                                                        \
+    STORAGE void MTD(Deque, clear, /) {                                        \
+        if (!NSCALL(Deque, trivial_drop_value, /)) {                           \
+            for (usize i = 0; i < self->size; i++) {                           \
+                NSCALL(Deque, drop_value, /, CALL(Deque, *self, at, /, i));    \
+            }                                                                  \
+        }                                                                      \
+        self->head = 0;                                                        \
+        self->size = 0;                                                        \
+    }
@@ -0,0 +1,248 @@
+// clang-format off
+/// tem_intrusive_list.h: provides a template for implementing intrusive doubly-linked lists.
+///
+/// The links of an intrusive list are embedded in the elements: T has a field of type IListLink for each list it may
+/// be on, and the list finds the element of a link by offsetof. The list never allocates, copies or owns the elements,
+/// which stay where they are (e.g. in a vector or a slot map), so an element may sit on several lists at once, one per
+/// link field. An element must not move, nor be dropped, while it is on a list, and it is on at most one list per link.
+///
+/// Macros:
+///     DECLARE_INTRUSIVE_LIST(IList, T, LINK): declare an intrusive list of T linked by the field `IListLink LINK` of
+///         T.
+///     INTRUSIVE_LIST_FOR_EACH(IList, list, ptr): iterate over the elements of list by the pointer ptr, e.g.
+///         INTRUSIVE_LIST_FOR_EACH(IList, list, p) { ... p->field ... }; ptr must not be removed in the body.
+///
+/// IList Methods:
+///     IList.init(): initialize the list.
+///     IList.drop(): drop the list; the elements are not owned, so it only forgets them.
+///     IList::entry(IListLink *link) -> T *: the element of a link, or NULL for NULL.
+///     IList::next(T *obj) -> T *: the next element on the list, or NULL.
+///     IList::prev(T *obj) -> T *: the previous element on the list, or NULL.
+///     IList.front() -> T *: the first element, or NULL if the list is empty.
+///     IList.back() -> T *: the last element, or NULL if the list is empty.
+///     IList.push_front(T *obj): link an element at the front.
+///     IList.push_back(T *obj): link an element at the back.
+///     IList.insert_after(T *pos, T *obj): link an element after pos, or at the front if pos is NULL.
+///     IList.insert_before(T *pos, T *obj): link an element before pos, or at the back if pos is NULL.
+///     IList.pop_front() -> T *: unlink the first element and return it, or NULL if the list is empty.
+///     IList.pop_back() -> T *: unlink the last element and return it, or NULL if the list is empty.
+///     IList.remove(T *obj) -> T *: unlink an element, and return the next one.
+///     IList.move_to_front(T *obj): move an element of the list to the front.
+///     IList.move_to_back(T *obj): move an element of the list to the back.
+///     IList.splice(T *pos, IList *other): move all the elements of other after pos, or to the front if pos is NULL.
+///     IList.swap(IList *other): swap the list with another list.
+///     IList.size() -> usize: the number of elements.
+///     IList.empty() -> bool: check if the list is empty.
+///
+///     All the methods are O(1), and none allocates.
+// clang-format on
+
+#pragma once
+
+#include <stddef.h>
+
+#include "debug.h"
+#include "utils.h"
+
+typedef struct IListLink {
+    struct IListLink *prev;
+    struct IListLink *next;
+} IListLink;
+
+#undef INTRUSIVE_LIST_FOR_EACH
+#define INTRUSIVE_LIST_FOR_EACH(IList, list, ptr)                              \
+    for (typeof(CALL(IList, list, front, /)) ptr =                             \
+             CALL(IList, list, front, /);                                      \
+         ptr; ptr = NSCALL(IList, next, /, ptr))
+
+/// declare at .h files
+#undef DECLARE_INTRUSIVE_LIST
+#define DECLARE_INTRUSIVE_LIST(IList, T, LINK)                                 \
+    DECLARE_INTRUSIVE_LIST_INNER(IList, typeof(T), LINK)
+
+#undef DECLARE_INTRUSIVE_LIST_INNER
+#define DECLARE_INTRUSIVE_LIST_INNER(IList, T, LINK)                           \
+    typedef struct IList {                                                     \
+        IListLink *head;                                                       \
+        IListLink *tail;                                                       \
+        usize size;                                                            \
+    } IList;                                                                   \
+                                                                               \
+    /* IList.init() */                                                         \
+    FUNC_STATIC void MTD(IList, init, /) {                                     \
+        self->head = NULL;                                                     \
+        self->tail = NULL;                                                     \
+        self->size = 0;                                                        \
+    }                                                                          \
+                                                                               \
+    /* IList.drop() */                                                         \
+    FUNC_STATIC void MTD(IList, drop, /) { CALL(IList, *self, init, /); }      \
+                                                                               \
+    DELETED_CLONER(IList, FUNC_STATIC);                                        \
+                                                                               \
+    /* IList::entry(IListLink *link) -> T * */                                 \
+    FUNC_STATIC T *NSMTD(IList, entry, /, IListLink * MPROT(link)) {           \
+        if (!MPROT(link)) {                                                    \
+            return NULL;                                                       \
+        }                                                                      \
+        return (T *)((char *)MPROT(link) - offsetof(T, LINK));                 \
+    }                                                                          \
+                                                                               \
+    /* IList::next(T *obj) -> T * */                                           \
+    FUNC_STATIC T *NSMTD(IList, next, /, T * MPROT(obj)) {                     \
+        return NSCALL(IList, entry, /, MPROT(obj)->LINK.next);                 \
+    }                                                                          \
+                                                                               \
+    /* IList::prev(T *obj) -> T * */                                           \
+    FUNC_STATIC T *NSMTD(IList, prev, /, T * MPROT(obj)) {                     \
+        return NSCALL(IList, entry, /, MPROT(obj)->LINK.prev);                 \
+    }                                                                          \
+                                                                               \
+    /* IList.front() -> T * */                                                 \
+    FUNC_STATIC T *MTD(IList, front, /) {                                      \
+        return NSCALL(IList, entry, /, self->head);                            \
+    }                                                                          \
+                                                                               \
+    /* IList.back() -> T * */                                                  \
+    FUNC_STATIC T *MTD(IList, back, /) {                                       \
+        return NSCALL(IList, entry, /, self->tail);                            \
+    }                                                                          \
+                                                                               \
+    /* IList.link_after(IListLink *pos, IListLink *node) */                    \
+    FUNC_STATIC void MTD(IList, link_after, /, IListLink * MPROT(pos),         \
+                         IListLink * MPROT(node)) {                            \
+        IListLink *MPROT(next) = MPROT(pos) ? MPROT(pos)->next : self->head;   \
+        MPROT(node)->prev = MPROT(pos);                                        \
+        MPROT(node)->next = MPROT(next);                                       \
+        if (MPROT(pos)) {                                                      \
+            MPROT(pos)->next = MPROT(node);                                    \
+        } else {                                                               \
+            self->head = MPROT(node);                                          \
+        }                                                                      \
+        if (MPROT(next)) {                                                     \
+            MPROT(next)->prev = MPROT(node);                                   \
+        } else {                                                               \
+            self->tail = MPROT(node);                                          \
+        }                                                                      \
+        self->size++;                                                          \
+    }                                                                          \
+                                                                               \
+    /* IList.unlink(IListLink *node) */                                        \
+    FUNC_STATIC void MTD(IList, unlink, /, IListLink * MPROT(node)) {          \
+        ASSERT(self->size > 0);                                                \
+        if (MPROT(node)->prev) {                                               \
+            MPROT(node)->prev->next = MPROT(node)->next;                       \
+        } else {                                                               \
+            self->head = MPROT(node)->next;                                    \
+        }                                                                      \
+        if (MPROT(node)->next) {                                               \
+            MPROT(node)->next->prev = MPROT(node)->prev;                       \
+        } else {                                                               \
+            self->tail = MPROT(node)->prev;                                    \
+        }                                                                      \
+        MPROT(node)->prev = NULL;                                              \
+        MPROT(node)->next = NULL;                                              \
+        self->size--;                                                          \
+    }                                                                          \
+                                                                               \
+    /* IList.push_front(T *obj) */                                             \
+    FUNC_STATIC void MTD(IList, push_front, /, T * MPROT(obj)) {               \
+        CALL(IList, *self, link_after, /, NULL, &MPROT(obj)->LINK);            \
+    }                                                                          \
+                                                                               \
+    /* IList.push_back(T *obj) */                                              \
+    FUNC_STATIC void MTD(IList, push_back, /, T * MPROT(obj)) {                \
+        CALL(IList, *self, link_after, /, self->tail, &MPROT(obj)->LINK);      \
+    }                                                                          \
+                                                                               \
+    /* IList.insert_after(T *pos, T *obj) */                                   \
+    FUNC_STATIC void MTD(IList, insert_after, /, T * MPROT(pos),               \
+                         T * MPROT(obj)) {                                     \
+        CALL(IList, *self, link_after, /,                                      \
+             MPROT(pos) ? &MPROT(pos)->LINK : NULL, &MPROT(obj)->LINK);        \
+    }                                                                          \
+                                                                               \
+    /* IList.insert_before(T *pos, T *obj) */                                  \
+    FUNC_STATIC void MTD(IList, insert_before, /, T * MPROT(pos),              \
+                         T * MPROT(obj)) {                                     \
+        CALL(IList, *self, link_after, /,                                      \
+             MPROT(pos) ? MPROT(pos)->LINK.prev : self->tail,                  \
+             &MPROT(obj)->LINK);                                               \
+    }                                                                          \
+                                                                               \
+    /* IList.pop_front() -> T * */                                             \
+    FUNC_STATIC T *MTD(IList, pop_front, /) {                                  \
+        IListLink *MPROT(node) = self->head;                                   \
+        if (MPROT(node)) {                                                     \
+            CALL(IList, *self, unlink, /, MPROT(node));                        \
+        }                                                                      \
+        return NSCALL(IList, entry, /, MPROT(node));                           \
+    }                                                                          \
+                                                                               \
+    /* IList.pop_back() -> T * */                                              \
+    FUNC_STATIC T *MTD(IList, pop_back, /) {                                   \
+        IListLink *MPROT(node) = self->tail;                                   \
+        if (MPROT(node)) {                                                     \
+            CALL(IList, *self, unlink, /, MPROT(node));                        \
+        }                                                                      \
+        return NSCALL(IList, entry, /, MPROT(node));                           \
+    }                                                                          \
+                                                                               \
+    /* IList.remove(T *obj) -> T * */                                          \
+    FUNC_STATIC T *MTD(IList, remove, /, T * MPROT(obj)) {                     \
+        T *MPROT(next) = NSCALL(IList, next, /, MPROT(obj));                   \
+        CALL(IList, *self, unlink, /, &MPROT(obj)->LINK);                      \
+        return MPROT(next);                                                    \
+    }                                                                          \
+                                                                               \
+    /* IList.move_to_front(T *obj) */                                          \
+    FUNC_STATIC void MTD(IList, move_to_front, /, T * MPROT(obj)) {            \
+        if (self->head != &MPROT(obj)->LINK) {                                 \
+            CALL(IList, *self, unlink, /, &MPROT(obj)->LINK);                  \
+            CALL(IList, *self, link_after, /, NULL, &MPROT(obj)->LINK);        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* IList.move_to_back(T *obj) */                                           \
+    FUNC_STATIC void MTD(IList, move_to_back, /, T * MPROT(obj)) {             \
+        if (self->tail != &MPROT(obj)->LINK) {                                 \
+            CALL(IList, *self, unlink, /, &MPROT(obj)->LINK);                  \
+            CALL(IList, *self, link_after, /, self->tail, &MPROT(obj)->LINK);  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* IList.splice(T *pos, IList *other) */                                   \
+    FUNC_STATIC void MTD(IList, splice, /, T * MPROT(pos), IList * other) {    \
+        if (other == self || !other->head) {                                   \
+            return;                                                            \
+        }                                                                      \
+        IListLink *MPROT(prev) = MPROT(pos) ? &MPROT(pos)->LINK : NULL;        \
+        IListLink *MPROT(next) = MPROT(prev) ? MPROT(prev)->next : self->head; \
+        other->head->prev = MPROT(prev);                                       \
+        other->tail->next = MPROT(next);                                       \
+        if (MPROT(prev)) {                                                     \
+            MPROT(prev)->next = other->head;                                   \
+        } else {                                                               \
+            self->head = other->head;                                          \
+        }                                                                      \
+        if (MPROT(next)) {                                                     \
+            MPROT(next)->prev = other->tail;                                   \
+        } else {                                                               \
+            self->tail = other->tail;                                          \
+        }                                                                      \
+        self->size += other->size;                                             \
+        CALL(IList, *other, init, /);                                          \
+    }                                                                          \
+                                                                               \
+    /* IList.swap(IList *other) */                                             \
+    FUNC_STATIC void MTD(IList, swap, /, IList * other) {                      \
+        IList MPROT(temp) = *self;                                             \
+        *self = *other;                                                        \
+        *other = MPROT(temp);                                                  \
+    }                                                                          \
+                                                                               \
+    /* IList.size() -> usize */                                                \
+    FUNC_STATIC usize MTD(IList, size, /) { return self->size; }               \
+                                                                               \
+    /* IList.empty() -> bool */                                                \
+    FUNC_STATIC bool MTD(IList, empty, /) { return self->size == 0; }
@@ -8,14 +8,35 @@
 ///         - GENERATOR_CLASS_VALUE: define a class value generator.
 ///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
 ///     DEFINE_LIST(List, T, STORAGE): define a list.
+///     DECLARE_LIST_WITH_ALLOCATOR(List, T, STORAGE, value_gen, alloc_gen): declare a list with the memory of another
+///         allocator; DECLARE_LIST uses the libc heap.
+///         alloc_gen: define the allocator generator, see allocator.h.
+///     DECLARE_LIST_ALGORITHM(List, T, STORAGE, com_gen): declare the sorting methods of a list.
+///         com_gen: define the comparator generator, see tem_algorithm.h.
+///     DEFINE_LIST_ALGORITHM(List, T, STORAGE): define the sorting methods of a list.
 ///
 ///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
 ///
+/// Node Pools:
+///     By default every node is allocated on its own, by the allocator of the list type. A list initialized by
+///     init_pooled carves its nodes from a NodePool (see node_pool.h) instead: either a pool shared with other lists
+///     (of the same thread), which must outlive them and hold nodes of at least sizeof(ListNode), or a pool private to
+///     the list. A list with a private pool releases whole slabs on clear and drop, without freeing the nodes one by
+///     one; drop releases the pool too, leaving the list in the default mode.
+///
+///     clone_from into a pooled list allocates all the nodes of the clone in one contiguous block of the pool, in list
+///     order, so that building the clone takes one allocation and traversing it is sequential. A list in the default
+///     mode allocates the nodes of the clone one by one, and stays in the default mode, since its nodes are freed one
+///     by one and may move to other lists in the default mode. clone_pooled opts into the block for the clone of any
+///     list: the clone owns a private pool, and its nodes do not move to lists in the default mode (see splice).
+///
 /// List Methods:
 ///     List.init(): initialize the list.
+///     List.init_pooled(NodePool *pool): initialize the list with the nodes from pool, or from a private pool if NULL.
 ///     List.drop(): drop the list.
-///     List.clone_from(const List *other): clone the list from another list.
-///     List.clone() const -> List: clone the list.
+///     List.clone_from(const List *other): clone the list from another list (with the nodes in one block if pooled).
+///     List.clone() const -> List: clone the list, in the mode of the list.
+///     List.clone_pooled() const -> List: clone the list into a private pool, with the nodes in one block.
 ///     List.front() -> T*: get the front element of the list.
 ///     List.back() -> T*: get the back element of the list.
 ///     List.push_front(T value): push a value to the front of the list.
@@ -25,22 +46,42 @@
 ///     List.remove_front(): remove the front element of the list.
 ///     List.remove_back(): remove the back element of the list.
 ///     List.remove(ListNode *it) -> ListNode *: remove a node from the list, and return the next node.
-///     List.insert_after(ListNode *it, T value): insert a value after a node.
+///     List.insert_after(ListNode *it, T value): insert a value after a node, or at the front if it is NULL.
+///     List.splice(ListNode *pos, List *other, ListNode *first, ListNode *last): move the nodes [first, last) of other
+///         (last NULL for the end of other) before pos (NULL for the end), relinking them; other may be the list
+///         itself, when pos must not be in [first, last). O(1) within a list or when moving all of other, otherwise the
+///         moved nodes are counted.
 ///     List.swap(List *other): swap the list with another list.
 ///     List.empty() -> bool: check if the list is empty.
 ///     List.clear(): clear the list.
 ///
+/// Algorithm Methods (DECLARE_LIST_ALGORITHM):
+///     List.sort(): sort the list, stable (bottom-up merge sort relinking the nodes, with no allocation).
+///     List.merge(List *other): merge the sorted other into the sorted list, stable (the elements of the list come
+///         first among equal ones), leaving other empty.
+///     List.is_sorted() -> bool: check if the list is sorted.
+///
+///     Nodes move only between lists allocating alike: both on their own (by the same allocator), or from the same
+///     shared NodePool.
 // clang-format on
 #pragma once
 
+#include "allocator.h"
 #include "debug.h"
+#include "node_pool.h"
 #include "tem_memory_primitive.h"
 #include "utils.h"
 
 #undef DECLARE_LIST
 #define DECLARE_LIST(List, T, STORAGE, value_gen)                              \
+    DECLARE_LIST_WITH_ALLOCATOR(List, T, STORAGE, value_gen,                   \
+                                GENERATOR_LIBC_ALLOCATOR)
+
+#undef DECLARE_LIST_WITH_ALLOCATOR
+#define DECLARE_LIST_WITH_ALLOCATOR(List, T, STORAGE, value_gen, alloc_gen)    \
     DECLARE_LIST_INNER(List, CONCATENATE(List, Node), typeof(T), STORAGE);     \
-    value_gen(List, T);
+    value_gen(List, T);                                                        \
+    alloc_gen(List);
 
 #undef DEFINE_LIST
 #define DEFINE_LIST(List, T, STORAGE)                                          \
@@ -59,6 +100,9 @@
         struct ListNode *head;                                                 \
         struct ListNode *tail;                                                 \
         usize size;                                                            \
+        /* the pool of the nodes, or NULL to allocate them on their own */     \
+        NodePool *pool;                                                        \
+        bool own_pool;                                                         \
     } List;                                                                    \
                                                                                \
     /* NOTE: Methods that are required to defined outside the template */      \
@@ -69,6 +113,12 @@
     /* List::clone_value(const T *other) -> T */                               \
     FUNC_STATIC T NSMTD(List, clone_value, /, const T *other);                 \
                                                                                \
+    /* List::trivial_drop_value() -> bool */                                   \
+    FUNC_STATIC bool NSMTD(List, trivial_drop_value, /);                       \
+                                                                               \
+    /* List::allocator() -> Allocator * */                                     \
+    FUNC_STATIC Allocator *NSMTD(List, allocator, /);                          \
+                                                                               \
     /* NOTE: Methods to implement in .c */                                     \
                                                                                \
     /* List.drop() */                                                          \
@@ -101,6 +151,11 @@
     /* List.insert_after(ListNode *it, T value) */                             \
     STORAGE void MTD(List, insert_after, /, ListNode * it, T value);           \
                                                                                \
+    /* List.splice(ListNode *pos, List *other, ListNode *first,                \
+     *             ListNode *last) */                                          \
+    STORAGE void MTD(List, splice, /, ListNode * pos, List * other,            \
+                     ListNode * first, ListNode * last);                       \
+                                                                               \
     /* NOTE: static methods that are not required to implement in .c */        \
                                                                                \
     /* List.init() */                                                          \
@@ -108,22 +163,85 @@
         self->head = NULL;                                                     \
         self->tail = NULL;                                                     \
         self->size = 0;                                                        \
+        self->pool = NULL;                                                     \
+        self->own_pool = false;                                                \
+    }                                                                          \
+                                                                               \
+    /* List.create_pool(): make a private pool for the list */                 \
+    FUNC_STATIC void MTD(List, create_pool, /) {                               \
+        Allocator *MPROT(allocator) = NSCALL(List, allocator, /);              \
+        self->pool = CREOBJRAWHEAP_IN(NodePool, MPROT(allocator));             \
+        CALL(NodePool, *self->pool, init_in, /, sizeof(ListNode),              \
+             __alignof__(ListNode), MPROT(allocator));                         \
+        self->own_pool = true;                                                 \
+    }                                                                          \
+                                                                               \
+    /* List.init_pooled(NodePool *pool) */                                     \
+    FUNC_STATIC void MTD(List, init_pooled, /, NodePool * MPROT(pool)) {       \
+        CALL(List, *self, init, /);                                            \
+        if (MPROT(pool)) {                                                     \
+            ASSERT(MPROT(pool)->node_size >= sizeof(ListNode));                \
+            self->pool = MPROT(pool);                                          \
+        } else {                                                               \
+            CALL(List, *self, create_pool, /);                                 \
+        }                                                                      \
     }                                                                          \
                                                                                \
     /* List.clone() const -> List */                                           \
-    FUNC_STATIC DEFAULT_DERIVE_CLONE(List, /);                                 \
+    FUNC_STATIC List MTDCONST(List, clone, /) {                                \
+        List MPROT(ret);                                                       \
+        if (self->pool) {                                                      \
+            CALL(List, MPROT(ret), init_pooled, /,                             \
+                 self->own_pool ? NULL : self->pool);                          \
+        } else {                                                               \
+            CALL(List, MPROT(ret), init, /);                                   \
+        }                                                                      \
+        CALL(List, MPROT(ret), clone_from, /, self);                           \
+        return MPROT(ret);                                                     \
+    }                                                                          \
+                                                                               \
+    /* List.clone_pooled() const -> List: clone the list into a private pool */\
+    FUNC_STATIC List MTDCONST(List, clone_pooled, /) {                         \
+        List MPROT(ret);                                                       \
+        CALL(List, MPROT(ret), init_pooled, /, NULL);                          \
+        CALL(List, MPROT(ret), clone_from, /, self);                           \
+        return MPROT(ret);                                                     \
+    }                                                                          \
+                                                                               \
+    /* List.alloc_node() -> ListNode*: an uninitialized node */                \
+    FUNC_STATIC ListNode *MTD(List, alloc_node, /) {                           \
+        if (self->pool) {                                                      \
+            return (ListNode *)CALL(NodePool, *self->pool, alloc, /);          \
+        }                                                                      \
+        return CREOBJRAWHEAP_IN(ListNode, NSCALL(List, allocator, /));         \
+    }                                                                          \
+                                                                               \
+    /* List.free_node(ListNode *node) */                                       \
+    FUNC_STATIC void MTD(List, free_node, /, ListNode * MPROT(node)) {         \
+        if (self->pool) {                                                      \
+            CALL(NodePool, *self->pool, free, /, MPROT(node));                 \
+        } else {                                                               \
+            NSCALL(Allocator, deallocate, /, NSCALL(List, allocator, /),       \
+                   MPROT(node), sizeof(ListNode));                             \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* List.drop_values(): drop the values, keeping the nodes */               \
+    FUNC_STATIC void MTD(List, drop_values, /) {                               \
+        if (NSCALL(List, trivial_drop_value, /)) {                             \
+            return;                                                            \
+        }                                                                      \
+        for (ListNode *MPROT(it) = self->head; MPROT(it);                      \
+             MPROT(it) = MPROT(it)->next) {                                    \
+            NSCALL(List, drop_value, /, &MPROT(it)->data);                     \
+        }                                                                      \
+    }                                                                          \
                                                                                \
     /* List.swap(List *other) */                                               \
     FUNC_STATIC void MTD(List, swap, /, List * other) {                        \
-        ListNode *MPROT(temp) = self->head;                                    \
-        self->head = other->head;                                              \
-        other->head = MPROT(temp);                                             \
-        MPROT(temp) = self->tail;                                              \
-        self->tail = other->tail;                                              \
-        other->tail = MPROT(temp);                                             \
-        usize MPROT(temp_size) = self->size;                                   \
-        self->size = other->size;                                              \
-        other->size = MPROT(temp_size);                                        \
+        List MPROT(temp) = *self;                                              \
+        *self = *other;                                                        \
+        *other = MPROT(temp);                                                  \
     }                                                                          \
                                                                                \
     /* List.remove_front() */                                                  \
@@ -142,17 +260,41 @@
     FUNC_STATIC bool MTD(List, empty, /) { return self->size == 0; }           \
                                                                                \
     /* List.clear() */                                                         \
-    FUNC_STATIC void MTD(List, clear, /) { DROPOBJ(List, *self); }
+    FUNC_STATIC void MTD(List, clear, /) {                                     \
+        if (!self->own_pool) {                                                 \
+            DROPOBJ(List, *self);                                              \
+            return;                                                            \
+        }                                                                      \
+        CALL(List, *self, drop_values, /);                                     \
+        CALL(NodePool, *self->pool, reset, /);                                 \
+        self->head = NULL;                                                     \
+        self->tail = NULL;                                                     \
+        self->size = 0;                                                        \
+    }
 
 #undef DEFINE_LIST_INNER
 #define DEFINE_LIST_INNER(List, ListNode, T, STORAGE)                          \
     /* List.drop() */                                                          \
     STORAGE void MTD(List, drop, /) {                                          \
+        if (self->own_pool) {                                                  \
+            CALL(List, *self, drop_values, /);                                 \
+            DROPOBJHEAP_IN(NodePool, NSCALL(List, allocator, /), self->pool);  \
+            CALL(List, *self, init, /);                                        \
+            return;                                                            \
+        }                                                                      \
+        if (!self->pool && NSCALL(List, trivial_drop_value, /)) {              \
+            /* an allocator freeing nothing lets the nodes be */               \
+            Allocator *MPROT(allocator) = NSCALL(List, allocator, /);          \
+            if (!NSCALL(Allocator, frees_blocks, /, MPROT(allocator))) {       \
+                CALL(List, *self, init, /);                                    \
+                return;                                                        \
+            }                                                                  \
+        }                                                                      \
         while (self->head) {                                                   \
             ListNode *MPROT(now) = self->head;                                 \
             self->head = self->head->next;                                     \
             NSCALL(List, drop_value, /, &MPROT(now)->data);                    \
-            free(MPROT(now));                                                  \
+            CALL(List, *self, free_node, /, MPROT(now));                       \
         }                                                                      \
         self->head = NULL;                                                     \
         self->tail = NULL;                                                     \
@@ -161,26 +303,41 @@
                                                                                \
     /* List.clone_from(const List *other) */                                   \
     STORAGE void MTD(List, clone_from, /, const List *MPROT(other)) {          \
-        DROPOBJ(List, *self);                                                  \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(List, *self, clear, /);                                           \
         if (!MPROT(other)->head) {                                             \
             return;                                                            \
         }                                                                      \
+        /* a pooled list takes the nodes of the clone in one block, in list    \
+         * order; a shared pool may hold nodes larger than ListNode */         \
+        char *MPROT(block) = NULL;                                             \
+        if (self->pool) {                                                      \
+            MPROT(block) = (char *)CALL(NodePool, *self->pool, alloc_bulk, /,  \
+                                        MPROT(other)->size);                   \
+        }                                                                      \
         ListNode *MPROT(p) = NULL;                                             \
-        ListNode *MPROT(now) = NULL;                                           \
-        ListNode *MPROT(it) = MPROT(other)->head;                              \
-        while (MPROT(it)) {                                                    \
-            MPROT(p) = MPROT(now);                                             \
-            MPROT(now) = CREOBJRAWHEAP(ListNode);                              \
+        for (ListNode *MPROT(it) = MPROT(other)->head; MPROT(it);              \
+             MPROT(it) = MPROT(it)->next) {                                    \
+            ListNode *MPROT(now);                                              \
+            if (MPROT(block)) {                                                \
+                MPROT(now) = (ListNode *)MPROT(block);                         \
+                MPROT(block) += self->pool->node_size;                         \
+            } else {                                                           \
+                MPROT(now) = CALL(List, *self, alloc_node, /);                 \
+            }                                                                  \
             MPROT(now)->data = NSCALL(List, clone_value, /, &MPROT(it)->data); \
+            MPROT(now)->prev = MPROT(p);                                       \
             if (MPROT(p)) {                                                    \
                 MPROT(p)->next = MPROT(now);                                   \
             } else {                                                           \
                 self->head = MPROT(now);                                       \
             }                                                                  \
-            MPROT(now)->prev = MPROT(p);                                       \
-            MPROT(it) = MPROT(it)->next;                                       \
+            MPROT(p) = MPROT(now);                                             \
         }                                                                      \
-        self->tail = MPROT(now);                                               \
+        MPROT(p)->next = NULL;                                                 \
+        self->tail = MPROT(p);                                                 \
         self->size = MPROT(other)->size;                                       \
     }                                                                          \
                                                                                \
@@ -198,7 +355,7 @@
                                                                                \
     /* List.push_front(T value) */                                             \
     STORAGE void MTD(List, push_front, /, T MPROT(value)) {                    \
-        ListNode *MPROT(now) = CREOBJRAWHEAP(ListNode);                        \
+        ListNode *MPROT(now) = CALL(List, *self, alloc_node, /);               \
         MPROT(now)->data = MPROT(value);                                       \
         MPROT(now)->next = self->head;                                         \
         MPROT(now)->prev = NULL;                                               \
@@ -214,7 +371,7 @@
                                                                                \
     /* List.push_back(T value) */                                              \
     STORAGE void MTD(List, push_back, /, T MPROT(value)) {                     \
-        ListNode *MPROT(now) = CREOBJRAWHEAP(ListNode);                        \
+        ListNode *MPROT(now) = CALL(List, *self, alloc_node, /);               \
         MPROT(now)->data = MPROT(value);                                       \
         MPROT(now)->prev = self->tail;                                         \
         MPROT(now)->next = NULL;                                               \
@@ -239,7 +396,7 @@
         } else {                                                               \
             self->tail = NULL;                                                 \
         }                                                                      \
-        free(MPROT(now));                                                      \
+        CALL(List, *self, free_node, /, MPROT(now));                           \
         self->size--;                                                          \
         return MPROT(value);                                                   \
     }                                                                          \
@@ -255,7 +412,7 @@
         } else {                                                               \
             self->head = NULL;                                                 \
         }                                                                      \
-        free(MPROT(now));                                                      \
+        CALL(List, *self, free_node, /, MPROT(now));                           \
         self->size--;                                                          \
         return MPROT(value);                                                   \
     }                                                                          \
@@ -274,15 +431,16 @@
         ListNode *MPROT(ret) = MPROT(it)->next;                                \
         NSCALL(List, drop_value, /, &MPROT(it)->data);                         \
         self->size--;                                                          \
-        free(MPROT(it));                                                       \
+        CALL(List, *self, free_node, /, MPROT(it));                            \
         return MPROT(ret);                                                     \
     }                                                                          \
     /* List.insert_after(ListNode *it, T value) */                             \
     STORAGE void MTD(List, insert_after, /, ListNode * it, T value) {          \
         if (!it) {                                                             \
             CALL(List, *self, push_front, /, value);                           \
+            return;                                                            \
         }                                                                      \
-        ListNode *MPROT(now) = CREOBJRAWHEAP(ListNode);                        \
+        ListNode *MPROT(now) = CALL(List, *self, alloc_node, /);               \
         MPROT(now)->data = value;                                              \
         MPROT(now)->next = it->next;                                           \
         MPROT(now)->prev = it;                                                 \
@@ -293,4 +451,182 @@
         }                                                                      \
         it->next = MPROT(now);                                                 \
         self->size++;                                                          \
+    }                                                                          \
+                                                                               \
+    /* List.splice(ListNode *pos, List *other, ListNode *first,                \
+     *             ListNode *last) */                                          \
+    STORAGE void MTD(List, splice, /, ListNode * MPROT(pos),                   \
+                     List * MPROT(other), ListNode * MPROT(first),             \
+                     ListNode * MPROT(last)) {                                 \
+        if (MPROT(first) == MPROT(last)) {                                     \
+            return;                                                            \
+        }                                                                      \
+        ASSERT(self->pool == MPROT(other)->pool);                              \
+        usize MPROT(n) = 0;                                                    \
+        if (MPROT(other) != self) {                                            \
+            if (MPROT(first) == MPROT(other)->head && !MPROT(last)) {          \
+                MPROT(n) = MPROT(other)->size;                                 \
+            } else {                                                           \
+                for (ListNode *MPROT(it) = MPROT(first);                       \
+                     MPROT(it) != MPROT(last); MPROT(it) = MPROT(it)->next) {  \
+                    MPROT(n)++;                                                \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+        ListNode *MPROT(back) =                                                \
+            MPROT(last) ? MPROT(last)->prev : MPROT(other)->tail;              \
+        if (MPROT(first)->prev) {                                              \
+            MPROT(first)->prev->next = MPROT(last);                            \
+        } else {                                                               \
+            MPROT(other)->head = MPROT(last);                                  \
+        }                                                                      \
+        if (MPROT(last)) {                                                     \
+            MPROT(last)->prev = MPROT(first)->prev;                            \
+        } else {                                                               \
+            MPROT(other)->tail = MPROT(first)->prev;                           \
+        }                                                                      \
+        MPROT(other)->size -= MPROT(n);                                        \
+        ListNode *MPROT(before) = MPROT(pos) ? MPROT(pos)->prev : self->tail;  \
+        MPROT(first)->prev = MPROT(before);                                    \
+        MPROT(back)->next = MPROT(pos);                                        \
+        if (MPROT(before)) {                                                   \
+            MPROT(before)->next = MPROT(first);                                \
+        } else {                                                               \
+            self->head = MPROT(first);                                         \
+        }                                                                      \
+        if (MPROT(pos)) {                                                      \
+            MPROT(pos)->prev = MPROT(back);                                    \
+        } else {                                                               \
+            self->tail = MPROT(back);                                          \
+        }                                                                      \
+        self->size += MPROT(n);                                                \
+    }
+
+/// declare at .h files
+#undef DECLARE_LIST_ALGORITHM
+#define DECLARE_LIST_ALGORITHM(List, T, STORAGE, com_gen)                      \
+    DECLARE_LIST_ALGORITHM_INNER(List, CONCATENATE(List, Node), typeof(T),     \
+                                 STORAGE);                                     \
+    com_gen(List, T);
+
+/// define at .c files
+#undef DEFINE_LIST_ALGORITHM
+#define DEFINE_LIST_ALGORITHM(List, T, STORAGE)                                \
+    DEFINE_LIST_ALGORITHM_INNER(List, CONCATENATE(List, Node), typeof(T),      \
+                                STORAGE);
+
+#undef DECLARE_LIST_ALGORITHM_INNER
+#define DECLARE_LIST_ALGORITHM_INNER(List, ListNode, T, STORAGE)               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* List::comparator(const T *a, const T *b) -> int */                      \
+    FUNC_STATIC int NSMTD(List, comparator, /, const T *a, const T *b);        \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* List.sort() */                                                          \
+    STORAGE void MTD(List, sort, /);                                           \
+                                                                               \
+    /* List.merge(List *other) */                                              \
+    STORAGE void MTD(List, merge, /, List * other);                            \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* List.is_sorted() -> bool */                                             \
+    FUNC_STATIC bool MTD(List, is_sorted, /) {                                 \
+        for (ListNode *MPROT(it) = self->head; MPROT(it) && MPROT(it)->next;   \
+             MPROT(it) = MPROT(it)->next) {                                    \
+            if (NSCALL(List, comparator, /, &MPROT(it)->next->data,            \
+                       &MPROT(it)->data) < 0) {                                \
+                return false;                                                  \
+            }                                                                  \
+        }                                                                      \
+        return true;                                                           \
+    }
+
+#undef DEFINE_LIST_ALGORITHM_INNER
+#define DEFINE_LIST_ALGORITHM_INNER(List, ListNode, T, STORAGE)                \
+    /* merge the sorted chains a and b, linked by next only, stable (the       \
+     * elements of a come first among equal ones); return the head */          \
+    static ListNode *NSMTD(List, merge_chains, /, ListNode * MPROT(a),         \
+                           ListNode * MPROT(b)) {                              \
+        ListNode *MPROT(head) = NULL;                                          \
+        ListNode **MPROT(link) = &MPROT(head);                                 \
+        while (MPROT(a) && MPROT(b)) {                                         \
+            if (NSCALL(List, comparator, /, &MPROT(b)->data,                   \
+                       &MPROT(a)->data) < 0) {                                 \
+                *MPROT(link) = MPROT(b);                                       \
+                MPROT(b) = MPROT(b)->next;                                     \
+            } else {                                                           \
+                *MPROT(link) = MPROT(a);                                       \
+                MPROT(a) = MPROT(a)->next;                                     \
+            }                                                                  \
+            MPROT(link) = &(*MPROT(link))->next;                               \
+        }                                                                      \
+        *MPROT(link) = MPROT(a) ? MPROT(a) : MPROT(b);                         \
+        return MPROT(head);                                                    \
+    }                                                                          \
+                                                                               \
+    /* rebuild the prev links and the tail after relinking by next */          \
+    static void MTD(List, relink_prev, /) {                                    \
+        ListNode *MPROT(prev) = NULL;                                          \
+        for (ListNode *MPROT(it) = self->head; MPROT(it);                      \
+             MPROT(it) = MPROT(it)->next) {                                    \
+            MPROT(it)->prev = MPROT(prev);                                     \
+            MPROT(prev) = MPROT(it);                                           \
+        }                                                                      \
+        self->tail = MPROT(prev);                                              \
+    }                                                                          \
+                                                                               \
+    /* List.sort() */                                                          \
+    STORAGE void MTD(List, sort, /) {                                          \
+        if (self->size < 2) {                                                  \
+            return;                                                            \
+        }                                                                      \
+        /* runs[i] is a sorted chain of 2^i nodes or NULL, like the bits of a  \
+         * binary counter, so that each merge works on recently touched nodes; \
+         * higher runs hold older nodes, which come first for stability */     \
+        ListNode *MPROT(runs)[sizeof(usize) * 8] = {NULL};                     \
+        usize MPROT(n_runs) = 0;                                               \
+        ListNode *MPROT(it) = self->head;                                      \
+        while (MPROT(it)) {                                                    \
+            ListNode *MPROT(chain) = MPROT(it);                                \
+            MPROT(it) = MPROT(it)->next;                                       \
+            MPROT(chain)->next = NULL;                                         \
+            usize MPROT(i) = 0;                                                \
+            for (; MPROT(i) < MPROT(n_runs) && MPROT(runs)[MPROT(i)];          \
+                 MPROT(i)++) {                                                 \
+                MPROT(chain) = NSCALL(List, merge_chains, /,                   \
+                                      MPROT(runs)[MPROT(i)], MPROT(chain));    \
+                MPROT(runs)[MPROT(i)] = NULL;                                  \
+            }                                                                  \
+            if (MPROT(i) == MPROT(n_runs)) {                                   \
+                MPROT(n_runs)++;                                               \
+            }                                                                  \
+            MPROT(runs)[MPROT(i)] = MPROT(chain);                              \
+        }                                                                      \
+        ListNode *MPROT(sorted) = NULL;                                        \
+        for (usize MPROT(i) = 0; MPROT(i) < MPROT(n_runs); MPROT(i)++) {       \
+            if (MPROT(runs)[MPROT(i)]) {                                       \
+                MPROT(sorted) = NSCALL(List, merge_chains, /,                  \
+                                       MPROT(runs)[MPROT(i)], MPROT(sorted));  \
+            }                                                                  \
+        }                                                                      \
+        self->head = MPROT(sorted);                                            \
+        CALL(List, *self, relink_prev, /);                                     \
+    }                                                                          \
+                                                                               \
+    /* List.merge(List *other) */                                              \
+    STORAGE void MTD(List, merge, /, List * MPROT(other)) {                    \
+        if (MPROT(other) == self || !MPROT(other)->head) {                     \
+            return;                                                            \
+        }                                                                      \
+        ASSERT(self->pool == MPROT(other)->pool);                              \
+        self->head =                                                           \
+            NSCALL(List, merge_chains, /, self->head, MPROT(other)->head);     \
+        CALL(List, *self, relink_prev, /);                                     \
+        self->size += MPROT(other)->size;                                      \
+        MPROT(other)->head = NULL;                                             \
+        MPROT(other)->tail = NULL;                                             \
+        MPROT(other)->size = 0;                                                \
     }
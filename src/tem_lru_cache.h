@@ -0,0 +1,428 @@
+// clang-format off
+/// tem_lru_cache.h: provides a template for implementing fixed-capacity LRU / CLOCK caches.
+///
+/// The entries live in one array allocated at init, and a flat open-addressing index (linear probing, at most half
+/// full) maps the hashes of the keys to them; the recency list is threaded through the entries by u32 links, so no
+/// operation allocates after init and get / put / erase / evict are O(1) on average.
+///
+/// Inserting into a full cache evicts one entry, passed to the eviction callback (if set) before being dropped:
+///     - LRU (init): the least recently used entry; a hit moves its entry to the front of the recency list.
+///     - CLOCK (init_clock): a hand sweeps the entries, clearing their referenced bits, and evicts the first one whose
+///       bit is clear; a hit only sets the bit of its entry, without relinking, which keeps hits cheap and write-light
+///       (the cache itself takes no lock).
+/// The counters hits, misses (of get) and evictions are kept in the fields of the same names.
+///
+/// Macros:
+///     DECLARE_LRU_CACHE(Cache, K, V, STORAGE, key_gen, value_gen, com_gen, hash_gen): declare a cache.
+///         key_gen: define the key generator.
+///         - GENERATOR_PLAIN_KEY: define a plain key generator.
+///         - GENERATOR_CLASS_KEY: define a class key generator.
+///         - GENERATOR_CUSTOM_KEY: define a custom key generator.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///         com_gen: define the comparator generator; keys are equal if the comparator returns 0.
+///         - GENERATOR_PLAIN_COMPARATOR: define a plain comparator generator.
+///         - GENERATOR_CLASS_COMPARATOR: define a class comparator generator.
+///         - GENERATOR_CUSTOM_COMPARATOR: define a custom comparator generator.
+///         hash_gen: define the hash generator.
+///         - GENERATOR_PLAIN_HASH: define a plain hash generator.
+///         - GENERATOR_CLASS_HASH: define a class hash generator.
+///         - GENERATOR_CUSTOM_HASH: define a custom hash generator.
+///     DEFINE_LRU_CACHE(Cache, K, V, STORAGE): define a cache.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// CacheEvictCallback is `void (*)(K *key, V *value, void *ctx)`.
+///
+/// Cache Methods:
+///     Cache.init(usize capacity): initialize an LRU cache of capacity entries.
+///     Cache.init_clock(usize capacity): initialize a CLOCK cache of capacity entries.
+///     Cache.drop(): drop the cache; the eviction callback is not called.
+///     Cache.set_evict_callback(CacheEvictCallback callback, void *ctx): set the eviction callback (NULL for none).
+///     Cache.get(const K *key) -> V *: find the value of a key and mark it used, or return NULL; counts a hit or a
+///         miss.
+///     Cache.peek(const K *key) -> V *: find the value of a key, neither marking it nor counting.
+///     Cache.put(K key, V value) -> V *: insert or assign a key-value pair, mark it used, and return the value.
+///     Cache.erase(const K *key) -> bool: remove (and drop) the entry of a key, or return false if not found.
+///     Cache.clear(): remove (and drop) all the entries; the counters are kept.
+///     Cache.reset_stats(): zero the counters.
+///     Cache.empty() -> bool: check if the cache is empty.
+///
+/// The entries are iterated from the most recently inserted or used (LRU) or inserted (CLOCK) one: from
+/// `entries + head`, following the `next` links until LRU_CACHE_NONE.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+/// the end of the recency list and of the free list
+#undef LRU_CACHE_NONE
+#define LRU_CACHE_NONE ((u32)-1)
+
+/// declare at .h files
+#undef DECLARE_LRU_CACHE
+#define DECLARE_LRU_CACHE(Cache, K, V, STORAGE, key_gen, value_gen, com_gen,   \
+                          hash_gen)                                            \
+    DECLARE_LRU_CACHE_INNER(Cache, CONCATENATE(Cache, Entry),                  \
+                            CONCATENATE(Cache, EvictCallback), typeof(K),      \
+                            typeof(V), STORAGE);                               \
+    key_gen(Cache, K);                                                         \
+    value_gen(Cache, V);                                                       \
+    com_gen(Cache, K);                                                         \
+    hash_gen(Cache, K);
+
+#undef DECLARE_LRU_CACHE_INNER
+#define DECLARE_LRU_CACHE_INNER(Cache, CacheEntry, CacheEvictCallback, K, V,   \
+                                STORAGE)                                       \
+    typedef struct CacheEntry {                                                \
+        K key;                                                                 \
+        V value;                                                               \
+        u64 hash;                                                              \
+        /* the recency list, most recent first; next also links the free */    \
+        u32 prev;                                                              \
+        u32 next;                                                              \
+        bool referenced;                                                       \
+    } CacheEntry;                                                              \
+                                                                               \
+    typedef void (*CacheEvictCallback)(K * key, V * value, void *ctx);         \
+                                                                               \
+    typedef struct Cache {                                                     \
+        CacheEntry *entries;                                                   \
+        /* the index: each bucket holds an entry + 1, or 0 if empty */         \
+        u32 *buckets;                                                          \
+        usize bucket_mask;                                                     \
+        usize capacity;                                                        \
+        usize size;                                                            \
+        /* the entries [0, used) have been taken once */                       \
+        usize used;                                                            \
+        u32 head;                                                              \
+        u32 tail;                                                              \
+        u32 free_head;                                                         \
+        /* the hand of CLOCK */                                                \
+        usize hand;                                                            \
+        bool clock;                                                            \
+        CacheEvictCallback on_evict;                                           \
+        void *evict_ctx;                                                       \
+        u64 hits;                                                              \
+        u64 misses;                                                            \
+        u64 evictions;                                                         \
+    } Cache;                                                                   \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* Cache::comparator(const K *a, const K *b) -> int */                     \
+    FUNC_STATIC int NSMTD(Cache, comparator, /, const K *a, const K *b);       \
+                                                                               \
+    /* Cache::hash(const K *key) -> u64 */                                     \
+    FUNC_STATIC u64 NSMTD(Cache, hash, /, const K *key);                       \
+                                                                               \
+    /* Cache::drop_key(K *key) */                                              \
+    FUNC_STATIC void NSMTD(Cache, drop_key, /, K * key);                       \
+                                                                               \
+    /* Cache::drop_value(V *value) */                                          \
+    FUNC_STATIC void NSMTD(Cache, drop_value, /, V * value);                   \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* Cache.init(usize capacity) */                                           \
+    STORAGE void MTD(Cache, init, /, usize capacity);                          \
+                                                                               \
+    /* Cache.init_clock(usize capacity) */                                     \
+    STORAGE void MTD(Cache, init_clock, /, usize capacity);                    \
+                                                                               \
+    /* Cache.drop() */                                                         \
+    STORAGE void MTD(Cache, drop, /);                                          \
+                                                                               \
+    /* Cache.get(const K *key) -> V * */                                       \
+    STORAGE V *MTD(Cache, get, /, const K *key);                               \
+                                                                               \
+    /* Cache.peek(const K *key) -> V * */                                      \
+    STORAGE V *MTD(Cache, peek, /, const K *key);                              \
+                                                                               \
+    /* Cache.put(K key, V value) -> V * */                                     \
+    STORAGE V *MTD(Cache, put, /, K key, V value);                             \
+                                                                               \
+    /* Cache.erase(const K *key) -> bool */                                    \
+    STORAGE bool MTD(Cache, erase, /, const K *key);                           \
+                                                                               \
+    /* Cache.clear() */                                                        \
+    STORAGE void MTD(Cache, clear, /);                                         \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    DELETED_CLONER(Cache, FUNC_STATIC);                                        \
+                                                                               \
+    /* Cache.set_evict_callback(CacheEvictCallback callback, void *ctx) */     \
+    FUNC_STATIC void MTD(Cache, set_evict_callback, /,                         \
+                         CacheEvictCallback callback, void *ctx) {             \
+        self->on_evict = callback;                                             \
+        self->evict_ctx = ctx;                                                 \
+    }                                                                          \
+                                                                               \
+    /* Cache.reset_stats() */                                                  \
+    FUNC_STATIC void MTD(Cache, reset_stats, /) {                              \
+        self->hits = 0;                                                        \
+        self->misses = 0;                                                      \
+        self->evictions = 0;                                                   \
+    }                                                                          \
+                                                                               \
+    /* Cache.empty() -> bool */                                                \
+    FUNC_STATIC bool MTD(Cache, empty, /) { return self->size == 0; }
+
+/// define at .c files
+#undef DEFINE_LRU_CACHE
+#define DEFINE_LRU_CACHE(Cache, K, V, STORAGE)                                 \
+    DEFINE_LRU_CACHE_INNER(Cache, CONCATENATE(Cache, Entry), typeof(K),        \
+                           typeof(V), STORAGE)
+
+#undef DEFINE_LRU_CACHE_INNER
+#define DEFINE_LRU_CACHE_INNER(Cache, CacheEntry, K, V, STORAGE)               \
+    static void MTD(Cache, setup, /, usize MPROT(capacity),                    \
+                    bool MPROT(clock)) {                                       \
+        ASSERT(MPROT(capacity) > 0 && MPROT(capacity) < LRU_CACHE_NONE,        \
+               "bad capacity");                                                \
+        usize MPROT(n_buckets) = 2;                                            \
+        while (MPROT(n_buckets) < MPROT(capacity) * 2) {                       \
+            MPROT(n_buckets) *= 2;                                             \
+        }                                                                      \
+        self->entries =                                                        \
+            (CacheEntry *)malloc(MPROT(capacity) * sizeof(CacheEntry));        \
+        self->buckets = (u32 *)calloc(MPROT(n_buckets), sizeof(u32));          \
+        ASSERT(self->entries && self->buckets);                                \
+        self->bucket_mask = MPROT(n_buckets) - 1;                              \
+        self->capacity = MPROT(capacity);                                      \
+        self->size = 0;                                                        \
+        self->used = 0;                                                        \
+        self->head = LRU_CACHE_NONE;                                           \
+        self->tail = LRU_CACHE_NONE;                                           \
+        self->free_head = LRU_CACHE_NONE;                                      \
+        self->hand = 0;                                                        \
+        self->clock = MPROT(clock);                                            \
+        self->on_evict = NULL;                                                 \
+        self->evict_ctx = NULL;                                                \
+        CALL(Cache, *self, reset_stats, /);                                    \
+    }                                                                          \
+                                                                               \
+    /* the bucket holding a key, or bucket_mask + 1 if not found */            \
+    static usize MTD(Cache, find_bucket, /, const K *MPROT(key),               \
+                     u64 MPROT(hash)) {                                        \
+        usize MPROT(b) = (usize)MPROT(hash) & self->bucket_mask;               \
+        while (self->buckets[MPROT(b)]) {                                      \
+            CacheEntry *MPROT(e) =                                             \
+                self->entries + self->buckets[MPROT(b)] - 1;                   \
+            if (MPROT(e)->hash == MPROT(hash) &&                               \
+                NSCALL(Cache, comparator, /, &MPROT(e)->key, MPROT(key)) ==    \
+                    0) {                                                       \
+                return MPROT(b);                                               \
+            }                                                                  \
+            MPROT(b) = (MPROT(b) + 1) & self->bucket_mask;                     \
+        }                                                                      \
+        return self->bucket_mask + 1;                                          \
+    }                                                                          \
+                                                                               \
+    /* empty a bucket, shifting back the entries probed past it */             \
+    static void MTD(Cache, unindex, /, usize MPROT(b)) {                       \
+        usize MPROT(hole) = MPROT(b);                                          \
+        for (;;) {                                                             \
+            MPROT(b) = (MPROT(b) + 1) & self->bucket_mask;                     \
+            u32 MPROT(id) = self->buckets[MPROT(b)];                           \
+            if (!MPROT(id)) {                                                  \
+                break;                                                         \
+            }                                                                  \
+            usize MPROT(home) =                                                \
+                (usize)self->entries[MPROT(id) - 1].hash & self->bucket_mask;  \
+            /* the entry may move to the hole unless its home lies cyclically  \
+             * in (hole, b] */                                                 \
+            if (((MPROT(b) - MPROT(home)) & self->bucket_mask) >=              \
+                ((MPROT(b) - MPROT(hole)) & self->bucket_mask)) {              \
+                self->buckets[MPROT(hole)] = MPROT(id);                        \
+                MPROT(hole) = MPROT(b);                                        \
+            }                                                                  \
+        }                                                                      \
+        self->buckets[MPROT(hole)] = 0;                                        \
+    }                                                                          \
+                                                                               \
+    static void MTD(Cache, unlink, /, u32 MPROT(id)) {                         \
+        CacheEntry *MPROT(e) = self->entries + MPROT(id);                      \
+        if (MPROT(e)->prev != LRU_CACHE_NONE) {                                \
+            self->entries[MPROT(e)->prev].next = MPROT(e)->next;               \
+        } else {                                                               \
+            self->head = MPROT(e)->next;                                       \
+        }                                                                      \
+        if (MPROT(e)->next != LRU_CACHE_NONE) {                                \
+            self->entries[MPROT(e)->next].prev = MPROT(e)->prev;               \
+        } else {                                                               \
+            self->tail = MPROT(e)->prev;                                       \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void MTD(Cache, link_front, /, u32 MPROT(id)) {                     \
+        CacheEntry *MPROT(e) = self->entries + MPROT(id);                      \
+        MPROT(e)->prev = LRU_CACHE_NONE;                                       \
+        MPROT(e)->next = self->head;                                           \
+        if (self->head != LRU_CACHE_NONE) {                                    \
+            self->entries[self->head].prev = MPROT(id);                        \
+        } else {                                                               \
+            self->tail = MPROT(id);                                            \
+        }                                                                      \
+        self->head = MPROT(id);                                                \
+    }                                                                          \
+                                                                               \
+    static void MTD(Cache, touch, /, u32 MPROT(id)) {                          \
+        if (self->clock) {                                                     \
+            self->entries[MPROT(id)].referenced = true;                        \
+        } else if (self->head != MPROT(id)) {                                  \
+            CALL(Cache, *self, unlink, /, MPROT(id));                          \
+            CALL(Cache, *self, link_front, /, MPROT(id));                      \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* evict an entry of the full cache, and return it to be reused */         \
+    static u32 MTD(Cache, evict, /) {                                          \
+        u32 MPROT(id);                                                         \
+        if (self->clock) {                                                     \
+            while (self->entries[self->hand].referenced) {                     \
+                self->entries[self->hand].referenced = false;                  \
+                self->hand = (self->hand + 1) % self->capacity;                \
+            }                                                                  \
+            MPROT(id) = (u32)self->hand;                                       \
+            self->hand = (self->hand + 1) % self->capacity;                    \
+        } else {                                                               \
+            MPROT(id) = self->tail;                                            \
+        }                                                                      \
+        CacheEntry *MPROT(e) = self->entries + MPROT(id);                      \
+        usize MPROT(b) = CALL(Cache, *self, find_bucket, /, &MPROT(e)->key,    \
+                              MPROT(e)->hash);                                 \
+        CALL(Cache, *self, unindex, /, MPROT(b));                              \
+        CALL(Cache, *self, unlink, /, MPROT(id));                              \
+        if (self->on_evict) {                                                  \
+            self->on_evict(&MPROT(e)->key, &MPROT(e)->value, self->evict_ctx); \
+        }                                                                      \
+        NSCALL(Cache, drop_key, /, &MPROT(e)->key);                            \
+        NSCALL(Cache, drop_value, /, &MPROT(e)->value);                        \
+        self->size--;                                                          \
+        self->evictions++;                                                     \
+        return MPROT(id);                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cache, init, /, usize MPROT(capacity)) {                  \
+        CALL(Cache, *self, setup, /, MPROT(capacity), false);                  \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cache, init_clock, /, usize MPROT(capacity)) {            \
+        CALL(Cache, *self, setup, /, MPROT(capacity), true);                   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cache, drop, /) {                                         \
+        CALL(Cache, *self, clear, /);                                          \
+        free(self->entries);                                                   \
+        free(self->buckets);                                                   \
+        self->entries = NULL;                                                  \
+        self->buckets = NULL;                                                  \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE V *MTD(Cache, get, /, const K *MPROT(key)) {                       \
+        usize MPROT(b) = CALL(Cache, *self, find_bucket, /, MPROT(key),        \
+                              NSCALL(Cache, hash, /, MPROT(key)));             \
+        if (MPROT(b) > self->bucket_mask) {                                    \
+            self->misses++;                                                    \
+            return NULL;                                                       \
+        }                                                                      \
+        self->hits++;                                                          \
+        u32 MPROT(id) = self->buckets[MPROT(b)] - 1;                           \
+        CALL(Cache, *self, touch, /, MPROT(id));                               \
+        return &self->entries[MPROT(id)].value;                                \
+    }                                                                          \
+                                                                               \
+    STORAGE V *MTD(Cache, peek, /, const K *MPROT(key)) {                      \
+        usize MPROT(b) = CALL(Cache, *self, find_bucket, /, MPROT(key),        \
+                              NSCALL(Cache, hash, /, MPROT(key)));             \
+        if (MPROT(b) > self->bucket_mask) {                                    \
+            return NULL;                                                       \
+        }                                                                      \
+        return &self->entries[self->buckets[MPROT(b)] - 1].value;              \
+    }                                                                          \
+                                                                               \
+    STORAGE V *MTD(Cache, put, /, K MPROT(key), V MPROT(value)) {              \
+        u64 MPROT(hash) = NSCALL(Cache, hash, /, &MPROT(key));                 \
+        usize MPROT(b) =                                                       \
+            CALL(Cache, *self, find_bucket, /, &MPROT(key), MPROT(hash));      \
+        u32 MPROT(id);                                                         \
+        if (MPROT(b) <= self->bucket_mask) {                                   \
+            MPROT(id) = self->buckets[MPROT(b)] - 1;                           \
+            CacheEntry *MPROT(e) = self->entries + MPROT(id);                  \
+            NSCALL(Cache, drop_key, /, &MPROT(key));                           \
+            NSCALL(Cache, drop_value, /, &MPROT(e)->value);                    \
+            MPROT(e)->value = MPROT(value);                                    \
+            CALL(Cache, *self, touch, /, MPROT(id));                           \
+            return &MPROT(e)->value;                                           \
+        }                                                                      \
+        if (self->size == self->capacity) {                                    \
+            MPROT(id) = CALL(Cache, *self, evict, /);                          \
+        } else if (self->free_head != LRU_CACHE_NONE) {                        \
+            MPROT(id) = self->free_head;                                       \
+            self->free_head = self->entries[MPROT(id)].next;                   \
+        } else {                                                               \
+            MPROT(id) = (u32)self->used++;                                     \
+        }                                                                      \
+        CacheEntry *MPROT(e) = self->entries + MPROT(id);                      \
+        MPROT(e)->key = MPROT(key);                                            \
+        MPROT(e)->value = MPROT(value);                                        \
+        MPROT(e)->hash = MPROT(hash);                                          \
+        MPROT(e)->referenced = false;                                          \
+        CALL(Cache, *self, link_front, /, MPROT(id));                          \
+        MPROT(b) = (usize)MPROT(hash) & self->bucket_mask;                     \
+        while (self->buckets[MPROT(b)]) {                                      \
+            MPROT(b) = (MPROT(b) + 1) & self->bucket_mask;                     \
+        }                                                                      \
+        self->buckets[MPROT(b)] = MPROT(id) + 1;                               \
+        self->size++;                                                          \
+        return &MPROT(e)->value;                                               \
+    }                                                                          \
+                                                                               \
+    STORAGE bool MTD(Cache, erase, /, const K *MPROT(key)) {                   \
+        usize MPROT(b) = CALL(Cache, *self, find_bucket, /, MPROT(key),        \
+                              NSCALL(Cache, hash, /, MPROT(key)));             \
+        if (MPROT(b) > self->bucket_mask) {                                    \
+            return false;                                                      \
+        }                                                                      \
+        u32 MPROT(id) = self->buckets[MPROT(b)] - 1;                           \
+        CacheEntry *MPROT(e) = self->entries + MPROT(id);                      \
+        CALL(Cache, *self, unindex, /, MPROT(b));                              \
+        CALL(Cache, *self, unlink, /, MPROT(id));                              \
+        NSCALL(Cache, drop_key, /, &MPROT(e)->key);                            \
+        NSCALL(Cache, drop_value, /, &MPROT(e)->value);                        \
+        MPROT(e)->referenced = false;                                          \
+        MPROT(e)->next = self->free_head;                                      \
+        self->free_head = MPROT(id);                                           \
+        self->size--;                                                          \
+        return true;                                                           \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Cache, clear, /) {                                        \
+        for (u32 MPROT(id) = self->head; MPROT(id) != LRU_CACHE_NONE;          \
+             MPROT(id) = self->entries[MPROT(id)].next) {                      \
+            NSCALL(Cache, drop_key, /, &self->entries[MPROT(id)].key);         \
+            NSCALL(Cache, drop_value, /, &self->entries[MPROT(id)].value);     \
+        }                                                                      \
+        if (self->size > 0) {                                                  \
+            memset(self->buckets, 0,                                           \
+                   (self->bucket_mask + 1) * sizeof(u32));                     \
+        }                                                                      \
+        self->size = 0;                                                        \
+        self->used = 0;                                                        \
+        self->head = LRU_CACHE_NONE;                                           \
+        self->tail = LRU_CACHE_NONE;                                           \
+        self->free_head = LRU_CACHE_NONE;                                      \
+        self->hand = 0;                                                        \
+    }
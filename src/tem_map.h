@@ -16,6 +16,9 @@
 ///         - GENERATOR_CLASS_COMPARATOR: define a class comparator generator.
 ///         - GENERATOR_CUSTOM_COMPARATOR: define a custom comparator generator.
 ///     DEFINE_MAPPING(Mapping, K, V, STORAGE): define a mapping.
+///     DECLARE_MAPPING_WITH_ALLOCATOR(Mapping, K, V, STORAGE, key_gen, value_gen, com_gen, alloc_gen): declare a
+///         mapping with the memory of another allocator; DECLARE_MAPPING uses the libc heap.
+///         alloc_gen: define the allocator generator, see allocator.h.
 ///
 ///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
 ///
@@ -45,19 +48,39 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "allocator.h"
+#include "container_core.h"
 #include "debug.h"
 #include "tem_memory_primitive.h"
 #include "utils.h"
 
+/// the rotations and iteration of treaps, by the shared core with
+/// OOPINC_SHARED_CORE
+#undef DEFINE_MAPPING_LINKS
+#ifdef OOPINC_SHARED_CORE
+#define DEFINE_MAPPING_LINKS(MappingNode)                                      \
+    DEFINE_TREAP_NODE(MappingNode, link, TreapCore)
+#else
+#define DEFINE_MAPPING_LINKS(MappingNode)                                      \
+    DEFINE_TREAP_NODE(MappingNode, link, TreapLocal)
+#endif
+
 #undef DECLARE_MAPPING
 #define DECLARE_MAPPING(Mapping, K, V, STORAGE, key_gen, value_gen, com_gen)   \
+    DECLARE_MAPPING_WITH_ALLOCATOR(Mapping, K, V, STORAGE, key_gen, value_gen, \
+                                   com_gen, GENERATOR_LIBC_ALLOCATOR)
+
+#undef DECLARE_MAPPING_WITH_ALLOCATOR
+#define DECLARE_MAPPING_WITH_ALLOCATOR(Mapping, K, V, STORAGE, key_gen,        \
+                                       value_gen, com_gen, alloc_gen)          \
     DECLARE_MAPPING_INNER(Mapping, CONCATENATE(Mapping, Node),                 \
                           CONCATENATE(Mapping, InsertResult),                  \
                           CONCATENATE(Mapping, Iterator), typeof(K),           \
                           typeof(V), STORAGE);                                 \
     key_gen(Mapping, K);                                                       \
     value_gen(Mapping, V);                                                     \
-    com_gen(Mapping, K);
+    com_gen(Mapping, K);                                                       \
+    alloc_gen(Mapping);
 
 #undef DEFINE_MAPPING
 #define DEFINE_MAPPING(Mapping, K, V, STORAGE)                                 \
@@ -70,12 +93,9 @@
 #define DECLARE_MAPPING_INNER(Mapping, MappingNode, MappingInsertResult,       \
                               MappingIterator, K, V, STORAGE)                  \
     typedef struct MappingNode {                                               \
+        TreapCore link;                                                        \
         K key;                                                                 \
         V value;                                                               \
-        struct MappingNode *left_son;                                          \
-        struct MappingNode *right_son;                                         \
-        struct MappingNode *parent;                                            \
-        u64 random_value;                                                      \
     } MappingNode;                                                             \
                                                                                \
     typedef struct Mapping {                                                   \
@@ -107,6 +127,23 @@
     /* Mapping::clone_value(const V *other) -> V */                            \
     FUNC_STATIC V NSMTD(Mapping, clone_value, /, const V *other);              \
                                                                                \
+    /* Mapping::clone_from_key(K *key, const K *other) */                      \
+    FUNC_STATIC void NSMTD(Mapping, clone_from_key, /, K * key,                \
+                           const K *other);                                    \
+                                                                               \
+    /* Mapping::clone_from_value(V *value, const V *other) */                  \
+    FUNC_STATIC void NSMTD(Mapping, clone_from_value, /, V * value,            \
+                           const V *other);                                    \
+                                                                               \
+    /* Mapping::trivial_drop_key() -> bool */                                  \
+    FUNC_STATIC bool NSMTD(Mapping, trivial_drop_key, /);                      \
+                                                                               \
+    /* Mapping::trivial_drop_value() -> bool */                                \
+    FUNC_STATIC bool NSMTD(Mapping, trivial_drop_value, /);                    \
+                                                                               \
+    /* Mapping::allocator() -> Allocator * */                                  \
+    FUNC_STATIC Allocator *NSMTD(Mapping, allocator, /);                       \
+                                                                               \
     /* NOTE: Methods to implement in .c */                                     \
                                                                                \
     /* Mapping.drop() */                                                       \
@@ -173,6 +210,8 @@
 #undef DEFINE_MAPPING_INNER
 #define DEFINE_MAPPING_INNER(Mapping, MappingNode, MappingInsertResult,        \
                              MappingIterator, K, V, STORAGE)                   \
+    DEFINE_MAPPING_LINKS(MappingNode)                                          \
+                                                                               \
     /* MappingNode::random_value() -> u64 */                                   \
     static u64 NSMTD(MappingNode, random_value, /) {                           \
         /* NOTE: the thread safety is not guaranteed */                        \
@@ -187,10 +226,10 @@
     static void MTD(MappingNode, init, /, K MPROT(key), V MPROT(value)) {      \
         self->key = MPROT(key);                                                \
         self->value = MPROT(value);                                            \
-        self->left_son = NULL;                                                 \
-        self->right_son = NULL;                                                \
-        self->parent = NULL;                                                   \
-        self->random_value = NSMTD(MappingNode, random_value, /);              \
+        self->link.left_son = NULL;                                            \
+        self->link.right_son = NULL;                                           \
+        self->link.parent = NULL;                                              \
+        self->link.random_value = NSMTD(MappingNode, random_value, /);         \
     }                                                                          \
                                                                                \
     /* MappingNode.drop() */                                                   \
@@ -198,106 +237,101 @@
         NSCALL(Mapping, drop_key, /, &self->key);                              \
         NSCALL(Mapping, drop_value, /, &self->value);                          \
                                                                                \
-        if (self->left_son) {                                                  \
-            DROPOBJHEAP(MappingNode, self->left_son);                          \
-            self->left_son = NULL;                                             \
+        if (self->link.left_son) {                                             \
+            DROPOBJHEAP_IN(                                                    \
+                MappingNode, NSCALL(Mapping, allocator, /),                    \
+                NSCALL(MappingNode, entry, /, self->link.left_son));           \
+            self->link.left_son = NULL;                                        \
         }                                                                      \
-        if (self->right_son) {                                                 \
-            DROPOBJHEAP(MappingNode, self->right_son);                         \
-            self->right_son = NULL;                                            \
+        if (self->link.right_son) {                                            \
+            DROPOBJHEAP_IN(                                                    \
+                MappingNode, NSCALL(Mapping, allocator, /),                    \
+                NSCALL(MappingNode, entry, /, self->link.right_son));          \
+            self->link.right_son = NULL;                                       \
         }                                                                      \
     }                                                                          \
                                                                                \
-    /* MappingNode.clone_from(const MappingNode *other, bool free_before) */   \
+    /* MappingNode.clone_from(const MappingNode *other, bool reuse_kv); with   \
+     * reuse_kv, the key and value of the node are cloned into in place, so    \
+     * that their resources are reused */                                      \
     static void MTD(MappingNode, clone_from, /,                                \
-                    const MappingNode *MPROT(other),                           \
-                    bool MPROT(free_before)) {                                 \
+                    const MappingNode *MPROT(other), bool MPROT(reuse_kv)) {   \
         ASSERT(self);                                                          \
         ASSERT(MPROT(other));                                                  \
                                                                                \
-        if (MPROT(free_before)) {                                              \
-            NSCALL(Mapping, drop_key, /, &self->key);                          \
-            NSCALL(Mapping, drop_value, /, &self->value);                      \
+        if (MPROT(reuse_kv)) {                                                 \
+            NSCALL(Mapping, clone_from_key, /, &self->key,                     \
+                   &MPROT(other)->key);                                        \
+            NSCALL(Mapping, clone_from_value, /, &self->value,                 \
+                   &MPROT(other)->value);                                      \
+        } else {                                                               \
+            self->key = NSCALL(Mapping, clone_key, /, &MPROT(other)->key);     \
+            self->value =                                                      \
+                NSCALL(Mapping, clone_value, /, &MPROT(other)->value);         \
         }                                                                      \
-                                                                               \
-        self->key = NSCALL(Mapping, clone_key, /, &MPROT(other)->key);         \
-        self->value = NSCALL(Mapping, clone_value, /, &MPROT(other)->value);   \
-                                                                               \
-        if (MPROT(other)->left_son) {                                          \
-            bool MPROT(free_son_kv) = true;                                    \
-            if (!self->left_son) {                                             \
-                self->left_son = CREOBJRAWHEAP(MappingNode);                   \
-                self->left_son->left_son = NULL;                               \
-                self->left_son->right_son = NULL;                              \
-                self->left_son->parent = self;                                 \
-                self->left_son->random_value =                                 \
-                    MPROT(other)->left_son->random_value;                      \
-                MPROT(free_son_kv) = false;                                    \
+        /* a reused node takes the priority of the cloned one too */           \
+        self->link.random_value = MPROT(other)->link.random_value;             \
+                                                                               \
+        if (MPROT(other)->link.left_son) {                                     \
+            bool MPROT(reuse_son_kv) = true;                                   \
+            MappingNode *MPROT(son) =                                          \
+                NSCALL(MappingNode, entry, /, self->link.left_son);            \
+            if (!MPROT(son)) {                                                 \
+                MPROT(son) = CREOBJRAWHEAP_IN(MappingNode,                     \
+                                              NSCALL(Mapping, allocator, /));  \
+                MPROT(son)->link.left_son = NULL;                              \
+                MPROT(son)->link.right_son = NULL;                             \
+                MPROT(son)->link.parent = &self->link;                         \
+                self->link.left_son = &MPROT(son)->link;                       \
+                MPROT(reuse_son_kv) = false;                                   \
             }                                                                  \
-            CALL(MappingNode, *self->left_son, clone_from, /,                  \
-                 MPROT(other)->left_son, MPROT(free_son_kv));                  \
-        } else if (self->left_son) {                                           \
-            DROPOBJHEAP(MappingNode, self->left_son);                          \
-            self->left_son = NULL;                                             \
+            CALL(MappingNode, *MPROT(son), clone_from, /,                      \
+                 NSCALL(MappingNode, entry, /, MPROT(other)->link.left_son),   \
+                 MPROT(reuse_son_kv));                                         \
+        } else if (self->link.left_son) {                                      \
+            DROPOBJHEAP_IN(                                                    \
+                MappingNode, NSCALL(Mapping, allocator, /),                    \
+                NSCALL(MappingNode, entry, /, self->link.left_son));           \
+            self->link.left_son = NULL;                                        \
         }                                                                      \
                                                                                \
-        if (MPROT(other)->right_son) {                                         \
-            bool MPROT(free_son_kv) = true;                                    \
-            if (!self->right_son) {                                            \
-                self->right_son = CREOBJRAWHEAP(MappingNode);                  \
-                self->right_son->left_son = NULL;                              \
-                self->right_son->right_son = NULL;                             \
-                self->right_son->parent = self;                                \
-                self->right_son->random_value =                                \
-                    MPROT(other)->right_son->random_value;                     \
-                MPROT(free_son_kv) = false;                                    \
+        if (MPROT(other)->link.right_son) {                                    \
+            bool MPROT(reuse_son_kv) = true;                                   \
+            MappingNode *MPROT(son) =                                          \
+                NSCALL(MappingNode, entry, /, self->link.right_son);           \
+            if (!MPROT(son)) {                                                 \
+                MPROT(son) = CREOBJRAWHEAP_IN(MappingNode,                     \
+                                              NSCALL(Mapping, allocator, /));  \
+                MPROT(son)->link.left_son = NULL;                              \
+                MPROT(son)->link.right_son = NULL;                             \
+                MPROT(son)->link.parent = &self->link;                         \
+                self->link.right_son = &MPROT(son)->link;                      \
+                MPROT(reuse_son_kv) = false;                                   \
             }                                                                  \
-            CALL(MappingNode, *self->right_son, clone_from, /,                 \
-                 MPROT(other)->right_son, MPROT(free_son_kv));                 \
-        } else if (self->right_son) {                                          \
-            DROPOBJHEAP(MappingNode, self->right_son);                         \
-            self->right_son = NULL;                                            \
-        }                                                                      \
-    }                                                                          \
-                                                                               \
-    /* MappingNode::lturn(&MappingNode) */                                     \
-    static void NSMTD(MappingNode, lturn, /, MappingNode * *MPROT(p)) {        \
-        MappingNode *MPROT(son) = (*MPROT(p))->right_son;                      \
-        ASSERT(MPROT(son));                                                    \
-        (*MPROT(p))->right_son = MPROT(son)->left_son;                         \
-        if (MPROT(son)->left_son) {                                            \
-            MPROT(son)->left_son->parent = *MPROT(p);                          \
+            CALL(MappingNode, *MPROT(son), clone_from, /,                      \
+                 NSCALL(MappingNode, entry, /, MPROT(other)->link.right_son),  \
+                 MPROT(reuse_son_kv));                                         \
+        } else if (self->link.right_son) {                                     \
+            DROPOBJHEAP_IN(                                                    \
+                MappingNode, NSCALL(Mapping, allocator, /),                    \
+                NSCALL(MappingNode, entry, /, self->link.right_son));          \
+            self->link.right_son = NULL;                                       \
         }                                                                      \
-        MPROT(son)->left_son = *MPROT(p);                                      \
-        MPROT(son)->parent = (*MPROT(p))->parent;                              \
-        (*MPROT(p))->parent = MPROT(son);                                      \
-        *MPROT(p) = MPROT(son);                                                \
     }                                                                          \
                                                                                \
-    /* MappingNode::rturn(&MappingNode) */                                     \
-    static void NSMTD(MappingNode, rturn, /, MappingNode * *MPROT(p)) {        \
-        MappingNode *MPROT(son) = (*MPROT(p))->left_son;                       \
-        ASSERT(MPROT(son));                                                    \
-        (*MPROT(p))->left_son = MPROT(son)->right_son;                         \
-        if (MPROT(son)->right_son) {                                           \
-            MPROT(son)->right_son->parent = *MPROT(p);                         \
-        }                                                                      \
-        MPROT(son)->right_son = *MPROT(p);                                     \
-        MPROT(son)->parent = (*MPROT(p))->parent;                              \
-        (*MPROT(p))->parent = MPROT(son);                                      \
-        *MPROT(p) = MPROT(son);                                                \
-    }                                                                          \
-                                                                               \
-    /* MappingNode::insert(&MappingNode, K key, V value) ->                    \
+    /* MappingNode::insert(TreapCore **p, K key, V value, bool overwrite) ->   \
      * MappingInsertResult */                                                  \
     static MappingInsertResult NSMTD(MappingNode, insert, /,                   \
-                                     MappingNode * *MPROT(p), K MPROT(key),    \
+                                     TreapCore * *MPROT(p), K MPROT(key),      \
                                      V MPROT(value), bool MPROT(overwrite)) {  \
         ASSERT(MPROT(p));                                                      \
-        MappingNode *MPROT(node) = *MPROT(p);                                  \
+        MappingNode *MPROT(node) = NSCALL(MappingNode, entry, /, *MPROT(p));   \
         if (!MPROT(node)) {                                                    \
-            *MPROT(p) = CREOBJHEAP(MappingNode, /, MPROT(key), MPROT(value));  \
-            return (MappingInsertResult){*MPROT(p), true};                     \
+            MPROT(node) =                                                      \
+                CREOBJHEAP_IN(MappingNode, NSCALL(Mapping, allocator, /), /,   \
+                              MPROT(key), MPROT(value));                       \
+            *MPROT(p) = &MPROT(node)->link;                                    \
+            return (MappingInsertResult){MPROT(node), true};                   \
         }                                                                      \
         int MPROT(cmp_val) =                                                   \
             NSCALL(Mapping, comparator, /, &MPROT(node)->key, &MPROT(key));    \
@@ -314,26 +348,26 @@
             }                                                                  \
         } else if (MPROT(cmp_val) > 0) {                                       \
             MappingInsertResult MPROT(result) =                                \
-                NSCALL(MappingNode, insert, /, &MPROT(node)->left_son,         \
+                NSCALL(MappingNode, insert, /, &MPROT(node)->link.left_son,    \
                        MPROT(key), MPROT(value), MPROT(overwrite));            \
             if (MPROT(result).inserted) {                                      \
-                ASSERT(MPROT(node)->left_son);                                 \
-                MPROT(node)->left_son->parent = MPROT(node);                   \
-                if (MPROT(node)->left_son->random_value <                      \
-                    MPROT(node)->random_value) {                               \
+                ASSERT(MPROT(node)->link.left_son);                            \
+                MPROT(node)->link.left_son->parent = &MPROT(node)->link;       \
+                if (MPROT(node)->link.left_son->random_value <                 \
+                    MPROT(node)->link.random_value) {                          \
                     NSCALL(MappingNode, rturn, /, MPROT(p));                   \
                 }                                                              \
             }                                                                  \
             return MPROT(result);                                              \
         } else {                                                               \
             MappingInsertResult MPROT(result) =                                \
-                NSCALL(MappingNode, insert, /, &MPROT(node)->right_son,        \
+                NSCALL(MappingNode, insert, /, &MPROT(node)->link.right_son,   \
                        MPROT(key), MPROT(value), MPROT(overwrite));            \
             if (MPROT(result).inserted) {                                      \
-                ASSERT(MPROT(node)->right_son);                                \
-                MPROT(node)->right_son->parent = MPROT(node);                  \
-                if (MPROT(node)->right_son->random_value <                     \
-                    MPROT(node)->random_value) {                               \
+                ASSERT(MPROT(node)->link.right_son);                           \
+                MPROT(node)->link.right_son->parent = &MPROT(node)->link;      \
+                if (MPROT(node)->link.right_son->random_value <                \
+                    MPROT(node)->link.random_value) {                          \
                     NSCALL(MappingNode, lturn, /, MPROT(p));                   \
                 }                                                              \
             }                                                                  \
@@ -351,98 +385,36 @@
         if (MPROT(cmp_val) == 0) {                                             \
             return self;                                                       \
         } else if (MPROT(cmp_val) > 0) {                                       \
-            return NSCALL(MappingNode, find, /, self->left_son, MPROT(key));   \
+            return NSCALL(MappingNode, find, /,                                \
+                          NSCALL(MappingNode, entry, /, self->link.left_son),  \
+                          MPROT(key));                                         \
         } else {                                                               \
-            return NSCALL(MappingNode, find, /, self->right_son, MPROT(key));  \
-        }                                                                      \
-    }                                                                          \
-                                                                               \
-    /* MappingNode::erase(&MappingNode) */                                     \
-    static void NSMTD(MappingNode, erase, /, MappingNode * *MPROT(p)) {        \
-        ASSERT(MPROT(p));                                                      \
-        while (true) {                                                         \
-            MappingNode *MPROT(node) = *MPROT(p);                              \
-            if (!MPROT(node)) {                                                \
-                return;                                                        \
-            }                                                                  \
-            if (!MPROT(node)->left_son) {                                      \
-                *MPROT(p) = MPROT(node)->right_son;                            \
-                if (*MPROT(p)) {                                               \
-                    (*MPROT(p))->parent = MPROT(node)->parent;                 \
-                }                                                              \
-                MPROT(node)->right_son = NULL;                                 \
-                DROPOBJHEAP(MappingNode, MPROT(node));                         \
-                return;                                                        \
-            } else if (!MPROT(node)->right_son) {                              \
-                *MPROT(p) = MPROT(node)->left_son;                             \
-                if (*MPROT(p)) {                                               \
-                    (*MPROT(p))->parent = MPROT(node)->parent;                 \
-                }                                                              \
-                MPROT(node)->left_son = NULL;                                  \
-                DROPOBJHEAP(MappingNode, MPROT(node));                         \
-                return;                                                        \
-            } else {                                                           \
-                if (MPROT(node)->left_son->random_value <                      \
-                    MPROT(node)->right_son->random_value) {                    \
-                    NSCALL(MappingNode, rturn, /, MPROT(p));                   \
-                    MPROT(p) = &(*MPROT(p))->right_son;                        \
-                } else {                                                       \
-                    NSCALL(MappingNode, lturn, /, MPROT(p));                   \
-                    MPROT(p) = &(*MPROT(p))->left_son;                         \
-                }                                                              \
-            }                                                                  \
+            return NSCALL(MappingNode, find, /,                                \
+                          NSCALL(MappingNode, entry, /, self->link.right_son), \
+                          MPROT(key));                                         \
         }                                                                      \
     }                                                                          \
                                                                                \
     /* MappingNode.is_left_son() -> bool */                                    \
     static bool MTD(MappingNode, is_left_son, /) {                             \
-        return self->parent && self->parent->left_son == self;                 \
-    }                                                                          \
-                                                                               \
-    /* MappingNode.next() -> MappingIterator */                                \
-    static MappingIterator MTD(MappingNode, next, /) {                         \
-        if (self->right_son) {                                                 \
-            MappingNode *MPROT(node) = self->right_son;                        \
-            while (MPROT(node)->left_son) {                                    \
-                MPROT(node) = MPROT(node)->left_son;                           \
-            }                                                                  \
-            return MPROT(node);                                                \
-        } else {                                                               \
-            MappingNode *MPROT(node) = self;                                   \
-            while (MPROT(node)->parent &&                                      \
-                   MPROT(node)->parent->right_son == MPROT(node)) {            \
-                MPROT(node) = MPROT(node)->parent;                             \
-            }                                                                  \
-            return MPROT(node)->parent;                                        \
-        }                                                                      \
-    }                                                                          \
-                                                                               \
-    /* MappingNode.prev() -> MappingIterator */                                \
-    static MappingIterator MTD(MappingNode, prev, /) {                         \
-        if (self->left_son) {                                                  \
-            MappingNode *MPROT(node) = self->left_son;                         \
-            while (MPROT(node)->right_son) {                                   \
-                MPROT(node) = MPROT(node)->right_son;                          \
-            }                                                                  \
-            return MPROT(node);                                                \
-        } else {                                                               \
-            ASSERT(self->parent);                                              \
-            MappingNode *MPROT(node) = self;                                   \
-            while (MPROT(node)->parent &&                                      \
-                   MPROT(node)->parent->left_son == MPROT(node)) {             \
-                MPROT(node) = MPROT(node)->parent;                             \
-            }                                                                  \
-            return MPROT(node)->parent;                                        \
-        }                                                                      \
+        return self->link.parent &&                                            \
+               self->link.parent->left_son == &self->link;                     \
     }                                                                          \
                                                                                \
     /* Implement the interface */                                              \
                                                                                \
     STORAGE void MTD(Mapping, drop, /) {                                       \
-        if (self->root) {                                                      \
-            DROPOBJHEAP(MappingNode, self->root);                              \
-            self->root = NULL;                                                 \
+        Allocator *MPROT(allocator) = NSCALL(Mapping, allocator, /);           \
+        /* the nodes of an allocator freeing nothing, which hold nothing to    \
+         * drop, are left as they are */                                       \
+        bool MPROT(walk) =                                                     \
+            NSCALL(Allocator, frees_blocks, /, MPROT(allocator)) ||            \
+            !NSCALL(Mapping, trivial_drop_key, /) ||                           \
+            !NSCALL(Mapping, trivial_drop_value, /);                           \
+        if (self->root && MPROT(walk)) {                                       \
+            DROPOBJHEAP_IN(MappingNode, MPROT(allocator), self->root);         \
         }                                                                      \
+        self->root = NULL;                                                     \
         self->size = 0;                                                        \
     }                                                                          \
                                                                                \
@@ -451,19 +423,20 @@
             return;                                                            \
         }                                                                      \
         if (MPROT(other)->root) {                                              \
-            bool MPROT(free_kv) = true;                                        \
+            bool MPROT(reuse_kv) = true;                                       \
             if (!self->root) {                                                 \
-                self->root = CREOBJRAWHEAP(MappingNode);                       \
-                self->root->left_son = NULL;                                   \
-                self->root->right_son = NULL;                                  \
-                self->root->parent = NULL;                                     \
-                self->root->random_value = MPROT(other)->root->random_value;   \
-                MPROT(free_kv) = false;                                        \
+                self->root = CREOBJRAWHEAP_IN(                                 \
+                    MappingNode, NSCALL(Mapping, allocator, /));               \
+                self->root->link.left_son = NULL;                              \
+                self->root->link.right_son = NULL;                             \
+                self->root->link.parent = NULL;                                \
+                MPROT(reuse_kv) = false;                                       \
             }                                                                  \
             CALL(MappingNode, *self->root, clone_from, /, MPROT(other)->root,  \
-                 MPROT(free_kv));                                              \
+                 MPROT(reuse_kv));                                             \
         } else if (self->root) {                                               \
-            DROPOBJHEAP(MappingNode, self->root);                              \
+            DROPOBJHEAP_IN(MappingNode, NSCALL(Mapping, allocator, /),         \
+                           self->root);                                        \
             self->root = NULL;                                                 \
         }                                                                      \
         self->size = MPROT(other)->size;                                       \
@@ -471,9 +444,11 @@
                                                                                \
     static MappingInsertResult MTD(Mapping, insert_inner, /, K MPROT(key),     \
                                    V MPROT(value), bool MPROT(overwrite)) {    \
+        TreapCore *MPROT(root) = self->root ? &self->root->link : NULL;        \
         MappingInsertResult MPROT(res) =                                       \
-            NSCALL(MappingNode, insert, /, &self->root, MPROT(key),            \
+            NSCALL(MappingNode, insert, /, &MPROT(root), MPROT(key),           \
                    MPROT(value), MPROT(overwrite));                            \
+        self->root = NSCALL(MappingNode, entry, /, MPROT(root));               \
         if (MPROT(res).inserted) {                                             \
             self->size++;                                                      \
         }                                                                      \
@@ -522,13 +497,18 @@
                                                                                \
     STORAGE void MTD(Mapping, erase, /, MappingIterator MPROT(node)) {         \
         ASSERT(MPROT(node));                                                   \
-        MappingNode **MPROT(p) = &self->root;                                  \
-        if (MPROT(node)->parent) {                                             \
+        TreapCore *MPROT(root) = &self->root->link;                            \
+        TreapCore **MPROT(p) = &MPROT(root);                                   \
+        if (MPROT(node)->link.parent) {                                        \
             MPROT(p) = CALL(MappingNode, *MPROT(node), is_left_son, /)         \
-                           ? &MPROT(node)->parent->left_son                    \
-                           : &MPROT(node)->parent->right_son;                  \
+                           ? &MPROT(node)->link.parent->left_son               \
+                           : &MPROT(node)->link.parent->right_son;             \
         }                                                                      \
-        NSCALL(MappingNode, erase, /, MPROT(p));                               \
+        MappingNode *MPROT(unlinked) =                                         \
+            NSCALL(MappingNode, unlink, /, MPROT(p));                          \
+        self->root = NSCALL(MappingNode, entry, /, MPROT(root));               \
+        DROPOBJHEAP_IN(MappingNode, NSCALL(Mapping, allocator, /),             \
+                       MPROT(unlinked));                                       \
         self->size--;                                                          \
     }                                                                          \
                                                                                \
@@ -545,33 +525,20 @@
         if (!self->root) {                                                     \
             return NULL;                                                       \
         }                                                                      \
-        MappingNode *MPROT(node) = self->root;                                 \
-        while (MPROT(node)->left_son) {                                        \
-            MPROT(node) = MPROT(node)->left_son;                               \
-        }                                                                      \
-        return MPROT(node);                                                    \
+        return NSCALL(MappingNode, leftmost, /, self->root);                   \
     }                                                                          \
                                                                                \
     STORAGE MappingIterator MTD(Mapping, next, /,                              \
                                 MappingIterator MPROT(node)) {                 \
         ASSERT(MPROT(node));                                                   \
-        MappingIterator MPROT(res) = CALL(MappingNode, *MPROT(node), next, /); \
-        if (!MPROT(res)) {                                                     \
-            return NULL;                                                       \
-        } else {                                                               \
-            return MPROT(res);                                                 \
-        }                                                                      \
+        return CALL(MappingNode, *MPROT(node), next, /);                       \
     }                                                                          \
                                                                                \
     STORAGE MappingIterator MTD(Mapping, prev, /,                              \
                                 MappingIterator MPROT(node)) {                 \
         if (!MPROT(node)) {                                                    \
             ASSERT(self->root);                                                \
-            MappingNode *MPROT(res) = self->root;                              \
-            while (MPROT(res)->right_son) {                                    \
-                MPROT(res) = MPROT(res)->right_son;                            \
-            }                                                                  \
-            return MPROT(res);                                                 \
+            return NSCALL(MappingNode, rightmost, /, self->root);              \
         } else {                                                               \
             return CALL(MappingNode, *MPROT(node), prev, /);                   \
         }                                                                      \
@@ -586,9 +553,11 @@
                 NSCALL(Mapping, comparator, /, &MPROT(node)->key, MPROT(key)); \
             if (MPROT(cmp_val) >= 0) {                                         \
                 MPROT(res) = MPROT(node);                                      \
-                MPROT(node) = MPROT(node)->left_son;                           \
+                MPROT(node) = NSCALL(MappingNode, entry, /,                    \
+                                     MPROT(node)->link.left_son);              \
             } else {                                                           \
-                MPROT(node) = MPROT(node)->right_son;                          \
+                MPROT(node) = NSCALL(MappingNode, entry, /,                    \
+                                     MPROT(node)->link.right_son);             \
             }                                                                  \
         }                                                                      \
         return MPROT(res);                                                     \
@@ -603,9 +572,11 @@
                 NSCALL(Mapping, comparator, /, &MPROT(node)->key, MPROT(key)); \
             if (MPROT(cmp_val) > 0) {                                          \
                 MPROT(res) = MPROT(node);                                      \
-                MPROT(node) = MPROT(node)->left_son;                           \
+                MPROT(node) = NSCALL(MappingNode, entry, /,                    \
+                                     MPROT(node)->link.left_son);              \
             } else {                                                           \
-                MPROT(node) = MPROT(node)->right_son;                          \
+                MPROT(node) = NSCALL(MappingNode, entry, /,                    \
+                                     MPROT(node)->link.right_son);             \
             }                                                                  \
         }                                                                      \
         return MPROT(res);                                                     \
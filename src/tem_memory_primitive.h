@@ -1,23 +1,45 @@
 #pragma once
 
+#include <string.h>
+
 #include "utils.h"
 
+/// Comparator generators define `Container::comparator(const K *a, const K *b)
+/// -> int`, and `Container::natural_order() -> bool` telling whether the order
+/// is the builtin `<` of K, which allows algorithms to pick faster paths.
+///
+/// Key (value) generators define `Container::drop_key(K *key)`,
+/// `Container::clone_key(const K *other) -> K`,
+/// `Container::clone_from_key(K *key, const K *other)` cloning into an existing
+/// key (reusing its resources), and the traits
+/// `Container::trivial_drop_key() -> bool` and
+/// `Container::trivial_clone_key() -> bool` telling whether the drop does
+/// nothing and the clone is a bitwise copy (see DECLARE_TRIVIAL_CLONE in
+/// utils.h), which allows containers to skip drop loops and memcpy clones.
+///
+/// Hash generators define `Container::hash(const K *key) -> u64`, which must
+/// agree with the comparator: keys comparing equal hash equally. The plain
+/// hash reads the bytes of K, so it is only right for keys without padding.
+
 #undef GENERATOR_PLAIN_COMPARATOR
 #define GENERATOR_PLAIN_COMPARATOR(Container, K)                               \
     FUNC_STATIC int NSMTD(Container, comparator, /, const typeof(K) *MPROT(a), \
                           const typeof(K) *MPROT(b)) {                         \
         return *MPROT(a) < *MPROT(b) ? -1 : (*MPROT(a) > *MPROT(b) ? 1 : 0);   \
-    }
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, natural_order, /) { return true; }
 
 #undef GENERATOR_CLASS_COMPARATOR
 #define GENERATOR_CLASS_COMPARATOR(Container, K)                               \
     FUNC_STATIC int NSMTD(Container, comparator, /, const typeof(K) *MPROT(a), \
                           const typeof(K) *MPROT(b)) {                         \
         return NSCALL(K, compare, /, MPROT(a), MPROT(b));                      \
-    }
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, natural_order, /) { return false; }
 
 #undef GENERATOR_CUSTOM_COMPARATOR
-#define GENERATOR_CUSTOM_COMPARATOR(Container, K)
+#define GENERATOR_CUSTOM_COMPARATOR(Container, K)                              \
+    FUNC_STATIC bool NSMTD(Container, natural_order, /) { return false; }
 
 #undef GENERATOR_PLAIN_KEY
 #define GENERATOR_PLAIN_KEY(Container, K)                                      \
@@ -26,7 +48,14 @@
     FUNC_STATIC typeof(K) NSMTD(Container, clone_key, /,                       \
                                 const typeof(K) *MPROT(other)) {               \
         return *MPROT(other);                                                  \
-    }
+    }                                                                          \
+    FUNC_STATIC void NSMTD(Container, clone_from_key, /,                       \
+                           typeof(K) *MPROT(key),                              \
+                           const typeof(K) *MPROT(other)) {                    \
+        *MPROT(key) = *MPROT(other);                                           \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_drop_key, /) { return true; }    \
+    FUNC_STATIC bool NSMTD(Container, trivial_clone_key, /) { return true; }
 
 #undef GENERATOR_CLASS_KEY
 #define GENERATOR_CLASS_KEY(Container, K)                                      \
@@ -36,6 +65,17 @@
     FUNC_STATIC typeof(K) NSMTD(Container, clone_key, /,                       \
                                 const typeof(K) *MPROT(other)) {               \
         return CALL(K, *MPROT(other), clone, /);                               \
+    }                                                                          \
+    FUNC_STATIC void NSMTD(Container, clone_from_key, /,                       \
+                           typeof(K) *MPROT(key),                              \
+                           const typeof(K) *MPROT(other)) {                    \
+        CALL(K, *MPROT(key), clone_from, /, MPROT(other));                     \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_drop_key, /) {                   \
+        return TYPE_IS_TRIVIAL_DROP(K);                                        \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_clone_key, /) {                  \
+        return TYPE_IS_TRIVIAL_CLONE(K);                                       \
     }
 
 #undef GENERATOR_CUSTOM_KEY
@@ -48,7 +88,14 @@
     FUNC_STATIC typeof(V) NSMTD(Container, clone_value, /,                     \
                                 const typeof(V) *MPROT(other)) {               \
         return *MPROT(other);                                                  \
-    }
+    }                                                                          \
+    FUNC_STATIC void NSMTD(Container, clone_from_value, /,                     \
+                           typeof(V) *MPROT(value),                            \
+                           const typeof(V) *MPROT(other)) {                    \
+        *MPROT(value) = *MPROT(other);                                         \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_drop_value, /) { return true; }  \
+    FUNC_STATIC bool NSMTD(Container, trivial_clone_value, /) { return true; }
 
 #undef GENERATOR_CLASS_VALUE
 #define GENERATOR_CLASS_VALUE(Container, V)                                    \
@@ -59,7 +106,59 @@
     FUNC_STATIC typeof(V) NSMTD(Container, clone_value, /,                     \
                                 const typeof(V) *MPROT(other)) {               \
         return CALL(V, *MPROT(other), clone, /);                               \
+    }                                                                          \
+    FUNC_STATIC void NSMTD(Container, clone_from_value, /,                     \
+                           typeof(V) *MPROT(value),                            \
+                           const typeof(V) *MPROT(other)) {                    \
+        CALL(V, *MPROT(value), clone_from, /, MPROT(other));                   \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_drop_value, /) {                 \
+        return TYPE_IS_TRIVIAL_DROP(V);                                        \
+    }                                                                          \
+    FUNC_STATIC bool NSMTD(Container, trivial_clone_value, /) {                \
+        return TYPE_IS_TRIVIAL_CLONE(V);                                       \
     }
 
 #undef GENERATOR_CUSTOM_VALUE
 #define GENERATOR_CUSTOM_VALUE(Container, V)
+
+/// Hash::mix(u64 x) -> u64: scrambles the bits of x (the finalizer of
+/// splitmix64), so that close keys spread over the buckets
+FUNC_STATIC u64 NSMTD(Hash, mix, /, u64 x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/// Hash::bytes(const void *data, usize len) -> u64: hashes a byte string
+/// (FNV-1a, then mixed)
+FUNC_STATIC u64 NSMTD(Hash, bytes, /, const void *data, usize len) {
+    const unsigned char *p = (const unsigned char *)data;
+    u64 h = 0xcbf29ce484222325ull;
+    for (usize i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ull;
+    }
+    return NSCALL(Hash, mix, /, h);
+}
+
+#undef GENERATOR_PLAIN_HASH
+#define GENERATOR_PLAIN_HASH(Container, K)                                     \
+    FUNC_STATIC u64 NSMTD(Container, hash, /, const typeof(K) *MPROT(key)) {   \
+        if (sizeof(K) <= sizeof(u64)) {                                        \
+            u64 MPROT(x) = 0;                                                  \
+            memcpy(&MPROT(x), MPROT(key), Min(sizeof(K), sizeof(u64)));        \
+            return NSCALL(Hash, mix, /, MPROT(x));                             \
+        }                                                                      \
+        return NSCALL(Hash, bytes, /, MPROT(key), sizeof(K));                  \
+    }
+
+#undef GENERATOR_CLASS_HASH
+#define GENERATOR_CLASS_HASH(Container, K)                                     \
+    FUNC_STATIC u64 NSMTD(Container, hash, /, const typeof(K) *MPROT(key)) {   \
+        return CALL(K, *MPROT(key), hash, /);                                  \
+    }
+
+#undef GENERATOR_CUSTOM_HASH
+#define GENERATOR_CUSTOM_HASH(Container, K)
@@ -0,0 +1,458 @@
+// clang-format off
+/// tem_priority_queue.h: provides templates for implementing d-ary heap priority queues.
+///
+/// The top of a queue is its minimum by the comparator; a comparator reversing the order gives a max-queue.
+///
+/// Macros:
+///     DECLARE_PRIORITY_QUEUE(PQ, Vec, T, D, STORAGE, com_gen): declare a priority queue stored in Vec, a plain or
+///         class vector of T declared before.
+///         D: the arity of the heap, e.g. 2 for a binary heap; 4 is usually faster for large queues.
+///         com_gen: define the comparator generator, see tem_algorithm.h.
+///     DEFINE_PRIORITY_QUEUE(PQ, Vec, T, D, STORAGE): define a priority queue.
+///     DECLARE_INDEXED_PRIORITY_QUEUE(IPQ, T, D, STORAGE, com_gen, value_gen): declare an indexed priority queue,
+///         whose elements are addressed by the handles returned by push.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_INDEXED_PRIORITY_QUEUE(IPQ, T, D, STORAGE): define an indexed priority queue.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// PriorityQueue Methods:
+///     PQ.init(): initialize the queue.
+///     PQ.drop(): drop the queue.
+///     PQ.clone_from(const PQ *other): clone the queue from another queue.
+///     PQ.clone() const -> PQ: clone the queue.
+///     PQ::from_vec(Vec vec) -> PQ: build a queue from a vector in O(n), taking its ownership.
+///     PQ.push(T value): push a value.
+///     PQ.pop() -> T: pop the top value.
+///     PQ.remove_top(): remove (and drop) the top value.
+///     PQ.top() -> T *: get the top value.
+///     PQ.size() -> usize: the number of values.
+///     PQ.empty() -> bool: check if the queue is empty.
+///     PQ.clear(): clear the queue.
+///
+/// IndexedPriorityQueue Methods:
+///     IPQ.init(): initialize the queue.
+///     IPQ.drop(): drop the queue.
+///     IPQ.clone_from(const IPQ *other): clone the queue from another queue, with the same handles.
+///     IPQ.clone() const -> IPQ: clone the queue.
+///     IPQ.push(T value) -> usize: push a value, and return its handle; the handles of removed values are reused.
+///     IPQ.pop() -> T: pop the top value.
+///     IPQ.remove(usize handle) -> T: remove the value of a handle.
+///     IPQ.update(usize handle, T value): replace (and drop) the value of a handle.
+///     IPQ.decrease_key(usize handle, T value): replace (and drop) the value of a handle by one not greater.
+///     IPQ.top() -> T *: get the top value.
+///     IPQ.top_handle() -> usize: get the handle of the top value.
+///     IPQ.get(usize handle) -> T *: get the value of a handle.
+///     IPQ.contains(usize handle) -> bool: check if a handle is in the queue.
+///     IPQ.size() -> usize: the number of values.
+///     IPQ.empty() -> bool: check if the queue is empty.
+///     IPQ.clear(): clear the queue.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+#undef PRIORITY_QUEUE_NO_POS
+#define PRIORITY_QUEUE_NO_POS ((usize)-1)
+
+/// declare at .h files
+#undef DECLARE_PRIORITY_QUEUE
+#define DECLARE_PRIORITY_QUEUE(PQ, Vec, T, D, STORAGE, com_gen)                \
+    DECLARE_PRIORITY_QUEUE_INNER(PQ, Vec, typeof(T), D, STORAGE);              \
+    com_gen(PQ, T);
+
+#undef DECLARE_PRIORITY_QUEUE_INNER
+#define DECLARE_PRIORITY_QUEUE_INNER(PQ, Vec, T, D, STORAGE)                   \
+    _Static_assert(D >= 2, "the arity of a heap must be at least 2");          \
+                                                                               \
+    typedef struct PQ {                                                        \
+        Vec heap;                                                              \
+    } PQ;                                                                      \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* PQ::comparator(const T *a, const T *b) -> int */                        \
+    FUNC_STATIC int NSMTD(PQ, comparator, /, const T *a, const T *b);          \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* PQ::from_vec(Vec vec) -> PQ */                                          \
+    STORAGE PQ NSMTD(PQ, from_vec, /, Vec vec);                                \
+                                                                               \
+    /* PQ.push(T value) */                                                     \
+    STORAGE void MTD(PQ, push, /, T value);                                    \
+                                                                               \
+    /* PQ.pop() -> T */                                                        \
+    STORAGE T MTD(PQ, pop, /);                                                 \
+                                                                               \
+    /* PQ.remove_top() */                                                      \
+    STORAGE void MTD(PQ, remove_top, /);                                       \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* PQ.init() */                                                            \
+    FUNC_STATIC void MTD(PQ, init, /) { self->heap = CREOBJ(Vec, /); }         \
+                                                                               \
+    /* PQ.drop() */                                                            \
+    FUNC_STATIC void MTD(PQ, drop, /) { DROPOBJ(Vec, self->heap); }            \
+                                                                               \
+    /* PQ.clone_from(const PQ *other) */                                       \
+    FUNC_STATIC void MTD(PQ, clone_from, /, const PQ *other) {                 \
+        CALL(Vec, self->heap, clone_from, /, &other->heap);                    \
+    }                                                                          \
+                                                                               \
+    /* PQ.clone() const -> PQ */                                               \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(PQ, /);                                   \
+                                                                               \
+    /* PQ.top() -> T * */                                                      \
+    FUNC_STATIC T *MTD(PQ, top, /) {                                           \
+        return CALL(Vec, self->heap, front, /);                                \
+    }                                                                          \
+                                                                               \
+    /* PQ.size() -> usize */                                                   \
+    FUNC_STATIC usize MTD(PQ, size, /) { return self->heap.size; }             \
+                                                                               \
+    /* PQ.empty() -> bool */                                                   \
+    FUNC_STATIC bool MTD(PQ, empty, /) { return self->heap.size == 0; }        \
+                                                                               \
+    /* PQ.clear() */                                                           \
+    FUNC_STATIC void MTD(PQ, clear, /) { CALL(Vec, self->heap, clear, /); }
+
+/// define at .c files
+#undef DEFINE_PRIORITY_QUEUE
+#define DEFINE_PRIORITY_QUEUE(PQ, Vec, T, D, STORAGE)                          \
+    DEFINE_PRIORITY_QUEUE_INNER(PQ, Vec, typeof(T), D, STORAGE)
+
+#undef DEFINE_PRIORITY_QUEUE_INNER
+#define DEFINE_PRIORITY_QUEUE_INNER(PQ, Vec, T, D, STORAGE)                    \
+    static void MTD(PQ, sift_up, /, usize i) {                                 \
+        T *MPROT(a) = self->heap.data;                                         \
+        T MPROT(x) = MPROT(a)[i];                                              \
+        while (i > 0) {                                                        \
+            usize MPROT(parent) = (i - 1) / (D);                               \
+            if (NSCALL(PQ, comparator, /, &MPROT(x),                           \
+                       MPROT(a) + MPROT(parent)) >= 0) {                       \
+                break;                                                         \
+            }                                                                  \
+            MPROT(a)[i] = MPROT(a)[MPROT(parent)];                             \
+            i = MPROT(parent);                                                 \
+        }                                                                      \
+        MPROT(a)[i] = MPROT(x);                                                \
+    }                                                                          \
+                                                                               \
+    static void MTD(PQ, sift_down, /, usize i) {                               \
+        T *MPROT(a) = self->heap.data;                                         \
+        usize MPROT(n) = self->heap.size;                                      \
+        T MPROT(x) = MPROT(a)[i];                                              \
+        while (i * (D) + 1 < MPROT(n)) {                                       \
+            usize MPROT(first) = i * (D) + 1;                                  \
+            usize MPROT(last) = Min(MPROT(first) + (D), MPROT(n));             \
+            usize MPROT(best) = MPROT(first);                                  \
+            for (usize j = MPROT(first) + 1; j < MPROT(last); j++) {           \
+                if (NSCALL(PQ, comparator, /, MPROT(a) + j,                    \
+                           MPROT(a) + MPROT(best)) < 0) {                      \
+                    MPROT(best) = j;                                           \
+                }                                                              \
+            }                                                                  \
+            if (NSCALL(PQ, comparator, /, MPROT(a) + MPROT(best),              \
+                       &MPROT(x)) >= 0) {                                      \
+                break;                                                         \
+            }                                                                  \
+            MPROT(a)[i] = MPROT(a)[MPROT(best)];                               \
+            i = MPROT(best);                                                   \
+        }                                                                      \
+        MPROT(a)[i] = MPROT(x);                                                \
+    }                                                                          \
+                                                                               \
+    STORAGE PQ NSMTD(PQ, from_vec, /, Vec MPROT(vec)) {                        \
+        PQ MPROT(pq) = {.heap = MPROT(vec)};                                   \
+        for (usize i = MPROT(vec).size / (D) + 1; i-- > 0;) {                  \
+            if (i < MPROT(vec).size) {                                         \
+                CALL(PQ, MPROT(pq), sift_down, /, i);                          \
+            }                                                                  \
+        }                                                                      \
+        return MPROT(pq);                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(PQ, push, /, T MPROT(value)) {                            \
+        CALL(Vec, self->heap, push_back, /, MPROT(value));                     \
+        CALL(PQ, *self, sift_up, /, self->heap.size - 1);                      \
+    }                                                                          \
+                                                                               \
+    STORAGE T MTD(PQ, pop, /) {                                                \
+        ASSERT(self->heap.size > 0);                                           \
+        T MPROT(top) = self->heap.data[0];                                     \
+        /* the top is moved out, so the vector must not drop it */             \
+        self->heap.data[0] = self->heap.data[--self->heap.size];               \
+        if (self->heap.size > 0) {                                             \
+            CALL(PQ, *self, sift_down, /, 0);                                  \
+        }                                                                      \
+        return MPROT(top);                                                     \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(PQ, remove_top, /) {                                      \
+        ASSERT(self->heap.size > 0);                                           \
+        usize MPROT(last) = self->heap.size - 1;                               \
+        T MPROT(top) = self->heap.data[0];                                     \
+        self->heap.data[0] = self->heap.data[MPROT(last)];                     \
+        self->heap.data[MPROT(last)] = MPROT(top);                             \
+        CALL(Vec, self->heap, pop_back, /);                                    \
+        if (self->heap.size > 0) {                                             \
+            CALL(PQ, *self, sift_down, /, 0);                                  \
+        }                                                                      \
+    }
+
+/// declare at .h files
+#undef DECLARE_INDEXED_PRIORITY_QUEUE
+#define DECLARE_INDEXED_PRIORITY_QUEUE(IPQ, T, D, STORAGE, com_gen, value_gen) \
+    DECLARE_INDEXED_PRIORITY_QUEUE_INNER(                                      \
+        IPQ, CONCATENATE(IPQ, Entry), CONCATENATE(IPQ, EntryVec),              \
+        CONCATENATE(IPQ, HandleVec), typeof(T), D, STORAGE);                   \
+    com_gen(IPQ, T);                                                           \
+    value_gen(IPQ, T);
+
+#undef DECLARE_INDEXED_PRIORITY_QUEUE_INNER
+#define DECLARE_INDEXED_PRIORITY_QUEUE_INNER(IPQ, IPQEntry, EntryVec,          \
+                                             HandleVec, T, D, STORAGE)         \
+    _Static_assert(D >= 2, "the arity of a heap must be at least 2");          \
+                                                                               \
+    typedef struct IPQEntry {                                                  \
+        T value;                                                               \
+        usize handle;                                                          \
+    } IPQEntry;                                                                \
+                                                                               \
+    DECLARE_PLAIN_VEC(EntryVec, IPQEntry, FUNC_STATIC);                        \
+    DEFINE_PLAIN_VEC(EntryVec, IPQEntry, FUNC_STATIC);                         \
+    DECLARE_PLAIN_VEC(HandleVec, usize, FUNC_STATIC);                          \
+    DEFINE_PLAIN_VEC(HandleVec, usize, FUNC_STATIC);                           \
+                                                                               \
+    typedef struct IPQ {                                                       \
+        EntryVec heap;                                                         \
+        /* the heap position of each handle, or PRIORITY_QUEUE_NO_POS */       \
+        HandleVec pos;                                                         \
+        HandleVec free_handles;                                                \
+    } IPQ;                                                                     \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* IPQ::comparator(const T *a, const T *b) -> int */                       \
+    FUNC_STATIC int NSMTD(IPQ, comparator, /, const T *a, const T *b);         \
+                                                                               \
+    /* IPQ::drop_value(T *value) */                                            \
+    FUNC_STATIC void NSMTD(IPQ, drop_value, /, T * value);                     \
+                                                                               \
+    /* IPQ::clone_value(const T *other) -> T */                                \
+    FUNC_STATIC T NSMTD(IPQ, clone_value, /, const T *other);                  \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* IPQ.drop() */                                                           \
+    STORAGE void MTD(IPQ, drop, /);                                            \
+                                                                               \
+    /* IPQ.clone_from(const IPQ *other) */                                     \
+    STORAGE void MTD(IPQ, clone_from, /, const IPQ *other);                    \
+                                                                               \
+    /* IPQ.clear() */                                                          \
+    STORAGE void MTD(IPQ, clear, /);                                           \
+                                                                               \
+    /* IPQ.push(T value) -> usize */                                           \
+    STORAGE usize MTD(IPQ, push, /, T value);                                  \
+                                                                               \
+    /* IPQ.remove(usize handle) -> T */                                        \
+    STORAGE T MTD(IPQ, remove, /, usize handle);                               \
+                                                                               \
+    /* IPQ.update(usize handle, T value) */                                    \
+    STORAGE void MTD(IPQ, update, /, usize handle, T value);                   \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* IPQ.init() */                                                           \
+    FUNC_STATIC void MTD(IPQ, init, /) {                                       \
+        self->heap = CREOBJ(EntryVec, /);                                      \
+        self->pos = CREOBJ(HandleVec, /);                                      \
+        self->free_handles = CREOBJ(HandleVec, /);                             \
+    }                                                                          \
+                                                                               \
+    /* IPQ.clone() const -> IPQ */                                             \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(IPQ, /);                                  \
+                                                                               \
+    /* IPQ.contains(usize handle) -> bool */                                   \
+    FUNC_STATIC bool MTD(IPQ, contains, /, usize handle) {                     \
+        return handle < self->pos.size &&                                      \
+               self->pos.data[handle] != PRIORITY_QUEUE_NO_POS;                \
+    }                                                                          \
+                                                                               \
+    /* IPQ.get(usize handle) -> T * */                                         \
+    FUNC_STATIC T *MTD(IPQ, get, /, usize handle) {                            \
+        ASSERT(CALL(IPQ, *self, contains, /, handle));                         \
+        return &self->heap.data[self->pos.data[handle]].value;                 \
+    }                                                                          \
+                                                                               \
+    /* IPQ.top() -> T * */                                                     \
+    FUNC_STATIC T *MTD(IPQ, top, /) {                                          \
+        return &CALL(EntryVec, self->heap, front, /)->value;                   \
+    }                                                                          \
+                                                                               \
+    /* IPQ.top_handle() -> usize */                                            \
+    FUNC_STATIC usize MTD(IPQ, top_handle, /) {                                \
+        return CALL(EntryVec, self->heap, front, /)->handle;                   \
+    }                                                                          \
+                                                                               \
+    /* IPQ.pop() -> T */                                                       \
+    FUNC_STATIC T MTD(IPQ, pop, /) {                                           \
+        usize MPROT(handle) = CALL(IPQ, *self, top_handle, /);                 \
+        return CALL(IPQ, *self, remove, /, MPROT(handle));                     \
+    }                                                                          \
+                                                                               \
+    /* IPQ.decrease_key(usize handle, T value) */                              \
+    FUNC_STATIC void MTD(IPQ, decrease_key, /, usize handle, T value) {        \
+        ASSERT(NSCALL(IPQ, comparator, /, &value,                              \
+                      CALL(IPQ, *self, get, /, handle)) <= 0,                  \
+               "decrease_key with a greater value");                           \
+        CALL(IPQ, *self, update, /, handle, value);                            \
+    }                                                                          \
+                                                                               \
+    /* IPQ.size() -> usize */                                                  \
+    FUNC_STATIC usize MTD(IPQ, size, /) { return self->heap.size; }            \
+                                                                               \
+    /* IPQ.empty() -> bool */                                                  \
+    FUNC_STATIC bool MTD(IPQ, empty, /) { return self->heap.size == 0; }
+
+/// define at .c files
+#undef DEFINE_INDEXED_PRIORITY_QUEUE
+#define DEFINE_INDEXED_PRIORITY_QUEUE(IPQ, T, D, STORAGE)                      \
+    DEFINE_INDEXED_PRIORITY_QUEUE_INNER(IPQ, CONCATENATE(IPQ, Entry),          \
+                                        CONCATENATE(IPQ, EntryVec),            \
+                                        CONCATENATE(IPQ, HandleVec),           \
+                                        typeof(T), D, STORAGE)
+
+#undef DEFINE_INDEXED_PRIORITY_QUEUE_INNER
+#define DEFINE_INDEXED_PRIORITY_QUEUE_INNER(IPQ, IPQEntry, EntryVec,           \
+                                            HandleVec, T, D, STORAGE)          \
+    /* place an entry at a heap position, and record the position */           \
+    static void MTD(IPQ, place, /, usize i, IPQEntry MPROT(entry)) {           \
+        self->heap.data[i] = MPROT(entry);                                     \
+        self->pos.data[MPROT(entry).handle] = i;                               \
+    }                                                                          \
+                                                                               \
+    static void MTD(IPQ, sift_up, /, usize i) {                                \
+        IPQEntry *MPROT(a) = self->heap.data;                                  \
+        IPQEntry MPROT(x) = MPROT(a)[i];                                       \
+        while (i > 0) {                                                        \
+            usize MPROT(parent) = (i - 1) / (D);                               \
+            if (NSCALL(IPQ, comparator, /, &MPROT(x).value,                    \
+                       &MPROT(a)[MPROT(parent)].value) >= 0) {                 \
+                break;                                                         \
+            }                                                                  \
+            CALL(IPQ, *self, place, /, i, MPROT(a)[MPROT(parent)]);            \
+            i = MPROT(parent);                                                 \
+        }                                                                      \
+        CALL(IPQ, *self, place, /, i, MPROT(x));                               \
+    }                                                                          \
+                                                                               \
+    static void MTD(IPQ, sift_down, /, usize i) {                              \
+        IPQEntry *MPROT(a) = self->heap.data;                                  \
+        usize MPROT(n) = self->heap.size;                                      \
+        IPQEntry MPROT(x) = MPROT(a)[i];                                       \
+        while (i * (D) + 1 < MPROT(n)) {                                       \
+            usize MPROT(first) = i * (D) + 1;                                  \
+            usize MPROT(last) = Min(MPROT(first) + (D), MPROT(n));             \
+            usize MPROT(best) = MPROT(first);                                  \
+            for (usize j = MPROT(first) + 1; j < MPROT(last); j++) {           \
+                if (NSCALL(IPQ, comparator, /, &MPROT(a)[j].value,             \
+                           &MPROT(a)[MPROT(best)].value) < 0) {                \
+                    MPROT(best) = j;                                           \
+                }                                                              \
+            }                                                                  \
+            if (NSCALL(IPQ, comparator, /, &MPROT(a)[MPROT(best)].value,       \
+                       &MPROT(x).value) >= 0) {                                \
+                break;                                                         \
+            }                                                                  \
+            CALL(IPQ, *self, place, /, i, MPROT(a)[MPROT(best)]);              \
+            i = MPROT(best);                                                   \
+        }                                                                      \
+        CALL(IPQ, *self, place, /, i, MPROT(x));                               \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(IPQ, drop, /) {                                           \
+        CALL(IPQ, *self, clear, /);                                            \
+        DROPOBJ(EntryVec, self->heap);                                         \
+        DROPOBJ(HandleVec, self->pos);                                         \
+        DROPOBJ(HandleVec, self->free_handles);                                \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(IPQ, clone_from, /, const IPQ *MPROT(other)) {            \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(IPQ, *self, clear, /);                                            \
+        CALL(EntryVec, self->heap, clone_from, /, &MPROT(other)->heap);        \
+        for (usize i = 0; i < self->heap.size; i++) {                          \
+            self->heap.data[i].value = NSCALL(                                 \
+                IPQ, clone_value, /, &MPROT(other)->heap.data[i].value);       \
+        }                                                                      \
+        CALL(HandleVec, self->pos, clone_from, /, &MPROT(other)->pos);         \
+        CALL(HandleVec, self->free_handles, clone_from, /,                     \
+             &MPROT(other)->free_handles);                                     \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(IPQ, clear, /) {                                          \
+        for (usize i = 0; i < self->heap.size; i++) {                          \
+            NSCALL(IPQ, drop_value, /, &self->heap.data[i].value);             \
+        }                                                                      \
+        CALL(EntryVec, self->heap, clear, /);                                  \
+        CALL(HandleVec, self->pos, clear, /);                                  \
+        CALL(HandleVec, self->free_handles, clear, /);                         \
+    }                                                                          \
+                                                                               \
+    STORAGE usize MTD(IPQ, push, /, T MPROT(value)) {                          \
+        usize MPROT(handle);                                                   \
+        if (self->free_handles.size > 0) {                                     \
+            MPROT(handle) = *CALL(HandleVec, self->free_handles, back, /);     \
+            CALL(HandleVec, self->free_handles, pop_back, /);                  \
+        } else {                                                               \
+            MPROT(handle) = self->pos.size;                                    \
+            CALL(HandleVec, self->pos, push_back, /, PRIORITY_QUEUE_NO_POS);   \
+        }                                                                      \
+        IPQEntry MPROT(entry) = {.value = MPROT(value),                        \
+                                 .handle = MPROT(handle)};                     \
+        CALL(EntryVec, self->heap, push_back, /, MPROT(entry));                \
+        CALL(IPQ, *self, sift_up, /, self->heap.size - 1);                     \
+        return MPROT(handle);                                                  \
+    }                                                                          \
+                                                                               \
+    STORAGE T MTD(IPQ, remove, /, usize MPROT(handle)) {                       \
+        ASSERT(CALL(IPQ, *self, contains, /, MPROT(handle)));                  \
+        usize MPROT(i) = self->pos.data[MPROT(handle)];                        \
+        T MPROT(value) = self->heap.data[MPROT(i)].value;                      \
+        self->pos.data[MPROT(handle)] = PRIORITY_QUEUE_NO_POS;                 \
+        CALL(HandleVec, self->free_handles, push_back, /, MPROT(handle));      \
+        IPQEntry MPROT(last) = self->heap.data[--self->heap.size];             \
+        if (MPROT(i) < self->heap.size) {                                      \
+            /* the last entry fills the hole, and may go either way */         \
+            CALL(IPQ, *self, place, /, MPROT(i), MPROT(last));                 \
+            CALL(IPQ, *self, sift_up, /, MPROT(i));                            \
+            CALL(IPQ, *self, sift_down, /,                                     \
+                 self->pos.data[MPROT(last).handle]);                          \
+        }                                                                      \
+        return MPROT(value);                                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(IPQ, update, /, usize MPROT(handle), T MPROT(value)) {    \
+        ASSERT(CALL(IPQ, *self, contains, /, MPROT(handle)));                  \
+        usize MPROT(i) = self->pos.data[MPROT(handle)];                        \
+        NSCALL(IPQ, drop_value, /, &self->heap.data[MPROT(i)].value);          \
+        self->heap.data[MPROT(i)].value = MPROT(value);                        \
+        CALL(IPQ, *self, sift_up, /, MPROT(i));                                \
+        CALL(IPQ, *self, sift_down, /, self->pos.data[MPROT(handle)]);         \
+    }
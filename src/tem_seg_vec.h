@@ -0,0 +1,221 @@
+// clang-format off
+/// tem_seg_vec.h: provides a template for implementing a segmented vector, whose elements never move.
+///
+/// The elements live in blocks of 8, 16, 32, ... elements, found through a fixed index table, so that indexing is
+/// O(1), push_back never copies existing elements, and pointers to the elements stay valid until they are removed.
+///
+/// Macros:
+///     DECLARE_SEG_VEC(SegVec, T, STORAGE, value_gen): declare a segmented vector.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_SEG_VEC(SegVec, T, STORAGE): define a segmented vector.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// SegVec Methods:
+///     SegVec.init(): initialize the vector.
+///     SegVec.drop(): drop the vector.
+///     SegVec.clone_from(const SegVec *other): clone the vector from another vector.
+///     SegVec.clone() const -> SegVec: clone the vector.
+///     SegVec.reserve(usize new_cap): allocate blocks until the capacity reaches new_cap.
+///     SegVec.push_back(T value): push a value to the back of the vector.
+///     SegVec.pop_back(): pop (and drop) a value from the back of the vector.
+///     SegVec.truncate(usize limit): truncate the vector to the specified limit; the blocks are kept.
+///     SegVec.swap(SegVec *other): swap the vector with another vector; the elements stay in place.
+///     SegVec.at(usize index) -> T *: get the element at the specified index.
+///     SegVec.front() -> T *: get the first element of the vector.
+///     SegVec.back() -> T *: get the last element of the vector.
+///     SegVec.empty() -> bool: check if the vector is empty.
+///     SegVec.clear(): clear the vector; the blocks are kept.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+/// block k holds SEG_VEC_FIRST_BLOCK << k elements, and the element at index i
+/// is found from the highest bit of i + SEG_VEC_FIRST_BLOCK
+#undef SEG_VEC_FIRST_BLOCK_LOG
+#define SEG_VEC_FIRST_BLOCK_LOG 3
+
+#undef SEG_VEC_FIRST_BLOCK
+#define SEG_VEC_FIRST_BLOCK ((usize)1 << SEG_VEC_FIRST_BLOCK_LOG)
+
+#undef SEG_VEC_MAX_BLOCKS
+#define SEG_VEC_MAX_BLOCKS (64 - SEG_VEC_FIRST_BLOCK_LOG)
+
+#undef DECLARE_SEG_VEC
+#define DECLARE_SEG_VEC(SegVec, T, STORAGE, value_gen)                         \
+    DECLARE_SEG_VEC_INNER(SegVec, typeof(T), STORAGE);                         \
+    value_gen(SegVec, T);
+
+#undef DEFINE_SEG_VEC
+#define DEFINE_SEG_VEC(SegVec, T, STORAGE)                                     \
+    DEFINE_SEG_VEC_INNER(SegVec, typeof(T), STORAGE);
+
+#undef DECLARE_SEG_VEC_INNER
+#define DECLARE_SEG_VEC_INNER(SegVec, T, STORAGE)                              \
+    typedef struct SegVec {                                                    \
+        T *blocks[SEG_VEC_MAX_BLOCKS];                                         \
+        usize n_blocks;                                                        \
+        usize size;                                                            \
+        usize capacity;                                                        \
+    } SegVec;                                                                  \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* SegVec::drop_value(T *value) */                                         \
+    FUNC_STATIC void NSMTD(SegVec, drop_value, /, T * value);                  \
+                                                                               \
+    /* SegVec::clone_value(const T *other) -> T */                             \
+    FUNC_STATIC T NSMTD(SegVec, clone_value, /, const T *other);               \
+                                                                               \
+    /* SegVec::trivial_drop_value() -> bool */                                 \
+    FUNC_STATIC bool NSMTD(SegVec, trivial_drop_value, /);                     \
+                                                                               \
+    /* SegVec::trivial_clone_value() -> bool */                                \
+    FUNC_STATIC bool NSMTD(SegVec, trivial_clone_value, /);                    \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* SegVec.drop() */                                                        \
+    STORAGE void MTD(SegVec, drop, /);                                         \
+                                                                               \
+    /* SegVec.clone_from(const SegVec *other) */                               \
+    STORAGE void MTD(SegVec, clone_from, /, const SegVec *other);              \
+                                                                               \
+    /* SegVec.reserve(usize new_cap) */                                        \
+    STORAGE void MTD(SegVec, reserve, /, usize new_cap);                       \
+                                                                               \
+    /* SegVec.truncate(usize limit) */                                         \
+    STORAGE void MTD(SegVec, truncate, /, usize limit);                        \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* SegVec.init() */                                                        \
+    FUNC_STATIC void MTD(SegVec, init, /) {                                    \
+        self->n_blocks = 0;                                                    \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* SegVec.clone() const -> SegVec */                                       \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(SegVec, /);                               \
+                                                                               \
+    /* SegVec.at(usize index) -> T * */                                        \
+    FUNC_STATIC T *MTD(SegVec, at, /, usize index) {                           \
+        ASSERT(index < self->size);                                            \
+        usize MPROT(pos) = index + SEG_VEC_FIRST_BLOCK;                        \
+        int MPROT(msb) = 63 - __builtin_clzll((unsigned long long)MPROT(pos)); \
+        return self->blocks[MPROT(msb) - SEG_VEC_FIRST_BLOCK_LOG] +            \
+               (MPROT(pos) - ((usize)1 << MPROT(msb)));                        \
+    }                                                                          \
+                                                                               \
+    /* SegVec.front() -> T * */                                                \
+    FUNC_STATIC T *MTD(SegVec, front, /) {                                     \
+        return CALL(SegVec, *self, at, /, 0);                                  \
+    }                                                                          \
+                                                                               \
+    /* SegVec.back() -> T * */                                                 \
+    FUNC_STATIC T *MTD(SegVec, back, /) {                                      \
+        return CALL(SegVec, *self, at, /, self->size - 1);                     \
+    }                                                                          \
+                                                                               \
+    /* SegVec.push_back(T value) */                                            \
+    FUNC_STATIC void MTD(SegVec, push_back, /, T value) {                      \
+        if (self->size == self->capacity) {                                    \
+            CALL(SegVec, *self, reserve, /, self->size + 1);                   \
+        }                                                                      \
+        self->size++;                                                          \
+        *CALL(SegVec, *self, back, /) = value;                                 \
+    }                                                                          \
+                                                                               \
+    /* SegVec.pop_back() */                                                    \
+    FUNC_STATIC void MTD(SegVec, pop_back, /) {                                \
+        ASSERT(self->size > 0);                                                \
+        NSCALL(SegVec, drop_value, /, CALL(SegVec, *self, back, /));           \
+        self->size--;                                                          \
+    }                                                                          \
+                                                                               \
+    /* SegVec.swap(SegVec *other) */                                           \
+    FUNC_STATIC void MTD(SegVec, swap, /, SegVec * other) {                    \
+        SegVec MPROT(temp) = *self;                                            \
+        *self = *other;                                                        \
+        *other = MPROT(temp);                                                  \
+    }                                                                          \
+                                                                               \
+    /* SegVec.empty() -> bool */                                               \
+    FUNC_STATIC bool MTD(SegVec, empty, /) { return self->size == 0; }         \
+                                                                               \
+    /* SegVec.clear() */                                                       \
+    FUNC_STATIC void MTD(SegVec, clear, /) {                                   \
+        CALL(SegVec, *self, truncate, /, 0);                                   \
+    }
+
+#undef DEFINE_SEG_VEC_INNER
+#define DEFINE_SEG_VEC_INNER(SegVec, T, STORAGE)                               \
+    /* SegVec.drop() */                                                        \
+    STORAGE void MTD(SegVec, drop, /) {                                        \
+        CALL(SegVec, *self, truncate, /, 0);                                   \
+        for (usize i = 0; i < self->n_blocks; i++) {                           \
+            free(self->blocks[i]);                                             \
+        }                                                                      \
+        self->n_blocks = 0;                                                    \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* SegVec.clone_from(const SegVec *other) */                               \
+    STORAGE void MTD(SegVec, clone_from, /, const SegVec *MPROT(other)) {      \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(SegVec, *self, truncate, /, 0);                                   \
+        CALL(SegVec, *self, reserve, /, MPROT(other)->size);                   \
+        /* the blocks of both vectors have the same layout */                  \
+        usize MPROT(left) = MPROT(other)->size;                                \
+        for (usize i = 0; MPROT(left) > 0; i++) {                              \
+            usize MPROT(n) = Min(MPROT(left), SEG_VEC_FIRST_BLOCK << i);       \
+            if (NSCALL(SegVec, trivial_clone_value, /)) {                      \
+                memcpy(self->blocks[i], MPROT(other)->blocks[i],               \
+                       MPROT(n) * sizeof(T));                                  \
+            } else {                                                           \
+                for (usize j = 0; j < MPROT(n); j++) {                         \
+                    self->blocks[i][j] = NSCALL(SegVec, clone_value, /,        \
+                                                &MPROT(other)->blocks[i][j]);  \
+                }                                                              \
+            }                                                                  \
+            MPROT(left) -= MPROT(n);                                           \
+        }                                                                      \
+        self->size = MPROT(other)->size;                                       \
+    }                                                                          \
+                                                                               \
+    /* SegVec.reserve(usize new_cap) */                                        \
+    STORAGE void MTD(SegVec, reserve, /, usize MPROT(new_cap)) {               \
+        while (self->capacity < MPROT(new_cap)) {                              \
+            ASSERT(self->n_blocks < SEG_VEC_MAX_BLOCKS);                       \
+            usize MPROT(n) = SEG_VEC_FIRST_BLOCK << self->n_blocks;            \
+            T *MPROT(block) = (T *)malloc(MPROT(n) * sizeof(T));               \
+            ASSERT(MPROT(block));                                              \
+            self->blocks[self->n_blocks++] = MPROT(block);                     \
+            self->capacity += MPROT(n);                                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* SegVec.truncate(usize limit) */                                         \
+    STORAGE void MTD(SegVec, truncate, /, usize MPROT(limit)) {                \
+        if (NSCALL(SegVec, trivial_drop_value, /)) {                           \
+            self->size = Min(self->size, MPROT(limit));                        \
+            return;                                                            \
+        }                                                                      \
+        while (self->size > MPROT(limit)) {                                    \
+            CALL(SegVec, *self, pop_back, /);                                  \
+        }                                                                      \
+    }
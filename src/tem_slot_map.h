@@ -0,0 +1,301 @@
+// clang-format off
+/// tem_slot_map.h: provides a template for implementing generational slot maps.
+///
+/// A slot map owns its values and hands out handles to them. The values are kept dense in one array for iteration,
+/// and a table of slots maps each handle to its value in O(1). Each slot has a generation counter, bumped whenever its
+/// value is inserted or removed, so that a stale handle (whose value is removed) is detected instead of aliasing a
+/// newer value in the reused slot.
+///
+/// Macros:
+///     DECLARE_SLOT_MAP(SlotMap, T, STORAGE, value_gen): declare a slot map.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_SLOT_MAP(SlotMap, T, STORAGE): define a slot map.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// SlotHandle is shared by all slot maps: {u32 index; u32 generation;}; the generation of a live value is odd, so
+/// a zero-initialized handle is never valid.
+///
+/// SlotMap Methods:
+///     SlotMap.init(): initialize the slot map.
+///     SlotMap.drop(): drop the slot map.
+///     SlotMap.clone_from(const SlotMap *other): clone the slot map from another one; the handles stay valid.
+///     SlotMap.clone() const -> SlotMap: clone the slot map.
+///     SlotMap.reserve(usize new_cap): reserve the capacity of the values and the slots.
+///     SlotMap.insert(T value) -> SlotHandle: insert a value, and return its handle.
+///     SlotMap.contains(SlotHandle handle) -> bool: check if a handle refers to a value.
+///     SlotMap.get(SlotHandle handle) -> T *: get the value of a handle, or NULL if the handle is stale.
+///     SlotMap.remove(SlotHandle handle) -> T: remove the value of a valid handle, and return it.
+///     SlotMap.erase(SlotHandle handle) -> bool: remove (and drop) the value of a handle, or return false if stale.
+///     SlotMap.handle_at(usize index) -> SlotHandle: the handle of the value at an index of the dense array.
+///     SlotMap.empty() -> bool: check if the slot map is empty.
+///     SlotMap.clear(): clear the slot map; all the handles become stale.
+///
+/// The values are iterated through the dense array `values[0, size)`, in no particular order; removing a value moves
+/// the last value into its place.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+typedef struct SlotHandle {
+    u32 index;
+    u32 generation;
+} SlotHandle;
+
+/// the end of the free list of slots
+#undef SLOT_MAP_NONE
+#define SLOT_MAP_NONE ((u32)-1)
+
+/// declare at .h files
+#undef DECLARE_SLOT_MAP
+#define DECLARE_SLOT_MAP(SlotMap, T, STORAGE, value_gen)                       \
+    DECLARE_SLOT_MAP_INNER(SlotMap, CONCATENATE(SlotMap, Slot), typeof(T),     \
+                           STORAGE);                                           \
+    value_gen(SlotMap, T);
+
+#undef DECLARE_SLOT_MAP_INNER
+#define DECLARE_SLOT_MAP_INNER(SlotMap, SlotMapSlot, T, STORAGE)               \
+    typedef struct SlotMapSlot {                                               \
+        /* the index of the value if the slot is live, else the next free */   \
+        u32 link;                                                              \
+        u32 generation;                                                        \
+    } SlotMapSlot;                                                             \
+                                                                               \
+    typedef struct SlotMap {                                                   \
+        T *values;                                                             \
+        /* the slot of each value */                                           \
+        u32 *owners;                                                           \
+        usize size;                                                            \
+        usize capacity;                                                        \
+        SlotMapSlot *slots;                                                    \
+        usize n_slots;                                                         \
+        usize slots_capacity;                                                  \
+        u32 free_head;                                                         \
+    } SlotMap;                                                                 \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* SlotMap::drop_value(T *value) */                                        \
+    FUNC_STATIC void NSMTD(SlotMap, drop_value, /, T * value);                 \
+                                                                               \
+    /* SlotMap::clone_value(const T *other) -> T */                            \
+    FUNC_STATIC T NSMTD(SlotMap, clone_value, /, const T *other);              \
+                                                                               \
+    /* SlotMap::trivial_drop_value() -> bool */                                \
+    FUNC_STATIC bool NSMTD(SlotMap, trivial_drop_value, /);                    \
+                                                                               \
+    /* SlotMap::trivial_clone_value() -> bool */                               \
+    FUNC_STATIC bool NSMTD(SlotMap, trivial_clone_value, /);                   \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* SlotMap.drop() */                                                       \
+    STORAGE void MTD(SlotMap, drop, /);                                        \
+                                                                               \
+    /* SlotMap.clone_from(const SlotMap *other) */                             \
+    STORAGE void MTD(SlotMap, clone_from, /, const SlotMap *other);            \
+                                                                               \
+    /* SlotMap.reserve(usize new_cap) */                                       \
+    STORAGE void MTD(SlotMap, reserve, /, usize new_cap);                      \
+                                                                               \
+    /* SlotMap.insert(T value) -> SlotHandle */                                \
+    STORAGE SlotHandle MTD(SlotMap, insert, /, T value);                       \
+                                                                               \
+    /* SlotMap.remove(SlotHandle handle) -> T */                               \
+    STORAGE T MTD(SlotMap, remove, /, SlotHandle handle);                      \
+                                                                               \
+    /* SlotMap.clear() */                                                      \
+    STORAGE void MTD(SlotMap, clear, /);                                       \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* SlotMap.init() */                                                       \
+    FUNC_STATIC void MTD(SlotMap, init, /) {                                   \
+        self->values = NULL;                                                   \
+        self->owners = NULL;                                                   \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+        self->slots = NULL;                                                    \
+        self->n_slots = 0;                                                     \
+        self->slots_capacity = 0;                                              \
+        self->free_head = SLOT_MAP_NONE;                                       \
+    }                                                                          \
+                                                                               \
+    /* SlotMap.clone() const -> SlotMap */                                     \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(SlotMap, /);                              \
+                                                                               \
+    /* SlotMap.contains(SlotHandle handle) -> bool */                          \
+    FUNC_STATIC bool MTD(SlotMap, contains, /, SlotHandle handle) {            \
+        return handle.index < self->n_slots &&                                 \
+               self->slots[handle.index].generation == handle.generation &&    \
+               (handle.generation & 1);                                        \
+    }                                                                          \
+                                                                               \
+    /* SlotMap.get(SlotHandle handle) -> T * */                                \
+    FUNC_STATIC T *MTD(SlotMap, get, /, SlotHandle handle) {                   \
+        if (!CALL(SlotMap, *self, contains, /, handle)) {                      \
+            return NULL;                                                       \
+        }                                                                      \
+        return self->values + self->slots[handle.index].link;                  \
+    }                                                                          \
+                                                                               \
+    /* SlotMap.erase(SlotHandle handle) -> bool */                             \
+    FUNC_STATIC bool MTD(SlotMap, erase, /, SlotHandle handle) {               \
+        if (!CALL(SlotMap, *self, contains, /, handle)) {                      \
+            return false;                                                      \
+        }                                                                      \
+        T MPROT(value) = CALL(SlotMap, *self, remove, /, handle);              \
+        NSCALL(SlotMap, drop_value, /, &MPROT(value));                         \
+        return true;                                                           \
+    }                                                                          \
+                                                                               \
+    /* SlotMap.handle_at(usize index) -> SlotHandle */                         \
+    FUNC_STATIC SlotHandle MTD(SlotMap, handle_at, /, usize index) {           \
+        ASSERT(index < self->size);                                            \
+        u32 MPROT(slot) = self->owners[index];                                 \
+        SlotHandle MPROT(handle) = {                                           \
+            .index = MPROT(slot),                                              \
+            .generation = self->slots[MPROT(slot)].generation,                 \
+        };                                                                     \
+        return MPROT(handle);                                                  \
+    }                                                                          \
+                                                                               \
+    /* SlotMap.empty() -> bool */                                              \
+    FUNC_STATIC bool MTD(SlotMap, empty, /) { return self->size == 0; }
+
+/// define at .c files
+#undef DEFINE_SLOT_MAP
+#define DEFINE_SLOT_MAP(SlotMap, T, STORAGE)                                   \
+    DEFINE_SLOT_MAP_INNER(SlotMap, CONCATENATE(SlotMap, Slot), typeof(T),      \
+                          STORAGE)
+
+#undef DEFINE_SLOT_MAP_INNER
+#define DEFINE_SLOT_MAP_INNER(SlotMap, SlotMapSlot, T, STORAGE)                \
+    STORAGE void MTD(SlotMap, drop, /) {                                       \
+        CALL(SlotMap, *self, clear, /);                                        \
+        free(self->values);                                                    \
+        free(self->owners);                                                    \
+        free(self->slots);                                                     \
+        CALL(SlotMap, *self, init, /);                                         \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(SlotMap, clone_from, /, const SlotMap *MPROT(other)) {    \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(SlotMap, *self, drop, /);                                         \
+        CALL(SlotMap, *self, reserve, /,                                       \
+             Max(MPROT(other)->size, MPROT(other)->n_slots));                  \
+        if (NSCALL(SlotMap, trivial_clone_value, /)) {                         \
+            if (MPROT(other)->size > 0) {                                      \
+                memcpy(self->values, MPROT(other)->values,                     \
+                       MPROT(other)->size * sizeof(T));                        \
+            }                                                                  \
+        } else {                                                               \
+            for (usize i = 0; i < MPROT(other)->size; i++) {                   \
+                self->values[i] =                                              \
+                    NSCALL(SlotMap, clone_value, /, MPROT(other)->values + i); \
+            }                                                                  \
+        }                                                                      \
+        if (MPROT(other)->size > 0) {                                          \
+            memcpy(self->owners, MPROT(other)->owners,                         \
+                   MPROT(other)->size * sizeof(u32));                          \
+        }                                                                      \
+        if (MPROT(other)->n_slots > 0) {                                       \
+            memcpy(self->slots, MPROT(other)->slots,                           \
+                   MPROT(other)->n_slots * sizeof(SlotMapSlot));               \
+        }                                                                      \
+        self->size = MPROT(other)->size;                                       \
+        self->n_slots = MPROT(other)->n_slots;                                 \
+        self->free_head = MPROT(other)->free_head;                             \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(SlotMap, reserve, /, usize MPROT(new_cap)) {              \
+        ASSERT(MPROT(new_cap) < SLOT_MAP_NONE, "too many slots");              \
+        if (MPROT(new_cap) > self->capacity) {                                 \
+            self->values =                                                     \
+                (T *)realloc(self->values, MPROT(new_cap) * sizeof(T));        \
+            self->owners =                                                     \
+                (u32 *)realloc(self->owners, MPROT(new_cap) * sizeof(u32));    \
+            ASSERT(self->values && self->owners);                              \
+            self->capacity = MPROT(new_cap);                                   \
+        }                                                                      \
+        if (MPROT(new_cap) > self->slots_capacity) {                           \
+            self->slots = (SlotMapSlot *)realloc(                              \
+                self->slots, MPROT(new_cap) * sizeof(SlotMapSlot));            \
+            ASSERT(self->slots);                                               \
+            self->slots_capacity = MPROT(new_cap);                             \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE SlotHandle MTD(SlotMap, insert, /, T MPROT(value)) {               \
+        if (self->size == self->capacity) {                                    \
+            CALL(SlotMap, *self, reserve, /,                                   \
+                 Max((usize)4, self->capacity * 2));                           \
+        }                                                                      \
+        u32 MPROT(slot) = self->free_head;                                     \
+        if (MPROT(slot) != SLOT_MAP_NONE) {                                    \
+            self->free_head = self->slots[MPROT(slot)].link;                   \
+        } else {                                                               \
+            /* every value has a slot, so there is room for a new one */       \
+            MPROT(slot) = (u32)self->n_slots++;                                \
+            self->slots[MPROT(slot)].generation = 0;                           \
+        }                                                                      \
+        SlotMapSlot *MPROT(s) = self->slots + MPROT(slot);                     \
+        MPROT(s)->link = (u32)self->size;                                      \
+        MPROT(s)->generation++;                                                \
+        self->values[self->size] = MPROT(value);                               \
+        self->owners[self->size] = MPROT(slot);                                \
+        self->size++;                                                          \
+        SlotHandle MPROT(handle) = {                                           \
+            .index = MPROT(slot),                                              \
+            .generation = MPROT(s)->generation,                                \
+        };                                                                     \
+        return MPROT(handle);                                                  \
+    }                                                                          \
+                                                                               \
+    STORAGE T MTD(SlotMap, remove, /, SlotHandle MPROT(handle)) {              \
+        ASSERT(CALL(SlotMap, *self, contains, /, MPROT(handle)),               \
+               "stale slot handle");                                           \
+        SlotMapSlot *MPROT(s) = self->slots + MPROT(handle).index;             \
+        u32 MPROT(index) = MPROT(s)->link;                                     \
+        T MPROT(value) = self->values[MPROT(index)];                           \
+        /* the last value fills the hole */                                    \
+        usize MPROT(last) = --self->size;                                      \
+        self->values[MPROT(index)] = self->values[MPROT(last)];                \
+        self->owners[MPROT(index)] = self->owners[MPROT(last)];                \
+        self->slots[self->owners[MPROT(index)]].link = MPROT(index);           \
+        MPROT(s)->generation++;                                                \
+        MPROT(s)->link = self->free_head;                                      \
+        self->free_head = MPROT(handle).index;                                 \
+        return MPROT(value);                                                   \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(SlotMap, clear, /) {                                      \
+        if (!NSCALL(SlotMap, trivial_drop_value, /)) {                         \
+            for (usize i = 0; i < self->size; i++) {                           \
+                NSCALL(SlotMap, drop_value, /, self->values + i);              \
+            }                                                                  \
+        }                                                                      \
+        /* keep the generations, so that the old handles stay stale */         \
+        for (usize i = 0; i < self->n_slots; i++) {                            \
+            if (self->slots[i].generation & 1) {                               \
+                self->slots[i].generation++;                                   \
+            }                                                                  \
+            self->slots[i].link =                                              \
+                i + 1 < self->n_slots ? (u32)(i + 1) : SLOT_MAP_NONE;          \
+        }                                                                      \
+        self->free_head = self->n_slots > 0 ? 0 : SLOT_MAP_NONE;               \
+        self->size = 0;                                                        \
+    }
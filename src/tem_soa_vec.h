@@ -0,0 +1,220 @@
+// clang-format off
+/// tem_soa_vec.h: provides a template for implementing a structure-of-arrays vector, which stores each field of its
+/// elements in a separate contiguous array, so that a scan over one field reads only that field.
+///
+/// The fields are given by an X-macro, and must be plain data:
+///
+///     #define PARTICLE_FIELDS(F) F(f32, x) F(f32, y) F(u32, flags)
+///     DECLARE_SOA_VEC(SoaParticle, PARTICLE_FIELDS, FUNC_EXTERN);
+///
+/// Macros:
+///     DECLARE_SOA_VEC(Soa, FIELDS, STORAGE): declare a structure-of-arrays vector.
+///     DEFINE_SOA_VEC(Soa, FIELDS, STORAGE): define a structure-of-arrays vector.
+///     SOA_AT(soa, field, index): the lvalue of the field of the element at index, bounds checked.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// Each field `f` of type `T` is the column `T *f` of the vector, next to `size` and `capacity` (which are thus not
+/// allowed as field names). The elements are passed by value as `SoaElem`, a struct of all the fields.
+///
+/// SoaVec Methods:
+///     Soa.init(): initialize the vector.
+///     Soa.drop(): drop the vector.
+///     Soa.clone_from(const Soa *other): clone the vector from another vector.
+///     Soa.clone() const -> Soa: clone the vector.
+///     Soa.reserve(usize new_cap): reserve the capacity of every column.
+///     Soa.push_back(SoaElem elem): push an element to the back of the vector.
+///     Soa.pop_back(): pop an element from the back of the vector.
+///     Soa.erase(usize index): erase an element at the specified index.
+///     Soa.truncate(usize limit): truncate the vector to the specified limit.
+///     Soa.swap(Soa *other): swap the vector with another vector.
+///     Soa.get(usize index) -> SoaElem: gather the element at the specified index.
+///     Soa.set(usize index, SoaElem elem): scatter an element to the specified index.
+///     Soa.empty() -> bool: check if the vector is empty.
+///     Soa.clear(): clear the vector.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "utils.h"
+
+#undef SOA_AT
+#define SOA_AT(soa, field, index)                                              \
+    (*({                                                                       \
+        usize MPROT(soa_index) = (index);                                      \
+        ASSERT(MPROT(soa_index) < (soa).size);                                 \
+        (soa).field + MPROT(soa_index);                                        \
+    }))
+
+/// per field expansions, used with the FIELDS X-macro
+#undef SOA_VEC_COLUMN
+#define SOA_VEC_COLUMN(T, f) T *f;
+
+#undef SOA_VEC_ELEM_FIELD
+#define SOA_VEC_ELEM_FIELD(T, f) T f;
+
+#undef SOA_VEC_INIT_COLUMN
+#define SOA_VEC_INIT_COLUMN(T, f) self->f = NULL;
+
+#undef SOA_VEC_DROP_COLUMN
+#define SOA_VEC_DROP_COLUMN(T, f)                                              \
+    free(self->f);                                                             \
+    self->f = NULL;
+
+#undef SOA_VEC_RESERVE_COLUMN
+#define SOA_VEC_RESERVE_COLUMN(T, f)                                           \
+    self->f = (T *)realloc(self->f, MPROT(new_cap) * sizeof(T));               \
+    ASSERT(self->f);
+
+#undef SOA_VEC_COPY_COLUMN
+#define SOA_VEC_COPY_COLUMN(T, f)                                              \
+    memcpy(self->f, MPROT(other)->f, MPROT(other)->size * sizeof(T));
+
+#undef SOA_VEC_ERASE_COLUMN
+#define SOA_VEC_ERASE_COLUMN(T, f)                                             \
+    memmove(self->f + MPROT(index), self->f + MPROT(index) + 1,                \
+            (self->size - MPROT(index) - 1) * sizeof(T));
+
+#undef SOA_VEC_GET_FIELD
+#define SOA_VEC_GET_FIELD(T, f) MPROT(elem).f = self->f[MPROT(index)];
+
+#undef SOA_VEC_SET_FIELD
+#define SOA_VEC_SET_FIELD(T, f) self->f[MPROT(index)] = MPROT(elem).f;
+
+/// declare at .h files
+#undef DECLARE_SOA_VEC
+#define DECLARE_SOA_VEC(Soa, FIELDS, STORAGE)                                  \
+    DECLARE_SOA_VEC_INNER(Soa, CONCATENATE(Soa, Elem), FIELDS, STORAGE)
+
+#undef DECLARE_SOA_VEC_INNER
+#define DECLARE_SOA_VEC_INNER(Soa, SoaElem, FIELDS, STORAGE)                   \
+    typedef struct SoaElem {                                                   \
+        FIELDS(SOA_VEC_ELEM_FIELD)                                             \
+    } SoaElem;                                                                 \
+                                                                               \
+    typedef struct Soa {                                                       \
+        FIELDS(SOA_VEC_COLUMN)                                                 \
+        usize size;                                                            \
+        usize capacity;                                                        \
+    } Soa;                                                                     \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* Soa.clone_from(const Soa *other) */                                     \
+    STORAGE void MTD(Soa, clone_from, /, const Soa *other);                    \
+                                                                               \
+    /* Soa.drop() */                                                           \
+    STORAGE void MTD(Soa, drop, /);                                            \
+                                                                               \
+    /* Soa.reserve(usize new_cap) */                                           \
+    STORAGE void MTD(Soa, reserve, /, usize new_cap);                          \
+                                                                               \
+    /* Soa.push_back(SoaElem elem) */                                          \
+    STORAGE void MTD(Soa, push_back, /, SoaElem elem);                         \
+                                                                               \
+    /* Soa.erase(usize index) */                                               \
+    STORAGE void MTD(Soa, erase, /, usize index);                              \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* Soa.init() */                                                           \
+    FUNC_STATIC void MTD(Soa, init, /) {                                       \
+        FIELDS(SOA_VEC_INIT_COLUMN)                                            \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    /* Soa.clone() const -> Soa */                                             \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(Soa, /);                                  \
+                                                                               \
+    /* Soa.pop_back() */                                                       \
+    FUNC_STATIC void MTD(Soa, pop_back, /) {                                   \
+        ASSERT(self->size > 0);                                                \
+        self->size--;                                                          \
+    }                                                                          \
+                                                                               \
+    /* Soa.truncate(usize limit) */                                            \
+    FUNC_STATIC void MTD(Soa, truncate, /, usize limit) {                      \
+        if (limit < self->size) {                                              \
+            self->size = limit;                                                \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Soa.swap(Soa *other) */                                                 \
+    FUNC_STATIC void MTD(Soa, swap, /, Soa * other) {                          \
+        Soa MPROT(tmp) = *self;                                                \
+        *self = *other;                                                        \
+        *other = MPROT(tmp);                                                   \
+    }                                                                          \
+                                                                               \
+    /* Soa.get(usize index) -> SoaElem */                                      \
+    FUNC_STATIC SoaElem MTD(Soa, get, /, usize MPROT(index)) {                 \
+        ASSERT(MPROT(index) < self->size);                                     \
+        SoaElem MPROT(elem);                                                   \
+        FIELDS(SOA_VEC_GET_FIELD)                                              \
+        return MPROT(elem);                                                    \
+    }                                                                          \
+                                                                               \
+    /* Soa.set(usize index, SoaElem elem) */                                   \
+    FUNC_STATIC void MTD(Soa, set, /, usize MPROT(index),                      \
+                         SoaElem MPROT(elem)) {                                \
+        ASSERT(MPROT(index) < self->size);                                     \
+        FIELDS(SOA_VEC_SET_FIELD)                                              \
+    }                                                                          \
+                                                                               \
+    /* Soa.empty() -> bool */                                                  \
+    FUNC_STATIC bool MTD(Soa, empty, /) { return self->size == 0; }            \
+                                                                               \
+    /* Soa.clear() */                                                          \
+    FUNC_STATIC void MTD(Soa, clear, /) { self->size = 0; }
+
+/// define at .c files
+#undef DEFINE_SOA_VEC
+#define DEFINE_SOA_VEC(Soa, FIELDS, STORAGE)                                   \
+    DEFINE_SOA_VEC_INNER(Soa, CONCATENATE(Soa, Elem), FIELDS, STORAGE)
+
+#undef DEFINE_SOA_VEC_INNER
+#define DEFINE_SOA_VEC_INNER(Soa, SoaElem, FIELDS, STORAGE)                    \
+    STORAGE void MTD(Soa, clone_from, /, const Soa *MPROT(other)) {            \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(Soa, *self, reserve, /, MPROT(other)->size);                      \
+        self->size = MPROT(other)->size;                                       \
+        if (MPROT(other)->size > 0) {                                          \
+            FIELDS(SOA_VEC_COPY_COLUMN)                                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Soa, drop, /) {                                           \
+        FIELDS(SOA_VEC_DROP_COLUMN)                                            \
+        self->size = 0;                                                        \
+        self->capacity = 0;                                                    \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Soa, reserve, /, usize MPROT(new_cap)) {                  \
+        if (MPROT(new_cap) <= self->capacity) {                                \
+            return;                                                            \
+        }                                                                      \
+        FIELDS(SOA_VEC_RESERVE_COLUMN)                                         \
+        self->capacity = MPROT(new_cap);                                       \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Soa, push_back, /, SoaElem MPROT(elem)) {                 \
+        if (self->size == self->capacity) {                                    \
+            CALL(Soa, *self, reserve, /, Max((usize)4, self->capacity * 2));   \
+        }                                                                      \
+        usize MPROT(index) = self->size++;                                     \
+        FIELDS(SOA_VEC_SET_FIELD)                                              \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Soa, erase, /, usize MPROT(index)) {                      \
+        ASSERT(MPROT(index) < self->size);                                     \
+        FIELDS(SOA_VEC_ERASE_COLUMN)                                           \
+        self->size--;                                                          \
+    }
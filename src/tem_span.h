@@ -0,0 +1,197 @@
+// clang-format off
+/// tem_span.h: provides a template for implementing spans, non-owning views (T *data, usize size) of contiguous
+/// elements.
+///
+/// A span borrows the elements of a vector (or any array), so passing a range of a vector costs nothing and never
+/// allocates; the span is valid as long as the elements are not moved, e.g. by a reallocation of the vector.
+/// Declaring the span over `const T` gives a read-only view.
+///
+/// Macros:
+///     DECLARE_SPAN(Span, T): declare a span.
+///     DECLARE_SPAN_ALGORITHM(Span, T, STORAGE, com_gen): declare the sorting and searching methods of a span.
+///         com_gen: define the comparator generator, see tem_algorithm.h.
+///     DEFINE_SPAN_ALGORITHM(Span, T, STORAGE): define the sorting and searching methods of a span.
+///     DECLARE_SPAN_ALGORITHM_OF(Span, Ord, T): declare the sorting and searching methods of a span by the slice
+///         algorithms already in the namespace Ord, e.g. a vector with DECLARE_VEC_ALGORITHM; nothing to define.
+///     SPAN_OF(Span, vec): the span of all the elements of vec, which is anything with `data` and `size`.
+///     SPAN_RANGE(Span, vec, lo, hi): the span of the elements of vec in [lo, hi).
+///     SPAN_FOR_EACH(span, ptr): iterate over the elements of span by the pointer ptr, e.g.
+///         SPAN_FOR_EACH(span, p) { ... *p ... }
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// Span Methods:
+///     Span.init(T *data, usize size): initialize the span.
+///     Span.drop(): drop the span; the elements are not owned, so it does nothing.
+///     Span.clone_from(const Span *other): make the span view the elements of another one.
+///     Span.clone() const -> Span: clone the span (not the elements).
+///     Span::from_range(T *data, usize size, usize lo, usize hi) -> Span: the span of data[lo, hi).
+///     Span.size() -> usize: the number of elements.
+///     Span.empty() -> bool: check if the span is empty.
+///     Span.at(usize index) -> T *: get the element at the specified index.
+///     Span.front() -> T *: get the first element of the span.
+///     Span.back() -> T *: get the last element of the span.
+///     Span.subspan(usize lo, usize hi) -> Span: the span of the elements in [lo, hi).
+///     Span.split_at(usize mid, Span *left, Span *right): split the span into [0, mid) and [mid, size).
+///
+/// Algorithm Methods (DECLARE_SPAN_ALGORITHM):
+///     Span.sort(): sort the span, not stable.
+///     Span.stable_sort(): sort the span, stable.
+///     Span.is_sorted() -> bool: check if the span is sorted.
+///     Span.lower_bound(const T *key) -> usize: the first index whose element >= key; the span must be sorted.
+///     Span.upper_bound(const T *key) -> usize: the first index whose element > key; the span must be sorted.
+///     Span.binary_search(const T *key) -> T *: an element == key, or NULL; the span must be sorted.
+///     Span.dedup() -> usize: move consecutive duplicates to the tail, and return the length of the remaining prefix;
+///         the span does not own the elements, so they are neither dropped nor removed.
+// clang-format on
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "debug.h"
+#include "tem_algorithm.h"
+#include "utils.h"
+
+#undef SPAN_OF
+#define SPAN_OF(Span, vec)                                                     \
+    NSCALL(Span, from_range, /, (vec).data, (vec).size, 0, (vec).size)
+
+#undef SPAN_RANGE
+#define SPAN_RANGE(Span, vec, lo, hi)                                          \
+    NSCALL(Span, from_range, /, (vec).data, (vec).size, lo, hi)
+
+#undef SPAN_FOR_EACH
+#define SPAN_FOR_EACH(span, ptr)                                               \
+    for (typeof((span).data) ptr = (span).data,                                \
+                             MPROT(span_end) = (span).data + (span).size;      \
+         ptr != MPROT(span_end); ptr++)
+
+/// declare at .h files
+#undef DECLARE_SPAN
+#define DECLARE_SPAN(Span, T) DECLARE_SPAN_INNER(Span, typeof(T))
+
+#undef DECLARE_SPAN_INNER
+#define DECLARE_SPAN_INNER(Span, T)                                            \
+    typedef struct Span {                                                      \
+        T *data;                                                               \
+        usize size;                                                            \
+    } Span;                                                                    \
+                                                                               \
+    /* Span.init(T *data, usize size) */                                       \
+    FUNC_STATIC void MTD(Span, init, /, T * data, usize size) {                \
+        self->data = data;                                                     \
+        self->size = size;                                                     \
+    }                                                                          \
+                                                                               \
+    /* Span.drop() */                                                          \
+    FUNC_STATIC void MTD(Span, drop, /) {}                                     \
+                                                                               \
+    /* Span.clone_from(const Span *other) */                                   \
+    FUNC_STATIC void MTD(Span, clone_from, /, const Span *other) {             \
+        *self = *other;                                                        \
+    }                                                                          \
+                                                                               \
+    /* Span.clone() const -> Span */                                           \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(Span, /, NULL, 0);                        \
+                                                                               \
+    /* Span::from_range(T *data, usize size, usize lo, usize hi) -> Span */    \
+    FUNC_STATIC Span NSMTD(Span, from_range, /, T * data, usize size,          \
+                           usize lo, usize hi) {                               \
+        ASSERT(lo <= hi && hi <= size, "range [%zu, %zu) out of %zu", lo, hi,  \
+               size);                                                          \
+        Span MPROT(span) = {.data = data + lo, .size = hi - lo};               \
+        return MPROT(span);                                                    \
+    }                                                                          \
+                                                                               \
+    /* Span.size() -> usize */                                                 \
+    FUNC_STATIC usize MTD(Span, size, /) { return self->size; }                \
+                                                                               \
+    /* Span.empty() -> bool */                                                 \
+    FUNC_STATIC bool MTD(Span, empty, /) { return self->size == 0; }           \
+                                                                               \
+    /* Span.at(usize index) -> T * */                                          \
+    FUNC_STATIC T *MTD(Span, at, /, usize index) {                             \
+        ASSERT(index < self->size);                                            \
+        return self->data + index;                                             \
+    }                                                                          \
+                                                                               \
+    /* Span.front() -> T * */                                                  \
+    FUNC_STATIC T *MTD(Span, front, /) {                                       \
+        return CALL(Span, *self, at, /, 0);                                    \
+    }                                                                          \
+                                                                               \
+    /* Span.back() -> T * */                                                   \
+    FUNC_STATIC T *MTD(Span, back, /) {                                        \
+        return CALL(Span, *self, at, /, self->size - 1);                       \
+    }                                                                          \
+                                                                               \
+    /* Span.subspan(usize lo, usize hi) -> Span */                             \
+    FUNC_STATIC Span MTD(Span, subspan, /, usize lo, usize hi) {               \
+        return NSCALL(Span, from_range, /, self->data, self->size, lo, hi);    \
+    }                                                                          \
+                                                                               \
+    /* Span.split_at(usize mid, Span *left, Span *right) */                    \
+    FUNC_STATIC void MTD(Span, split_at, /, usize mid, Span *left,             \
+                         Span *right) {                                        \
+        ASSERT(mid <= self->size);                                             \
+        Span MPROT(span) = *self;                                              \
+        left->data = MPROT(span).data;                                         \
+        left->size = mid;                                                      \
+        right->data = MPROT(span).data + mid;                                  \
+        right->size = MPROT(span).size - mid;                                  \
+    }
+
+/// declare at .h files
+#undef DECLARE_SPAN_ALGORITHM
+#define DECLARE_SPAN_ALGORITHM(Span, T, STORAGE, com_gen)                      \
+    DECLARE_SLICE_ALGORITHM(Span, T, STORAGE, com_gen);                        \
+    DECLARE_SPAN_ALGORITHM_INNER(Span, Span, typeof(T))
+
+#undef DECLARE_SPAN_ALGORITHM_OF
+#define DECLARE_SPAN_ALGORITHM_OF(Span, Ord, T)                                \
+    DECLARE_SPAN_ALGORITHM_INNER(Span, Ord, typeof(T))
+
+/// define at .c files
+#undef DEFINE_SPAN_ALGORITHM
+#define DEFINE_SPAN_ALGORITHM(Span, T, STORAGE)                                \
+    DEFINE_SLICE_ALGORITHM(Span, T, STORAGE)
+
+#undef DECLARE_SPAN_ALGORITHM_INNER
+#define DECLARE_SPAN_ALGORITHM_INNER(Span, Ord, T)                             \
+    /* Span.sort() */                                                          \
+    FUNC_STATIC void MTD(Span, sort, /) {                                      \
+        NSCALL(Ord, sort_slice, /, self->data, self->size);                    \
+    }                                                                          \
+                                                                               \
+    /* Span.stable_sort() */                                                   \
+    FUNC_STATIC void MTD(Span, stable_sort, /) {                               \
+        NSCALL(Ord, stable_sort_slice, /, self->data, self->size);             \
+    }                                                                          \
+                                                                               \
+    /* Span.is_sorted() -> bool */                                             \
+    FUNC_STATIC bool MTD(Span, is_sorted, /) {                                 \
+        return NSCALL(Ord, is_sorted_slice, /, self->data, self->size);        \
+    }                                                                          \
+                                                                               \
+    /* Span.lower_bound(const T *key) -> usize */                              \
+    FUNC_STATIC usize MTD(Span, lower_bound, /, const T *key) {                \
+        return NSCALL(Ord, lower_bound_slice, /, self->data, self->size, key); \
+    }                                                                          \
+                                                                               \
+    /* Span.upper_bound(const T *key) -> usize */                              \
+    FUNC_STATIC usize MTD(Span, upper_bound, /, const T *key) {                \
+        return NSCALL(Ord, upper_bound_slice, /, self->data, self->size, key); \
+    }                                                                          \
+                                                                               \
+    /* Span.binary_search(const T *key) -> T * */                              \
+    FUNC_STATIC T *MTD(Span, binary_search, /, const T *key) {                 \
+        usize MPROT(pos) =                                                     \
+            NSCALL(Ord, binary_search_slice, /, self->data, self->size, key);  \
+        return MPROT(pos) < self->size ? self->data + MPROT(pos) : NULL;       \
+    }                                                                          \
+                                                                               \
+    /* Span.dedup() -> usize */                                                \
+    FUNC_STATIC usize MTD(Span, dedup, /) {                                    \
+        return NSCALL(Ord, dedup_slice, /, self->data, self->size);            \
+    }
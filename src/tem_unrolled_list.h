@@ -0,0 +1,472 @@
+// clang-format off
+/// tem_unrolled_list.h: provides a template for implementing an unrolled doubly-linked list.
+///
+/// Each node holds an array of up to UNROLLED_LIST_NODE_CAP(T) elements (about UNROLLED_LIST_NODE_BYTES bytes), so
+/// iterating touches one node per array instead of one per element, and the links cost 16 bytes per node rather than
+/// per element. Inserting into a full node splits it in halves; erasing from a node less than half full refills it
+/// from the next node, or merges the two. Inserting or erasing in the middle moves at most a node of elements, and
+/// index-based access skips whole nodes.
+///
+/// Macros:
+///     DECLARE_UNROLLED_LIST(UList, T, STORAGE, value_gen): declare an unrolled list.
+///         value_gen: define the value generator.
+///         - GENERATOR_PLAIN_VALUE: define a plain value generator.
+///         - GENERATOR_CLASS_VALUE: define a class value generator.
+///         - GENERATOR_CUSTOM_VALUE: define a custom value generator.
+///     DEFINE_UNROLLED_LIST(UList, T, STORAGE): define an unrolled list.
+///
+///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
+///
+/// UList Methods:
+///     UList.init(): initialize the list.
+///     UList.drop(): drop the list.
+///     UList.clone_from(const UList *other): clone the list from another list.
+///     UList.clone() const -> UList: clone the list.
+///     UList.front() -> T*: get the front element of the list.
+///     UList.back() -> T*: get the back element of the list.
+///     UList.at(usize index) -> T*: get the element at index; O(size / UNROLLED_LIST_NODE_CAP(T)).
+///     UList.push_front(T value): push a value to the front of the list.
+///     UList.push_back(T value): push a value to the back of the list.
+///     UList.pop_front() -> T: pop a value from the front of the list.
+///     UList.pop_back() -> T: pop a value from the back of the list.
+///     UList.remove_front(): remove the front element of the list.
+///     UList.remove_back(): remove the back element of the list.
+///     UList.insert(usize index, T value): insert a value at index (<= size).
+///     UList.erase(usize index): erase the element at index.
+///     UList.remove(UListIterator it) -> UListIterator: remove an element, and return the iterator of the next one.
+///     UList.insert_after(UListIterator it, T value): insert a value after an element, or at the front if it is the
+///         end.
+///     UList.swap(UList *other): swap the list with another list.
+///     UList.empty() -> bool: check if the list is empty.
+///     UList.clear(): clear the list.
+///     UList.begin() -> UListIterator: the iterator of the first element.
+///     UList::next(UListIterator it) -> UListIterator: the iterator of the next element.
+///     UList::deref(UListIterator it) -> T*: the element of an iterator.
+///
+///     An iterator is the end when its node is NULL, e.g.
+///         for (UListIterator it = CALL(UList, list, begin, /); it.node; it = NSCALL(UList, next, /, it)) { ... }
+///     and the fastest iteration walks the nodes and their arrays directly:
+///         for (UListNode *node = list.head; node; node = node->next) { ... node->data[0, node->size) ... }
+///     Inserting or erasing invalidates the iterators and the element pointers of the nodes involved.
+// clang-format on
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "tem_memory_primitive.h"
+#include "utils.h"
+
+#undef UNROLLED_LIST_NODE_BYTES
+#define UNROLLED_LIST_NODE_BYTES 2048
+
+#undef UNROLLED_LIST_NODE_CAP
+#define UNROLLED_LIST_NODE_CAP(T)                                              \
+    (sizeof(T) * 8 < UNROLLED_LIST_NODE_BYTES                                  \
+         ? UNROLLED_LIST_NODE_BYTES / sizeof(T)                                \
+         : 8)
+
+#undef DECLARE_UNROLLED_LIST
+#define DECLARE_UNROLLED_LIST(UList, T, STORAGE, value_gen)                    \
+    DECLARE_UNROLLED_LIST_INNER(UList, CONCATENATE(UList, Node),               \
+                                CONCATENATE(UList, Iterator), typeof(T),       \
+                                STORAGE);                                      \
+    value_gen(UList, T);
+
+#undef DEFINE_UNROLLED_LIST
+#define DEFINE_UNROLLED_LIST(UList, T, STORAGE)                                \
+    DEFINE_UNROLLED_LIST_INNER(UList, CONCATENATE(UList, Node),                \
+                               CONCATENATE(UList, Iterator), typeof(T),        \
+                               STORAGE);
+
+#undef DECLARE_UNROLLED_LIST_INNER
+#define DECLARE_UNROLLED_LIST_INNER(UList, UListNode, UListIterator, T,        \
+                                    STORAGE)                                   \
+                                                                               \
+    typedef struct UListNode {                                                 \
+        struct UListNode *prev;                                                \
+        struct UListNode *next;                                                \
+        usize size;                                                            \
+        T data[UNROLLED_LIST_NODE_CAP(T)];                                     \
+    } UListNode;                                                               \
+                                                                               \
+    typedef struct UList {                                                     \
+        struct UListNode *head;                                                \
+        struct UListNode *tail;                                                \
+        usize size;                                                            \
+    } UList;                                                                   \
+                                                                               \
+    /* the position of an element; node is NULL at the end */                  \
+    typedef struct UListIterator {                                             \
+        struct UListNode *node;                                                \
+        usize index;                                                           \
+    } UListIterator;                                                           \
+                                                                               \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* UList::drop_value(T *value) */                                          \
+    FUNC_STATIC void NSMTD(UList, drop_value, /, T * value);                   \
+                                                                               \
+    /* UList::clone_value(const T *other) -> T */                              \
+    FUNC_STATIC T NSMTD(UList, clone_value, /, const T *other);                \
+                                                                               \
+    /* UList::trivial_drop_value() -> bool */                                  \
+    FUNC_STATIC bool NSMTD(UList, trivial_drop_value, /);                      \
+                                                                               \
+    /* UList::trivial_clone_value() -> bool */                                 \
+    FUNC_STATIC bool NSMTD(UList, trivial_clone_value, /);                     \
+                                                                               \
+    /* NOTE: Methods to implement in .c */                                     \
+                                                                               \
+    /* UList.drop() */                                                         \
+    STORAGE void MTD(UList, drop, /);                                          \
+                                                                               \
+    /* UList.clone_from(const UList *other) */                                 \
+    STORAGE void MTD(UList, clone_from, /, const UList *other);                \
+                                                                               \
+    /* UList.at(usize index) -> T* */                                          \
+    STORAGE T *MTD(UList, at, /, usize index);                                 \
+                                                                               \
+    /* UList.push_front(T value) */                                            \
+    STORAGE void MTD(UList, push_front, /, T value);                           \
+                                                                               \
+    /* UList.push_back(T value) */                                             \
+    STORAGE void MTD(UList, push_back, /, T value);                            \
+                                                                               \
+    /* UList.pop_front() -> T */                                               \
+    STORAGE T MTD(UList, pop_front, /);                                        \
+                                                                               \
+    /* UList.pop_back() -> T */                                                \
+    STORAGE T MTD(UList, pop_back, /);                                         \
+                                                                               \
+    /* UList.insert(usize index, T value) */                                   \
+    STORAGE void MTD(UList, insert, /, usize index, T value);                  \
+                                                                               \
+    /* UList.erase(usize index) */                                             \
+    STORAGE void MTD(UList, erase, /, usize index);                            \
+                                                                               \
+    /* UList.remove(UListIterator it) -> UListIterator */                      \
+    STORAGE UListIterator MTD(UList, remove, /, UListIterator it);             \
+                                                                               \
+    /* UList.insert_after(UListIterator it, T value) */                        \
+    STORAGE void MTD(UList, insert_after, /, UListIterator it, T value);       \
+                                                                               \
+    /* NOTE: static methods that are not required to implement in .c */        \
+                                                                               \
+    /* UList.init() */                                                         \
+    FUNC_STATIC void MTD(UList, init, /) {                                     \
+        self->head = NULL;                                                     \
+        self->tail = NULL;                                                     \
+        self->size = 0;                                                        \
+    }                                                                          \
+                                                                               \
+    /* UList.clone() const -> UList */                                         \
+    FUNC_STATIC DEFAULT_DERIVE_CLONE(UList, /);                                \
+                                                                               \
+    /* UList.front() -> T* */                                                  \
+    FUNC_STATIC T *MTD(UList, front, /) {                                      \
+        ASSERT(self->head);                                                    \
+        return &self->head->data[0];                                           \
+    }                                                                          \
+                                                                               \
+    /* UList.back() -> T* */                                                   \
+    FUNC_STATIC T *MTD(UList, back, /) {                                       \
+        ASSERT(self->tail);                                                    \
+        return &self->tail->data[self->tail->size - 1];                        \
+    }                                                                          \
+                                                                               \
+    /* UList.remove_front() */                                                 \
+    FUNC_STATIC void MTD(UList, remove_front, /) {                             \
+        T MPROT(value) = CALL(UList, *self, pop_front, /);                     \
+        NSCALL(UList, drop_value, /, &MPROT(value));                           \
+    }                                                                          \
+                                                                               \
+    /* UList.remove_back() */                                                  \
+    FUNC_STATIC void MTD(UList, remove_back, /) {                              \
+        T MPROT(value) = CALL(UList, *self, pop_back, /);                      \
+        NSCALL(UList, drop_value, /, &MPROT(value));                           \
+    }                                                                          \
+                                                                               \
+    /* UList.swap(UList *other) */                                             \
+    FUNC_STATIC void MTD(UList, swap, /, UList * other) {                      \
+        UList MPROT(temp) = *self;                                             \
+        *self = *other;                                                        \
+        *other = MPROT(temp);                                                  \
+    }                                                                          \
+                                                                               \
+    /* UList.empty() -> bool */                                                \
+    FUNC_STATIC bool MTD(UList, empty, /) { return self->size == 0; }          \
+                                                                               \
+    /* UList.clear() */                                                        \
+    FUNC_STATIC void MTD(UList, clear, /) { DROPOBJ(UList, *self); }           \
+                                                                               \
+    /* UList.begin() -> UListIterator */                                       \
+    FUNC_STATIC UListIterator MTD(UList, begin, /) {                           \
+        UListIterator MPROT(it) = {.node = self->head, .index = 0};            \
+        return MPROT(it);                                                      \
+    }                                                                          \
+                                                                               \
+    /* UList::next(UListIterator it) -> UListIterator */                       \
+    FUNC_STATIC UListIterator NSMTD(UList, next, /, UListIterator it) {        \
+        if (++it.index == it.node->size) {                                     \
+            it.node = it.node->next;                                           \
+            it.index = 0;                                                      \
+        }                                                                      \
+        return it;                                                             \
+    }                                                                          \
+                                                                               \
+    /* UList::deref(UListIterator it) -> T* */                                 \
+    FUNC_STATIC T *NSMTD(UList, deref, /, UListIterator it) {                  \
+        return &it.node->data[it.index];                                       \
+    }
+
+#undef DEFINE_UNROLLED_LIST_INNER
+#define DEFINE_UNROLLED_LIST_INNER(UList, UListNode, UListIterator, T,         \
+                                   STORAGE)                                    \
+    /* link a new empty node after prev, or at the front if prev is NULL */    \
+    static UListNode *MTD(UList, new_node, /, UListNode * MPROT(prev)) {       \
+        UListNode *MPROT(node) = CREOBJRAWHEAP(UListNode);                     \
+        MPROT(node)->size = 0;                                                 \
+        MPROT(node)->prev = MPROT(prev);                                       \
+        MPROT(node)->next = MPROT(prev) ? MPROT(prev)->next : self->head;      \
+        if (MPROT(node)->prev) {                                               \
+            MPROT(node)->prev->next = MPROT(node);                             \
+        } else {                                                               \
+            self->head = MPROT(node);                                          \
+        }                                                                      \
+        if (MPROT(node)->next) {                                               \
+            MPROT(node)->next->prev = MPROT(node);                             \
+        } else {                                                               \
+            self->tail = MPROT(node);                                          \
+        }                                                                      \
+        return MPROT(node);                                                    \
+    }                                                                          \
+                                                                               \
+    /* unlink a node and free it, without dropping its elements */             \
+    static void MTD(UList, free_node, /, UListNode * MPROT(node)) {            \
+        if (MPROT(node)->prev) {                                               \
+            MPROT(node)->prev->next = MPROT(node)->next;                       \
+        } else {                                                               \
+            self->head = MPROT(node)->next;                                    \
+        }                                                                      \
+        if (MPROT(node)->next) {                                               \
+            MPROT(node)->next->prev = MPROT(node)->prev;                       \
+        } else {                                                               \
+            self->tail = MPROT(node)->prev;                                    \
+        }                                                                      \
+        free(MPROT(node));                                                     \
+    }                                                                          \
+                                                                               \
+    /* the iterator of the element at index < size, from the nearer end */     \
+    static UListIterator MTD(UList, locate, /, usize MPROT(index)) {           \
+        ASSERT(MPROT(index) < self->size, "index %zu out of %zu",              \
+               MPROT(index), self->size);                                      \
+        UListIterator MPROT(it);                                               \
+        if (MPROT(index) < self->size / 2) {                                   \
+            MPROT(it).node = self->head;                                       \
+            while (MPROT(index) >= MPROT(it).node->size) {                     \
+                MPROT(index) -= MPROT(it).node->size;                          \
+                MPROT(it).node = MPROT(it).node->next;                         \
+            }                                                                  \
+            MPROT(it).index = MPROT(index);                                    \
+        } else {                                                               \
+            usize MPROT(rindex) = self->size - 1 - MPROT(index);               \
+            MPROT(it).node = self->tail;                                       \
+            while (MPROT(rindex) >= MPROT(it).node->size) {                    \
+                MPROT(rindex) -= MPROT(it).node->size;                         \
+                MPROT(it).node = MPROT(it).node->prev;                         \
+            }                                                                  \
+            MPROT(it).index = MPROT(it).node->size - 1 - MPROT(rindex);        \
+        }                                                                      \
+        return MPROT(it);                                                      \
+    }                                                                          \
+                                                                               \
+    /* insert a value at pos <= node->size, splitting a full node */           \
+    static void MTD(UList, insert_in, /, UListNode * MPROT(node),              \
+                    usize MPROT(pos), T MPROT(value)) {                        \
+        const usize MPROT(cap) = UNROLLED_LIST_NODE_CAP(T);                    \
+        if (MPROT(node)->size == MPROT(cap)) {                                 \
+            UListNode *MPROT(right) =                                          \
+                CALL(UList, *self, new_node, /, MPROT(node));                  \
+            usize MPROT(half) = MPROT(cap) / 2;                                \
+            memcpy(MPROT(right)->data, MPROT(node)->data + MPROT(half),        \
+                   (MPROT(cap) - MPROT(half)) * sizeof(T));                    \
+            MPROT(right)->size = MPROT(cap) - MPROT(half);                     \
+            MPROT(node)->size = MPROT(half);                                   \
+            if (MPROT(pos) > MPROT(half)) {                                    \
+                MPROT(node) = MPROT(right);                                    \
+                MPROT(pos) -= MPROT(half);                                     \
+            }                                                                  \
+        }                                                                      \
+        memmove(MPROT(node)->data + MPROT(pos) + 1,                            \
+                MPROT(node)->data + MPROT(pos),                                \
+                (MPROT(node)->size - MPROT(pos)) * sizeof(T));                 \
+        MPROT(node)->data[MPROT(pos)] = MPROT(value);                          \
+        MPROT(node)->size++;                                                   \
+        self->size++;                                                          \
+    }                                                                          \
+                                                                               \
+    /* move the element at pos out to *value, rebalance the node with the next \
+     * one, and return the iterator of the element after it */                 \
+    static UListIterator MTD(UList, take_in, /, UListNode * MPROT(node),       \
+                             usize MPROT(pos), T * MPROT(value)) {             \
+        const usize MPROT(cap) = UNROLLED_LIST_NODE_CAP(T);                    \
+        *MPROT(value) = MPROT(node)->data[MPROT(pos)];                         \
+        memmove(MPROT(node)->data + MPROT(pos),                                \
+                MPROT(node)->data + MPROT(pos) + 1,                            \
+                (MPROT(node)->size - MPROT(pos) - 1) * sizeof(T));             \
+        MPROT(node)->size--;                                                   \
+        self->size--;                                                          \
+        UListNode *MPROT(next) = MPROT(node)->next;                            \
+        UListIterator MPROT(it) = {.node = MPROT(next), .index = 0};           \
+        if (MPROT(node)->size == 0) {                                          \
+            CALL(UList, *self, free_node, /, MPROT(node));                     \
+            return MPROT(it);                                                  \
+        }                                                                      \
+        if (MPROT(next) && MPROT(node)->size < MPROT(cap) / 2) {               \
+            usize MPROT(moved) = MPROT(next)->size;                            \
+            if (MPROT(node)->size + MPROT(next)->size > MPROT(cap)) {          \
+                /* refill the node up to the average of the two */             \
+                MPROT(moved) = (MPROT(next)->size - MPROT(node)->size) / 2;    \
+            }                                                                  \
+            memcpy(MPROT(node)->data + MPROT(node)->size, MPROT(next)->data,   \
+                   MPROT(moved) * sizeof(T));                                  \
+            MPROT(node)->size += MPROT(moved);                                 \
+            MPROT(next)->size -= MPROT(moved);                                 \
+            if (MPROT(next)->size == 0) {                                      \
+                CALL(UList, *self, free_node, /, MPROT(next));                 \
+            } else {                                                           \
+                memmove(MPROT(next)->data, MPROT(next)->data + MPROT(moved),   \
+                        MPROT(next)->size * sizeof(T));                        \
+            }                                                                  \
+        }                                                                      \
+        if (MPROT(pos) < MPROT(node)->size) {                                  \
+            MPROT(it).node = MPROT(node);                                      \
+            MPROT(it).index = MPROT(pos);                                      \
+        } else {                                                               \
+            MPROT(it).node = MPROT(node)->next;                                \
+        }                                                                      \
+        return MPROT(it);                                                      \
+    }                                                                          \
+                                                                               \
+    /* UList.drop() */                                                         \
+    STORAGE void MTD(UList, drop, /) {                                         \
+        bool MPROT(trivial) = NSCALL(UList, trivial_drop_value, /);            \
+        while (self->head) {                                                   \
+            UListNode *MPROT(now) = self->head;                                \
+            self->head = self->head->next;                                     \
+            if (!MPROT(trivial)) {                                             \
+                for (usize MPROT(i) = 0; MPROT(i) < MPROT(now)->size;          \
+                     MPROT(i)++) {                                             \
+                    NSCALL(UList, drop_value, /, &MPROT(now)->data[MPROT(i)]); \
+                }                                                              \
+            }                                                                  \
+            free(MPROT(now));                                                  \
+        }                                                                      \
+        self->tail = NULL;                                                     \
+        self->size = 0;                                                        \
+    }                                                                          \
+                                                                               \
+    /* UList.clone_from(const UList *other) */                                 \
+    STORAGE void MTD(UList, clone_from, /, const UList *MPROT(other)) {        \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        DROPOBJ(UList, *self);                                                 \
+        bool MPROT(trivial) = NSCALL(UList, trivial_clone_value, /);           \
+        for (UListNode *MPROT(it) = MPROT(other)->head; MPROT(it);             \
+             MPROT(it) = MPROT(it)->next) {                                    \
+            UListNode *MPROT(now) =                                            \
+                CALL(UList, *self, new_node, /, self->tail);                   \
+            if (MPROT(trivial)) {                                              \
+                memcpy(MPROT(now)->data, MPROT(it)->data,                      \
+                       MPROT(it)->size * sizeof(T));                           \
+            } else {                                                           \
+                for (usize MPROT(i) = 0; MPROT(i) < MPROT(it)->size;           \
+                     MPROT(i)++) {                                             \
+                    MPROT(now)->data[MPROT(i)] = NSCALL(                       \
+                        UList, clone_value, /, &MPROT(it)->data[MPROT(i)]);    \
+                }                                                              \
+            }                                                                  \
+            MPROT(now)->size = MPROT(it)->size;                                \
+        }                                                                      \
+        self->size = MPROT(other)->size;                                       \
+    }                                                                          \
+                                                                               \
+    /* UList.at(usize index) -> T* */                                          \
+    STORAGE T *MTD(UList, at, /, usize MPROT(index)) {                         \
+        UListIterator MPROT(it) = CALL(UList, *self, locate, /, MPROT(index)); \
+        return &MPROT(it).node->data[MPROT(it).index];                         \
+    }                                                                          \
+                                                                               \
+    /* UList.push_front(T value) */                                            \
+    STORAGE void MTD(UList, push_front, /, T MPROT(value)) {                   \
+        if (!self->head || self->head->size == UNROLLED_LIST_NODE_CAP(T)) {    \
+            CALL(UList, *self, new_node, /, NULL);                             \
+        }                                                                      \
+        CALL(UList, *self, insert_in, /, self->head, 0, MPROT(value));         \
+    }                                                                          \
+                                                                               \
+    /* UList.push_back(T value) */                                             \
+    STORAGE void MTD(UList, push_back, /, T MPROT(value)) {                    \
+        if (!self->tail || self->tail->size == UNROLLED_LIST_NODE_CAP(T)) {    \
+            CALL(UList, *self, new_node, /, self->tail);                       \
+        }                                                                      \
+        CALL(UList, *self, insert_in, /, self->tail, self->tail->size,         \
+             MPROT(value));                                                    \
+    }                                                                          \
+                                                                               \
+    /* UList.pop_front() -> T */                                               \
+    STORAGE T MTD(UList, pop_front, /) {                                       \
+        ASSERT(self->head);                                                    \
+        T MPROT(value);                                                        \
+        CALL(UList, *self, take_in, /, self->head, 0, &MPROT(value));          \
+        return MPROT(value);                                                   \
+    }                                                                          \
+                                                                               \
+    /* UList.pop_back() -> T */                                                \
+    STORAGE T MTD(UList, pop_back, /) {                                        \
+        ASSERT(self->tail);                                                    \
+        T MPROT(value);                                                        \
+        CALL(UList, *self, take_in, /, self->tail, self->tail->size - 1,       \
+             &MPROT(value));                                                   \
+        return MPROT(value);                                                   \
+    }                                                                          \
+                                                                               \
+    /* UList.insert(usize index, T value) */                                   \
+    STORAGE void MTD(UList, insert, /, usize MPROT(index), T MPROT(value)) {   \
+        if (MPROT(index) == self->size) {                                      \
+            CALL(UList, *self, push_back, /, MPROT(value));                    \
+            return;                                                            \
+        }                                                                      \
+        UListIterator MPROT(it) = CALL(UList, *self, locate, /, MPROT(index)); \
+        CALL(UList, *self, insert_in, /, MPROT(it).node, MPROT(it).index,      \
+             MPROT(value));                                                    \
+    }                                                                          \
+                                                                               \
+    /* UList.erase(usize index) */                                             \
+    STORAGE void MTD(UList, erase, /, usize MPROT(index)) {                    \
+        UListIterator MPROT(it) = CALL(UList, *self, locate, /, MPROT(index)); \
+        CALL(UList, *self, remove, /, MPROT(it));                              \
+    }                                                                          \
+                                                                               \
+    /* UList.remove(UListIterator it) -> UListIterator */                      \
+    STORAGE UListIterator MTD(UList, remove, /, UListIterator MPROT(it)) {     \
+        T MPROT(value);                                                        \
+        MPROT(it) = CALL(UList, *self, take_in, /, MPROT(it).node,             \
+                         MPROT(it).index, &MPROT(value));                      \
+        NSCALL(UList, drop_value, /, &MPROT(value));                           \
+        return MPROT(it);                                                      \
+    }                                                                          \
+                                                                               \
+    /* UList.insert_after(UListIterator it, T value) */                        \
+    STORAGE void MTD(UList, insert_after, /, UListIterator MPROT(it),          \
+                     T MPROT(value)) {                                         \
+        if (!MPROT(it).node) {                                                 \
+            CALL(UList, *self, push_front, /, MPROT(value));                   \
+            return;                                                            \
+        }                                                                      \
+        CALL(UList, *self, insert_in, /, MPROT(it).node, MPROT(it).index + 1,  \
+             MPROT(value));                                                    \
+    }
@@ -6,6 +6,19 @@
 ///     DEFINE_PLAIN_VEC(Vec, T, STORAGE): define a plain vector-like data structure.
 ///     DECLARE_CLASS_VEC(Vec, T, STORAGE): declare a class vector-like data structure.
 ///     DEFINE_CLASS_VEC(Vec, T, STORAGE): define a class vector-like data structure.
+///     DECLARE_PLAIN_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, alloc_gen),
+///     DECLARE_CLASS_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, alloc_gen): declare a vector with the memory of another
+///         allocator; the plain DECLARE_*_VEC use the libc heap.
+///         alloc_gen: define the allocator generator, see allocator.h.
+///     DECLARE_VEC_ALGORITHM(Vec, T, STORAGE, com_gen): declare the sorting and searching methods of a (plain or class)
+///         vector.
+///         com_gen: define the comparator generator, see tem_algorithm.h.
+///     DEFINE_VEC_ALGORITHM(Vec, T, STORAGE): define the sorting and searching methods of a vector.
+///     DECLARE_VEC_SORT_BY(Vec, By, T, STORAGE, com_gen): declare the sorting and searching methods of a vector by
+///         another order, named with the suffix `_by_<By>`; the comparator lives in the namespace `Vec_<By>`.
+///     DEFINE_VEC_SORT_BY(Vec, By, T, STORAGE): define the sorting and searching methods of a vector by another order.
+///     DECLARE_VEC_NUMERIC(Vec, T): declare the numeric methods of a plain vector, vectorized by simd.h for
+///         32/64-bit integers and floats and falling back to scalar loops for other arithmetic types.
 ///
 ///     Here STORAGE is either `FUNC_STATIC` or `FUNC_EXTERN`
 ///
@@ -17,9 +30,15 @@
 ///     Vec.reserve(usize new_cap): reserve the capacity of the vector.
 ///     Vec.insert(usize to_index, T elem): insert an element at the specified index.
 ///     Vec.erase(usize index): erase an element at the specified index.
+///     Vec.erase_range(usize lo, usize hi): erase the elements in [lo, hi).
+///     Vec.retain(bool (*pred)(const T *elem, void *ctx), void *ctx): keep only the elements satisfying pred, in one
+///         pass.
+///     Vec.erase_if(bool (*pred)(const T *elem, void *ctx), void *ctx): erase the elements satisfying pred, in one
+///         pass.
 ///     Vec.push_back(T elem): push an element to the back of the vector.
 ///     Vec.pop_back(): pop an element from the back of the vector.
 ///     Vec.resize(usize new_size): resize the vector to the specified size.
+///     Vec.truncate(usize limit): truncate the vector to the specified limit.
 ///     Vec.swap(Vec *other): swap the vector with another vector.
 ///     Vec.shrink_to_fit(): shrink the capacity of the vector to its size.
 ///     Vec.empty() -> bool: check if the vector is empty.
@@ -31,11 +50,17 @@
 /// Class Vec Methods:
 ///    Vec.init(): initialize the vector.
 ///    Vec.drop(): drop the vector.
-///    Vec.clone_from(const Vec *other): clone the vector from another vector.
+///    Vec.clone_from(const Vec *other): clone the vector from another vector; the existing elements are cloned into
+///        by their own clone_from, reusing their resources.
 ///    Vec.clone() const -> Vec: clone the vector.
 ///    Vec.reserve(usize new_cap): reserve the capacity of the vector.
 ///    Vec.insert(usize to_index, T elem): insert an element at the specified index.
 ///    Vec.erase(usize index): erase an element at the specified index.
+///    Vec.erase_range(usize lo, usize hi): erase (and drop) the elements in [lo, hi).
+///    Vec.retain(bool (*pred)(const T *elem, void *ctx), void *ctx): keep only the elements satisfying pred, in one
+///        pass; each removed element is dropped once.
+///    Vec.erase_if(bool (*pred)(const T *elem, void *ctx), void *ctx): erase the elements satisfying pred, in one
+///        pass; each removed element is dropped once.
 ///    Vec.push_back(T elem): push an element to the back of the vector.
 ///    Vec.pop_back(): pop an element from the back of the vector.
 ///    Vec.resize(usize new_size, T padding): resize the vector to the specified size.
@@ -47,6 +72,29 @@
 ///    Vec.at(usize index) -> T *: get the element at the specified index.
 ///    Vec.front() -> T *: get the first element of the vector.
 ///    Vec.back() -> T *: get the last element of the vector.
+///
+///    If T declares DECLARE_TRIVIAL_CLONE / DECLARE_TRIVIAL_DROP (see utils.h), the elements are cloned by memcpy and
+///    the drop loops are skipped.
+///
+/// Algorithm Methods (DECLARE_VEC_ALGORITHM):
+///    Vec.sort(): sort the vector, not stable.
+///    Vec.stable_sort(): sort the vector, stable.
+///    Vec.is_sorted() -> bool: check if the vector is sorted.
+///    Vec.lower_bound(const T *key) -> usize: the first index whose element >= key; the vector must be sorted.
+///    Vec.upper_bound(const T *key) -> usize: the first index whose element > key; the vector must be sorted.
+///    Vec.binary_search(const T *key) -> T *: an element == key, or NULL; the vector must be sorted.
+///    Vec.dedup(): remove consecutive duplicates (dropped in class vectors).
+///
+///    DECLARE_VEC_SORT_BY(Vec, By, ...) provides the same methods with the
+///    suffix `_by_<By>`, e.g. Vec.sort_by_<By>().
+///
+/// Numeric Methods (DECLARE_VEC_NUMERIC):
+///    Vec.find(T value) -> usize: the first index of value, or size if absent.
+///    Vec.count(T value) -> usize: the number of elements == value.
+///    Vec.contains(T value) -> bool: check if the vector contains value.
+///    Vec.minmax() -> VecMinMax: the minimum and maximum ({T min; T max;}); the vector must not be empty.
+///    Vec.sum() -> SIMD_SUM_TYPE(T): the sum, accumulated in i64, u64 or f64.
+///    Vec.filter_into(Vec *out, SimdCmp cmp, T value): append the elements `e` with `e cmp value` to out.
 // clang-format on
 
 #pragma once
@@ -55,13 +103,35 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
+#include "container_core.h"
 #include "debug.h"
+#include "simd.h"
+#include "tem_algorithm.h"
 #include "utils.h"
 
+/// the growth and the element moves of vectors, by the shared core with
+/// OOPINC_SHARED_CORE
+#undef DEFINE_VEC_CORE_GROWTH
+#ifdef OOPINC_SHARED_CORE
+#define DEFINE_VEC_CORE_GROWTH(Vec, T, STORAGE)                                \
+    DEFINE_VEC_GROWTH_SHARED(Vec, T, STORAGE)                                  \
+    DEFINE_VEC_SHIFT_SHARED(Vec, T)
+#else
+#define DEFINE_VEC_CORE_GROWTH(Vec, T, STORAGE)                                \
+    DEFINE_VEC_GROWTH(Vec, T, STORAGE)                                         \
+    DEFINE_VEC_SHIFT(Vec, T)
+#endif
+
 /// declare at .h files
 #undef DECLARE_PLAIN_VEC
 #define DECLARE_PLAIN_VEC(Vec, T, STORAGE)                                     \
-    DECLARE_PLAIN_VEC_INNER(Vec, typeof(T), STORAGE)
+    DECLARE_PLAIN_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, GENERATOR_LIBC_ALLOCATOR)
+
+#undef DECLARE_PLAIN_VEC_WITH_ALLOCATOR
+#define DECLARE_PLAIN_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, alloc_gen)           \
+    DECLARE_PLAIN_VEC_INNER(Vec, typeof(T), STORAGE);                          \
+    alloc_gen(Vec)
 
 #undef DECLARE_PLAIN_VEC_INNER
 #define DECLARE_PLAIN_VEC_INNER(Vec, T, STORAGE)                               \
@@ -71,6 +141,11 @@
         usize capacity;                                                        \
     } Vec;                                                                     \
                                                                                \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* Vec::allocator() -> Allocator * */                                      \
+    FUNC_STATIC Allocator *NSMTD(Vec, allocator, /);                           \
+                                                                               \
     /* NOTE: Methods to implement in .c */                                     \
                                                                                \
     /* Vec.clone_from(const Vec *other) */                                     \
@@ -88,6 +163,17 @@
     /* Vec.erase(usize index) */                                               \
     STORAGE void MTD(Vec, erase, /, usize index);                              \
                                                                                \
+    /* Vec.erase_range(usize lo, usize hi) */                                  \
+    STORAGE void MTD(Vec, erase_range, /, usize lo, usize hi);                 \
+                                                                               \
+    /* Vec.retain(bool (*pred)(const T *elem, void *ctx), void *ctx) */        \
+    STORAGE void MTD(Vec, retain, /, bool (*pred)(const T *elem, void *ctx),   \
+                     void *ctx);                                               \
+                                                                               \
+    /* Vec.erase_if(bool (*pred)(const T *elem, void *ctx), void *ctx) */      \
+    STORAGE void MTD(Vec, erase_if, /, bool (*pred)(const T *elem, void *ctx), \
+                     void *ctx);                                               \
+                                                                               \
     /* Vec.push_back(T elem) */                                                \
     STORAGE void MTD(Vec, push_back, /, T elem);                               \
                                                                                \
@@ -121,6 +207,13 @@
     /* Vec.clear() */                                                          \
     FUNC_STATIC void MTD(Vec, clear, /) { self->size = 0; }                    \
                                                                                \
+    /* Vec.truncate(usize limit) */                                            \
+    FUNC_STATIC void MTD(Vec, truncate, /, usize limit) {                      \
+        if (limit < self->size) {                                              \
+            self->size = limit;                                                \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
     /* Vec.at(usize index) -> T* */                                            \
     FUNC_STATIC T *MTD(Vec, at, /, usize index) {                              \
         ASSERT(index < self->size);                                            \
@@ -155,43 +248,14 @@
     }                                                                          \
                                                                                \
     STORAGE void MTD(Vec, drop, /) {                                           \
-        free(self->data);                                                      \
+        NSCALL(Allocator, deallocate, /, NSCALL(Vec, allocator, /),            \
+               self->data, self->capacity * sizeof(T));                        \
         self->data = NULL;                                                     \
         self->size = 0;                                                        \
         self->capacity = 0;                                                    \
     }                                                                          \
                                                                                \
-    STORAGE void MTD(Vec, reserve, /, usize MPROT(new_cap)) {                  \
-        if (MPROT(new_cap) <= self->capacity) {                                \
-            return;                                                            \
-        }                                                                      \
-        ASSERT(MPROT(new_cap) > 0);                                            \
-        self->data = (T *)realloc(self->data, MPROT(new_cap) * sizeof(T));     \
-        ASSERT(self->data);                                                    \
-        memset(self->data + self->capacity, 0,                                 \
-               (MPROT(new_cap) - self->capacity) * sizeof(T));                 \
-        self->capacity = MPROT(new_cap);                                       \
-    }                                                                          \
-                                                                               \
-    static usize NSMTD(Vec, num_from_size, /) {                                \
-        usize MPROT(size) = sizeof(T);                                         \
-        /* For tiny vectors. From Rust's alloc::raw_vec::min_non_zero_cap */   \
-        if (MPROT(size) == 1) {                                                \
-            return 8;                                                          \
-        } else if (MPROT(size) <= 1024) {                                      \
-            return 4;                                                          \
-        } else {                                                               \
-            return 1;                                                          \
-        }                                                                      \
-    }                                                                          \
-                                                                               \
-    STORAGE void MTD(Vec, check_expansion, /) {                                \
-        if (self->size < self->capacity) {                                     \
-            return;                                                            \
-        }                                                                      \
-        CALL(Vec, *self, reserve, /,                                           \
-             Max(NSCALL(Vec, num_from_size, /), self->capacity * 2));          \
-    }                                                                          \
+    DEFINE_VEC_CORE_GROWTH(Vec, T, STORAGE)                                    \
                                                                                \
     STORAGE void MTD(Vec, insert, /, usize MPROT(to_index), T MPROT(elem)) {   \
         ASSERT(MPROT(to_index) <= self->size);                                 \
@@ -200,9 +264,7 @@
             return;                                                            \
         }                                                                      \
         CALL(Vec, *self, check_expansion, /);                                  \
-        memmove(self->data + MPROT(to_index) + 1,                              \
-                self->data + MPROT(to_index),                                  \
-                (self->size - MPROT(to_index)) * sizeof(T));                   \
+        CALL(Vec, *self, open_gap, /, MPROT(to_index));                        \
         self->data[MPROT(to_index)] = MPROT(elem);                             \
         self->size++;                                                          \
     }                                                                          \
@@ -213,11 +275,44 @@
             CALL(Vec, *self, pop_back, /);                                     \
             return;                                                            \
         }                                                                      \
-        memmove(self->data + MPROT(index), self->data + MPROT(index) + 1,      \
-                (self->size - MPROT(index) - 1) * sizeof(T));                  \
+        CALL(Vec, *self, close_gap, /, MPROT(index), MPROT(index) + 1);        \
         self->size--;                                                          \
     }                                                                          \
                                                                                \
+    STORAGE void MTD(Vec, erase_range, /, usize MPROT(lo), usize MPROT(hi)) {  \
+        ASSERT(MPROT(lo) <= MPROT(hi) && MPROT(hi) <= self->size);             \
+        CALL(Vec, *self, close_gap, /, MPROT(lo), MPROT(hi));                  \
+        self->size -= MPROT(hi) - MPROT(lo);                                   \
+    }                                                                          \
+                                                                               \
+    /* keep the elements whose pred(elem, ctx) == keep, in one pass */         \
+    static void MTD(Vec, compact, /,                                           \
+                    bool (*MPROT(pred))(const T *elem, void *ctx),             \
+                    void *MPROT(ctx), bool MPROT(keep)) {                      \
+        usize MPROT(kept) = 0;                                                 \
+        for (usize i = 0; i < self->size; i++) {                               \
+            if (MPROT(pred)(self->data + i, MPROT(ctx)) == MPROT(keep)) {      \
+                if (MPROT(kept) != i) {                                        \
+                    self->data[MPROT(kept)] = self->data[i];                   \
+                }                                                              \
+                MPROT(kept)++;                                                 \
+            }                                                                  \
+        }                                                                      \
+        self->size = MPROT(kept);                                              \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, retain, /,                                           \
+                     bool (*MPROT(pred))(const T *elem, void *ctx),            \
+                     void *MPROT(ctx)) {                                       \
+        CALL(Vec, *self, compact, /, MPROT(pred), MPROT(ctx), true);           \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, erase_if, /,                                         \
+                     bool (*MPROT(pred))(const T *elem, void *ctx),            \
+                     void *MPROT(ctx)) {                                       \
+        CALL(Vec, *self, compact, /, MPROT(pred), MPROT(ctx), false);          \
+    }                                                                          \
+                                                                               \
     STORAGE void MTD(Vec, push_back, /, T MPROT(elem)) {                       \
         CALL(Vec, *self, check_expansion, /);                                  \
         self->data[self->size++] = MPROT(elem);                                \
@@ -240,27 +335,27 @@
         Vec MPROT(tmp) = *self;                                                \
         *self = *MPROT(other);                                                 \
         *MPROT(other) = MPROT(tmp);                                            \
-    }                                                                          \
-                                                                               \
-    STORAGE void MTD(Vec, shrink_to_fit, /) {                                  \
-        if (self->size == self->capacity) {                                    \
-            return;                                                            \
-        }                                                                      \
-        self->data = (T *)realloc(self->data, self->size * sizeof(T));         \
-        ASSERT(self->data);                                                    \
-        self->capacity = self->size;                                           \
     }
 
 /// declare at .h files
 
 #undef DECLARE_CLASS_VEC
 #define DECLARE_CLASS_VEC(Vec, T, STORAGE)                                     \
+    DECLARE_CLASS_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, GENERATOR_LIBC_ALLOCATOR)
+
+#undef DECLARE_CLASS_VEC_WITH_ALLOCATOR
+#define DECLARE_CLASS_VEC_WITH_ALLOCATOR(Vec, T, STORAGE, alloc_gen)           \
     typedef struct Vec {                                                       \
         T *data;                                                               \
         usize size;                                                            \
         usize capacity;                                                        \
     } Vec;                                                                     \
                                                                                \
+    /* NOTE: Methods that are required to defined outside the template */      \
+                                                                               \
+    /* Vec::allocator() -> Allocator * */                                      \
+    FUNC_STATIC Allocator *NSMTD(Vec, allocator, /);                           \
+                                                                               \
     /* NOTE: Methods to implement in .c */                                     \
                                                                                \
     /* Vec.clone_from(const Vec *other) */                                     \
@@ -281,6 +376,17 @@
     /* Vec.erase(usize index) */                                               \
     STORAGE void MTD(Vec, erase, /, usize index);                              \
                                                                                \
+    /* Vec.erase_range(usize lo, usize hi) */                                  \
+    STORAGE void MTD(Vec, erase_range, /, usize lo, usize hi);                 \
+                                                                               \
+    /* Vec.retain(bool (*pred)(const T *elem, void *ctx), void *ctx) */        \
+    STORAGE void MTD(Vec, retain, /, bool (*pred)(const T *elem, void *ctx),   \
+                     void *ctx);                                               \
+                                                                               \
+    /* Vec.erase_if(bool (*pred)(const T *elem, void *ctx), void *ctx) */      \
+    STORAGE void MTD(Vec, erase_if, /, bool (*pred)(const T *elem, void *ctx), \
+                     void *ctx);                                               \
+                                                                               \
     /* Vec.push_back(T elem) */                                                \
     STORAGE void MTD(Vec, push_back, /, T elem);                               \
                                                                                \
@@ -326,73 +432,63 @@
     /* Vec.back() -> T * */                                                    \
     FUNC_STATIC T *MTD(Vec, back, /) {                                         \
         return CALL(Vec, *self, at, /, self->size - 1);                        \
-    }
+    }                                                                          \
+                                                                               \
+    alloc_gen(Vec)
 
 /// define at .c files
 #undef DEFINE_CLASS_VEC
 #define DEFINE_CLASS_VEC(Vec, T, STORAGE)                                      \
-    STORAGE void MTD(Vec, clone_from, /, const Vec *MPROT(other)) {            \
-        if (self == MPROT(other)) {                                            \
+    /* drop the elements in [lo, hi), unless the drop of T is trivial */       \
+    static void MTD(Vec, drop_range, /, usize MPROT(lo), usize MPROT(hi)) {    \
+        if (TYPE_IS_TRIVIAL_DROP(T)) {                                         \
             return;                                                            \
         }                                                                      \
-        for (usize i = 0; i < self->size; i++) {                               \
+        for (usize i = MPROT(lo); i < MPROT(hi); i++) {                        \
             CALL(T, self->data[i], drop, /);                                   \
         }                                                                      \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, clone_from, /, const Vec *MPROT(other)) {            \
+        if (self == MPROT(other)) {                                            \
+            return;                                                            \
+        }                                                                      \
+        CALL(Vec, *self, truncate, /, MPROT(other)->size);                     \
         CALL(Vec, *self, reserve, /, MPROT(other)->size);                      \
-        self->size = MPROT(other)->size;                                       \
+        if (TYPE_IS_TRIVIAL_CLONE(T)) {                                        \
+            if (MPROT(other)->size > 0) {                                      \
+                memcpy(self->data, MPROT(other)->data,                         \
+                       MPROT(other)->size * sizeof(T));                        \
+            }                                                                  \
+            self->size = MPROT(other)->size;                                   \
+            return;                                                            \
+        }                                                                      \
+        /* clone into the existing elements, reusing their resources */        \
         for (usize i = 0; i < self->size; i++) {                               \
+            CALL(T, self->data[i], clone_from, /, &MPROT(other)->data[i]);     \
+        }                                                                      \
+        for (usize i = self->size; i < MPROT(other)->size; i++) {              \
             self->data[i] = CALL(T, MPROT(other)->data[i], clone, /);          \
         }                                                                      \
+        self->size = MPROT(other)->size;                                       \
     }                                                                          \
                                                                                \
     STORAGE void MTD(Vec, drop, /) {                                           \
-        for (usize i = 0; i < self->size; i++) {                               \
-            CALL(T, self->data[i], drop, /);                                   \
-        }                                                                      \
-        free(self->data);                                                      \
+        CALL(Vec, *self, clear, /);                                            \
+        NSCALL(Allocator, deallocate, /, NSCALL(Vec, allocator, /),            \
+               self->data, self->capacity * sizeof(T));                        \
         self->data = NULL;                                                     \
         self->size = 0;                                                        \
         self->capacity = 0;                                                    \
     }                                                                          \
                                                                                \
-    STORAGE void MTD(Vec, reserve, /, usize MPROT(new_cap)) {                  \
-        if (MPROT(new_cap) <= self->capacity) {                                \
-            return;                                                            \
-        }                                                                      \
-        self->data = (T *)realloc(self->data, MPROT(new_cap) * sizeof(T));     \
-        ASSERT(self->data);                                                    \
-        memset(self->data + self->capacity, 0,                                 \
-               (MPROT(new_cap) - self->capacity) * sizeof(T));                 \
-        self->capacity = MPROT(new_cap);                                       \
-    }                                                                          \
+    DEFINE_VEC_CORE_GROWTH(Vec, T, STORAGE)                                    \
                                                                                \
     STORAGE void MTD(Vec, clear, /) {                                          \
-        for (usize i = 0; i < self->size; i++) {                               \
-            CALL(T, self->data[i], drop, /);                                   \
-        }                                                                      \
+        CALL(Vec, *self, drop_range, /, 0, self->size);                        \
         self->size = 0;                                                        \
     }                                                                          \
                                                                                \
-    STORAGE usize NSMTD(Vec, num_from_size, /) {                               \
-        usize MPROT(size) = sizeof(T);                                         \
-        /* For tiny vectors. From Rust's alloc::raw_vec::min_non_zero_cap*/    \
-        if (MPROT(size) == 1) {                                                \
-            return 8;                                                          \
-        } else if (MPROT(size) <= 1024) {                                      \
-            return 4;                                                          \
-        } else {                                                               \
-            return 1;                                                          \
-        }                                                                      \
-    }                                                                          \
-                                                                               \
-    STORAGE void MTD(Vec, check_expansion, /) {                                \
-        if (self->size < self->capacity) {                                     \
-            return;                                                            \
-        }                                                                      \
-        CALL(Vec, *self, reserve, /,                                           \
-             Max(NSCALL(Vec, num_from_size, /), self->capacity * 2));          \
-    }                                                                          \
-                                                                               \
     STORAGE void MTD(Vec, insert, /, usize MPROT(to_index), T MPROT(elem)) {   \
         ASSERT(MPROT(to_index) <= self->size);                                 \
         if (MPROT(to_index) == self->size) {                                   \
@@ -400,9 +496,7 @@
             return;                                                            \
         }                                                                      \
         CALL(Vec, *self, check_expansion, /);                                  \
-        memmove(self->data + MPROT(to_index) + 1,                              \
-                self->data + MPROT(to_index),                                  \
-                (self->size - MPROT(to_index)) * sizeof(T));                   \
+        CALL(Vec, *self, open_gap, /, MPROT(to_index));                        \
         self->data[MPROT(to_index)] = MPROT(elem);                             \
         self->size++;                                                          \
     }                                                                          \
@@ -414,11 +508,47 @@
             return;                                                            \
         }                                                                      \
         CALL(T, self->data[MPROT(index)], drop, /);                            \
-        memmove(self->data + MPROT(index), self->data + MPROT(index) + 1,      \
-                (self->size - MPROT(index) - 1) * sizeof(T));                  \
+        CALL(Vec, *self, close_gap, /, MPROT(index), MPROT(index) + 1);        \
         self->size--;                                                          \
     }                                                                          \
                                                                                \
+    STORAGE void MTD(Vec, erase_range, /, usize MPROT(lo), usize MPROT(hi)) {  \
+        ASSERT(MPROT(lo) <= MPROT(hi) && MPROT(hi) <= self->size);             \
+        CALL(Vec, *self, drop_range, /, MPROT(lo), MPROT(hi));                 \
+        CALL(Vec, *self, close_gap, /, MPROT(lo), MPROT(hi));                  \
+        self->size -= MPROT(hi) - MPROT(lo);                                   \
+    }                                                                          \
+                                                                               \
+    /* keep the elements whose pred(elem, ctx) == keep, in one pass */         \
+    static void MTD(Vec, compact, /,                                           \
+                    bool (*MPROT(pred))(const T *elem, void *ctx),             \
+                    void *MPROT(ctx), bool MPROT(keep)) {                      \
+        usize MPROT(kept) = 0;                                                 \
+        for (usize i = 0; i < self->size; i++) {                               \
+            if (MPROT(pred)(self->data + i, MPROT(ctx)) == MPROT(keep)) {      \
+                if (MPROT(kept) != i) {                                        \
+                    self->data[MPROT(kept)] = self->data[i];                   \
+                }                                                              \
+                MPROT(kept)++;                                                 \
+            } else {                                                           \
+                CALL(T, self->data[i], drop, /);                               \
+            }                                                                  \
+        }                                                                      \
+        self->size = MPROT(kept);                                              \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, retain, /,                                           \
+                     bool (*MPROT(pred))(const T *elem, void *ctx),            \
+                     void *MPROT(ctx)) {                                       \
+        CALL(Vec, *self, compact, /, MPROT(pred), MPROT(ctx), true);           \
+    }                                                                          \
+                                                                               \
+    STORAGE void MTD(Vec, erase_if, /,                                         \
+                     bool (*MPROT(pred))(const T *elem, void *ctx),            \
+                     void *MPROT(ctx)) {                                       \
+        CALL(Vec, *self, compact, /, MPROT(pred), MPROT(ctx), false);          \
+    }                                                                          \
+                                                                               \
     STORAGE void MTD(Vec, push_back, /, T MPROT(elem)) {                       \
         CALL(Vec, *self, check_expansion, /);                                  \
         self->data[self->size++] = MPROT(elem);                                \
@@ -434,9 +564,7 @@
                      T MPROT(padding)) {                                       \
         CALL(Vec, *self, reserve, /, MPROT(new_size));                         \
         if (MPROT(new_size) < self->size) {                                    \
-            for (usize i = MPROT(new_size); i < self->size; i++) {             \
-                CALL(T, self->data[i], drop, /);                               \
-            }                                                                  \
+            CALL(Vec, *self, drop_range, /, MPROT(new_size), self->size);      \
         } else if (MPROT(new_size) > self->size) {                             \
             for (usize i = self->size; i + 1 < MPROT(new_size); i++) {         \
                 self->data[i] = CALL(T, MPROT(padding), clone, /);             \
@@ -450,9 +578,7 @@
         if (MPROT(limit) >= self->size) {                                      \
             return;                                                            \
         }                                                                      \
-        for (usize i = MPROT(limit); i < self->size; i++) {                    \
-            CALL(T, self->data[i], drop, /);                                   \
-        }                                                                      \
+        CALL(Vec, *self, drop_range, /, MPROT(limit), self->size);             \
         self->size = MPROT(limit);                                             \
     }                                                                          \
                                                                                \
@@ -463,13 +589,218 @@
         Vec MPROT(tmp) = *self;                                                \
         *self = *MPROT(other);                                                 \
         *MPROT(other) = MPROT(tmp);                                            \
+    }
+
+/// declare at .h files
+#undef DECLARE_VEC_ALGORITHM
+#define DECLARE_VEC_ALGORITHM(Vec, T, STORAGE, com_gen)                        \
+    DECLARE_SLICE_ALGORITHM(Vec, T, STORAGE, com_gen);                         \
+    DECLARE_VEC_ALGORITHM_INNER(Vec, Vec, typeof(T), )
+
+#undef DECLARE_VEC_SORT_BY
+#define DECLARE_VEC_SORT_BY(Vec, By, T, STORAGE, com_gen)                      \
+    DECLARE_SLICE_ALGORITHM(CONCATENATE3(Vec, _, By), T, STORAGE, com_gen);    \
+    DECLARE_VEC_ALGORITHM_INNER(Vec, CONCATENATE3(Vec, _, By), typeof(T),      \
+                                CONCATENATE(_by_, By))
+
+/// define at .c files
+#undef DEFINE_VEC_ALGORITHM
+#define DEFINE_VEC_ALGORITHM(Vec, T, STORAGE)                                  \
+    DEFINE_SLICE_ALGORITHM(Vec, T, STORAGE)
+
+#undef DEFINE_VEC_SORT_BY
+#define DEFINE_VEC_SORT_BY(Vec, By, T, STORAGE)                                \
+    DEFINE_SLICE_ALGORITHM(CONCATENATE3(Vec, _, By), T, STORAGE)
+
+#undef DECLARE_VEC_ALGORITHM_INNER
+#define DECLARE_VEC_ALGORITHM_INNER(Vec, Ord, T, SUFFIX)                       \
+    /* Vec.sort() */                                                           \
+    FUNC_STATIC void MTD(Vec, CONCATENATE(sort, SUFFIX), /) {                  \
+        NSCALL(Ord, sort_slice, /, self->data, self->size);                    \
     }                                                                          \
                                                                                \
-    STORAGE void MTD(Vec, shrink_to_fit, /) {                                  \
-        if (self->size == self->capacity) {                                    \
-            return;                                                            \
+    /* Vec.stable_sort() */                                                    \
+    FUNC_STATIC void MTD(Vec, CONCATENATE(stable_sort, SUFFIX), /) {           \
+        NSCALL(Ord, stable_sort_slice, /, self->data, self->size);             \
+    }                                                                          \
+                                                                               \
+    /* Vec.is_sorted() -> bool */                                              \
+    FUNC_STATIC bool MTD(Vec, CONCATENATE(is_sorted, SUFFIX), /) {             \
+        return NSCALL(Ord, is_sorted_slice, /, self->data, self->size);        \
+    }                                                                          \
+                                                                               \
+    /* Vec.lower_bound(const T *key) -> usize */                               \
+    FUNC_STATIC usize MTD(Vec, CONCATENATE(lower_bound, SUFFIX), /,            \
+                          const T *key) {                                      \
+        return NSCALL(Ord, lower_bound_slice, /, self->data, self->size, key); \
+    }                                                                          \
+                                                                               \
+    /* Vec.upper_bound(const T *key) -> usize */                               \
+    FUNC_STATIC usize MTD(Vec, CONCATENATE(upper_bound, SUFFIX), /,            \
+                          const T *key) {                                      \
+        return NSCALL(Ord, upper_bound_slice, /, self->data, self->size, key); \
+    }                                                                          \
+                                                                               \
+    /* Vec.binary_search(const T *key) -> T * */                               \
+    FUNC_STATIC T *MTD(Vec, CONCATENATE(binary_search, SUFFIX), /,             \
+                       const T *key) {                                         \
+        usize MPROT(pos) =                                                     \
+            NSCALL(Ord, binary_search_slice, /, self->data, self->size, key);  \
+        return MPROT(pos) < self->size ? self->data + MPROT(pos) : NULL;       \
+    }                                                                          \
+                                                                               \
+    /* Vec.dedup() */                                                          \
+    FUNC_STATIC void MTD(Vec, CONCATENATE(dedup, SUFFIX), /) {                 \
+        usize MPROT(kept) =                                                    \
+            NSCALL(Ord, dedup_slice, /, self->data, self->size);               \
+        CALL(Vec, *self, truncate, /, MPROT(kept));                            \
+    }
+
+/// numeric kernels of plain vectors, dispatched to simd.h
+#undef DECLARE_VEC_NUMERIC
+#define DECLARE_VEC_NUMERIC(Vec, T) DECLARE_VEC_NUMERIC_INNER(Vec, typeof(T))
+
+/// VEC_NUMERIC_SWITCH(T, CASE) expands to CASE(Suffix, K) for the kernel
+/// matching T, and falls through for other types
+#undef VEC_NUMERIC_SWITCH
+#define VEC_NUMERIC_SWITCH(T, CASE)                                            \
+    switch (SIMD_KIND(T)) {                                                    \
+    case SIMD_KIND_I32:                                                        \
+        CASE(i32, i32);                                                        \
+    case SIMD_KIND_U32:                                                        \
+        CASE(u32, u32);                                                        \
+    case SIMD_KIND_I64:                                                        \
+        CASE(i64, i64);                                                        \
+    case SIMD_KIND_U64:                                                        \
+        CASE(u64, u64);                                                        \
+    case SIMD_KIND_F32:                                                        \
+        CASE(f32, f32);                                                        \
+    case SIMD_KIND_F64:                                                        \
+        CASE(f64, f64);                                                        \
+    default:                                                                   \
+        break;                                                                 \
+    }
+
+#undef VEC_NUMERIC_FIND
+#define VEC_NUMERIC_FIND(Suffix, K)                                            \
+    return NSCALL(Simd, CONCATENATE(find_, Suffix), /,                         \
+                  (const K *)(const void *)self->data, self->size, (K)value)
+
+#undef VEC_NUMERIC_COUNT
+#define VEC_NUMERIC_COUNT(Suffix, K)                                           \
+    return NSCALL(Simd, CONCATENATE(count_, Suffix), /,                        \
+                  (const K *)(const void *)self->data, self->size, (K)value)
+
+#undef VEC_NUMERIC_MINMAX
+#define VEC_NUMERIC_MINMAX(Suffix, K)                                          \
+    NSCALL(Simd, CONCATENATE(minmax_, Suffix), /,                              \
+           (const K *)(const void *)self->data, self->size,                    \
+           (K *)(void *)&MPROT(res).min, (K *)(void *)&MPROT(res).max);        \
+    return MPROT(res)
+
+#undef VEC_NUMERIC_SUM
+#define VEC_NUMERIC_SUM(Suffix, K)                                             \
+    return NSCALL(Simd, CONCATENATE(sum_, Suffix), /,                          \
+                  (const K *)(const void *)self->data, self->size)
+
+#undef VEC_NUMERIC_FILTER
+#define VEC_NUMERIC_FILTER(Suffix, K)                                          \
+    out->size += NSCALL(Simd, CONCATENATE(filter_, Suffix), /,                 \
+                        (const K *)(const void *)self->data, self->size, cmp,  \
+                        (K)value, (K *)(void *)(out->data + out->size));       \
+    return
+
+#undef DECLARE_VEC_NUMERIC_INNER
+#define DECLARE_VEC_NUMERIC_INNER(Vec, T)                                      \
+    typedef struct CONCATENATE(Vec, MinMax) {                                  \
+        T min;                                                                 \
+        T max;                                                                 \
+    } CONCATENATE(Vec, MinMax);                                                \
+                                                                               \
+    /* Vec.find(T value) -> usize */                                           \
+    FUNC_STATIC usize MTD(Vec, find, /, T value) {                             \
+        VEC_NUMERIC_SWITCH(T, VEC_NUMERIC_FIND);                               \
+        for (usize i = 0; i < self->size; i++) {                               \
+            if (self->data[i] == value) {                                      \
+                return i;                                                      \
+            }                                                                  \
+        }                                                                      \
+        return self->size;                                                     \
+    }                                                                          \
+                                                                               \
+    /* Vec.count(T value) -> usize */                                          \
+    FUNC_STATIC usize MTD(Vec, count, /, T value) {                            \
+        VEC_NUMERIC_SWITCH(T, VEC_NUMERIC_COUNT);                              \
+        usize MPROT(cnt) = 0;                                                  \
+        for (usize i = 0; i < self->size; i++) {                               \
+            MPROT(cnt) += self->data[i] == value;                              \
+        }                                                                      \
+        return MPROT(cnt);                                                     \
+    }                                                                          \
+                                                                               \
+    /* Vec.contains(T value) -> bool */                                        \
+    FUNC_STATIC bool MTD(Vec, contains, /, T value) {                          \
+        return CALL(Vec, *self, find, /, value) < self->size;                  \
+    }                                                                          \
+                                                                               \
+    /* Vec.minmax() -> VecMinMax */                                            \
+    FUNC_STATIC CONCATENATE(Vec, MinMax) MTD(Vec, minmax, /) {                 \
+        ASSERT(self->size > 0, "minmax of an empty vector");                   \
+        CONCATENATE(Vec, MinMax) MPROT(res);                                   \
+        VEC_NUMERIC_SWITCH(T, VEC_NUMERIC_MINMAX);                             \
+        MPROT(res).min = MPROT(res).max = self->data[0];                       \
+        for (usize i = 1; i < self->size; i++) {                               \
+            if (self->data[i] < MPROT(res).min) {                              \
+                MPROT(res).min = self->data[i];                                \
+            }                                                                  \
+            if (self->data[i] > MPROT(res).max) {                              \
+                MPROT(res).max = self->data[i];                                \
+            }                                                                  \
+        }                                                                      \
+        return MPROT(res);                                                     \
+    }                                                                          \
+                                                                               \
+    /* Vec.sum() -> SIMD_SUM_TYPE(T) */                                        \
+    FUNC_STATIC SIMD_SUM_TYPE(T) MTD(Vec, sum, /) {                            \
+        VEC_NUMERIC_SWITCH(T, VEC_NUMERIC_SUM);                                \
+        SIMD_SUM_TYPE(T) MPROT(sum) = 0;                                       \
+        for (usize i = 0; i < self->size; i++) {                               \
+            MPROT(sum) += self->data[i];                                       \
+        }                                                                      \
+        return MPROT(sum);                                                     \
+    }                                                                          \
+                                                                               \
+    /* Vec.filter_into(Vec *out, SimdCmp cmp, T value) */                      \
+    FUNC_STATIC void MTD(Vec, filter_into, /, Vec *out, SimdCmp cmp,           \
+                         T value) {                                            \
+        ASSERT(out != self, "filter_into the vector itself");                  \
+        CALL(Vec, *out, reserve, /, out->size + self->size);                   \
+        VEC_NUMERIC_SWITCH(T, VEC_NUMERIC_FILTER);                             \
+        for (usize i = 0; i < self->size; i++) {                               \
+            T MPROT(elem) = self->data[i];                                     \
+            bool MPROT(keep) = false;                                          \
+            switch (cmp) {                                                     \
+            case SIMD_CMP_EQ:                                                  \
+                MPROT(keep) = MPROT(elem) == value;                            \
+                break;                                                         \
+            case SIMD_CMP_NE:                                                  \
+                MPROT(keep) = MPROT(elem) != value;                            \
+                break;                                                         \
+            case SIMD_CMP_LT:                                                  \
+                MPROT(keep) = MPROT(elem) < value;                             \
+                break;                                                         \
+            case SIMD_CMP_LE:                                                  \
+                MPROT(keep) = MPROT(elem) <= value;                            \
+                break;                                                         \
+            case SIMD_CMP_GT:                                                  \
+                MPROT(keep) = MPROT(elem) > value;                             \
+                break;                                                         \
+            case SIMD_CMP_GE:                                                  \
+                MPROT(keep) = MPROT(elem) >= value;                            \
+                break;                                                         \
+            }                                                                  \
+            if (MPROT(keep)) {                                                 \
+                out->data[out->size++] = MPROT(elem);                          \
+            }                                                                  \
         }                                                                      \
-        self->data = (T *)realloc(self->data, self->size * sizeof(T));         \
-        ASSERT(self->data);                                                    \
-        self->capacity = self->size;                                           \
     }
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+
+#include "debug.h"
+#include "timer_wheel.h"
+
+void MTD(TimerWheel, init, /, u64 tick, u32 slot_bits, u32 levels, u64 now) {
+    ASSERT(tick > 0 && slot_bits > 0 && levels > 0 && slot_bits * levels < 64);
+    usize n_slots = (usize)levels << slot_bits;
+    self->slots = (TimerList *)malloc(n_slots * sizeof(TimerList));
+    ASSERT(self->slots);
+    for (usize i = 0; i < n_slots; i++) {
+        CALL(TimerList, self->slots[i], init, /);
+    }
+    self->tick = tick;
+    self->slot_bits = slot_bits;
+    self->levels = levels;
+    self->now_tick = now / tick;
+    self->size = 0;
+}
+
+void MTD(TimerWheel, drop, /) {
+    usize n_slots = (usize)self->levels << self->slot_bits;
+    for (usize i = 0; i < n_slots; i++) {
+        Timer *timer;
+        while ((timer = CALL(TimerList, self->slots[i], pop_front, /))) {
+            timer->slot = NULL;
+        }
+    }
+    free(self->slots);
+    self->slots = NULL;
+    self->size = 0;
+}
+
+/* link a timer expiring at or after now_tick into the slot of the lowest level
+ * covering it, or of the top level if it is beyond the span of the wheel */
+static void MTD(TimerWheel, place, /, Timer *timer) {
+    u64 span = (u64)1 << (self->slot_bits * self->levels);
+    u64 delta = Min(timer->expires - self->now_tick, span - 1);
+    u64 expires = self->now_tick + delta;
+    u32 level = 0;
+    while (level + 1 < self->levels &&
+           delta >> (self->slot_bits * (level + 1))) {
+        level++;
+    }
+    u64 mask = ((u64)1 << self->slot_bits) - 1;
+    usize index = ((usize)level << self->slot_bits) +
+                  (usize)((expires >> (self->slot_bits * level)) & mask);
+    CALL(TimerList, self->slots[index], push_back, /, timer);
+    timer->slot = &self->slots[index];
+}
+
+void MTD(TimerWheel, arm, /, Timer *timer, u64 deadline) {
+    CALL(TimerWheel, *self, cancel, /, timer);
+    u64 expires = deadline / self->tick + (deadline % self->tick != 0);
+    timer->expires = Max(expires, self->now_tick + 1);
+    CALL(TimerWheel, *self, place, /, timer);
+    self->size++;
+}
+
+usize MTD(TimerWheel, advance, /, u64 now) {
+    u64 target = now / self->tick;
+    u64 mask = ((u64)1 << self->slot_bits) - 1;
+    usize fired = 0;
+    while (self->now_tick < target) {
+        if (self->size == 0) {
+            self->now_tick = target;
+            break;
+        }
+        u64 t = ++self->now_tick;
+        // move the timers of the slots reached down, from the top level, so
+        // that a timer may move down several levels at once
+        for (u32 level = self->levels - 1; level > 0; level--) {
+            u32 shift = self->slot_bits * level;
+            if (t & (((u64)1 << shift) - 1)) {
+                continue;
+            }
+            TimerList *slot = &self->slots[((usize)level << self->slot_bits) +
+                                           (usize)((t >> shift) & mask)];
+            Timer *timer;
+            while ((timer = CALL(TimerList, *slot, pop_front, /))) {
+                CALL(TimerWheel, *self, place, /, timer);
+            }
+        }
+        // no timer armed by the callbacks lands in this slot, which holds the
+        // ticks t + k * 2^slot_bits
+        TimerList *slot = &self->slots[t & mask];
+        Timer *timer;
+        while ((timer = CALL(TimerList, *slot, pop_front, /))) {
+            timer->slot = NULL;
+            self->size--;
+            fired++;
+            timer->callback(timer);
+        }
+    }
+    return fired;
+}
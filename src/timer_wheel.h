@@ -0,0 +1,98 @@
+// clang-format off
+/// timer_wheel.h: provides a hierarchical timer wheel
+///
+/// Time is counted in ticks of `tick` units (any unit of the caller, e.g. ms or ns), and a timer fires at the first
+/// tick boundary at or after its deadline, so never early. The wheel has `levels` levels of 2^slot_bits slots each, and
+/// the slots of level L span 2^(slot_bits * L) ticks; a timer sits in the slot of the lowest level covering its
+/// deadline, and moves down a level each time the wheel reaches its slot, so that it is moved at most `levels` times.
+/// Deadlines beyond the span of the wheel (2^(slot_bits * levels) ticks) wait in the top level and are placed again.
+///
+/// The slots are intrusive lists (see tem_intrusive_list.h) of Timer, which the caller embeds into its own structs: a
+/// timer is never allocated nor copied by the wheel, and must not move nor be dropped while armed. Arming and
+/// cancelling are O(1), and advancing is O(1) per tick passed plus the timers fired or moved down.
+///
+///     Timer.init(TimerCallback callback, void *ctx): initializes an unarmed timer; the callback gets the timer, whose
+///         ctx field is free for the caller
+///     Timer.armed() const -> bool: checks if the timer is armed
+///     TimerWheel.init(u64 tick, u32 slot_bits, u32 levels, u64 now): initializes the wheel at time now;
+///         slot_bits * levels must be less than 64
+///     TimerWheel.drop(): drops the wheel, disarming the timers without firing them
+///     TimerWheel.arm(Timer *timer, u64 deadline): arms (or re-arms) a timer to fire at deadline; a deadline already
+///         passed fires at the next tick
+///     TimerWheel.cancel(Timer *timer) -> bool: disarms a timer, and returns whether it was armed
+///     TimerWheel.advance(u64 now) -> usize: moves the time to now (never backwards), and fires the timers due, in the
+///         order of their ticks; returns their number. The callbacks may arm and cancel any timer, including theirs.
+///     TimerWheel.size() const -> usize: the number of armed timers
+///     TimerWheel.empty() const -> bool: checks if no timer is armed
+// clang-format on
+
+#pragma once
+
+#include "tem_intrusive_list.h"
+#include "utils.h"
+
+typedef struct Timer Timer;
+
+typedef void (*TimerCallback)(Timer *timer);
+
+struct Timer {
+    IListLink link;
+    /// the slot holding the timer, or NULL if unarmed
+    struct TimerList *slot;
+    /// the tick to fire at
+    u64 expires;
+    TimerCallback callback;
+    void *ctx;
+};
+
+DECLARE_INTRUSIVE_LIST(TimerList, Timer, link);
+
+typedef struct TimerWheel {
+    /// levels * 2^slot_bits slots, level by level
+    TimerList *slots;
+    u64 tick;
+    u32 slot_bits;
+    u32 levels;
+    /// the last tick passed; the timers of the ticks up to it have fired
+    u64 now_tick;
+    usize size;
+} TimerWheel;
+
+FUNC_STATIC void MTD(Timer, init, /, TimerCallback callback, void *ctx) {
+    self->link.prev = NULL;
+    self->link.next = NULL;
+    self->slot = NULL;
+    self->expires = 0;
+    self->callback = callback;
+    self->ctx = ctx;
+}
+
+FUNC_STATIC bool MTDCONST(Timer, armed, /) { return self->slot != NULL; }
+
+/* TimerWheel.init(u64 tick, u32 slot_bits, u32 levels, u64 now) */
+void MTD(TimerWheel, init, /, u64 tick, u32 slot_bits, u32 levels, u64 now);
+
+/* TimerWheel.drop() */
+void MTD(TimerWheel, drop, /);
+
+DELETED_CLONER(TimerWheel, FUNC_STATIC);
+
+/* TimerWheel.arm(Timer *timer, u64 deadline) */
+void MTD(TimerWheel, arm, /, Timer *timer, u64 deadline);
+
+FUNC_STATIC bool MTD(TimerWheel, cancel, /, Timer *timer) {
+    if (!timer->slot) {
+        return false;
+    }
+    CALL(TimerList, *timer->slot, remove, /, timer);
+    timer->slot = NULL;
+    self->size--;
+    return true;
+}
+
+/* TimerWheel.advance(u64 now) -> usize */
+usize MTD(TimerWheel, advance, /, u64 now);
+
+FUNC_STATIC usize MTDCONST(TimerWheel, size, /) { return self->size; }
+
+FUNC_STATIC bool MTDCONST(TimerWheel, empty, /) { return self->size == 0; }
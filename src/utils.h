@@ -94,6 +94,29 @@
         MPROT(X) < MPROT(Y) ? -1 : (MPROT(X) > MPROT(Y) ? 1 : 0);              \
     })
 
+/// Type predicates; all of them are compile-time constants
+#undef TYPE_IS_SIGNED_INTEGER
+#define TYPE_IS_SIGNED_INTEGER(T)                                              \
+    (__builtin_types_compatible_p(T, signed char) ||                           \
+     __builtin_types_compatible_p(T, short) ||                                 \
+     __builtin_types_compatible_p(T, int) ||                                   \
+     __builtin_types_compatible_p(T, long) ||                                  \
+     __builtin_types_compatible_p(T, long long) ||                             \
+     (__builtin_types_compatible_p(T, char) && (char)-1 < 0))
+
+#undef TYPE_IS_UNSIGNED_INTEGER
+#define TYPE_IS_UNSIGNED_INTEGER(T)                                            \
+    (__builtin_types_compatible_p(T, unsigned char) ||                         \
+     __builtin_types_compatible_p(T, unsigned short) ||                        \
+     __builtin_types_compatible_p(T, unsigned int) ||                          \
+     __builtin_types_compatible_p(T, unsigned long) ||                         \
+     __builtin_types_compatible_p(T, unsigned long long) ||                    \
+     (__builtin_types_compatible_p(T, char) && (char)-1 > 0))
+
+#undef TYPE_IS_INTEGER
+#define TYPE_IS_INTEGER(T)                                                     \
+    (TYPE_IS_SIGNED_INTEGER(T) || TYPE_IS_UNSIGNED_INTEGER(T))
+
 /* method call support */
 
 /// MTDNAME defines the name of the method
@@ -125,7 +148,8 @@
     NSCALL(cls, method, slash, &(self), ##__VA_ARGS__)
 
 /// CREOBJ and DROPOBJ are used to create and drop an object; CREOBJHEAP and
-/// DROPOBJ are used to create and drop an object on heap
+/// DROPOBJ are used to create and drop an object on heap (see CREOBJHEAP_IN in
+/// allocator.h for other allocators)
 #undef CREOBJ
 #define CREOBJ(cls, slash, ...)                                                \
     ({                                                                         \
@@ -230,6 +254,38 @@
         PANIC("Cloning is not allowed for " #cls);                             \
     }
 
+/// trivial traits: a class whose clone is a bitwise copy, or whose drop does
+/// nothing, may declare so by DECLARE_TRIVIAL_CLONE(cls) (which defines
+/// clone_from and clone) or DECLARE_TRIVIAL_DROP(cls) (which defines drop) at
+/// .h files. The methods return TRIVIAL_TRAIT_TAG instead of void, so that
+/// TYPE_IS_TRIVIAL_CLONE(cls) and TYPE_IS_TRIVIAL_DROP(cls) detect the traits
+/// at compile time, and containers copy the elements by memcpy or skip the
+/// drop loops. The class must provide clone_from and drop either way.
+#undef DECLARE_TRIVIAL_CLONE
+#define DECLARE_TRIVIAL_CLONE(cls)                                             \
+    FUNC_STATIC TRIVIAL_TRAIT_TAG MTD(cls, clone_from, /,                      \
+                                      const typeof(cls) *MPROT(other)) {       \
+        *self = *MPROT(other);                                                 \
+        return TRIVIAL_TRAIT;                                                  \
+    }                                                                          \
+    FUNC_STATIC typeof(cls) MTDCONST(cls, clone, /) { return *self; }
+
+#undef DECLARE_TRIVIAL_DROP
+#define DECLARE_TRIVIAL_DROP(cls)                                              \
+    FUNC_STATIC TRIVIAL_TRAIT_TAG MTD(cls, drop, /) { return TRIVIAL_TRAIT; }
+
+#undef TYPE_IS_TRIVIAL_CLONE
+#define TYPE_IS_TRIVIAL_CLONE(cls)                                             \
+    __builtin_types_compatible_p(                                              \
+        typeof(NSCALL(cls, clone_from, /, (typeof(cls) *)0,                    \
+                      (const typeof(cls) *)0)),                                \
+        TRIVIAL_TRAIT_TAG)
+
+#undef TYPE_IS_TRIVIAL_DROP
+#define TYPE_IS_TRIVIAL_DROP(cls)                                              \
+    __builtin_types_compatible_p(                                              \
+        typeof(NSCALL(cls, drop, /, (typeof(cls) *)0)), TRIVIAL_TRAIT_TAG)
+
 /* type definitions */
 
 typedef int8_t i8;
@@ -242,10 +298,15 @@ typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 typedef size_t usize;
+typedef float f32;
+typedef double f64;
 typedef void *Any;
 typedef struct ZERO_SIZE_TYPE {
 } ZERO_SIZE_TYPE;
 static const ZERO_SIZE_TYPE ZERO_SIZE = {};
+typedef struct TRIVIAL_TRAIT_TAG {
+} TRIVIAL_TRAIT_TAG;
+static const TRIVIAL_TRAIT_TAG TRIVIAL_TRAIT = {};
 
 #define COLOR_BLACK "\033[0;30m"
 #define COLOR_RED "\033[0;31m"
@@ -2,3 +2,6 @@
 
 DEFINE_LIST(ListI32, i32, FUNC_EXTERN);
 DEFINE_LIST(ListString, String, FUNC_EXTERN);
+
+DEFINE_LIST_ALGORITHM(ListI32, i32, FUNC_EXTERN);
+DEFINE_LIST_ALGORITHM(ListString, String, FUNC_EXTERN);
@@ -4,3 +4,7 @@
 
 DECLARE_LIST(ListI32, i32, FUNC_EXTERN, GENERATOR_PLAIN_VALUE);
 DECLARE_LIST(ListString, String, FUNC_EXTERN, GENERATOR_CLASS_VALUE);
+
+DECLARE_LIST_ALGORITHM(ListI32, i32, FUNC_EXTERN, GENERATOR_PLAIN_COMPARATOR);
+DECLARE_LIST_ALGORITHM(ListString, String, FUNC_EXTERN,
+                       GENERATOR_CLASS_COMPARATOR);
@@ -3,3 +3,7 @@
 DEFINE_PLAIN_VEC(VecCString, const char *, FUNC_EXTERN);
 DEFINE_PLAIN_VEC(VecI32, i32, FUNC_EXTERN);
 DEFINE_CLASS_VEC(VecStr, String, FUNC_EXTERN);
+
+DEFINE_VEC_ALGORITHM(VecI32, i32, FUNC_EXTERN);
+DEFINE_VEC_SORT_BY(VecI32, desc, i32, FUNC_EXTERN);
+DEFINE_VEC_ALGORITHM(VecStr, String, FUNC_EXTERN);
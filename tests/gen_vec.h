@@ -5,3 +5,12 @@
 DECLARE_PLAIN_VEC(VecCString, const char *, FUNC_EXTERN);
 DECLARE_PLAIN_VEC(VecI32, i32, FUNC_EXTERN);
 DECLARE_CLASS_VEC(VecStr, String, FUNC_EXTERN);
+
+DECLARE_VEC_ALGORITHM(VecI32, i32, FUNC_EXTERN, GENERATOR_PLAIN_COMPARATOR);
+DECLARE_VEC_SORT_BY(VecI32, desc, i32, FUNC_EXTERN,
+                    GENERATOR_CUSTOM_COMPARATOR);
+DECLARE_VEC_ALGORITHM(VecStr, String, FUNC_EXTERN, GENERATOR_CLASS_COMPARATOR);
+
+FUNC_STATIC int NSMTD(VecI32_desc, comparator, /, const i32 *a, const i32 *b) {
+    return NORMALCMP(*b, *a);
+}
@@ -0,0 +1,197 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "debug.h"
+#include "str.h"
+#include "tem_list.h"
+#include "tem_map.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+/// an allocator counting its live blocks, which checks the sizes passed back
+/// against a header in front of each block
+typedef struct CountingHeap {
+    usize blocks;
+    usize bytes;
+    usize calls;
+} CountingHeap;
+
+#define COUNTING_HEADER 16
+
+static void *counting_alloc(void *ctx, usize size) {
+    CountingHeap *heap = (CountingHeap *)ctx;
+    char *block = (char *)malloc(COUNTING_HEADER + size);
+    ASSERT(block);
+    memcpy(block, &size, sizeof(usize));
+    heap->blocks++;
+    heap->bytes += size;
+    heap->calls++;
+    return block + COUNTING_HEADER;
+}
+
+static void counting_check(void *ptr, usize size) {
+    usize recorded;
+    memcpy(&recorded, (char *)ptr - COUNTING_HEADER, sizeof(usize));
+    ASSERT(recorded == size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, usize old_size,
+                              usize new_size) {
+    CountingHeap *heap = (CountingHeap *)ctx;
+    if (!ptr) {
+        ASSERT(old_size == 0);
+        return counting_alloc(ctx, new_size);
+    }
+    counting_check(ptr, old_size);
+    char *block = (char *)realloc((char *)ptr - COUNTING_HEADER,
+                                  COUNTING_HEADER + new_size);
+    ASSERT(block);
+    memcpy(block, &new_size, sizeof(usize));
+    heap->bytes += new_size - old_size;
+    heap->calls++;
+    return block + COUNTING_HEADER;
+}
+
+static void counting_free(void *ctx, void *ptr, usize size) {
+    CountingHeap *heap = (CountingHeap *)ctx;
+    if (!ptr) {
+        return;
+    }
+    counting_check(ptr, size);
+    free((char *)ptr - COUNTING_HEADER);
+    heap->blocks--;
+    heap->bytes -= size;
+    heap->calls++;
+}
+
+static CountingHeap counting_heap;
+
+static Allocator counting_allocator = {
+    .alloc = counting_alloc,
+    .realloc = counting_realloc,
+    .free = counting_free,
+    .ctx = &counting_heap,
+};
+
+DECLARE_PLAIN_VEC_WITH_ALLOCATOR(CVecI32, i32, FUNC_STATIC,
+                                 GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_PLAIN_VEC(CVecI32, i32, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(CVecI32, allocator, /) {
+    return &counting_allocator;
+}
+
+DECLARE_CLASS_VEC_WITH_ALLOCATOR(CVecStr, String, FUNC_STATIC,
+                                 GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_CLASS_VEC(CVecStr, String, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(CVecStr, allocator, /) {
+    return &counting_allocator;
+}
+
+DECLARE_LIST_WITH_ALLOCATOR(CListI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE,
+                            GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_LIST(CListI32, i32, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(CListI32, allocator, /) {
+    return &counting_allocator;
+}
+
+DECLARE_MAPPING_WITH_ALLOCATOR(CMapIS, i32, String, FUNC_STATIC,
+                               GENERATOR_PLAIN_KEY, GENERATOR_CLASS_VALUE,
+                               GENERATOR_PLAIN_COMPARATOR,
+                               GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_MAPPING(CMapIS, i32, String, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(CMapIS, allocator, /) {
+    return &counting_allocator;
+}
+
+static void allocator_vec() {
+    CVecI32 v = CREOBJ(CVecI32, /);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(CVecI32, v, push_back, /, i);
+    }
+    ASSERT(counting_heap.blocks == 1 &&
+           counting_heap.bytes == v.capacity * sizeof(i32));
+    CVecI32 copy = CALL(CVecI32, v, clone, /);
+    CALL(CVecI32, copy, truncate, /, 10);
+    CALL(CVecI32, copy, shrink_to_fit, /);
+    ASSERT(counting_heap.blocks == 2 &&
+           counting_heap.bytes == (v.capacity + 10) * sizeof(i32));
+    CALL(CVecI32, copy, clear, /);
+    CALL(CVecI32, copy, shrink_to_fit, /);
+    ASSERT(counting_heap.blocks == 1 && !copy.data);
+    DROPOBJ(CVecI32, copy);
+    DROPOBJ(CVecI32, v);
+
+    // the strings themselves stay on the libc heap
+    CVecStr s = CREOBJ(CVecStr, /);
+    CALL(CVecStr, s, push_back, /, NSCALL(String, from_raw, /, "hello"));
+    CALL(CVecStr, s, push_back, /, NSCALL(String, from_raw, /, "world"));
+    ASSERT(counting_heap.blocks == 1);
+    DROPOBJ(CVecStr, s);
+    ASSERT(counting_heap.blocks == 0 && counting_heap.bytes == 0);
+}
+
+static void allocator_list() {
+    CListI32 list = CREOBJ(CListI32, /);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(CListI32, list, push_back, /, i);
+    }
+    ASSERT(counting_heap.blocks == 100);
+    CALL(CListI32, list, pop_front, /);
+    ASSERT(counting_heap.blocks == 99);
+    // the clone allocates its nodes one by one too
+    CListI32 copy = CALL(CListI32, list, clone, /);
+    ASSERT(counting_heap.blocks == 198 && !copy.pool);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(CListI32, copy, push_front, /, i);
+    }
+    DROPOBJ(CListI32, copy);
+    ASSERT(counting_heap.blocks == 99);
+    DROPOBJ(CListI32, list);
+    ASSERT(counting_heap.blocks == 0 && counting_heap.bytes == 0);
+
+    // a shared pool may take its slabs from any allocator
+    NodePool pool;
+    CALL(NodePool, pool, init_in, /, sizeof(CListI32Node),
+         __alignof__(CListI32Node), NSCALL(Allocator, libc, /));
+    CListI32 pooled;
+    CALL(CListI32, pooled, init_pooled, /, &pool);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(CListI32, pooled, push_back, /, i);
+    }
+    ASSERT(counting_heap.blocks == 0);
+    DROPOBJ(CListI32, pooled);
+    DROPOBJ(NodePool, pool);
+}
+
+static void allocator_mapping() {
+    CMapIS map = CREOBJ(CMapIS, /);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(CMapIS, map, insert, /, i, NSCALL(String, from_f, /, "%d", i));
+    }
+    ASSERT(counting_heap.blocks == 100);
+    CMapIS copy = CALL(CMapIS, map, clone, /);
+    ASSERT(counting_heap.blocks == 200);
+    i32 key = 42;
+    CMapISIterator it = CALL(CMapIS, map, find, /, &key);
+    CALL(CMapIS, map, erase, /, it);
+    ASSERT(counting_heap.blocks == 199);
+    it = CALL(CMapIS, copy, find, /, &key);
+    ASSERT_EQ_STR(STRING_C_STR(it->value), "42");
+    DROPOBJ(CMapIS, copy);
+    DROPOBJ(CMapIS, map);
+    ASSERT(counting_heap.blocks == 0 && counting_heap.bytes == 0);
+
+    CMapIS *heap_map = CREOBJHEAP_IN(CMapIS, &counting_allocator, /);
+    CALL(CMapIS, *heap_map, insert, /, 1, NSCALL(String, from_raw, /, "one"));
+    ASSERT(counting_heap.blocks == 2);
+    DROPOBJHEAP_IN(CMapIS, &counting_allocator, heap_map);
+    ASSERT(counting_heap.blocks == 0 && counting_heap.bytes == 0);
+}
+
+void test_allocator() {
+    allocator_vec();
+    allocator_list();
+    allocator_mapping();
+    ASSERT(counting_heap.calls > 0);
+}
@@ -0,0 +1,184 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "debug.h"
+#include "tem_list.h"
+#include "tem_map.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+/// the backing allocator of the arenas, counting its calls
+static usize backing_calls;
+static usize backing_blocks;
+
+static void *backing_alloc(ATTR_UNUSED void *ctx, usize size) {
+    backing_calls++;
+    backing_blocks++;
+    return malloc(size);
+}
+
+static void *backing_realloc(ATTR_UNUSED void *ctx, void *ptr,
+                             ATTR_UNUSED usize old_size, usize new_size) {
+    backing_calls++;
+    return realloc(ptr, new_size);
+}
+
+static void backing_free(ATTR_UNUSED void *ctx, void *ptr,
+                         ATTR_UNUSED usize size) {
+    backing_calls++;
+    backing_blocks--;
+    free(ptr);
+}
+
+static Allocator backing = {
+    .alloc = backing_alloc,
+    .realloc = backing_realloc,
+    .free = backing_free,
+    .ctx = NULL,
+};
+
+static Arena request_arena;
+
+DECLARE_PLAIN_VEC_WITH_ALLOCATOR(AVecI32, i32, FUNC_STATIC,
+                                 GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_PLAIN_VEC(AVecI32, i32, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AVecI32, allocator, /) {
+    return CALL(Arena, request_arena, as_allocator, /);
+}
+
+DECLARE_LIST_WITH_ALLOCATOR(AListI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE,
+                            GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_LIST(AListI32, i32, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AListI32, allocator, /) {
+    return CALL(Arena, request_arena, as_allocator, /);
+}
+
+DECLARE_MAPPING_WITH_ALLOCATOR(AMapII, i32, i32, FUNC_STATIC,
+                               GENERATOR_PLAIN_KEY, GENERATOR_PLAIN_VALUE,
+                               GENERATOR_PLAIN_COMPARATOR,
+                               GENERATOR_CUSTOM_ALLOCATOR);
+DEFINE_MAPPING(AMapII, i32, i32, FUNC_STATIC);
+FUNC_STATIC Allocator *NSMTD(AMapII, allocator, /) {
+    return CALL(Arena, request_arena, as_allocator, /);
+}
+
+static void arena_blocks() {
+    Arena arena;
+    CALL(Arena, arena, init_in, /, 256, &backing);
+    ASSERT(CALL(Arena, arena, memory, /) == 0 && backing_calls == 0);
+    char *a = (char *)CALL(Arena, arena, alloc, /, 3);
+    char *b = (char *)CALL(Arena, arena, alloc, /, 40);
+    ASSERT((usize)a % ARENA_ALIGN == 0 && (usize)b % ARENA_ALIGN == 0);
+    ASSERT(b == a + ARENA_ALIGN);
+    memset(a, 'a', 3);
+    memset(b, 'b', 40);
+
+    // the last block grows in place, the others move
+    char *grown = (char *)CALL(Arena, arena, realloc, /, b, 40, 100);
+    ASSERT(grown == b && grown[39] == 'b');
+    char *moved = (char *)CALL(Arena, arena, realloc, /, a, 3, 20);
+    ASSERT(moved != a && moved[0] == 'a' && moved[2] == 'a');
+    ASSERT(CALL(Arena, arena, realloc, /, a, 3, 1) == a);
+    ASSERT(backing_calls == 1);
+
+    ArenaMark mark = CALL(Arena, arena, mark, /);
+    // a request larger than the chunks gets a chunk of its own
+    char *large = (char *)CALL(Arena, arena, alloc, /, 10000);
+    memset(large, 'l', 10000);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(Arena, arena, alloc, /, 64);
+    }
+    usize chunks = backing_blocks;
+    ASSERT(chunks > 2);
+    CALL(Arena, arena, rewind, /, mark);
+    // the largest chunk released is kept as the spare
+    ASSERT(backing_blocks == 2);
+    ASSERT(CALL(Arena, arena, alloc, /, 16) == mark.cursor);
+    CALL(Arena, arena, rewind, /, mark);
+    usize calls = backing_calls;
+    large = (char *)CALL(Arena, arena, alloc, /, 10000);
+    memset(large, 'l', 10000);
+    ASSERT(backing_calls == calls);
+
+    CALL(Arena, arena, reset, /);
+    ASSERT(backing_blocks == 1);
+    ASSERT(CALL(Arena, arena, memory, /) >= 10000);
+    DROPOBJ(Arena, arena);
+    ASSERT(backing_blocks == 0);
+}
+
+/// builds the temporary containers of a request
+static i64 arena_request(i32 n) {
+    AVecI32 vec = CREOBJ(AVecI32, /);
+    AListI32 list = CREOBJ(AListI32, /);
+    AMapII map = CREOBJ(AMapII, /);
+    for (i32 i = 0; i < n; i++) {
+        CALL(AVecI32, vec, push_back, /, i);
+        CALL(AListI32, list, push_front, /, i);
+        CALL(AMapII, map, insert_or_assign, /, i % 50, i);
+    }
+    AListI32 copy = CALL(AListI32, list, clone, /);
+    i64 sum = 0;
+    for (usize i = 0; i < vec.size; i++) {
+        sum += vec.data[i];
+    }
+    for (AListI32Node *it = copy.head; it; it = it->next) {
+        sum += it->data;
+    }
+    for (AMapIIIterator it = CALL(AMapII, map, begin, /); it;
+         it = CALL(AMapII, map, next, /, it)) {
+        sum += it->value;
+    }
+    // with an arena, the drops free nothing and the list skips its nodes
+    DROPOBJ(AListI32, list);
+    ASSERT(!list.head && list.size == 0);
+    DROPOBJ(AMapII, map);
+    ASSERT(!map.root && map.size == 0);
+    DROPOBJ(AListI32, copy);
+    DROPOBJ(AVecI32, vec);
+    return sum;
+}
+
+static void arena_containers() {
+    CALL(Arena, request_arena, init_in, /, 0, &backing);
+    usize calls = 0;
+    for (i32 round = 0; round < 20; round++) {
+        i32 n = 500;
+        i64 expected = 2 * (i64)n * (n - 1) / 2;
+        for (i32 k = 0; k < 50; k++) {
+            expected += (n - 50) + k;
+        }
+        ASSERT(arena_request(n) == expected);
+        if (round == 2) {
+            calls = backing_calls;
+        }
+        CALL(Arena, request_arena, reset, /);
+        ASSERT(backing_blocks == 1);
+    }
+    // a warm arena takes no more memory from the backing allocator
+    ASSERT(backing_calls == calls);
+
+    // the requests nest by marks
+    AVecI32 outer = CREOBJ(AVecI32, /);
+    CALL(AVecI32, outer, push_back, /, 7);
+    ArenaMark mark = CALL(Arena, request_arena, mark, /);
+    AVecI32 inner = CREOBJ(AVecI32, /);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(AVecI32, inner, push_back, /, i);
+    }
+    CALL(Arena, request_arena, rewind, /, mark);
+    ASSERT(outer.size == 1 && outer.data[0] == 7);
+    AMapII *map = CREOBJHEAP_IN(
+        AMapII, CALL(Arena, request_arena, as_allocator, /), /);
+    CALL(AMapII, *map, insert, /, 1, 2);
+    i32 key = 1;
+    ASSERT(CALL(AMapII, *map, find, /, &key)->value == 2);
+    DROPOBJ(Arena, request_arena);
+    ASSERT(backing_blocks == 0);
+}
+
+void test_arena() {
+    arena_blocks();
+    arena_containers();
+}
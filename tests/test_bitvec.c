@@ -0,0 +1,118 @@
+#include "debug.h"
+#include "tem_bitvec.h"
+#include "utils.h"
+
+DECLARE_BITVEC(BitVec, FUNC_STATIC);
+DEFINE_BITVEC(BitVec, FUNC_STATIC);
+
+static BitVec gen_multiples(usize n, usize k) {
+    BitVec bv = CREOBJ(BitVec, /);
+    for (usize i = 0; i < n; i++) {
+        CALL(BitVec, bv, push_back, /, i % k == 0);
+    }
+    return bv;
+}
+
+static void bitvec_simple() {
+    BitVec bv = gen_multiples(1000, 3);
+    ASSERT(bv.size == 1000);
+    ASSERT(CALL(BitVec, bv, test, /, 999) && !CALL(BitVec, bv, test, /, 998));
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 334);
+
+    CALL(BitVec, bv, set, /, 998, true);
+    CALL(BitVec, bv, set, /, 0, false);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 334);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 0) == 3);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 64) == 66);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 997) == 998);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 1000) == 1000);
+
+    // shrinking clears the bits beyond the size
+    CALL(BitVec, bv, resize, /, 100, false);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 33);
+    CALL(BitVec, bv, resize, /, 1000, false);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 33);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 100) == 1000);
+    CALL(BitVec, bv, resize, /, 1070, true);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 103);
+    ASSERT(CALL(BitVec, bv, find_next_set, /, 100) == 1000);
+
+    CALL(BitVec, bv, fill, /, true);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 1070);
+    CALL(BitVec, bv, fill, /, false);
+    ASSERT(CALL(BitVec, bv, count_ones, /) == 0);
+
+    BitVec copied = gen_multiples(2000, 2);
+    CALL(BitVec, copied, clone_from, /, &bv);
+    ASSERT(copied.size == 1070 && CALL(BitVec, copied, count_ones, /) == 0);
+    CALL(BitVec, copied, resize, /, 2000, false);
+    ASSERT(CALL(BitVec, copied, count_ones, /) == 0);
+
+    CALL(BitVec, bv, clear, /);
+    ASSERT(CALL(BitVec, bv, empty, /));
+    DROPOBJ(BitVec, copied);
+    DROPOBJ(BitVec, bv);
+}
+
+static void bitvec_bulk() {
+    for (usize n = 0; n < 300; n += 37) {
+        BitVec a = gen_multiples(n, 2);
+        BitVec b = gen_multiples(n, 3);
+        BitVec c = CALL(BitVec, a, clone, /);
+
+        CALL(BitVec, c, and_with, /, &b);
+        ASSERT(CALL(BitVec, c, count_ones, /) == (n + 5) / 6);
+        for (usize i = 0; i < n; i++) {
+            ASSERT(CALL(BitVec, c, test, /, i) == (i % 6 == 0));
+        }
+
+        CALL(BitVec, c, clone_from, /, &a);
+        CALL(BitVec, c, or_with, /, &b);
+        for (usize i = 0; i < n; i++) {
+            ASSERT(CALL(BitVec, c, test, /, i) == (i % 2 == 0 || i % 3 == 0));
+        }
+
+        CALL(BitVec, c, clone_from, /, &a);
+        CALL(BitVec, c, xor_with, /, &b);
+        for (usize i = 0; i < n; i++) {
+            bool expected = (i % 2 == 0) != (i % 3 == 0);
+            ASSERT(CALL(BitVec, c, test, /, i) == expected);
+        }
+
+        CALL(BitVec, c, clone_from, /, &a);
+        CALL(BitVec, c, andnot_with, /, &b);
+        usize expected = 0;
+        BITVEC_FOR_EACH_SET_BIT(c, i) {
+            while (expected % 2 != 0 || expected % 3 == 0) {
+                expected++;
+            }
+            ASSERT(i == expected);
+            expected++;
+        }
+        ASSERT(CALL(BitVec, c, find_next_set, /, expected) == n);
+
+        // break leaves the whole iteration, not only the current word
+        usize visits = 0, last = 0;
+        BITVEC_FOR_EACH_SET_BIT(c, i) {
+            if (++visits == 4) {
+                break;
+            }
+            last = i;
+        }
+        ASSERT(n < 10 || (visits == 4 && last == 8));
+
+        DROPOBJ(BitVec, c);
+        DROPOBJ(BitVec, b);
+        DROPOBJ(BitVec, a);
+    }
+}
+
+void test_bitvec() {
+    SimdLevel supported = NSCALL(Simd, level, /);
+    for (SimdLevel level = SIMD_LEVEL_SCALAR; level <= supported; level++) {
+        NSCALL(Simd, set_level, /, level);
+        bitvec_simple();
+        bitvec_bulk();
+    }
+    NSCALL(Simd, set_level, /, supported);
+}
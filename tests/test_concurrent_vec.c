@@ -0,0 +1,109 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "str.h"
+#include "tem_concurrent_vec.h"
+#include "utils.h"
+
+DECLARE_CONCURRENT_VEC(CVecU64, u64, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_CONCURRENT_VEC(CVecU64, u64, FUNC_STATIC);
+
+DECLARE_CONCURRENT_VEC(CVecStr, String, FUNC_STATIC, GENERATOR_CLASS_VALUE);
+DEFINE_CONCURRENT_VEC(CVecStr, String, FUNC_STATIC);
+
+#define CVEC_WRITERS 4
+#define CVEC_PER_WRITER 50000
+#define CVEC_TOTAL (CVEC_WRITERS * CVEC_PER_WRITER)
+
+typedef struct CVecWriter {
+    CVecU64 *vec;
+    u64 id;
+} CVecWriter;
+
+static void *cvec_write(void *arg) {
+    CVecWriter *writer = (CVecWriter *)arg;
+    for (u64 i = 0; i < CVEC_PER_WRITER; i++) {
+        CALL(CVecU64, *writer->vec, push_back, /,
+             writer->id * CVEC_PER_WRITER + i);
+    }
+    return NULL;
+}
+
+/* read the published prefix while the writers run */
+static void *cvec_read(void *arg) {
+    CVecU64 *vec = (CVecU64 *)arg;
+    usize seen = 0;
+    while (seen < CVEC_TOTAL) {
+        usize published = CALL(CVecU64, *vec, published, /);
+        ASSERT(published >= seen && published <= CVEC_TOTAL);
+        for (; seen < published; seen++) {
+            ASSERT(*CALL(CVecU64, *vec, at, /, seen) < CVEC_TOTAL);
+        }
+    }
+    return NULL;
+}
+
+static void cvec_threads() {
+    CVecU64 vec = CREOBJ(CVecU64, /);
+    pthread_t writers[CVEC_WRITERS], reader;
+    CVecWriter args[CVEC_WRITERS];
+    ASSERT(pthread_create(&reader, NULL, cvec_read, &vec) == 0);
+    for (usize i = 0; i < CVEC_WRITERS; i++) {
+        args[i] = (CVecWriter){.vec = &vec, .id = i};
+        ASSERT(pthread_create(&writers[i], NULL, cvec_write, &args[i]) == 0);
+    }
+    for (usize i = 0; i < CVEC_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+    pthread_join(reader, NULL);
+
+    // every value is appended once, and the values of a writer keep its order
+    ASSERT(CALL(CVecU64, vec, size, /) == CVEC_TOTAL);
+    ASSERT(CALL(CVecU64, vec, published, /) == CVEC_TOTAL);
+    bool *found = (bool *)calloc(CVEC_TOTAL, sizeof(bool));
+    u64 last[CVEC_WRITERS] = {0};
+    for (usize i = 0; i < CVEC_TOTAL; i++) {
+        u64 value = *CALL(CVecU64, vec, at, /, i);
+        u64 id = value / CVEC_PER_WRITER;
+        ASSERT(!found[value] && (value % CVEC_PER_WRITER == 0 ||
+                                 value > last[id]));
+        found[value] = true;
+        last[id] = value;
+    }
+    free(found);
+
+    CVecU64 copied = CALL(CVecU64, vec, clone, /);
+    ASSERT(CALL(CVecU64, copied, published, /) == CVEC_TOTAL);
+    ASSERT(*CALL(CVecU64, copied, at, /, 12345) ==
+           *CALL(CVecU64, vec, at, /, 12345));
+    DROPOBJ(CVecU64, copied);
+    DROPOBJ(CVecU64, vec);
+}
+
+static void cvec_class() {
+    CVecStr vec = CREOBJ(CVecStr, /);
+    CALL(CVecStr, vec, reserve, /, 64);
+    ASSERT(vec.blocks[0] && !vec.blocks[1]);
+    for (usize i = 0; i < 200; i++) {
+        ASSERT(CALL(CVecStr, vec, push_back, /,
+                    NSCALL(String, from_f, /, "%zu", i)) == i);
+    }
+    ASSERT(CALL(CVecStr, vec, published, /) == 200);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(CVecStr, vec, at, /, 150)), "150");
+
+    CVecStr copied = CALL(CVecStr, vec, clone, /);
+    CALL(CVecStr, vec, clear, /);
+    ASSERT(CALL(CVecStr, vec, published, /) == 0);
+    CALL(CVecStr, vec, push_back, /, NSCALL(String, from_raw, /, "again"));
+    ASSERT(CALL(CVecStr, vec, published, /) == 1);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(CVecStr, copied, at, /, 199)), "199");
+
+    DROPOBJ(CVecStr, copied);
+    DROPOBJ(CVecStr, vec);
+}
+
+void test_concurrent_vec() {
+    cvec_threads();
+    cvec_class();
+}
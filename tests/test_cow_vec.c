@@ -0,0 +1,103 @@
+#include "debug.h"
+#include "str.h"
+#include "tem_cow_vec.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+DECLARE_PLAIN_VEC(CowInnerI32, i32, FUNC_STATIC);
+DEFINE_PLAIN_VEC(CowInnerI32, i32, FUNC_STATIC);
+DECLARE_COW_VEC(CowI32, CowInnerI32, i32, FUNC_STATIC);
+DEFINE_COW_VEC(CowI32, CowInnerI32, i32, FUNC_STATIC);
+
+DECLARE_CLASS_VEC(CowInnerStr, String, FUNC_STATIC);
+DEFINE_CLASS_VEC(CowInnerStr, String, FUNC_STATIC);
+DECLARE_COW_VEC(CowStr, CowInnerStr, String, FUNC_STATIC);
+DEFINE_COW_VEC(CowStr, CowInnerStr, String, FUNC_STATIC);
+
+static void cow_plain() {
+    CowI32 a = CREOBJ(CowI32, /);
+    ASSERT(CALL(CowI32, a, empty, /) && !a.shared);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(CowI32, a, push_back, /, i);
+    }
+
+    // clones share the buffer until one of them is written
+    CowI32 b = CALL(CowI32, a, clone, /);
+    CowI32 c = CALL(CowI32, b, clone, /);
+    ASSERT(a.shared == b.shared && b.shared == c.shared);
+    ASSERT(a.shared->refs == 3 && CALL(CowI32, a, is_shared, /));
+    ASSERT(*CALL(CowI32, c, get, /, 42) == 42);
+
+    *CALL(CowI32, b, at_mut, /, 0) = -1;
+    ASSERT(b.shared != a.shared && a.shared->refs == 2);
+    ASSERT(*CALL(CowI32, a, get, /, 0) == 0);
+    ASSERT(*CALL(CowI32, b, get, /, 0) == -1);
+    // b owns its buffer now, so writes go in place
+    CowI32Shared *owned = b.shared;
+    CALL(CowI32, b, insert, /, 1, 7);
+    CALL(CowI32, b, erase, /, 2);
+    CALL(CowI32, b, pop_back, /);
+    ASSERT(b.shared == owned && CALL(CowI32, b, size, /) == 99);
+    ASSERT(*CALL(CowI32, b, get, /, 1) == 7);
+
+    // clearing a shared buffer releases it instead of copying
+    CALL(CowI32, c, clear, /);
+    ASSERT(!c.shared && CALL(CowI32, c, empty, /));
+    ASSERT(!CALL(CowI32, a, is_shared, /));
+    ASSERT(CALL(CowI32, a, view, /)->size == 100);
+
+    CALL(CowI32, c, clone_from, /, &b);
+    ASSERT(c.shared == b.shared);
+    CALL(CowI32, c, clone_from, /, &a);
+    ASSERT(c.shared == a.shared && !CALL(CowI32, b, is_shared, /));
+
+    DROPOBJ(CowI32, c);
+    DROPOBJ(CowI32, b);
+    DROPOBJ(CowI32, a);
+}
+
+static void cow_class() {
+    CowInnerStr inner = CREOBJ(CowInnerStr, /);
+    for (usize i = 0; i < 10; i++) {
+        CALL(CowInnerStr, inner, push_back, /,
+             NSCALL(String, from_f, /, "s%zu", i));
+    }
+    CowStr a = NSCALL(CowStr, from_vec, /, inner);
+    CowStr b = CALL(CowStr, a, clone, /);
+    ASSERT(a.shared == b.shared);
+
+    // the first write deep-copies the elements of the shared buffer
+    String *s = CALL(CowStr, b, at_mut, /, 3);
+    CALL(String, *s, push_str, /, "!");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(CowStr, b, at_mut, /, 3)), "s3!");
+    const String *orig = CALL(CowStr, a, get, /, 3);
+    ASSERT(orig->size == 2 && orig->data[0] == 's' && orig->data[1] == '3');
+
+    DROPOBJ(CowStr, a);
+    ASSERT(!CALL(CowStr, b, is_shared, /));
+    DROPOBJ(CowStr, b);
+}
+
+static void cow_string() {
+    CowString a = NSCALL(CowString, from_vec, /,
+                         NSCALL(String, from_raw, /, "hello"));
+    CowString b = CALL(CowString, a, clone, /);
+    ASSERT_EQ_STR(CALL(CowString, b, c_str, /), "hello");
+    ASSERT(a.shared == b.shared);
+    CALL(CowString, b, push_back, /, '!');
+    ASSERT_EQ_STR(CALL(CowString, b, c_str, /), "hello!");
+    ASSERT_EQ_STR(CALL(CowString, a, c_str, /), "hello");
+
+    CowString empty = CREOBJ(CowString, /);
+    ASSERT_EQ_STR(CALL(CowString, empty, c_str, /), "");
+
+    DROPOBJ(CowString, empty);
+    DROPOBJ(CowString, b);
+    DROPOBJ(CowString, a);
+}
+
+void test_cow_vec() {
+    cow_plain();
+    cow_class();
+    cow_string();
+}
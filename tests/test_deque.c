@@ -0,0 +1,94 @@
+#include "debug.h"
+#include "str.h"
+#include "tem_deque.h"
+#include "utils.h"
+
+DECLARE_DEQUE(DequeI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_DEQUE(DequeI32, i32, FUNC_STATIC);
+
+DECLARE_DEQUE(DequeStr, String, FUNC_STATIC, GENERATOR_CLASS_VALUE);
+DEFINE_DEQUE(DequeStr, String, FUNC_STATIC);
+
+static void deque_plain() {
+    DequeI32 d = CREOBJ(DequeI32, /);
+    ASSERT(CALL(DequeI32, d, empty, /));
+
+    // model the deque by a window [lo, hi) of consecutive integers
+    i32 lo = 0, hi = 0;
+    u32 state = 7;
+    for (usize step = 0; step < 10000; step++) {
+        state = state * 1103515245u + 12345u;
+        switch ((state >> 16) % 5) {
+        case 0:
+        case 1:
+            CALL(DequeI32, d, push_back, /, hi++);
+            break;
+        case 2:
+            CALL(DequeI32, d, push_front, /, --lo);
+            break;
+        case 3:
+            if (lo < hi) {
+                ASSERT(CALL(DequeI32, d, pop_front, /) == lo++);
+            }
+            break;
+        case 4:
+            if (lo < hi) {
+                ASSERT(CALL(DequeI32, d, pop_back, /) == --hi);
+            }
+            break;
+        }
+        ASSERT(d.size == (usize)(hi - lo));
+        ASSERT((d.capacity & (d.capacity - 1)) == 0);
+        if (step % 97 == 0 && lo < hi) {
+            ASSERT(*CALL(DequeI32, d, front, /) == lo);
+            ASSERT(*CALL(DequeI32, d, back, /) == hi - 1);
+            for (usize i = 0; i < d.size; i++) {
+                ASSERT(*CALL(DequeI32, d, at, /, i) == lo + (i32)i);
+            }
+        }
+    }
+
+    DequeI32 copied = CALL(DequeI32, d, clone, /);
+    ASSERT(copied.size == d.size);
+    for (usize i = 0; i < d.size; i++) {
+        ASSERT(*CALL(DequeI32, copied, at, /, i) == lo + (i32)i);
+    }
+    CALL(DequeI32, d, clear, /);
+    ASSERT(CALL(DequeI32, d, empty, /));
+    CALL(DequeI32, d, swap, /, &copied);
+    ASSERT(d.size == (usize)(hi - lo) && copied.size == 0);
+
+    DROPOBJ(DequeI32, copied);
+    DROPOBJ(DequeI32, d);
+}
+
+static void deque_class() {
+    DequeStr d = CREOBJ(DequeStr, /);
+    for (usize i = 0; i < 20; i++) {
+        CALL(DequeStr, d, push_back, /, NSCALL(String, from_f, /, "%zu", i));
+        CALL(DequeStr, d, push_front, /,
+             NSCALL(String, from_f, /, "-%zu", i + 1));
+    }
+    CALL(DequeStr, d, remove_front, /);
+    // d == [-19, ..., -1, 0, ..., 19], wrapped around the buffer
+    ASSERT(d.size == 39);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(DequeStr, d, front, /)), "-19");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(DequeStr, d, at, /, 20)), "1");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(DequeStr, d, back, /)), "19");
+
+    DequeStr copied = CALL(DequeStr, d, clone, /);
+    CALL(DequeStr, d, remove_back, /);
+    String s = CALL(DequeStr, d, pop_front, /);
+    ASSERT_EQ_STR(STRING_C_STR(s), "-19");
+    DROPOBJ(String, s);
+    ASSERT(d.size == 37 && copied.size == 39);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(DequeStr, copied, back, /)), "19");
+
+    DROPOBJ(DequeStr, copied);
+    DROPOBJ(DequeStr, d);
+}
+
+void test_deque() {
+    deque_plain();
+    deque_class();
+}
@@ -0,0 +1,75 @@
+#include "debug.h"
+#include "tem_intrusive_list.h"
+#include "utils.h"
+
+typedef struct Task {
+    i32 id;
+    IListLink run_link;
+    IListLink all_link;
+} Task;
+
+// a task may be on a run queue and on the list of all tasks at once
+DECLARE_INTRUSIVE_LIST(RunQueue, Task, run_link);
+DECLARE_INTRUSIVE_LIST(TaskList, Task, all_link);
+
+static i32 run_queue_ids(RunQueue *queue) {
+    i32 ids = 0;
+    INTRUSIVE_LIST_FOR_EACH(RunQueue, *queue, task) {
+        ids = ids * 10 + task->id;
+    }
+    return ids;
+}
+
+static void intrusive_naive() {
+    Task tasks[8];
+    RunQueue queue = CREOBJ(RunQueue, /);
+    TaskList all = CREOBJ(TaskList, /);
+    ASSERT(CALL(RunQueue, queue, front, /) == NULL);
+    ASSERT(CALL(RunQueue, queue, pop_front, /) == NULL);
+    for (i32 i = 0; i < 8; i++) {
+        tasks[i].id = i;
+        CALL(TaskList, all, push_back, /, &tasks[i]);
+    }
+    CALL(RunQueue, queue, push_back, /, &tasks[2]);
+    CALL(RunQueue, queue, push_back, /, &tasks[3]);
+    CALL(RunQueue, queue, push_front, /, &tasks[1]);
+    CALL(RunQueue, queue, insert_after, /, &tasks[1], &tasks[5]);
+    CALL(RunQueue, queue, insert_before, /, &tasks[1], &tasks[4]);
+    CALL(RunQueue, queue, insert_before, /, NULL, &tasks[6]);
+    ASSERT(run_queue_ids(&queue) == 415236);
+    ASSERT(CALL(RunQueue, queue, size, /) == 6 && all.size == 8);
+
+    // removal from one list leaves the other intact
+    ASSERT(CALL(RunQueue, queue, remove, /, &tasks[5]) == &tasks[2]);
+    ASSERT(CALL(TaskList, all, remove, /, &tasks[7]) == NULL);
+    ASSERT(CALL(TaskList, all, back, /) == &tasks[6]);
+    ASSERT(NSCALL(TaskList, prev, /, &tasks[6]) == &tasks[5]);
+    CALL(RunQueue, queue, move_to_front, /, &tasks[3]);
+    CALL(RunQueue, queue, move_to_back, /, &tasks[4]);
+    ASSERT(run_queue_ids(&queue) == 31264);
+    ASSERT(CALL(RunQueue, queue, pop_back, /) == &tasks[4]);
+    ASSERT(CALL(RunQueue, queue, pop_front, /) == &tasks[3]);
+    ASSERT(run_queue_ids(&queue) == 126);
+
+    RunQueue other = CREOBJ(RunQueue, /);
+    CALL(RunQueue, other, push_back, /, &tasks[0]);
+    CALL(RunQueue, other, push_back, /, &tasks[7]);
+    CALL(RunQueue, queue, splice, /, &tasks[1], &other);
+    ASSERT(CALL(RunQueue, other, empty, /));
+    ASSERT(run_queue_ids(&queue) == 10726 && queue.size == 5);
+    CALL(RunQueue, other, push_back, /, &tasks[3]);
+    CALL(RunQueue, queue, splice, /, NULL, &other);
+    CALL(RunQueue, other, splice, /, NULL, &queue);
+    CALL(RunQueue, queue, swap, /, &other);
+    ASSERT(run_queue_ids(&queue) == 310726);
+    ASSERT(CALL(RunQueue, other, empty, /));
+
+    i32 n = 0;
+    INTRUSIVE_LIST_FOR_EACH(TaskList, all, task) { n += task->id; }
+    ASSERT(n == 21);
+    DROPOBJ(RunQueue, other);
+    DROPOBJ(RunQueue, queue);
+    DROPOBJ(TaskList, all);
+}
+
+void test_intrusive_list() { intrusive_naive(); }
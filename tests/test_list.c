@@ -158,7 +158,224 @@ static void class_test() {
     CALL(ListString, list, push_back, /, s);
     DROPOBJ(ListString, list);
 }
+
+static void pooled() {
+    // a private pool, reused across clear
+    ListI32 list;
+    CALL(ListI32, list, init_pooled, /, NULL);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(ListI32, list, push_back, /, i);
+    }
+    CALL(ListI32, list, insert_after, /, list.head, -1);
+    ASSERT(CALL(ListI32, list, pop_front, /) == 0);
+    ASSERT(CALL(ListI32, list, pop_front, /) == -1);
+    usize memory = CALL(NodePool, *list.pool, memory, /);
+    ListI32 copy = CALL(ListI32, list, clone, /);
+    ASSERT(copy.own_pool && copy.pool != list.pool && copy.size == 999);
+    ASSERT(*CALL(ListI32, copy, back, /) == 999 && !copy.tail->next);
+    DROPOBJ(ListI32, copy);
+    CALL(ListI32, list, clear, /);
+    ASSERT(list.own_pool && CALL(ListI32, list, empty, /));
+    ASSERT(CALL(NodePool, *list.pool, memory, /) < memory);
+    // the kept slab serves the nodes again
+    for (i32 i = 0; i < 10; i++) {
+        CALL(ListI32, list, push_front, /, i);
+    }
+    ASSERT(*CALL(ListI32, list, front, /) == 9 && list.size == 10);
+    DROPOBJ(ListI32, list);
+    ASSERT(!list.pool && !list.own_pool);
+
+    // a pool shared by the lists of a type, recycling the freed nodes
+    NodePool pool = CREOBJ(NodePool, /, sizeof(ListStringNode),
+                           __alignof__(ListStringNode));
+    ListString a, b;
+    CALL(ListString, a, init_pooled, /, &pool);
+    CALL(ListString, b, init_pooled, /, &pool);
+    for (i32 i = 0; i < 100; i++) {
+        ListString *half = i % 2 ? &a : &b;
+        CALL(ListString, *half, push_back, /,
+             NSCALL(String, from_raw, /, i % 2 ? "odd" : "even"));
+    }
+    ListStringNode *node = b.head->next;
+    CALL(ListString, b, remove, /, node);
+    CALL(ListString, a, push_front, /, NSCALL(String, from_raw, /, "first"));
+    ASSERT(a.head == node);
+    ASSERT_EQ_STR(STRING_C_STR(a.head->data), "first");
+    ListString c = CALL(ListString, a, clone, /);
+    ASSERT(c.pool == &pool && !c.own_pool && c.size == 51);
+    CALL(ListString, a, swap, /, &b);
+    ASSERT(a.size == 49 && b.size == 51);
+    usize memory_shared = CALL(NodePool, pool, memory, /);
+    DROPOBJ(ListString, c);
+    DROPOBJ(ListString, b);
+    CALL(ListString, a, remove_back, /);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(ListString, a, back, /)), "even");
+    DROPOBJ(ListString, a);
+    ASSERT(CALL(NodePool, pool, memory, /) == memory_shared);
+    DROPOBJ(NodePool, pool);
+
+    // reset keeps the largest slab, even when it is not the newest
+    pool = CREOBJ(NodePool, /, sizeof(ListI32Node), __alignof__(ListI32Node));
+    CALL(NodePool, pool, alloc_bulk, /, 10000);
+    usize memory_bulk = CALL(NodePool, pool, memory, /);
+    CALL(NodePool, pool, alloc_bulk, /, 1);
+    CALL(NodePool, pool, reset, /);
+    ASSERT(CALL(NodePool, pool, memory, /) == memory_bulk);
+    CALL(NodePool, pool, alloc_bulk, /, 10000);
+    ASSERT(CALL(NodePool, pool, memory, /) == memory_bulk);
+    DROPOBJ(NodePool, pool);
+}
+
+static void list_check_links(ListI32 *list) {
+    usize n = 0;
+    ListI32Node *prev = NULL;
+    for (ListI32Node *it = list->head; it; it = it->next) {
+        ASSERT(it->prev == prev);
+        prev = it;
+        n++;
+    }
+    ASSERT(list->tail == prev && list->size == n);
+}
+
+static void splice_sort() {
+    ListI32 a = CREOBJ(ListI32, /);
+    ListI32 b = CREOBJ(ListI32, /);
+    CALL(ListI32, a, insert_after, /, NULL, 4);
+    for (i32 i = 3; i >= 0; i--) {
+        CALL(ListI32, a, insert_after, /, NULL, i);
+    }
+    for (i32 i = 5; i < 10; i++) {
+        CALL(ListI32, a, push_back, /, i);
+    }
+    for (i32 i = 100; i < 105; i++) {
+        CALL(ListI32, b, push_back, /, i);
+    }
+    ListI32Node *five = a.head;
+    while (five->data != 5) {
+        five = five->next;
+    }
+    // a: 0 1 2 3 4 101 102 5 6 7 8 9, b: 100 103 104
+    CALL(ListI32, a, splice, /, five, &b, b.head->next, b.tail->prev);
+    ASSERT(a.size == 12 && b.size == 3);
+    ASSERT(five->prev->data == 102 && b.head->next->data == 103);
+    // a: ... 9 100 103 104
+    CALL(ListI32, a, splice, /, NULL, &b, b.head, NULL);
+    ASSERT(a.size == 15 && CALL(ListI32, b, empty, /) && !b.head && !b.tail);
+    ASSERT(*CALL(ListI32, a, back, /) == 104);
+    // a: 3 4 101 ... 104 0 1 2, within the list
+    CALL(ListI32, a, splice, /, NULL, &a, a.head, a.head->next->next->next);
+    ASSERT(*CALL(ListI32, a, front, /) == 3 && a.tail->data == 2);
+    list_check_links(&a);
+    list_check_links(&b);
+
+    CALL(ListI32, a, sort, /);
+    ASSERT(CALL(ListI32, a, is_sorted, /));
+    list_check_links(&a);
+    ASSERT(*CALL(ListI32, a, front, /) == 0);
+    ASSERT(*CALL(ListI32, a, back, /) == 104);
+    for (i32 i = -5; i < 200; i += 10) {
+        CALL(ListI32, b, push_back, /, i);
+    }
+    CALL(ListI32, a, merge, /, &b);
+    ASSERT(a.size == 36 && CALL(ListI32, b, empty, /));
+    ASSERT(CALL(ListI32, a, is_sorted, /));
+    ASSERT(*CALL(ListI32, a, front, /) == -5);
+    list_check_links(&a);
+    DROPOBJ(ListI32, a);
+
+    // the sort relinks the same nodes, and keeps equal elements in order
+    ListI32Node *nodes[1000];
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(ListI32, a, push_back, /, (i * 7) % 10);
+        nodes[i] = a.tail;
+    }
+    CALL(ListI32, a, sort, /);
+    list_check_links(&a);
+    usize index = 0;
+    for (ListI32Node *it = a.head; it; it = it->next, index++) {
+        ASSERT(it->data == (i32)(index / 100));
+        // the (index % 100)-th node holding the value, in insertion order
+        i32 i = (i32)(index % 100) * 10;
+        while ((i * 7) % 10 != it->data) {
+            i++;
+        }
+        ASSERT(it == nodes[i]);
+    }
+    DROPOBJ(ListI32, a);
+
+    ListString words = CREOBJ(ListString, /);
+    const char *raw[] = {"pear", "fig", "apple", "kiwi", "date"};
+    for (usize i = 0; i < LENGTH(raw); i++) {
+        CALL(ListString, words, push_back, /,
+             NSCALL(String, from_raw, /, raw[i]));
+    }
+    CALL(ListString, words, sort, /);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(ListString, words, front, /)), "apple");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(ListString, words, back, /)), "pear");
+    ASSERT(CALL(ListString, words, is_sorted, /));
+    DROPOBJ(ListString, words);
+}
+
+static void bulk_clone() {
+    ListI32 list = CREOBJ(ListI32, /);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(ListI32, list, push_front, /, i);
+    }
+    // the clone of a list in the default mode stays in the default mode, so
+    // that its nodes move back into the original
+    ListI32 copy = CALL(ListI32, list, clone, /);
+    ASSERT(!copy.pool && !copy.own_pool && copy.size == 1000);
+    CALL(ListI32, list, splice, /, NULL, &copy, copy.head, NULL);
+    ASSERT(list.size == 2000 && CALL(ListI32, copy, empty, /));
+    list_check_links(&list);
+    CALL(ListI32, list, sort, /);
+    copy = CALL(ListI32, list, clone, /);
+    CALL(ListI32, list, merge, /, &copy);
+    ASSERT(list.size == 4000 && CALL(ListI32, list, is_sorted, /));
+    ASSERT(*CALL(ListI32, list, front, /) == 0 && list.tail->data == 999);
+    list_check_links(&list);
+    CALL(ListI32, list, clear, /);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(ListI32, list, push_front, /, i);
+    }
+
+    // the nodes of a pooled clone lie in list order in one block
+    copy = CALL(ListI32, list, clone_pooled, /);
+    ASSERT(copy.own_pool && copy.size == 1000);
+    i32 expected = 999;
+    for (ListI32Node *it = copy.head; it; it = it->next) {
+        ASSERT(it->data == expected--);
+        ASSERT(!it->next || it->next == it + 1);
+    }
+    list_check_links(&copy);
+    // the nodes are still freed and reused one by one
+    ListI32Node *second = copy.head->next;
+    CALL(ListI32, copy, remove_back, /);
+    CALL(ListI32, copy, remove, /, second);
+    CALL(ListI32, copy, push_back, /, -1);
+    ASSERT(copy.tail == second && copy.size == 999);
+    CALL(ListI32, copy, clone_from, /, &copy);
+    ASSERT(copy.size == 999);
+    DROPOBJ(ListI32, copy);
+
+    // into a shared pool of larger nodes
+    NodePool pool = CREOBJ(NodePool, /, 64, 16);
+    ListI32 shared;
+    CALL(ListI32, shared, init_pooled, /, &pool);
+    CALL(ListI32, shared, push_back, /, 7);
+    CALL(ListI32, shared, clone_from, /, &list);
+    ASSERT(shared.size == 1000 && !shared.own_pool);
+    ASSERT((char *)shared.tail == (char *)shared.head + 999 * 64);
+    list_check_links(&shared);
+    DROPOBJ(ListI32, shared);
+    DROPOBJ(NodePool, pool);
+    DROPOBJ(ListI32, list);
+}
+
 void test_list() {
     naive();
     class_test();
+    pooled();
+    splice_sort();
+    bulk_clone();
 }
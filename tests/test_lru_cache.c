@@ -0,0 +1,175 @@
+#include "debug.h"
+#include "str.h"
+#include "tem_lru_cache.h"
+#include "utils.h"
+
+DECLARE_LRU_CACHE(CacheI32, i32, i32, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                  GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR,
+                  GENERATOR_PLAIN_HASH);
+DEFINE_LRU_CACHE(CacheI32, i32, i32, FUNC_STATIC);
+
+DECLARE_LRU_CACHE(CacheStr, String, String, FUNC_STATIC, GENERATOR_CLASS_KEY,
+                  GENERATOR_CLASS_VALUE, GENERATOR_CLASS_COMPARATOR,
+                  GENERATOR_CLASS_HASH);
+DEFINE_LRU_CACHE(CacheStr, String, String, FUNC_STATIC);
+
+#define LRU_KEYS 64
+#define LRU_CAP 16
+
+/// the naive model: the value and the last use of each key, 0 if absent
+typedef struct LruModel {
+    i32 value[LRU_KEYS];
+    u64 last_use[LRU_KEYS];
+    u64 clock;
+    i32 evicted;
+} LruModel;
+
+static u32 lru_rand(u32 *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+static void lru_on_evict(i32 *key, i32 *value, void *ctx) {
+    LruModel *model = (LruModel *)ctx;
+    ASSERT(model->evicted == -1);
+    ASSERT(model->last_use[*key] && model->value[*key] == *value);
+    model->evicted = *key;
+}
+
+static void lru_random() {
+    CacheI32 cache;
+    CALL(CacheI32, cache, init, /, LRU_CAP);
+    LruModel model = {.clock = 0, .evicted = -1};
+    CALL(CacheI32, cache, set_evict_callback, /, lru_on_evict, &model);
+    u32 state = 5;
+    usize size = 0;
+    u64 hits = 0, misses = 0, evictions = 0;
+    for (i32 round = 0; round < 50000; round++) {
+        i32 key = (i32)(lru_rand(&state) % LRU_KEYS);
+        u32 op = lru_rand(&state) % 8;
+        if (op < 4) {
+            i32 *value = CALL(CacheI32, cache, get, /, &key);
+            if (model.last_use[key]) {
+                ASSERT(value && *value == model.value[key]);
+                model.last_use[key] = ++model.clock;
+                hits++;
+            } else {
+                ASSERT(!value);
+                misses++;
+            }
+        } else if (op < 7) {
+            i32 expected_victim = -1;
+            if (!model.last_use[key] && size == LRU_CAP) {
+                for (i32 k = 0; k < LRU_KEYS; k++) {
+                    if (model.last_use[k] &&
+                        (expected_victim == -1 ||
+                         model.last_use[k] < model.last_use[expected_victim])) {
+                        expected_victim = k;
+                    }
+                }
+            }
+            i32 *value = CALL(CacheI32, cache, put, /, key, round);
+            ASSERT(*value == round);
+            ASSERT(model.evicted == expected_victim);
+            if (expected_victim != -1) {
+                model.last_use[expected_victim] = 0;
+                model.evicted = -1;
+                evictions++;
+            } else if (!model.last_use[key]) {
+                size++;
+            }
+            model.value[key] = round;
+            model.last_use[key] = ++model.clock;
+        } else {
+            bool present = model.last_use[key] != 0;
+            ASSERT(CALL(CacheI32, cache, erase, /, &key) == present);
+            if (present) {
+                model.last_use[key] = 0;
+                size--;
+            }
+        }
+        ASSERT(cache.size == size);
+        ASSERT(cache.hits == hits && cache.misses == misses &&
+               cache.evictions == evictions);
+    }
+    // the recency list runs from the most recent use
+    u64 last = (u64)-1;
+    usize n = 0;
+    for (u32 id = cache.head; id != LRU_CACHE_NONE;
+         id = cache.entries[id].next) {
+        i32 key = cache.entries[id].key;
+        ASSERT(model.last_use[key] && model.last_use[key] < last);
+        last = model.last_use[key];
+        n++;
+    }
+    ASSERT(n == size);
+    CALL(CacheI32, cache, clear, /);
+    ASSERT(CALL(CacheI32, cache, empty, /));
+    i32 key = 3;
+    ASSERT(!CALL(CacheI32, cache, peek, /, &key));
+    DROPOBJ(CacheI32, cache);
+}
+
+static void lru_clock() {
+    CacheI32 cache;
+    CALL(CacheI32, cache, init_clock, /, 3);
+    for (i32 key = 0; key < 3; key++) {
+        CALL(CacheI32, cache, put, /, key, key * 10);
+    }
+    i32 key = 0;
+    ASSERT(*CALL(CacheI32, cache, get, /, &key) == 0);
+    // the hand spares the referenced 0, and evicts 1
+    CALL(CacheI32, cache, put, /, 3, 30);
+    key = 1;
+    ASSERT(!CALL(CacheI32, cache, peek, /, &key));
+    key = 0;
+    ASSERT(CALL(CacheI32, cache, peek, /, &key));
+    // 0 has lost its bit, and 2 is next to the hand
+    CALL(CacheI32, cache, put, /, 4, 40);
+    key = 2;
+    ASSERT(!CALL(CacheI32, cache, peek, /, &key));
+    ASSERT(cache.evictions == 2 && cache.size == 3);
+
+    // random use keeps the cache consistent
+    u32 state = 9;
+    for (i32 round = 0; round < 10000; round++) {
+        key = (i32)(lru_rand(&state) % 8);
+        i32 *value = CALL(CacheI32, cache, get, /, &key);
+        if (value) {
+            ASSERT(*value / 10 == key);
+        } else if (lru_rand(&state) % 2) {
+            CALL(CacheI32, cache, put, /, key, key * 10 + 1);
+        } else {
+            CALL(CacheI32, cache, erase, /, &key);
+        }
+        ASSERT(cache.size <= 3);
+    }
+    DROPOBJ(CacheI32, cache);
+}
+
+static void lru_class() {
+    CacheStr cache;
+    CALL(CacheStr, cache, init, /, 2);
+    CALL(CacheStr, cache, put, /, NSCALL(String, from_raw, /, "alpha"),
+         NSCALL(String, from_raw, /, "1"));
+    CALL(CacheStr, cache, put, /, NSCALL(String, from_raw, /, "beta"),
+         NSCALL(String, from_raw, /, "2"));
+    // assigning drops the new key and the old value
+    CALL(CacheStr, cache, put, /, NSCALL(String, from_raw, /, "alpha"),
+         NSCALL(String, from_raw, /, "3"));
+    CALL(CacheStr, cache, put, /, NSCALL(String, from_raw, /, "gamma"),
+         NSCALL(String, from_raw, /, "4"));
+    String key = NSCALL(String, mock_raw, /, "beta");
+    ASSERT(!CALL(CacheStr, cache, get, /, &key));
+    key = NSCALL(String, mock_raw, /, "alpha");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(CacheStr, cache, get, /, &key)), "3");
+    ASSERT(CALL(CacheStr, cache, erase, /, &key));
+    ASSERT(cache.size == 1 && cache.hits == 1 && cache.misses == 1);
+    DROPOBJ(CacheStr, cache);
+}
+
+void test_lru_cache() {
+    lru_random();
+    lru_clock();
+    lru_class();
+}
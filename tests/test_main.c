@@ -14,7 +14,14 @@ static void fork_to_run_test(const TestEntry *test, bool *shall_exit,
 int main(int argc, char *argv[]) {
     const TestEntry tests[] = {
         TESTENTRY(plain_vec), TESTENTRY(class_vec), TESTENTRY(map),
-        TESTENTRY(hstr),      TESTENTRY(list),
+        TESTENTRY(hstr),      TESTENTRY(list),      TESTENTRY(simd),
+        TESTENTRY(soa_vec),   TESTENTRY(seg_vec),   TESTENTRY(deque),
+        TESTENTRY(bitvec),    TESTENTRY(priority_queue), TESTENTRY(cow_vec),
+        TESTENTRY(concurrent_vec), TESTENTRY(packed_vec), TESTENTRY(slot_map),
+        TESTENTRY(span),           TESTENTRY(shared_core),
+        TESTENTRY(intrusive_list), TESTENTRY(unrolled_list),
+        TESTENTRY(timer_wheel), TESTENTRY(lru_cache), TESTENTRY(allocator),
+        TESTENTRY(arena),
     };
 
     const usize n_tests = LENGTH(tests);
@@ -188,7 +188,63 @@ static void finders() {
     DROPOBJ(MapSS, m);
 }
 
+static void refresh() {
+    MapSS m = CREOBJ(MapSS, /);
+    for (usize i = 0; i < 30; i++) {
+        String key = NSCALL(String, from_f, /, "key %02zu", i);
+        String value = NSCALL(String, from_f, /, "value %02zu", i);
+        CALL(MapSS, m, insert, /, key, value);
+    }
+    MapSS t = CALL(MapSS, m, clone, /);
+    const char *buffers[30];
+    usize n = 0;
+    for (MapSSIterator it = CALL(MapSS, t, begin, /); it;
+         it = CALL(MapSS, t, next, /, it)) {
+        buffers[n++] = it->value.data;
+    }
+
+    // the same shape: the keys and values are cloned into in place
+    for (MapSSIterator it = CALL(MapSS, m, begin, /); it;
+         it = CALL(MapSS, m, next, /, it)) {
+        it->value.data[0] = 'V';
+    }
+    CALL(MapSS, t, clone_from, /, &m);
+    n = 0;
+    for (MapSSIterator it = CALL(MapSS, t, begin, /); it;
+         it = CALL(MapSS, t, next, /, it)) {
+        ASSERT(it->value.data == buffers[n]);
+        ASSERT(it->value.data[0] == 'V');
+        n++;
+    }
+    ASSERT(n == 30);
+
+    // a new shape, and t stays a valid treap for further inserts
+    for (usize i = 30; i < 60; i++) {
+        String key = NSCALL(String, from_f, /, "key %02zu", i);
+        String value = NSCALL(String, from_f, /, "value %02zu", i);
+        CALL(MapSS, m, insert, /, key, value);
+    }
+    CALL(MapSS, t, clone_from, /, &m);
+    for (usize i = 60; i < 90; i++) {
+        String key = NSCALL(String, from_f, /, "key %02zu", i);
+        String value = NSCALL(String, from_f, /, "value %02zu", i);
+        CALL(MapSS, t, insert, /, key, value);
+    }
+    ASSERT(t.size == 90);
+    n = 0;
+    for (MapSSIterator it = CALL(MapSS, t, begin, /); it;
+         it = CALL(MapSS, t, next, /, it)) {
+        char expected[20];
+        snprintf(expected, sizeof(expected), "key %02zu", n++);
+        ASSERT_EQ_STR(STRING_C_STR(it->key), expected);
+    }
+
+    DROPOBJ(MapSS, t);
+    DROPOBJ(MapSS, m);
+}
+
 void test_map() {
     easy();
     finders();
+    refresh();
 }
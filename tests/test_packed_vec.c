@@ -0,0 +1,109 @@
+#include <stdlib.h>
+
+#include "debug.h"
+#include "packed_vec.h"
+#include "simd.h"
+#include "utils.h"
+
+static u64 packed_rand(u64 *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state >> 11;
+}
+
+/* check every access path of vec against the values */
+static void packed_check(const PackedVec *vec, const u64 *values, usize n,
+                         bool sorted) {
+    ASSERT(CALL(PackedVec, *vec, size, /) == n);
+    for (usize i = 0; i < n; i++) {
+        ASSERT(CALL(PackedVec, *vec, get, /, i) == values[i], "at %zu", i);
+    }
+    PackedVecIter iter = CALL(PackedVec, *vec, iter, /);
+    u64 value;
+    for (usize i = 0; i < n; i++) {
+        ASSERT(CALL(PackedVecIter, iter, next, /, &value));
+        ASSERT(value == values[i]);
+    }
+    ASSERT(!CALL(PackedVecIter, iter, next, /, &value));
+    if (!sorted) {
+        return;
+    }
+    for (usize i = 0; i < n; i += 97) {
+        for (u64 d = 0; d < 2; d++) {
+            u64 key = values[i] + d;
+            usize expected = 0;
+            while (expected < n && values[expected] < key) {
+                expected++;
+            }
+            ASSERT(CALL(PackedVec, *vec, lower_bound, /, key) == expected);
+        }
+    }
+    ASSERT(CALL(PackedVec, *vec, lower_bound, /, 0) == 0);
+    ASSERT(CALL(PackedVec, *vec, lower_bound, /, ~0ull) == n ||
+           values[n - 1] == ~0ull);
+}
+
+static void packed_sorted() {
+    enum { N = 10000 };
+    u64 *values = (u64 *)malloc(N * sizeof(u64));
+    u64 state = 1;
+    values[0] = 1000000;
+    for (usize i = 1; i < N; i++) {
+        values[i] = values[i - 1] + packed_rand(&state) % 100;
+    }
+    for (int delta = 0; delta < 2; delta++) {
+        for (int level = SIMD_LEVEL_SCALAR; level <= SIMD_LEVEL_AVX2;
+             level++) {
+            NSCALL(Simd, set_level, /, (SimdLevel)level);
+            PackedVec vec = CREOBJ(PackedVec, /, delta);
+            for (usize i = 0; i < N; i++) {
+                CALL(PackedVec, vec, push_back, /, values[i]);
+                if (i % 2500 == 0) {
+                    packed_check(&vec, values, i + 1, true);
+                }
+            }
+            packed_check(&vec, values, N, true);
+            // the values take at most 14 bits instead of 64
+            ASSERT(CALL(PackedVec, vec, memory, /) * 3 < N * sizeof(u64));
+
+            PackedVec copied = CALL(PackedVec, vec, clone, /);
+            CALL(PackedVec, vec, clear, /);
+            ASSERT(CALL(PackedVec, vec, empty, /));
+            ASSERT(CALL(PackedVec, vec, lower_bound, /, 5) == 0);
+            packed_check(&copied, values, N, true);
+            DROPOBJ(PackedVec, copied);
+            DROPOBJ(PackedVec, vec);
+        }
+    }
+    free(values);
+}
+
+static void packed_unsorted() {
+    enum { N = 700 };
+    u64 values[N];
+    u64 state = 9;
+    for (usize i = 0; i < N; i++) {
+        u64 r = packed_rand(&state);
+        // blocks of constants, narrow values and full-width values
+        values[i] = i < 128 ? 42 : i < 300 ? r % 5000 : r << 11 | (r >> 40);
+    }
+    values[400] = 0;
+    values[401] = ~0ull;
+    for (int delta = 0; delta < 2; delta++) {
+        for (int level = SIMD_LEVEL_SCALAR; level <= SIMD_LEVEL_AVX2;
+             level++) {
+            NSCALL(Simd, set_level, /, (SimdLevel)level);
+            PackedVec vec = CREOBJ(PackedVec, /, delta);
+            for (usize i = 0; i < N; i++) {
+                CALL(PackedVec, vec, push_back, /, values[i]);
+            }
+            packed_check(&vec, values, N, false);
+            ASSERT(vec.blocks[0].bits == 0);
+            DROPOBJ(PackedVec, vec);
+        }
+    }
+}
+
+void test_packed_vec() {
+    packed_sorted();
+    packed_unsorted();
+}
@@ -0,0 +1,210 @@
+#include <stdlib.h>
+
+#include "debug.h"
+#include "str.h"
+#include "tem_priority_queue.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+DECLARE_PLAIN_VEC(PQVecI32, i32, FUNC_STATIC);
+DEFINE_PLAIN_VEC(PQVecI32, i32, FUNC_STATIC);
+
+DECLARE_PRIORITY_QUEUE(BinaryHeapI32, PQVecI32, i32, 2, FUNC_STATIC,
+                       GENERATOR_PLAIN_COMPARATOR);
+DEFINE_PRIORITY_QUEUE(BinaryHeapI32, PQVecI32, i32, 2, FUNC_STATIC);
+
+DECLARE_PRIORITY_QUEUE(QuadHeapI32, PQVecI32, i32, 4, FUNC_STATIC,
+                       GENERATOR_PLAIN_COMPARATOR);
+DEFINE_PRIORITY_QUEUE(QuadHeapI32, PQVecI32, i32, 4, FUNC_STATIC);
+
+DECLARE_CLASS_VEC(PQVecStr, String, FUNC_STATIC);
+DEFINE_CLASS_VEC(PQVecStr, String, FUNC_STATIC);
+
+DECLARE_PRIORITY_QUEUE(HeapStr, PQVecStr, String, 3, FUNC_STATIC,
+                       GENERATOR_CLASS_COMPARATOR);
+DEFINE_PRIORITY_QUEUE(HeapStr, PQVecStr, String, 3, FUNC_STATIC);
+
+DECLARE_INDEXED_PRIORITY_QUEUE(IndexedHeapI32, i32, 4, FUNC_STATIC,
+                               GENERATOR_PLAIN_COMPARATOR,
+                               GENERATOR_PLAIN_VALUE);
+DEFINE_INDEXED_PRIORITY_QUEUE(IndexedHeapI32, i32, 4, FUNC_STATIC);
+
+DECLARE_INDEXED_PRIORITY_QUEUE(IndexedHeapStr, String, 2, FUNC_STATIC,
+                               GENERATOR_CLASS_COMPARATOR,
+                               GENERATOR_CLASS_VALUE);
+DEFINE_INDEXED_PRIORITY_QUEUE(IndexedHeapStr, String, 2, FUNC_STATIC);
+
+static u32 pq_rand(u32 *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+#define PQ_PLAIN_TEST(PQ)                                                      \
+    do {                                                                       \
+        PQ pq = CREOBJ(PQ, /);                                                 \
+        u32 state = 11;                                                        \
+        usize count[64] = {0};                                                 \
+        for (usize step = 0; step < 5000; step++) {                            \
+            if (pq_rand(&state) % 3 != 0 || CALL(PQ, pq, empty, /)) {          \
+                i32 value = (i32)(pq_rand(&state) % 64);                       \
+                CALL(PQ, pq, push, /, value);                                  \
+                count[value]++;                                                \
+            } else {                                                           \
+                i32 min = 0;                                                   \
+                while (count[min] == 0) {                                      \
+                    min++;                                                     \
+                }                                                              \
+                ASSERT(*CALL(PQ, pq, top, /) == min);                          \
+                ASSERT(CALL(PQ, pq, pop, /) == min);                           \
+                count[min]--;                                                  \
+            }                                                                  \
+        }                                                                      \
+        PQ copied = CALL(PQ, pq, clone, /);                                    \
+        i32 last = -1;                                                         \
+        while (!CALL(PQ, pq, empty, /)) {                                      \
+            i32 value = CALL(PQ, pq, pop, /);                                  \
+            ASSERT(value >= last && count[value] > 0);                         \
+            count[value]--;                                                    \
+            last = value;                                                      \
+        }                                                                      \
+        ASSERT(copied.heap.size > 0);                                          \
+        CALL(PQ, copied, clear, /);                                            \
+        ASSERT(CALL(PQ, copied, empty, /));                                    \
+        DROPOBJ(PQ, copied);                                                   \
+        DROPOBJ(PQ, pq);                                                       \
+    } while (0)
+
+static void pq_plain() {
+    PQ_PLAIN_TEST(BinaryHeapI32);
+    PQ_PLAIN_TEST(QuadHeapI32);
+
+    // heapify a vector in place, then drain it in order
+    PQVecI32 vec = CREOBJ(PQVecI32, /);
+    u32 state = 5;
+    for (usize i = 0; i < 1000; i++) {
+        CALL(PQVecI32, vec, push_back, /, (i32)(pq_rand(&state) % 100));
+    }
+    QuadHeapI32 pq = NSCALL(QuadHeapI32, from_vec, /, vec);
+    i32 last = -1;
+    for (usize i = 0; i < 1000; i++) {
+        i32 value = CALL(QuadHeapI32, pq, pop, /);
+        ASSERT(value >= last);
+        last = value;
+    }
+    ASSERT(CALL(QuadHeapI32, pq, empty, /));
+    DROPOBJ(QuadHeapI32, pq);
+}
+
+static void pq_class() {
+    HeapStr pq = CREOBJ(HeapStr, /);
+    for (usize i = 0; i < 100; i++) {
+        CALL(HeapStr, pq, push, /,
+             NSCALL(String, from_f, /, "%03zu", (i * 37) % 100));
+    }
+    CALL(HeapStr, pq, remove_top, /);
+    HeapStr copied = CALL(HeapStr, pq, clone, /);
+    for (usize i = 1; i < 100; i++) {
+        String s = CALL(HeapStr, pq, pop, /);
+        String expected = NSCALL(String, from_f, /, "%03zu", i);
+        ASSERT(NSCALL(String, compare, /, &s, &expected) == 0);
+        DROPOBJ(String, expected);
+        DROPOBJ(String, s);
+    }
+    ASSERT(CALL(HeapStr, pq, empty, /));
+    ASSERT(CALL(HeapStr, copied, size, /) == 99);
+    DROPOBJ(HeapStr, copied);
+    DROPOBJ(HeapStr, pq);
+}
+
+static void pq_indexed() {
+    // mirror the queue by an array of values indexed by handle
+    enum { N = 200 };
+    i32 model[N];
+    bool alive[N] = {false};
+    IndexedHeapI32 pq = CREOBJ(IndexedHeapI32, /);
+    u32 state = 3;
+    for (usize step = 0; step < 20000; step++) {
+        u32 op = pq_rand(&state) % 4;
+        usize handle = pq_rand(&state) % N;
+        if (op == 0 && pq.heap.size < N) {
+            i32 value = (i32)(pq_rand(&state) % 1000);
+            handle = CALL(IndexedHeapI32, pq, push, /, value);
+            ASSERT(handle < N && !alive[handle]);
+            alive[handle] = true;
+            model[handle] = value;
+        } else if (op == 1 && alive[handle]) {
+            i32 value = model[handle] - (i32)(pq_rand(&state) % 100);
+            CALL(IndexedHeapI32, pq, decrease_key, /, handle, value);
+            model[handle] = value;
+        } else if (op == 2 && alive[handle]) {
+            i32 value = (i32)(pq_rand(&state) % 1000);
+            CALL(IndexedHeapI32, pq, update, /, handle, value);
+            model[handle] = value;
+        } else if (op == 3 && alive[handle]) {
+            ASSERT(CALL(IndexedHeapI32, pq, remove, /, handle) ==
+                   model[handle]);
+            alive[handle] = false;
+        }
+        ASSERT(CALL(IndexedHeapI32, pq, contains, /, handle) == alive[handle]);
+        if (!CALL(IndexedHeapI32, pq, empty, /)) {
+            usize top = CALL(IndexedHeapI32, pq, top_handle, /);
+            ASSERT(alive[top] && *CALL(IndexedHeapI32, pq, top, /) ==
+                                     model[top]);
+            for (usize i = 0; i < N; i++) {
+                ASSERT(!alive[i] || model[i] >= model[top]);
+            }
+        }
+    }
+
+    IndexedHeapI32 copied = CALL(IndexedHeapI32, pq, clone, /);
+    while (!CALL(IndexedHeapI32, pq, empty, /)) {
+        usize handle = CALL(IndexedHeapI32, pq, top_handle, /);
+        ASSERT(*CALL(IndexedHeapI32, copied, get, /, handle) == model[handle]);
+        ASSERT(CALL(IndexedHeapI32, pq, pop, /) == model[handle]);
+        alive[handle] = false;
+    }
+    for (usize i = 0; i < N; i++) {
+        ASSERT(!alive[i]);
+    }
+    DROPOBJ(IndexedHeapI32, copied);
+    DROPOBJ(IndexedHeapI32, pq);
+}
+
+static void pq_indexed_class() {
+    IndexedHeapStr pq = CREOBJ(IndexedHeapStr, /);
+    usize handles[10];
+    for (usize i = 0; i < 10; i++) {
+        handles[i] = CALL(IndexedHeapStr, pq, push, /,
+                          NSCALL(String, from_f, /, "m%zu", i));
+    }
+    CALL(IndexedHeapStr, pq, decrease_key, /, handles[7],
+         NSCALL(String, from_f, /, "a"));
+    CALL(IndexedHeapStr, pq, update, /, handles[0],
+         NSCALL(String, from_f, /, "z"));
+    ASSERT(CALL(IndexedHeapStr, pq, top_handle, /) == handles[7]);
+    String removed = CALL(IndexedHeapStr, pq, remove, /, handles[1]);
+    ASSERT_EQ_STR(STRING_C_STR(removed), "m1");
+    DROPOBJ(String, removed);
+    // the handle of a removed value is reused
+    ASSERT(CALL(IndexedHeapStr, pq, push, /, NSCALL(String, from_f, /, "b")) ==
+           handles[1]);
+
+    IndexedHeapStr copied = CALL(IndexedHeapStr, pq, clone, /);
+    const char *expected[] = {"a",  "b",  "m2", "m3", "m4",
+                              "m5", "m6", "m8", "m9", "z"};
+    for (usize i = 0; i < LENGTH(expected); i++) {
+        String s = CALL(IndexedHeapStr, copied, pop, /);
+        ASSERT_EQ_STR(STRING_C_STR(s), expected[i]);
+        DROPOBJ(String, s);
+    }
+    ASSERT(CALL(IndexedHeapStr, copied, empty, /));
+    DROPOBJ(IndexedHeapStr, copied);
+    DROPOBJ(IndexedHeapStr, pq);
+}
+
+void test_priority_queue() {
+    pq_plain();
+    pq_class();
+    pq_indexed();
+    pq_indexed_class();
+}
@@ -0,0 +1,82 @@
+#include "debug.h"
+#include "str.h"
+#include "tem_seg_vec.h"
+#include "utils.h"
+
+DECLARE_SEG_VEC(SegVecI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_SEG_VEC(SegVecI32, i32, FUNC_STATIC);
+
+DECLARE_SEG_VEC(SegVecStr, String, FUNC_STATIC, GENERATOR_CLASS_VALUE);
+DEFINE_SEG_VEC(SegVecStr, String, FUNC_STATIC);
+
+static void seg_plain() {
+    SegVecI32 v = CREOBJ(SegVecI32, /);
+    ASSERT(CALL(SegVecI32, v, empty, /));
+    CALL(SegVecI32, v, push_back, /, 0);
+    i32 *first = CALL(SegVecI32, v, front, /);
+    i32 *pointers[1000];
+    pointers[0] = first;
+    for (i32 i = 1; i < 1000; i++) {
+        CALL(SegVecI32, v, push_back, /, i);
+        pointers[i] = CALL(SegVecI32, v, back, /);
+    }
+    ASSERT(v.size == 1000 && v.capacity >= 1000);
+    // the elements never move
+    for (i32 i = 0; i < 1000; i++) {
+        ASSERT(CALL(SegVecI32, v, at, /, (usize)i) == pointers[i]);
+        ASSERT(*pointers[i] == i);
+    }
+    ASSERT(*first == 0);
+
+    SegVecI32 copied = CALL(SegVecI32, v, clone, /);
+    CALL(SegVecI32, v, truncate, /, 10);
+    ASSERT(v.size == 10 && *CALL(SegVecI32, v, back, /) == 9);
+    CALL(SegVecI32, v, pop_back, /);
+    ASSERT(v.size == 9);
+    ASSERT(copied.size == 1000);
+    for (usize i = 0; i < copied.size; i++) {
+        ASSERT(*CALL(SegVecI32, copied, at, /, i) == (i32)i);
+    }
+
+    CALL(SegVecI32, v, swap, /, &copied);
+    ASSERT(v.size == 1000 && copied.size == 9);
+    ASSERT(CALL(SegVecI32, copied, front, /) == first);
+
+    CALL(SegVecI32, v, clear, /);
+    ASSERT(CALL(SegVecI32, v, empty, /));
+    CALL(SegVecI32, v, reserve, /, 5000);
+    ASSERT(v.capacity >= 5000);
+
+    DROPOBJ(SegVecI32, copied);
+    DROPOBJ(SegVecI32, v);
+}
+
+static void seg_class() {
+    SegVecStr v = CREOBJ(SegVecStr, /);
+    for (usize i = 0; i < 100; i++) {
+        CALL(SegVecStr, v, push_back, /, NSCALL(String, from_f, /, "%zu", i));
+    }
+    String *s42 = CALL(SegVecStr, v, at, /, 42);
+    for (usize i = 100; i < 300; i++) {
+        CALL(SegVecStr, v, push_back, /, NSCALL(String, from_f, /, "%zu", i));
+    }
+    ASSERT_EQ_STR(STRING_C_STR(*s42), "42");
+
+    SegVecStr copied = CREOBJ(SegVecStr, /);
+    CALL(SegVecStr, copied, push_back, /, NSCALL(String, from_raw, /, "x"));
+    CALL(SegVecStr, copied, clone_from, /, &v);
+    ASSERT(copied.size == 300);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(SegVecStr, copied, back, /)), "299");
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(SegVecStr, copied, front, /)), "0");
+
+    CALL(SegVecStr, v, truncate, /, 50);
+    ASSERT_EQ_STR(STRING_C_STR(*s42), "42");
+
+    DROPOBJ(SegVecStr, copied);
+    DROPOBJ(SegVecStr, v);
+}
+
+void test_seg_vec() {
+    seg_plain();
+    seg_class();
+}
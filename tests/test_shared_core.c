@@ -0,0 +1,66 @@
+// the containers of this file are built on the shared core, whatever the flags
+#ifndef OOPINC_SHARED_CORE
+#define OOPINC_SHARED_CORE
+#endif
+
+#include "debug.h"
+#include "tem_map.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+DECLARE_PLAIN_VEC(CoreVecI64, i64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(CoreVecI64, i64, FUNC_STATIC);
+
+DECLARE_MAPPING(CoreMapII, i32, i32, FUNC_STATIC, GENERATOR_PLAIN_KEY,
+                GENERATOR_PLAIN_VALUE, GENERATOR_PLAIN_COMPARATOR);
+DEFINE_MAPPING(CoreMapII, i32, i32, FUNC_STATIC);
+
+static void shared_core_vec() {
+    CoreVecI64 v = CREOBJ(CoreVecI64, /);
+    for (i64 i = 0; i < 1000; i++) {
+        CALL(CoreVecI64, v, push_back, /, i);
+    }
+    ASSERT(v.capacity == 1024);
+    CALL(CoreVecI64, v, insert, /, 0, -1);
+    CALL(CoreVecI64, v, erase, /, 500);
+    CALL(CoreVecI64, v, shrink_to_fit, /);
+    ASSERT(v.size == 1000 && v.capacity == 1000);
+    ASSERT(v.data[0] == -1 && v.data[499] == 498 && v.data[500] == 500);
+    CALL(CoreVecI64, v, resize, /, 1200);
+    ASSERT(v.data[1199] == 0);
+    DROPOBJ(CoreVecI64, v);
+}
+
+static void shared_core_map() {
+    CoreMapII m = CREOBJ(CoreMapII, /);
+    for (i32 i = 0; i < 500; i++) {
+        CALL(CoreMapII, m, insert, /, (i * 7) % 500, i);
+    }
+    for (i32 i = 0; i < 500; i += 3) {
+        CoreMapIIIterator it = CALL(CoreMapII, m, find, /, &i);
+        CALL(CoreMapII, m, erase, /, it);
+    }
+    ASSERT(m.size == 333);
+    i32 expected = 1;
+    for (CoreMapIIIterator it = CALL(CoreMapII, m, begin, /); it;
+         it = CALL(CoreMapII, m, next, /, it)) {
+        ASSERT(it->key == expected);
+        expected += expected % 3 == 1 ? 1 : 2;
+    }
+    ASSERT(expected == 500);
+    for (CoreMapIIIterator it = CALL(CoreMapII, m, prev, /, NULL); it;
+         it = CALL(CoreMapII, m, prev, /, it)) {
+        expected -= expected % 3 == 2 ? 1 : 2;
+        ASSERT(it->key == expected);
+        if (expected == 1) {
+            break;
+        }
+    }
+    ASSERT(expected == 1);
+    DROPOBJ(CoreMapII, m);
+}
+
+void test_shared_core() {
+    shared_core_vec();
+    shared_core_map();
+}
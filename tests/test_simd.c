@@ -0,0 +1,173 @@
+#include "debug.h"
+#include "gen_vec.h"
+#include "simd.h"
+#include "tem_vec.h"
+#include "utils.h"
+
+DECLARE_VEC_NUMERIC(VecI32, i32);
+
+DECLARE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecU64, u64, FUNC_STATIC);
+DECLARE_VEC_NUMERIC(VecU64, u64);
+
+DECLARE_PLAIN_VEC(VecF32, f32, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecF32, f32, FUNC_STATIC);
+DECLARE_VEC_NUMERIC(VecF32, f32);
+
+DECLARE_PLAIN_VEC(VecI16, i16, FUNC_STATIC);
+DEFINE_PLAIN_VEC(VecI16, i16, FUNC_STATIC);
+DECLARE_VEC_NUMERIC(VecI16, i16);
+
+static u32 rand_next(u32 *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 8;
+}
+
+static const usize simd_sizes[] = {0,  1,  3,  4,  7,   8,   15,
+                                   16, 17, 31, 32, 33, 100, 1000};
+
+static void simd_i32() {
+    u32 state = 1;
+    for (usize k = 0; k < LENGTH(simd_sizes); k++) {
+        usize n = simd_sizes[k];
+        VecI32 v = CREOBJ(VecI32, /);
+        for (usize i = 0; i < n; i++) {
+            CALL(VecI32, v, push_back, /, (i32)(rand_next(&state) % 41) - 20);
+        }
+
+        for (i32 x = -22; x <= 22; x++) {
+            usize first = n, cnt = 0;
+            for (usize i = 0; i < n; i++) {
+                if (v.data[i] == x) {
+                    first = first == n ? i : first;
+                    cnt++;
+                }
+            }
+            ASSERT(CALL(VecI32, v, find, /, x) == first);
+            ASSERT(CALL(VecI32, v, count, /, x) == cnt);
+            ASSERT(CALL(VecI32, v, contains, /, x) == (cnt > 0));
+
+            for (SimdCmp cmp = SIMD_CMP_EQ; cmp <= SIMD_CMP_GE; cmp++) {
+                VecI32 out = CREOBJ(VecI32, /);
+                CALL(VecI32, out, push_back, /, 12345);
+                CALL(VecI32, v, filter_into, /, &out, cmp, x);
+                usize j = 1;
+                for (usize i = 0; i < n; i++) {
+                    i32 e = v.data[i];
+                    bool keep = cmp == SIMD_CMP_EQ   ? e == x
+                                : cmp == SIMD_CMP_NE ? e != x
+                                : cmp == SIMD_CMP_LT ? e < x
+                                : cmp == SIMD_CMP_LE ? e <= x
+                                : cmp == SIMD_CMP_GT ? e > x
+                                                     : e >= x;
+                    if (keep) {
+                        ASSERT(j < out.size && out.data[j] == e);
+                        j++;
+                    }
+                }
+                ASSERT(out.size == j && out.data[0] == 12345);
+                DROPOBJ(VecI32, out);
+            }
+        }
+
+        i64 sum = 0;
+        for (usize i = 0; i < n; i++) {
+            sum += v.data[i];
+        }
+        ASSERT(CALL(VecI32, v, sum, /) == sum);
+
+        if (n >= 3) {
+            v.data[n / 2] = INT32_MIN;
+            v.data[n - 1] = INT32_MAX;
+            VecI32MinMax mm = CALL(VecI32, v, minmax, /);
+            ASSERT(mm.min == INT32_MIN && mm.max == INT32_MAX);
+        }
+        DROPOBJ(VecI32, v);
+    }
+}
+
+static void simd_u64() {
+    u32 state = 2;
+    for (usize k = 0; k < LENGTH(simd_sizes); k++) {
+        usize n = simd_sizes[k];
+        VecU64 v = CREOBJ(VecU64, /);
+        u64 sum = 0, min = UINT64_MAX, max = 0;
+        for (usize i = 0; i < n; i++) {
+            /* large values to check the unsigned comparisons */
+            u64 e = ((u64)rand_next(&state) << 40) | rand_next(&state) % 8;
+            CALL(VecU64, v, push_back, /, e);
+            sum += e;
+            min = e < min ? e : min;
+            max = e > max ? e : max;
+        }
+        ASSERT(CALL(VecU64, v, sum, /) == sum);
+        if (n > 0) {
+            VecU64MinMax mm = CALL(VecU64, v, minmax, /);
+            ASSERT(mm.min == min && mm.max == max);
+            ASSERT(CALL(VecU64, v, find, /, v.data[n - 1]) <= n - 1);
+            VecU64 out = CREOBJ(VecU64, /);
+            CALL(VecU64, v, filter_into, /, &out, SIMD_CMP_GE, max);
+            ASSERT(out.size == CALL(VecU64, v, count, /, max));
+            DROPOBJ(VecU64, out);
+        }
+        ASSERT(!CALL(VecU64, v, contains, /, 1ull << 63));
+        DROPOBJ(VecU64, v);
+    }
+}
+
+static void simd_f32() {
+    u32 state = 3;
+    for (usize k = 0; k < LENGTH(simd_sizes); k++) {
+        usize n = simd_sizes[k];
+        VecF32 v = CREOBJ(VecF32, /);
+        f64 sum = 0;
+        for (usize i = 0; i < n; i++) {
+            /* halves are exact, so the sum does not depend on the order */
+            f32 e = (f32)((i32)(rand_next(&state) % 200) - 100) / 2;
+            CALL(VecF32, v, push_back, /, e);
+            sum += e;
+        }
+        ASSERT(CALL(VecF32, v, sum, /) == sum);
+        if (n > 0) {
+            v.data[n - 1] = -1000.5f;
+            VecF32MinMax mm = CALL(VecF32, v, minmax, /);
+            ASSERT(mm.min == -1000.5f && mm.max <= 50.0f);
+            ASSERT(CALL(VecF32, v, find, /, -1000.5f) == n - 1);
+            VecF32 out = CREOBJ(VecF32, /);
+            CALL(VecF32, v, filter_into, /, &out, SIMD_CMP_LT, -100.0f);
+            ASSERT(out.size == 1 && out.data[0] == -1000.5f);
+            DROPOBJ(VecF32, out);
+        }
+        DROPOBJ(VecF32, v);
+    }
+}
+
+static void simd_fallback() {
+    VecI16 v = CREOBJ(VecI16, /);
+    for (i16 i = 0; i < 100; i++) {
+        CALL(VecI16, v, push_back, /, (i16)(i % 10 - 5));
+    }
+    ASSERT(CALL(VecI16, v, find, /, 4) == 9);
+    ASSERT(CALL(VecI16, v, count, /, -5) == 10);
+    ASSERT(CALL(VecI16, v, sum, /) == -50);
+    VecI16MinMax mm = CALL(VecI16, v, minmax, /);
+    ASSERT(mm.min == -5 && mm.max == 4);
+    VecI16 out = CREOBJ(VecI16, /);
+    CALL(VecI16, v, filter_into, /, &out, SIMD_CMP_GT, 2);
+    ASSERT(out.size == 20);
+    DROPOBJ(VecI16, out);
+    DROPOBJ(VecI16, v);
+}
+
+void test_simd() {
+    SimdLevel supported = NSCALL(Simd, level, /);
+    for (SimdLevel level = SIMD_LEVEL_SCALAR; level <= supported; level++) {
+        NSCALL(Simd, set_level, /, level);
+        ASSERT(NSCALL(Simd, level, /) == level);
+        simd_i32();
+        simd_u64();
+        simd_f32();
+    }
+    NSCALL(Simd, set_level, /, supported);
+    simd_fallback();
+}
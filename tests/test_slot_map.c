@@ -0,0 +1,110 @@
+#include "debug.h"
+#include "str.h"
+#include "tem_slot_map.h"
+#include "utils.h"
+
+DECLARE_SLOT_MAP(SlotMapI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_SLOT_MAP(SlotMapI32, i32, FUNC_STATIC);
+
+DECLARE_SLOT_MAP(SlotMapStr, String, FUNC_STATIC, GENERATOR_CLASS_VALUE);
+DEFINE_SLOT_MAP(SlotMapStr, String, FUNC_STATIC);
+
+/* check the dense array and the handles agree */
+static void slot_map_check(SlotMapI32 *map) {
+    for (usize i = 0; i < map->size; i++) {
+        SlotHandle h = CALL(SlotMapI32, *map, handle_at, /, i);
+        ASSERT(CALL(SlotMapI32, *map, get, /, h) == map->values + i);
+    }
+}
+
+static void slot_map_plain() {
+    enum { N = 200 };
+    SlotMapI32 map = CREOBJ(SlotMapI32, /);
+    SlotHandle handles[N];
+    bool live[N];
+    SlotHandle none = {0, 0};
+    ASSERT(!CALL(SlotMapI32, map, contains, /, none));
+
+    for (i32 i = 0; i < N; i++) {
+        handles[i] = CALL(SlotMapI32, map, insert, /, i);
+        live[i] = true;
+    }
+    u32 state = 3;
+    for (usize step = 0; step < 5000; step++) {
+        state = state * 1103515245u + 12345u;
+        i32 i = (i32)((state >> 16) % N);
+        if (live[i]) {
+            ASSERT(*CALL(SlotMapI32, map, get, /, handles[i]) == i);
+            if ((state >> 8) & 1) {
+                ASSERT(CALL(SlotMapI32, map, remove, /, handles[i]) == i);
+            } else {
+                ASSERT(CALL(SlotMapI32, map, erase, /, handles[i]));
+            }
+            live[i] = false;
+        } else {
+            // the old handle stays stale even if its slot is reused
+            SlotHandle stale = handles[i];
+            handles[i] = CALL(SlotMapI32, map, insert, /, i);
+            live[i] = true;
+            ASSERT(!CALL(SlotMapI32, map, contains, /, stale));
+            ASSERT(CALL(SlotMapI32, map, get, /, stale) == NULL);
+            ASSERT(!CALL(SlotMapI32, map, erase, /, stale));
+        }
+        if (step % 250 == 0) {
+            slot_map_check(&map);
+        }
+    }
+    usize n_live = 0;
+    for (i32 i = 0; i < N; i++) {
+        n_live += live[i];
+        ASSERT(CALL(SlotMapI32, map, contains, /, handles[i]) == live[i]);
+    }
+    ASSERT(map.size == n_live && map.n_slots == N);
+
+    // the handles are valid in the clone too
+    SlotMapI32 copied = CALL(SlotMapI32, map, clone, /);
+    CALL(SlotMapI32, map, clear, /);
+    ASSERT(CALL(SlotMapI32, map, empty, /));
+    for (i32 i = 0; i < N; i++) {
+        ASSERT(!CALL(SlotMapI32, map, contains, /, handles[i]));
+        if (live[i]) {
+            ASSERT(*CALL(SlotMapI32, copied, get, /, handles[i]) == i);
+        }
+    }
+    slot_map_check(&copied);
+    SlotHandle h = CALL(SlotMapI32, map, insert, /, 7);
+    ASSERT(*CALL(SlotMapI32, map, get, /, h) == 7 && map.n_slots == N);
+
+    DROPOBJ(SlotMapI32, copied);
+    DROPOBJ(SlotMapI32, map);
+}
+
+static void slot_map_class() {
+    SlotMapStr map = CREOBJ(SlotMapStr, /);
+    SlotHandle handles[10];
+    for (usize i = 0; i < 10; i++) {
+        handles[i] = CALL(SlotMapStr, map, insert, /,
+                          NSCALL(String, from_f, /, "%zu", i));
+    }
+    ASSERT(CALL(SlotMapStr, map, erase, /, handles[0]));
+    String s = CALL(SlotMapStr, map, remove, /, handles[5]);
+    ASSERT_EQ_STR(STRING_C_STR(s), "5");
+    DROPOBJ(String, s);
+    // the last value fills the first hole
+    ASSERT_EQ_STR(STRING_C_STR(map.values[0]), "9");
+
+    SlotMapStr copied = CALL(SlotMapStr, map, clone, /);
+    CALL(SlotMapStr, map, clear, /);
+    ASSERT(copied.size == 8);
+    ASSERT_EQ_STR(
+        STRING_C_STR(*CALL(SlotMapStr, copied, get, /, handles[3])), "3");
+    ASSERT(CALL(SlotMapStr, copied, get, /, handles[0]) == NULL);
+
+    DROPOBJ(SlotMapStr, copied);
+    DROPOBJ(SlotMapStr, map);
+}
+
+void test_slot_map() {
+    slot_map_plain();
+    slot_map_class();
+}
@@ -0,0 +1,65 @@
+#include "debug.h"
+#include "tem_soa_vec.h"
+#include "utils.h"
+
+#define PARTICLE_FIELDS(F) F(f32, x) F(f32, y) F(u8, alive) F(i64, id)
+
+DECLARE_SOA_VEC(SoaParticle, PARTICLE_FIELDS, FUNC_STATIC);
+DEFINE_SOA_VEC(SoaParticle, PARTICLE_FIELDS, FUNC_STATIC);
+
+static SoaParticle gen_particles(usize n) {
+    SoaParticle v = CREOBJ(SoaParticle, /);
+    for (usize i = 0; i < n; i++) {
+        SoaParticleElem p = {
+            .x = (f32)i, .y = (f32)i * 2, .alive = i % 3 != 0, .id = (i64)i};
+        CALL(SoaParticle, v, push_back, /, p);
+    }
+    return v;
+}
+
+static void soa_simple() {
+    SoaParticle v = gen_particles(100);
+    ASSERT(v.size == 100 && v.capacity >= 100);
+
+    f32 sum_x = 0;
+    for (usize i = 0; i < v.size; i++) {
+        sum_x += v.x[i];
+    }
+    ASSERT(sum_x == 4950);
+
+    SoaParticleElem p = CALL(SoaParticle, v, get, /, 42);
+    ASSERT(p.x == 42 && p.y == 84 && p.alive == 0 && p.id == 42);
+    p.y = -1;
+    CALL(SoaParticle, v, set, /, 42, p);
+    ASSERT(SOA_AT(v, y, 42) == -1);
+    SOA_AT(v, alive, 42) = 1;
+    ASSERT(v.alive[42] == 1);
+
+    CALL(SoaParticle, v, erase, /, 0);
+    // v == [1, 2, ..., 99] in every column
+    ASSERT(v.size == 99);
+    ASSERT(v.x[0] == 1 && v.y[0] == 2 && v.alive[0] == 1 && v.id[0] == 1);
+    ASSERT(v.id[98] == 99);
+
+    SoaParticle copied = CALL(SoaParticle, v, clone, /);
+    CALL(SoaParticle, v, erase, /, v.size - 1);
+    CALL(SoaParticle, v, pop_back, /);
+    ASSERT(v.size == 97 && copied.size == 99);
+    ASSERT(copied.id[98] == 99 && copied.y[41] == -1);
+
+    CALL(SoaParticle, v, swap, /, &copied);
+    ASSERT(v.size == 99 && copied.size == 97);
+
+    CALL(SoaParticle, v, truncate, /, 10);
+    ASSERT(v.size == 10 && v.id[9] == 10);
+    CALL(SoaParticle, v, clear, /);
+    ASSERT(CALL(SoaParticle, v, empty, /));
+
+    CALL(SoaParticle, v, clone_from, /, &copied);
+    ASSERT(v.size == 97 && v.x[96] == 97);
+
+    DROPOBJ(SoaParticle, copied);
+    DROPOBJ(SoaParticle, v);
+}
+
+void test_soa_vec() { soa_simple(); }
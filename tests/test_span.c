@@ -0,0 +1,92 @@
+#include "debug.h"
+#include "gen_vec.h"
+#include "str.h"
+#include "tem_span.h"
+#include "utils.h"
+
+DECLARE_SPAN(SpanI32, i32);
+DECLARE_SPAN_ALGORITHM(SpanI32, i32, FUNC_STATIC, GENERATOR_PLAIN_COMPARATOR);
+DEFINE_SPAN_ALGORITHM(SpanI32, i32, FUNC_STATIC);
+
+DECLARE_SPAN(SpanConstI32, const i32);
+
+// reuse the algorithms of VecStr
+DECLARE_SPAN(SpanStr, String);
+DECLARE_SPAN_ALGORITHM_OF(SpanStr, VecStr, String);
+
+static i32 span_sum(SpanConstI32 span) {
+    i32 sum = 0;
+    SPAN_FOR_EACH(span, p) { sum += *p; }
+    return sum;
+}
+
+static void span_plain() {
+    VecI32 vec = CREOBJ(VecI32, /);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(VecI32, vec, push_back, /, (i * 37) % 100);
+    }
+    SpanI32 all = SPAN_OF(SpanI32, vec);
+    ASSERT(all.data == vec.data && CALL(SpanI32, all, size, /) == 100);
+    ASSERT(span_sum(SPAN_OF(SpanConstI32, vec)) == 4950);
+
+    // sort the halves in place, through the views
+    SpanI32 left, right;
+    CALL(SpanI32, all, split_at, /, 50, &left, &right);
+    ASSERT(left.size == 50 && right.data == vec.data + 50);
+    CALL(SpanI32, left, sort, /);
+    CALL(SpanI32, right, stable_sort, /);
+    ASSERT(CALL(SpanI32, left, is_sorted, /));
+    ASSERT(CALL(SpanI32, right, is_sorted, /));
+    ASSERT(!CALL(SpanI32, all, is_sorted, /));
+    for (usize i = 1; i < 50; i++) {
+        ASSERT(vec.data[i - 1] <= vec.data[i]);
+    }
+    i32 key = *CALL(SpanI32, left, at, /, 10);
+    ASSERT(CALL(SpanI32, left, lower_bound, /, &key) == 10);
+    ASSERT(CALL(SpanI32, left, upper_bound, /, &key) == 11);
+    ASSERT(*CALL(SpanI32, left, binary_search, /, &key) == key);
+
+    CALL(SpanI32, all, sort, /);
+    for (i32 i = 0; i < 100; i++) {
+        ASSERT(vec.data[i] == i);
+    }
+    SpanI32 mid = SPAN_RANGE(SpanI32, vec, 20, 60);
+    SpanI32 inner = CALL(SpanI32, mid, subspan, /, 10, 15);
+    ASSERT(*CALL(SpanI32, inner, front, /) == 30);
+    ASSERT(*CALL(SpanI32, inner, back, /) == 34);
+    key = 70;
+    ASSERT(CALL(SpanI32, mid, binary_search, /, &key) == NULL);
+    ASSERT(CALL(SpanI32, mid, lower_bound, /, &key) == mid.size);
+    SpanI32 none = CALL(SpanI32, mid, subspan, /, 40, 40);
+    ASSERT(CALL(SpanI32, none, empty, /));
+
+    for (i32 i = 0; i < 100; i++) {
+        vec.data[i] = i / 10;
+    }
+    ASSERT(CALL(SpanI32, all, dedup, /) == 10);
+    ASSERT(span_sum(SPAN_RANGE(SpanConstI32, vec, 0, 10)) == 45);
+
+    DROPOBJ(VecI32, vec);
+}
+
+static void span_class() {
+    VecStr vec = CREOBJ(VecStr, /);
+    const char *words[] = {"pear", "fig", "apple", "kiwi", "date", "lime"};
+    for (usize i = 0; i < LENGTH(words); i++) {
+        CALL(VecStr, vec, push_back, /, NSCALL(String, from_raw, /, words[i]));
+    }
+    SpanStr tail = SPAN_RANGE(SpanStr, vec, 2, 6);
+    CALL(SpanStr, tail, sort, /);
+    ASSERT_EQ_STR(STRING_C_STR(vec.data[0]), "pear");
+    ASSERT_EQ_STR(STRING_C_STR(vec.data[2]), "apple");
+    ASSERT_EQ_STR(STRING_C_STR(vec.data[5]), "lime");
+    String key = NSCALL(String, from_raw, /, "kiwi");
+    ASSERT(CALL(SpanStr, tail, binary_search, /, &key) == vec.data + 4);
+    DROPOBJ(String, key);
+    DROPOBJ(VecStr, vec);
+}
+
+void test_span() {
+    span_plain();
+    span_class();
+}
@@ -0,0 +1,138 @@
+#include "debug.h"
+#include "timer_wheel.h"
+#include "utils.h"
+
+#define TW_TICK 10
+#define TW_TIMERS 64
+
+typedef struct TwTimer {
+    Timer timer;
+    /// the tick expected to fire at, if armed
+    u64 expected;
+    /// the tick fired at, or 0 if not fired since armed
+    u64 fired_at;
+} TwTimer;
+
+static u64 tw_last_fired;
+
+static u32 tw_rand(u32 *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+static void tw_on_fire(Timer *timer) {
+    TwTimer *t = (TwTimer *)timer;
+    TimerWheel *wheel = (TimerWheel *)timer->ctx;
+    ASSERT(t->fired_at == 0);
+    // the timers fire in the order of their ticks
+    ASSERT(wheel->now_tick >= tw_last_fired);
+    tw_last_fired = wheel->now_tick;
+    t->fired_at = wheel->now_tick;
+}
+
+static void tw_arm(TimerWheel *wheel, TwTimer *t, u64 deadline) {
+    u64 expected = (deadline + TW_TICK - 1) / TW_TICK;
+    t->expected = Max(expected, wheel->now_tick + 1);
+    t->fired_at = 0;
+    CALL(TimerWheel, *wheel, arm, /, &t->timer, deadline);
+}
+
+static void tw_random() {
+    TimerWheel wheel;
+    // 4 slots a level and 3 levels span 64 ticks only, so that many deadlines
+    // are beyond the span and cascade through every level
+    CALL(TimerWheel, wheel, init, /, TW_TICK, 2, 3, 1234);
+    TwTimer timers[TW_TIMERS];
+    for (usize i = 0; i < TW_TIMERS; i++) {
+        CALL(Timer, timers[i].timer, init, /, tw_on_fire, &wheel);
+        timers[i].fired_at = 0;
+    }
+    u32 state = 11;
+    u64 now = 1234;
+    tw_last_fired = 0;
+    for (usize round = 0; round < 20000; round++) {
+        TwTimer *t = &timers[tw_rand(&state) % TW_TIMERS];
+        u32 op = tw_rand(&state) % 4;
+        if (op < 2) {
+            u64 deadline = now + tw_rand(&state) % 2000 - 20;
+            tw_arm(&wheel, t, deadline);
+        } else if (op == 2) {
+            bool armed = CALL(Timer, t->timer, armed, /);
+            ASSERT(CALL(TimerWheel, wheel, cancel, /, &t->timer) == armed);
+            ASSERT(!CALL(Timer, t->timer, armed, /));
+        } else {
+            now += tw_rand(&state) % 60;
+            usize expected_fired = 0;
+            for (usize i = 0; i < TW_TIMERS; i++) {
+                if (CALL(Timer, timers[i].timer, armed, /) &&
+                    timers[i].expected <= now / TW_TICK) {
+                    expected_fired++;
+                }
+            }
+            ASSERT(CALL(TimerWheel, wheel, advance, /, now) == expected_fired);
+        }
+        usize armed = 0;
+        for (usize i = 0; i < TW_TIMERS; i++) {
+            if (CALL(Timer, timers[i].timer, armed, /)) {
+                ASSERT(timers[i].expected > wheel.now_tick);
+                armed++;
+            } else if (timers[i].fired_at) {
+                ASSERT(timers[i].fired_at == timers[i].expected);
+            }
+        }
+        ASSERT(CALL(TimerWheel, wheel, size, /) == armed);
+    }
+    DROPOBJ(TimerWheel, wheel);
+    for (usize i = 0; i < TW_TIMERS; i++) {
+        ASSERT(!CALL(Timer, timers[i].timer, armed, /));
+    }
+}
+
+typedef struct TwPeriodic {
+    Timer timer;
+    TimerWheel *wheel;
+    Timer *victim;
+    usize count;
+} TwPeriodic;
+
+static void tw_on_period(Timer *timer) {
+    TwPeriodic *p = (TwPeriodic *)timer;
+    p->count++;
+    // re-arm itself, and cancel the other timer from the callback
+    CALL(TimerWheel, *p->wheel, arm, /, timer,
+         p->wheel->now_tick * TW_TICK + 3 * TW_TICK);
+    CALL(TimerWheel, *p->wheel, cancel, /, p->victim);
+}
+
+static void tw_noop(Timer *timer) { (void)timer; }
+
+static void tw_callbacks() {
+    TimerWheel wheel;
+    CALL(TimerWheel, wheel, init, /, TW_TICK, 3, 2, 0);
+    TwPeriodic periodic;
+    Timer victim;
+    CALL(Timer, periodic.timer, init, /, tw_on_period, NULL);
+    CALL(Timer, victim, init, /, tw_noop, NULL);
+    periodic.wheel = &wheel;
+    periodic.victim = &victim;
+    periodic.count = 0;
+    CALL(TimerWheel, wheel, arm, /, &periodic.timer, 3 * TW_TICK);
+    CALL(TimerWheel, wheel, arm, /, &victim, 100 * TW_TICK);
+    ASSERT(CALL(TimerWheel, wheel, size, /) == 2);
+    // fires at ticks 3, 6, ..., 30
+    ASSERT(CALL(TimerWheel, wheel, advance, /, 30 * TW_TICK + 5) == 10);
+    ASSERT(periodic.count == 10);
+    ASSERT(!CALL(Timer, victim, armed, /));
+    ASSERT(CALL(TimerWheel, wheel, size, /) == 1);
+    // an empty wheel jumps to any time at once
+    CALL(TimerWheel, wheel, cancel, /, &periodic.timer);
+    ASSERT(CALL(TimerWheel, wheel, empty, /));
+    ASSERT(CALL(TimerWheel, wheel, advance, /, (u64)1 << 60) == 0);
+    ASSERT(wheel.now_tick == ((u64)1 << 60) / TW_TICK);
+    DROPOBJ(TimerWheel, wheel);
+}
+
+void test_timer_wheel() {
+    tw_random();
+    tw_callbacks();
+}
@@ -0,0 +1,141 @@
+#include "debug.h"
+#include "gen_vec.h"
+#include "str.h"
+#include "tem_unrolled_list.h"
+#include "utils.h"
+
+DECLARE_UNROLLED_LIST(UListI32, i32, FUNC_STATIC, GENERATOR_PLAIN_VALUE);
+DEFINE_UNROLLED_LIST(UListI32, i32, FUNC_STATIC);
+
+DECLARE_UNROLLED_LIST(UListStr, String, FUNC_STATIC, GENERATOR_CLASS_VALUE);
+DEFINE_UNROLLED_LIST(UListStr, String, FUNC_STATIC);
+
+static u32 ulist_rand(u32 *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+static void ulist_check(UListI32 *list, VecI32 *expected) {
+    ASSERT(list->size == expected->size);
+    usize i = 0;
+    for (UListI32Iterator it = CALL(UListI32, *list, begin, /); it.node;
+         it = NSCALL(UListI32, next, /, it)) {
+        ASSERT(*NSCALL(UListI32, deref, /, it) == expected->data[i]);
+        i++;
+    }
+    ASSERT(i == expected->size);
+    // all nodes but the first and the last one stay at least half full
+    for (UListI32Node *node = list->head; node; node = node->next) {
+        ASSERT(node->size > 0);
+        ASSERT(node == list->head || node == list->tail ||
+               node->size >= UNROLLED_LIST_NODE_CAP(i32) / 2);
+    }
+}
+
+static void ulist_naive() {
+    UListI32 list = CREOBJ(UListI32, /);
+    for (i32 i = 0; i < 1000; i++) {
+        CALL(UListI32, list, push_back, /, i);
+    }
+    CALL(UListI32, list, push_front, /, -1);
+    ASSERT(list.size == 1001);
+    ASSERT(*CALL(UListI32, list, front, /) == -1);
+    ASSERT(*CALL(UListI32, list, back, /) == 999);
+    ASSERT(*CALL(UListI32, list, at, /, 1) == 0);
+    ASSERT(*CALL(UListI32, list, at, /, 700) == 699);
+    ASSERT(CALL(UListI32, list, pop_front, /) == -1);
+    ASSERT(CALL(UListI32, list, pop_back, /) == 999);
+
+    // remove the odd elements through the iterators
+    UListI32Iterator it = CALL(UListI32, list, begin, /);
+    while (it.node) {
+        if (*NSCALL(UListI32, deref, /, it) % 2) {
+            it = CALL(UListI32, list, remove, /, it);
+        } else {
+            it = NSCALL(UListI32, next, /, it);
+        }
+    }
+    ASSERT(list.size == 500);
+    for (i32 i = 0; i < 500; i++) {
+        ASSERT(*CALL(UListI32, list, at, /, i) == 2 * i);
+    }
+    it = CALL(UListI32, list, begin, /);
+    CALL(UListI32, list, insert_after, /, it, 1);
+    it.node = NULL;
+    CALL(UListI32, list, insert_after, /, it, -2);
+    ASSERT(*CALL(UListI32, list, at, /, 0) == -2);
+    ASSERT(*CALL(UListI32, list, at, /, 2) == 1);
+
+    UListI32 copy = CALL(UListI32, list, clone, /);
+    CALL(UListI32, list, clear, /);
+    ASSERT(CALL(UListI32, list, empty, /) && !list.head);
+    CALL(UListI32, list, swap, /, &copy);
+    ASSERT(list.size == 502 && copy.size == 0);
+    ASSERT(*CALL(UListI32, list, back, /) == 998);
+    DROPOBJ(UListI32, copy);
+    DROPOBJ(UListI32, list);
+}
+
+static void ulist_random() {
+    UListI32 list = CREOBJ(UListI32, /);
+    VecI32 expected = CREOBJ(VecI32, /);
+    u32 state = 7;
+    for (i32 round = 0; round < 20000; round++) {
+        u32 op = ulist_rand(&state) % 8;
+        usize size = expected.size;
+        if (op < 5 || size == 0) {
+            usize index = ulist_rand(&state) % (size + 1);
+            CALL(UListI32, list, insert, /, index, round);
+            CALL(VecI32, expected, insert, /, index, round);
+        } else {
+            usize index = ulist_rand(&state) % size;
+            ASSERT(*CALL(UListI32, list, at, /, index) ==
+                   expected.data[index]);
+            CALL(UListI32, list, erase, /, index);
+            CALL(VecI32, expected, erase, /, index);
+        }
+        if (round % 1000 == 0) {
+            ulist_check(&list, &expected);
+        }
+    }
+    ulist_check(&list, &expected);
+    while (expected.size > 0) {
+        usize index = ulist_rand(&state) % expected.size;
+        CALL(UListI32, list, erase, /, index);
+        CALL(VecI32, expected, erase, /, index);
+    }
+    ASSERT(CALL(UListI32, list, empty, /) && !list.head && !list.tail);
+    DROPOBJ(VecI32, expected);
+    DROPOBJ(UListI32, list);
+}
+
+static void ulist_class() {
+    UListStr list = CREOBJ(UListStr, /);
+    const char *words[] = {"alpha", "beta", "gamma", "delta"};
+    for (usize i = 0; i < 100; i++) {
+        CALL(UListStr, list, push_back, /,
+             NSCALL(String, from_raw, /, words[i % LENGTH(words)]));
+    }
+    CALL(UListStr, list, insert, /, 50, NSCALL(String, from_raw, /, "mid"));
+    CALL(UListStr, list, erase, /, 0);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(UListStr, list, at, /, 49)), "mid");
+    UListStr copy = CALL(UListStr, list, clone, /);
+    CALL(UListStr, list, remove_front, /);
+    CALL(UListStr, list, remove_back, /);
+    String s = CALL(UListStr, copy, pop_back, /);
+    ASSERT_EQ_STR(STRING_C_STR(s), "delta");
+    DROPOBJ(String, s);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(UListStr, copy, front, /)), "beta");
+    ASSERT(list.size == 98 && copy.size == 99);
+    CALL(UListStr, copy, clone_from, /, &copy);
+    ASSERT(copy.size == 99);
+    ASSERT_EQ_STR(STRING_C_STR(*CALL(UListStr, copy, back, /)), "gamma");
+    DROPOBJ(UListStr, copy);
+    DROPOBJ(UListStr, list);
+}
+
+void test_unrolled_list() {
+    ulist_naive();
+    ulist_random();
+    ulist_class();
+}
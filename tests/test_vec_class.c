@@ -3,6 +3,32 @@
 #include "str.h"
 #include "utils.h"
 
+/// Tracked counts the drops of each id
+typedef struct Tracked {
+    usize id;
+} Tracked;
+
+static usize tracked_drops[100];
+
+static DEFAULT_INITIALIZER(Tracked);
+static DEFAULT_CLONER(Tracked);
+static DEFAULT_DERIVE_CLONE(Tracked, /);
+static void MTD(Tracked, drop, /) { tracked_drops[self->id]++; }
+
+DECLARE_CLASS_VEC(VecTracked, Tracked, FUNC_STATIC);
+DEFINE_CLASS_VEC(VecTracked, Tracked, FUNC_STATIC);
+
+/// Point is cloned bitwise and dropped by doing nothing
+typedef struct Point {
+    i32 x, y;
+} Point;
+
+DECLARE_TRIVIAL_CLONE(Point);
+DECLARE_TRIVIAL_DROP(Point);
+
+DECLARE_CLASS_VEC(VecPoint, Point, FUNC_STATIC);
+DEFINE_CLASS_VEC(VecPoint, Point, FUNC_STATIC);
+
 static VecStr gen_range(usize n) {
     VecStr v = CREOBJ(VecStr, /);
     for (usize i = 0; i < n; i++) {
@@ -199,7 +225,135 @@ static void class_ins_rem() {
     DROPOBJ(VecStr, v);
 }
 
+static void class_sort() {
+    VecStr v = CREOBJ(VecStr, /);
+    for (usize i = 0; i < 200; i++) {
+        String s = NSCALL(String, from_f, /, "%03zu", (i * 37) % 100);
+        CALL(VecStr, v, push_back, /, s);
+    }
+    VecStr stable = CALL(VecStr, v, clone, /);
+
+    CALL(VecStr, v, sort, /);
+    ASSERT(CALL(VecStr, v, is_sorted, /));
+    CALL(VecStr, stable, stable_sort, /);
+    assert_same_vec(&v, &stable);
+
+    String key = NSCALL(String, from_raw, /, "042");
+    ASSERT(CALL(VecStr, v, lower_bound, /, &key) == 84);
+    ASSERT(CALL(VecStr, v, upper_bound, /, &key) == 86);
+    String *found = CALL(VecStr, v, binary_search, /, &key);
+    ASSERT(found);
+    ASSERT_EQ_STR(STRING_C_STR(*found), "042");
+    DROPOBJ(String, key);
+
+    CALL(VecStr, v, dedup, /);
+    ASSERT(v.size == 100);
+    for (usize i = 0; i < v.size; i++) {
+        char t[32];
+        snprintf(t, sizeof(t), "%03zu", i);
+        ASSERT_EQ_STR(STRING_C_STR(v.data[i]), t);
+    }
+
+    DROPOBJ(VecStr, stable);
+    DROPOBJ(VecStr, v);
+}
+
+static bool is_odd_id(const Tracked *elem, ATTR_UNUSED void *ctx) {
+    return elem->id % 2 == 1;
+}
+
+static bool has_prefix(const String *elem, void *ctx) {
+    return elem->size > 0 && elem->data[0] == *(const char *)ctx;
+}
+
+static void class_retain() {
+    VecTracked v = CREOBJ(VecTracked, /);
+    for (usize i = 0; i < 100; i++) {
+        CALL(VecTracked, v, push_back, /, (Tracked){.id = i});
+    }
+    CALL(VecTracked, v, erase_if, /, is_odd_id, NULL);
+    ASSERT(v.size == 50);
+    for (usize i = 0; i < 100; i++) {
+        ASSERT(tracked_drops[i] == i % 2);
+    }
+    for (usize i = 0; i < v.size; i++) {
+        ASSERT(v.data[i].id == i * 2);
+    }
+
+    // v == [0, 2, ..., 98]; erase [20, 40), i.e. the ids 40..78
+    CALL(VecTracked, v, erase_range, /, 20, 40);
+    ASSERT(v.size == 30);
+    ASSERT(v.data[19].id == 38 && v.data[20].id == 80);
+    for (usize i = 0; i < 100; i++) {
+        ASSERT(tracked_drops[i] == (i % 2 || (i >= 40 && i < 80)));
+    }
+
+    DROPOBJ(VecTracked, v);
+    for (usize i = 0; i < 100; i++) {
+        ASSERT(tracked_drops[i] == 1);
+    }
+
+    VecStr vs = gen_range(30);
+    char prefix = '1';
+    CALL(VecStr, vs, retain, /, has_prefix, &prefix);
+    // vs == [1, 10, ..., 19]
+    ASSERT(vs.size == 11);
+    ASSERT_EQ_STR(STRING_C_STR(vs.data[0]), "1");
+    ASSERT_EQ_STR(STRING_C_STR(vs.data[10]), "19");
+    CALL(VecStr, vs, erase_range, /, 0, vs.size);
+    ASSERT(CALL(VecStr, vs, empty, /));
+    DROPOBJ(VecStr, vs);
+}
+
+static void class_refresh() {
+    VecStr source = gen_range(50);
+    VecStr v = gen_range(40);
+    const char *buffers[40];
+    for (usize i = 0; i < 40; i++) {
+        CALL(String, v.data[i], reserve, /, 8);
+        buffers[i] = v.data[i].data;
+    }
+    // the existing strings are cloned into, keeping their buffers
+    CALL(VecStr, v, clone_from, /, &source);
+    assert_same_vec(&v, &source);
+    for (usize i = 0; i < 40; i++) {
+        ASSERT(v.data[i].data == buffers[i]);
+    }
+    CALL(VecStr, source, truncate, /, 10);
+    CALL(VecStr, v, clone_from, /, &source);
+    assert_same_vec(&v, &source);
+    DROPOBJ(VecStr, source);
+    DROPOBJ(VecStr, v);
+}
+
+static void class_trivial() {
+    ASSERT(TYPE_IS_TRIVIAL_CLONE(Point) && TYPE_IS_TRIVIAL_DROP(Point));
+    ASSERT(!TYPE_IS_TRIVIAL_CLONE(Tracked) && !TYPE_IS_TRIVIAL_DROP(Tracked));
+    ASSERT(!TYPE_IS_TRIVIAL_CLONE(String) && !TYPE_IS_TRIVIAL_DROP(String));
+
+    VecPoint v = CREOBJ(VecPoint, /);
+    for (i32 i = 0; i < 100; i++) {
+        CALL(VecPoint, v, push_back, /, (Point){.x = i, .y = -i});
+    }
+    VecPoint copied = CALL(VecPoint, v, clone, /);
+    CALL(VecPoint, v, truncate, /, 10);
+    CALL(VecPoint, v, erase_range, /, 2, 5);
+    CALL(VecPoint, v, resize, /, 20, (Point){.x = 7, .y = 7});
+    ASSERT(v.size == 20 && v.data[2].x == 5 && v.data[19].y == 7);
+    CALL(VecPoint, v, clone_from, /, &copied);
+    ASSERT(v.size == 100);
+    for (i32 i = 0; i < 100; i++) {
+        ASSERT(v.data[i].x == i && v.data[i].y == -i);
+    }
+    DROPOBJ(VecPoint, copied);
+    DROPOBJ(VecPoint, v);
+}
+
 void test_class_vec() {
     class_simple();
     class_ins_rem();
+    class_sort();
+    class_retain();
+    class_refresh();
+    class_trivial();
 }
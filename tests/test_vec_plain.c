@@ -159,7 +159,139 @@ static void plain_ins_rem() {
     DROPOBJ(VecI32, v);
 }
 
+static int cmp_i32(const void *a, const void *b) {
+    return NORMALCMP(*(const i32 *)a, *(const i32 *)b);
+}
+
+static void plain_sort() {
+    const usize sizes[] = {0, 1, 2, 23, 24, 100, 129, 511, 512, 5000};
+    u64 seed = 12345;
+    for (usize s = 0; s < LENGTH(sizes); s++) {
+        usize n = sizes[s];
+        for (usize pattern = 0; pattern < 4; pattern++) {
+            VecI32 v = CREOBJ(VecI32, /);
+            for (usize i = 0; i < n; i++) {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                i32 x = (i32)(seed >> 33) - (1 << 30);
+                if (pattern == 1) {
+                    x = (i32)i;
+                } else if (pattern == 2) {
+                    x = (i32)(n - i);
+                } else if (pattern == 3) {
+                    x %= 7;
+                }
+                CALL(VecI32, v, push_back, /, x);
+            }
+            VecI32 expected = CALL(VecI32, v, clone, /);
+            if (n > 0) {
+                qsort(expected.data, n, sizeof(i32), cmp_i32);
+            }
+
+            VecI32 sorted = CALL(VecI32, v, clone, /);
+            CALL(VecI32, sorted, sort, /);
+            ASSERT(CALL(VecI32, sorted, is_sorted, /));
+            assert_same_vec(&sorted, &expected);
+
+            CALL(VecI32, sorted, clone_from, /, &v);
+            CALL(VecI32, sorted, stable_sort, /);
+            assert_same_vec(&sorted, &expected);
+
+            CALL(VecI32, sorted, clone_from, /, &v);
+            CALL(VecI32, sorted, sort_by_desc, /);
+            ASSERT(CALL(VecI32, sorted, is_sorted_by_desc, /));
+            for (usize i = 0; i < n; i++) {
+                ASSERT(sorted.data[i] == expected.data[n - 1 - i]);
+            }
+
+            CALL(VecI32, sorted, clone_from, /, &v);
+            CALL(VecI32, sorted, stable_sort_by_desc, /);
+            for (usize i = 0; i < n; i++) {
+                ASSERT(sorted.data[i] == expected.data[n - 1 - i]);
+            }
+
+            DROPOBJ(VecI32, sorted);
+            DROPOBJ(VecI32, expected);
+            DROPOBJ(VecI32, v);
+        }
+    }
+}
+
+static void plain_search() {
+    VecI32 v = CREOBJ(VecI32, /);
+    for (i32 i = 0; i < 10; i++) {
+        CALL(VecI32, v, push_back, /, i / 2 * 2);
+    }
+    // v == [0, 0, 2, 2, 4, 4, 6, 6, 8, 8]
+    i32 key = 4;
+    ASSERT(CALL(VecI32, v, lower_bound, /, &key) == 4);
+    ASSERT(CALL(VecI32, v, upper_bound, /, &key) == 6);
+    ASSERT(*CALL(VecI32, v, binary_search, /, &key) == 4);
+    key = 5;
+    ASSERT(CALL(VecI32, v, lower_bound, /, &key) == 6);
+    ASSERT(CALL(VecI32, v, upper_bound, /, &key) == 6);
+    ASSERT(CALL(VecI32, v, binary_search, /, &key) == NULL);
+    key = -1;
+    ASSERT(CALL(VecI32, v, lower_bound, /, &key) == 0);
+    key = 9;
+    ASSERT(CALL(VecI32, v, lower_bound, /, &key) == 10);
+    ASSERT(CALL(VecI32, v, binary_search, /, &key) == NULL);
+
+    CALL(VecI32, v, dedup, /);
+    // v == [0, 2, 4, 6, 8]
+    ASSERT(v.size == 5);
+    for (i32 i = 0; i < 5; i++) {
+        ASSERT(v.data[i] == i * 2);
+    }
+
+    CALL(VecI32, v, sort_by_desc, /);
+    // v == [8, 6, 4, 2, 0]
+    key = 6;
+    ASSERT(CALL(VecI32, v, lower_bound_by_desc, /, &key) == 1);
+    ASSERT(*CALL(VecI32, v, binary_search_by_desc, /, &key) == 6);
+
+    DROPOBJ(VecI32, v);
+}
+
+static bool is_multiple(const i32 *elem, void *ctx) {
+    return *elem % *(i32 *)ctx == 0;
+}
+
+static void plain_retain() {
+    VecI32 v = gen_range(10);
+    i32 three = 3;
+    CALL(VecI32, v, erase_if, /, is_multiple, &three);
+    // v == [1, 2, 4, 5, 7, 8]
+    ASSERT(v.size == 6);
+    ASSERT(v.data[0] == 1 && v.data[2] == 4 && v.data[5] == 8);
+
+    i32 two = 2;
+    CALL(VecI32, v, retain, /, is_multiple, &two);
+    // v == [2, 4, 8]
+    ASSERT(v.size == 3);
+    ASSERT(v.data[0] == 2 && v.data[1] == 4 && v.data[2] == 8);
+
+    CALL(VecI32, v, erase_range, /, 1, 1);
+    ASSERT(v.size == 3);
+    CALL(VecI32, v, erase_range, /, 0, 2);
+    // v == [8]
+    ASSERT(v.size == 1 && v.data[0] == 8);
+    CALL(VecI32, v, erase_range, /, 0, 1);
+    ASSERT(CALL(VecI32, v, empty, /));
+    CALL(VecI32, v, retain, /, is_multiple, &two);
+    ASSERT(CALL(VecI32, v, empty, /));
+    DROPOBJ(VecI32, v);
+
+    v = gen_range(1000);
+    CALL(VecI32, v, erase_range, /, 100, 900);
+    ASSERT(v.size == 200);
+    ASSERT(v.data[99] == 99 && v.data[100] == 900 && v.data[199] == 999);
+    DROPOBJ(VecI32, v);
+}
+
 void test_plain_vec() {
     plain_simple();
     plain_ins_rem();
+    plain_sort();
+    plain_search();
+    plain_retain();
 }